@@ -26,6 +26,12 @@ void Game::print_stats() {
     auto elapsed_millis = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
     std::stringstream ss;
     ss << "frames:" << frame_count << ", elapsedms:" << elapsed_millis;
+    if (settings_.headless) {
+        // only headless runs wait for the simulation step on its own, so the split is only meaningful there
+        ss << ", cpu us/frame: simulate " << frame_phase_time(FRAME_PHASE_SIMULATE) << ", record "
+           << frame_phase_time(FRAME_PHASE_RECORD) << ", submit " << frame_phase_time(FRAME_PHASE_SUBMIT) << ", wait "
+           << frame_phase_time(FRAME_PHASE_WAIT);
+    }
     shell_->log(Shell::LogPriority::LOG_INFO, ss.str().c_str());
 }
 
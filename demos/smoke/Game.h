@@ -17,6 +17,7 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <array>
 #include <chrono>
 #include <iostream>
 #include <string>
@@ -50,6 +51,9 @@ class Game {
         // Whether or not to use VkFlushMappedMemoryRanges
         bool flush_buffers;
 
+        // Render to offscreen images, with no window or swapchain
+        bool headless;
+
         int max_frame_count;
     };
     const Settings &settings() const { return settings_; }
@@ -75,6 +79,20 @@ class Game {
 
     virtual void on_frame(float frame_pred) {}
 
+    // Parts of a frame whose CPU time is tracked
+    enum FramePhase {
+        FRAME_PHASE_SIMULATE,
+        FRAME_PHASE_RECORD,
+        FRAME_PHASE_SUBMIT,
+        FRAME_PHASE_WAIT,
+        FRAME_PHASE_COUNT,
+    };
+    // Average CPU time per frame spent in phase so far, in microseconds
+    double frame_phase_time(FramePhase phase) const {
+        if (frame_count == 0) return 0.0;
+        return std::chrono::duration<double, std::micro>(frame_phase_times_[phase]).count() / frame_count;
+    }
+
     void print_stats();
     void quit();
 
@@ -82,6 +100,8 @@ class Game {
     int frame_count;
     std::chrono::time_point<std::chrono::system_clock> start_time;
 
+    void add_frame_phase_time(FramePhase phase, std::chrono::steady_clock::duration time) { frame_phase_times_[phase] += time; }
+
     Game(const std::string &name, const std::vector<std::string> &args) : settings_(), shell_(nullptr) {
         settings_.name = name;
         settings_.initial_width = 1280;
@@ -101,11 +121,17 @@ class Game {
 
         settings_.flush_buffers = false;
 
+        settings_.headless = false;
+
         settings_.max_frame_count = -1;
 
         parse_args(args);
 
+        // a headless run has no window to close, so always stop after a fixed number of frames
+        if (settings_.headless && settings_.max_frame_count == -1) settings_.max_frame_count = 1000;
+
         frame_count = 0;
+        frame_phase_times_.fill(std::chrono::steady_clock::duration::zero());
         // Record start time for printing stats later
         start_time = std::chrono::system_clock::now();
     }
@@ -114,6 +140,8 @@ class Game {
     Shell *shell_;
 
    private:
+    std::array<std::chrono::steady_clock::duration, FRAME_PHASE_COUNT> frame_phase_times_;
+
     void parse_args(const std::vector<std::string> &args) {
         for (auto it = args.begin(); it != args.end(); ++it) {
             if (*it == "--b") {
@@ -139,6 +167,8 @@ class Game {
                 settings_.no_present = true;
             } else if (*it == "--flush") {
                 settings_.flush_buffers = true;
+            } else if (*it == "--headless") {
+                settings_.headless = true;
             } else if (*it == "--c") {
                 ++it;
                 settings_.max_frame_count = std::stoi(*it);
@@ -14,30 +14,96 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "Smoke.h"
 
 namespace {
 
-#if defined(VK_USE_PLATFORM_ANDROID_KHR)
 Game *create_game(const std::vector<std::string> &args) { return new Smoke(args); }
-#endif
 
-Game *create_game(int argc, char **argv) {
+}  // namespace
+
+#if !defined(VK_USE_PLATFORM_ANDROID_KHR)
+
+#include "ShellHeadless.h"
+
+namespace {
+
+bool has_arg(int argc, char **argv, const char *arg) { return std::find(argv, argv + argc, std::string(arg)) != argv + argc; }
+
+bool is_headless(int argc, char **argv) { return has_arg(argc, argv, "--headless") || has_arg(argc, argv, "--sweep"); }
+
+// Run headless once per worker count, with uniform buffers and then push constants, and tabulate CPU time per frame
+int run_sweep(const std::vector<std::string> &args) {
+    const int max_worker_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    std::vector<int> worker_counts;
+    for (int count = 1; count < max_worker_count; count *= 2) worker_counts.push_back(count);
+    worker_counts.push_back(max_worker_count);
+
+    std::stringstream table;
+    table << std::fixed << std::setprecision(1);
+    table << "workers  params         simulate    record    submit      wait  (cpu us/frame)\n";
+    for (bool push_constants : {false, true}) {
+        for (int worker_count : worker_counts) {
+            std::vector<std::string> run_args(args);
+            run_args.push_back("--workers");
+            run_args.push_back(std::to_string(worker_count));
+            if (push_constants) run_args.push_back("-p");
+
+            Smoke game(run_args);
+            {
+                ShellHeadless shell(game);
+                shell.run();
+            }
+
+            table << std::setw(7) << worker_count << "  " << std::left << std::setw(13)
+                  << (push_constants ? "push_constant" : "uniform") << std::right;
+            for (int phase = 0; phase < Game::FRAME_PHASE_COUNT; phase++)
+                table << std::setw(10) << game.frame_phase_time(static_cast<Game::FramePhase>(phase));
+            table << "\n";
+        }
+    }
+
+    std::cout << table.str();
+
+    return 0;
+}
+
+int run_headless(int argc, char **argv) {
     std::vector<std::string> args(argv, argv + argc);
-    return new Smoke(args);
+    if (!has_arg(argc, argv, "--headless")) args.push_back("--headless");
+
+    if (has_arg(argc, argv, "--sweep")) return run_sweep(args);
+
+    Game *game = create_game(args);
+    {
+        ShellHeadless shell(*game);
+        shell.run();
+    }
+    delete game;
+
+    return 0;
 }
 
 }  // namespace
 
+#endif  // !VK_USE_PLATFORM_ANDROID_KHR
+
 #if defined(VK_USE_PLATFORM_XCB_KHR)
 
 #include "ShellXcb.h"
 
 int main(int argc, char **argv) {
-    Game *game = create_game(argc, argv);
+    if (is_headless(argc, argv)) return run_headless(argc, argv);
+
+    Game *game = create_game(std::vector<std::string>(argv, argv + argc));
     {
         ShellXcb shell(*game);
         shell.run();
@@ -52,7 +118,9 @@ int main(int argc, char **argv) {
 #include "ShellWayland.h"
 
 int main(int argc, char **argv) {
-    Game *game = create_game(argc, argv);
+    if (is_headless(argc, argv)) return run_headless(argc, argv);
+
+    Game *game = create_game(std::vector<std::string>(argv, argv + argc));
     {
         ShellWayland shell(*game);
         shell.run();
@@ -85,7 +153,9 @@ void android_main(android_app *app) {
 #include "ShellWin32.h"
 
 int main(int argc, char **argv) {
-    Game *game = create_game(argc, argv);
+    if (is_headless(argc, argv)) return run_headless(argc, argv);
+
+    Game *game = create_game(std::vector<std::string>(argv, argv + argc));
     {
         ShellWin32 shell(*game);
         shell.run();
@@ -95,4 +165,11 @@ int main(int argc, char **argv) {
     return 0;
 }
 
+#else
+
+int main(int argc, char **argv) {
+    if (!is_headless(argc, argv)) std::cout << "built without window system support, running headless\n";
+    return run_headless(argc, argv);
+}
+
 #endif  // VK_USE_PLATFORM_XCB_KHR
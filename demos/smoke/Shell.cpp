@@ -25,10 +25,17 @@
 #include "Game.h"
 
 Shell::Shell(Game &game)
-    : game_(game), settings_(game.settings()), ctx_(), game_tick_(1.0f / settings_.ticks_per_second), game_time_(game_tick_) {
-    // require generic WSI extensions
-    instance_extensions_.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
-    device_extensions_.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    : game_(game),
+      settings_(game.settings()),
+      ctx_(),
+      offscreen_mem_(VK_NULL_HANDLE),
+      game_tick_(1.0f / settings_.ticks_per_second),
+      game_time_(game_tick_) {
+    // require generic WSI extensions, unless rendering offscreen
+    if (!settings_.headless) {
+        instance_extensions_.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+        device_extensions_.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    }
 
     if (settings_.validate) {
         instance_extensions_.push_back(VK_EXT_DEBUG_REPORT_EXTENSION_NAME);
@@ -215,7 +222,14 @@ void Shell::create_context() {
     create_back_buffers();
 
     // initialize ctx_.{surface,format} before attach_shell
-    create_swapchain();
+    if (settings_.headless) {
+        ctx_.surface = VK_NULL_HANDLE;
+        ctx_.format.format = VK_FORMAT_B8G8R8A8_UNORM;
+        ctx_.format.colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+        ctx_.swapchain = VK_NULL_HANDLE;
+    } else {
+        create_swapchain();
+    }
 
     game_.attach_shell(*this);
 }
@@ -225,7 +239,10 @@ void Shell::destroy_context() {
 
     vk::DeviceWaitIdle(ctx_.dev);
 
-    destroy_swapchain();
+    if (settings_.headless)
+        destroy_offscreen_images();
+    else
+        destroy_swapchain();
 
     game_.detach_shell();
 
@@ -291,6 +308,9 @@ void Shell::create_back_buffers() {
         vk::assert_success(vk::CreateSemaphore(ctx_.dev, &sem_info, nullptr, &buf.render_semaphore));
         vk::assert_success(vk::CreateFence(ctx_.dev, &fence_info, nullptr, &buf.present_fence));
 
+        // when headless, each BackBuffer renders to an image of its own
+        buf.image_index = i;
+
         ctx_.back_buffers.push(buf);
     }
 }
@@ -332,6 +352,7 @@ void Shell::destroy_swapchain() {
 
         vk::DestroySwapchainKHR(ctx_.dev, ctx_.swapchain, nullptr);
         ctx_.swapchain = VK_NULL_HANDLE;
+        ctx_.images.clear();
     }
 
     vk::DestroySurfaceKHR(ctx_.instance, ctx_.surface, nullptr);
@@ -425,9 +446,77 @@ void Shell::resize_swapchain(uint32_t width_hint, uint32_t height_hint) {
         vk::DestroySwapchainKHR(ctx_.dev, swapchain_info.oldSwapchain, nullptr);
     }
 
+    vk::get(ctx_.dev, ctx_.swapchain, ctx_.images);
+
     game_.attach_swapchain();
 }
 
+void Shell::create_offscreen_images(uint32_t width, uint32_t height) {
+    assert(settings_.headless && ctx_.images.empty());
+
+    ctx_.extent.width = width;
+    ctx_.extent.height = height;
+
+    VkImageCreateInfo image_info = {};
+    image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    image_info.imageType = VK_IMAGE_TYPE_2D;
+    image_info.format = ctx_.format.format;
+    image_info.extent = {width, height, 1};
+    image_info.mipLevels = 1;
+    image_info.arrayLayers = 1;
+    image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    image_info.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    // one image per BackBuffer
+    ctx_.images.resize(ctx_.back_buffers.size());
+    for (auto &img : ctx_.images) vk::assert_success(vk::CreateImage(ctx_.dev, &image_info, nullptr, &img));
+
+    // all images are identical, so they can share one allocation
+    VkMemoryRequirements mem_reqs;
+    vk::GetImageMemoryRequirements(ctx_.dev, ctx_.images[0], &mem_reqs);
+    const VkDeviceSize aligned_size = (mem_reqs.size + mem_reqs.alignment - 1) / mem_reqs.alignment * mem_reqs.alignment;
+
+    VkPhysicalDeviceMemoryProperties mem_props;
+    vk::GetPhysicalDeviceMemoryProperties(ctx_.physical_dev, &mem_props);
+
+    VkMemoryAllocateInfo mem_info = {};
+    mem_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    mem_info.allocationSize = aligned_size * ctx_.images.size();
+    mem_info.memoryTypeIndex = mem_props.memoryTypeCount;
+    // prefer device local memory, but take any type the images can use
+    for (uint32_t idx = 0; idx < mem_props.memoryTypeCount; idx++) {
+        if (!(mem_reqs.memoryTypeBits & (1 << idx))) continue;
+
+        if (mem_props.memoryTypes[idx].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) {
+            mem_info.memoryTypeIndex = idx;
+            break;
+        }
+        if (mem_info.memoryTypeIndex == mem_props.memoryTypeCount) mem_info.memoryTypeIndex = idx;
+    }
+    if (mem_info.memoryTypeIndex == mem_props.memoryTypeCount) throw std::runtime_error("no memory type for offscreen images");
+
+    vk::assert_success(vk::AllocateMemory(ctx_.dev, &mem_info, nullptr, &offscreen_mem_));
+    for (size_t i = 0; i < ctx_.images.size(); i++)
+        vk::assert_success(vk::BindImageMemory(ctx_.dev, ctx_.images[i], offscreen_mem_, aligned_size * i));
+
+    game_.attach_swapchain();
+}
+
+void Shell::destroy_offscreen_images() {
+    if (!ctx_.images.empty()) {
+        game_.detach_swapchain();
+
+        for (auto img : ctx_.images) vk::DestroyImage(ctx_.dev, img, nullptr);
+        ctx_.images.clear();
+    }
+
+    vk::FreeMemory(ctx_.dev, offscreen_mem_, nullptr);
+    offscreen_mem_ = VK_NULL_HANDLE;
+}
+
 void Shell::add_game_time(float time) {
     int max_ticks = 3;
 
@@ -441,7 +530,7 @@ void Shell::add_game_time(float time) {
 
 void Shell::acquire_back_buffer() {
     // acquire just once when not presenting
-    if (settings_.no_present && ctx_.acquired_back_buffer.acquire_semaphore != VK_NULL_HANDLE) return;
+    if (!settings_.headless && settings_.no_present && ctx_.acquired_back_buffer.acquire_semaphore != VK_NULL_HANDLE) return;
 
     auto &buf = ctx_.back_buffers.front();
 
@@ -450,8 +539,17 @@ void Shell::acquire_back_buffer() {
     // reset the fence
     vk::assert_success(vk::ResetFences(ctx_.dev, 1, &buf.present_fence));
 
-    vk::assert_success(
-        vk::AcquireNextImageKHR(ctx_.dev, ctx_.swapchain, UINT64_MAX, buf.acquire_semaphore, VK_NULL_HANDLE, &buf.image_index));
+    if (settings_.headless) {
+        // the fence wait above means the image is no longer in use; signal acquire semaphore as the swapchain would
+        VkSubmitInfo submit_info = {};
+        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.signalSemaphoreCount = 1;
+        submit_info.pSignalSemaphores = &buf.acquire_semaphore;
+        vk::assert_success(vk::QueueSubmit(ctx_.game_queue, 1, &submit_info, VK_NULL_HANDLE));
+    } else {
+        vk::assert_success(vk::AcquireNextImageKHR(ctx_.dev, ctx_.swapchain, UINT64_MAX, buf.acquire_semaphore, VK_NULL_HANDLE,
+                                                   &buf.image_index));
+    }
 
     ctx_.acquired_back_buffer = buf;
     ctx_.back_buffers.pop();
@@ -462,6 +560,11 @@ void Shell::present_back_buffer() {
 
     if (!settings_.no_render) game_.on_frame(game_time_ / game_tick_);
 
+    if (settings_.headless) {
+        offscreen_present();
+        return;
+    }
+
     if (settings_.no_present) {
         fake_present();
         return;
@@ -502,3 +605,20 @@ void Shell::fake_present() {
     // push the buffer back just once for Shell::cleanup_vk
     if (buf.acquire_semaphore != ctx_.back_buffers.back().acquire_semaphore) ctx_.back_buffers.push(buf);
 }
+
+void Shell::offscreen_present() {
+    const auto &buf = ctx_.acquired_back_buffer;
+
+    assert(settings_.headless);
+
+    // wait render semaphore, and signal present_fence once the image is free again
+    VkPipelineStageFlags stage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    VkSubmitInfo submit_info = {};
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.waitSemaphoreCount = 1;
+    submit_info.pWaitSemaphores = (settings_.no_render) ? &buf.acquire_semaphore : &buf.render_semaphore;
+    submit_info.pWaitDstStageMask = &stage;
+    vk::assert_success(vk::QueueSubmit(ctx_.game_queue, 1, &submit_info, buf.present_fence));
+
+    ctx_.back_buffers.push(buf);
+}
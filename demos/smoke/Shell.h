@@ -62,6 +62,9 @@ class Shell {
         VkSwapchainKHR swapchain;
         VkExtent2D extent;
 
+        // images to render to: the swapchain's, or offscreen ones when headless
+        std::vector<VkImage> images;
+
         BackBuffer acquired_back_buffer;
     };
     const Context &context() const { return ctx_; }
@@ -87,6 +90,7 @@ class Shell {
     void destroy_context();
 
     void resize_swapchain(uint32_t width_hint, uint32_t height_hint);
+    void create_offscreen_images(uint32_t width, uint32_t height);
 
     void add_game_time(float time);
 
@@ -131,11 +135,16 @@ class Shell {
     virtual VkSurfaceKHR create_surface(VkInstance instance) = 0;
     void create_swapchain();
     void destroy_swapchain();
+    void destroy_offscreen_images();
 
     void fake_present();
+    void offscreen_present();
 
     Context ctx_;
 
+    // backs the offscreen images when headless
+    VkDeviceMemory offscreen_mem_;
+
     const float game_tick_;
     float game_time_;
 };
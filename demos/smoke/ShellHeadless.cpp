@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2016 Google, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sstream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+#include "Helpers.h"
+#include "Game.h"
+#include "ShellHeadless.h"
+
+ShellHeadless::ShellHeadless(Game &game) : Shell(game), lib_handle_(nullptr), quit_(false) {
+    if (game.settings().validate) instance_layers_.push_back("VK_LAYER_LUNARG_standard_validation");
+
+    init_vk();
+}
+
+ShellHeadless::~ShellHeadless() {
+    cleanup_vk();
+
+#if defined(_WIN32)
+    FreeLibrary(reinterpret_cast<HMODULE>(lib_handle_));
+#else
+    dlclose(lib_handle_);
+#endif
+}
+
+PFN_vkGetInstanceProcAddr ShellHeadless::load_vk() {
+#if defined(_WIN32)
+    const char filename[] = "vulkan-1.dll";
+    HMODULE mod;
+    PFN_vkGetInstanceProcAddr get_proc = NULL;
+
+    mod = LoadLibrary(filename);
+    if (mod) {
+        get_proc = reinterpret_cast<PFN_vkGetInstanceProcAddr>(GetProcAddress(mod, "vkGetInstanceProcAddr"));
+    }
+
+    if (!mod || !get_proc) {
+        std::stringstream ss;
+        ss << "failed to load " << filename;
+
+        if (mod) FreeLibrary(mod);
+
+        throw std::runtime_error(ss.str());
+    }
+
+    lib_handle_ = mod;
+
+    return get_proc;
+#else
+    const char filename[] = "libvulkan.so.1";
+    void *handle, *symbol;
+
+#ifdef UNINSTALLED_LOADER
+    handle = dlopen(UNINSTALLED_LOADER, RTLD_LAZY);
+    if (!handle) handle = dlopen(filename, RTLD_LAZY);
+#else
+    handle = dlopen(filename, RTLD_LAZY);
+#endif
+
+    if (handle) symbol = dlsym(handle, "vkGetInstanceProcAddr");
+
+    if (!handle || !symbol) {
+        std::stringstream ss;
+        ss << "failed to load " << dlerror();
+
+        if (handle) dlclose(handle);
+
+        throw std::runtime_error(ss.str());
+    }
+
+    lib_handle_ = handle;
+
+    return reinterpret_cast<PFN_vkGetInstanceProcAddr>(symbol);
+#endif
+}
+
+void ShellHeadless::run() {
+    create_context();
+    create_offscreen_images(settings_.initial_width, settings_.initial_height);
+
+    // a fixed step per frame, so that every run simulates the same thing
+    const float frame_time = 1.0f / settings_.ticks_per_second;
+
+    quit_ = false;
+    while (!quit_) {
+        acquire_back_buffer();
+        add_game_time(frame_time);
+        present_back_buffer();
+    }
+
+    destroy_context();
+}
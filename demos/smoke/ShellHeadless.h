@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2016 Google, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SHELL_HEADLESS_H
+#define SHELL_HEADLESS_H
+
+#include "Shell.h"
+
+// Renders into offscreen images with no window, surface or swapchain, advancing the game by one tick per frame until it
+// quits. Meant for benchmarking, so it also runs against ICDs without any WSI support.
+class ShellHeadless : public Shell {
+   public:
+    ShellHeadless(Game &game);
+    ~ShellHeadless();
+
+    void run();
+    void quit() { quit_ = true; }
+
+   private:
+    PFN_vkGetInstanceProcAddr load_vk();
+    bool can_present(VkPhysicalDevice phy, uint32_t queue_family) { return true; }
+
+    VkSurfaceKHR create_surface(VkInstance instance) { return VK_NULL_HANDLE; }
+
+    void *lib_handle_;
+
+    bool quit_;
+};
+
+#endif  // SHELL_HEADLESS_H
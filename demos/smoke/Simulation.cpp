@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <array>
@@ -68,206 +69,306 @@ class ColorPicker {
     std::uniform_real_distribution<float> blue_;
 };
 
-}  // namespace
-
-Animation::Animation(unsigned int rng_seed, float scale) : rng_(rng_seed), dir_(-1.0f, 1.0f), speed_(0.1f, 1.0f) {
-    float x = dir_(rng_);
-    float y = dir_(rng_);
-    float z = dir_(rng_);
-    if (std::abs(x) + std::abs(y) + std::abs(z) == 0.0f) x = 1.0f;
-
-    current_.axis = glm::normalize(glm::vec3(x, y, z));
-
-    current_.speed = speed_(rng_);
-    current_.scale = scale;
+// Unit vectors spanning the plane perpendicular to axis
+void circle_basis(const glm::vec3 &axis, glm::vec3 &a, glm::vec3 &b) {
+    glm::vec3 v;
+
+    if (axis.x != 0.0f) {
+        v.x = -axis.z / axis.x;
+        v.y = 0.0f;
+        v.z = 1.0f;
+    } else if (axis.y != 0.0f) {
+        v.x = 1.0f;
+        v.y = -axis.x / axis.y;
+        v.z = 0.0f;
+    } else {
+        v.x = 1.0f;
+        v.y = 0.0f;
+        v.z = -axis.x / axis.z;
+    }
 
-    current_.matrix = glm::scale(glm::mat4(1.0f), glm::vec3(current_.scale));
+    a = glm::normalize(v);
+    b = glm::normalize(glm::cross(a, axis));
 }
 
-glm::mat4 Animation::transformation(float t) {
-    current_.matrix = glm::rotate(current_.matrix, current_.speed * t, current_.axis);
+// Turn the angle whose cosine and sine are c and s by the step angle. The result is pulled back to the unit circle so that
+// rounding errors don't build up over many steps.
+inline void turn(float &c, float &s, float step_cos, float step_sin) {
+    const float next_c = c * step_cos - s * step_sin;
+    const float next_s = s * step_cos + c * step_sin;
+    const float k = 1.5f - 0.5f * (next_c * next_c + next_s * next_s);
 
-    return current_.matrix;
+    c = next_c * k;
+    s = next_s * k;
 }
 
-class Curve {
-   public:
-    virtual ~Curve() {}
-    virtual glm::vec3 evaluate(float t) = 0;
-};
+}  // namespace
 
-namespace {
+void Animations::add(unsigned int rng_seed, float scale) {
+    std::minstd_rand rng(rng_seed);
+    std::uniform_real_distribution<float> dir(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> speed(0.1f, 1.0f);
 
-enum CurveType {
-    CURVE_RANDOM,
-    CURVE_CIRCLE,
-    CURVE_COUNT,
-};
+    float x = dir(rng);
+    float y = dir(rng);
+    float z = dir(rng);
+    if (std::abs(x) + std::abs(y) + std::abs(z) == 0.0f) x = 1.0f;
 
-class RandomCurve : public Curve {
-   public:
-    RandomCurve(unsigned int rng_seed)
-        : rng_(rng_seed),
-          direction_(-0.3f, 0.3f),
-          duration_(1.0f, 5.0f),
-          segment_start_(0.0f),
-          segment_direction_(0.0f),
-          time_start_(0.0f),
-          time_duration_(0.0f) {}
-
-    glm::vec3 evaluate(float t) {
-        if (t >= time_start_ + time_duration_) new_segment(t);
-
-        pos_ += unit_dir_ * (t - last_);
-        last_ = t;
-
-        return pos_;
-    }
+    const glm::vec3 axis = glm::normalize(glm::vec3(x, y, z));
+    axis_x_.push_back(axis.x);
+    axis_y_.push_back(axis.y);
+    axis_z_.push_back(axis.z);
 
-   private:
-    void new_segment(float time_start) {
-        segment_start_ += segment_direction_;
-        segment_direction_ = glm::vec3(direction_(rng_), direction_(rng_), direction_(rng_));
+    speed_.push_back(speed(rng));
+    scale_.push_back(scale);
 
-        time_start_ = time_start;
-        time_duration_ = duration_(rng_);
+    cos_.push_back(1.0f);
+    sin_.push_back(0.0f);
 
-        unit_dir_ = segment_direction_ / time_duration_;
-        pos_ = segment_start_;
-        last_ = time_start_;
+    // the step for t = 0 is no rotation at all
+    step_t_.push_back(0.0f);
+    step_cos_.push_back(1.0f);
+    step_sin_.push_back(0.0f);
+}
+
+void Animations::update(float t, int begin, int end, glm::mat4 *models) {
+    // t is the tick interval, so the step rarely needs recomputing
+    for (int i = begin; i < end; i++) {
+        if (step_t_[i] != t) {
+            step_cos_[i] = std::cos(speed_[i] * t);
+            step_sin_[i] = std::sin(speed_[i] * t);
+            step_t_[i] = t;
+        }
     }
 
-    std::mt19937 rng_;
-    std::uniform_real_distribution<float> direction_;
-    std::uniform_real_distribution<float> duration_;
+    // rotations about the same axis add up, so each object's rotation is just the angle turned so far
+    for (int i = begin; i < end; i++) turn(cos_[i], sin_[i], step_cos_[i], step_sin_[i]);
 
-    glm::vec3 segment_start_;
-    glm::vec3 segment_direction_;
-    float time_start_;
-    float time_duration_;
+    // same matrix as glm::rotate, scaled
+    for (int i = begin; i < end; i++) {
+        const float c = cos_[i];
+        const float s = sin_[i];
+        const float x = axis_x_[i];
+        const float y = axis_y_[i];
+        const float z = axis_z_[i];
+        const float scale = scale_[i];
+        const float tx = (1.0f - c) * x * scale;
+        const float ty = (1.0f - c) * y * scale;
+        const float tz = (1.0f - c) * z * scale;
+        const float sc = c * scale;
+        const float ss = s * scale;
+
+        glm::mat4 &m = models[i];
+        m[0][0] = tx * x + sc;
+        m[0][1] = tx * y + ss * z;
+        m[0][2] = tx * z - ss * y;
+        m[0][3] = 0.0f;
+        m[1][0] = ty * x - ss * z;
+        m[1][1] = ty * y + sc;
+        m[1][2] = ty * z + ss * x;
+        m[1][3] = 0.0f;
+        m[2][0] = tz * x + ss * y;
+        m[2][1] = tz * y - ss * x;
+        m[2][2] = tz * z + sc;
+        m[2][3] = 0.0f;
+    }
+}
 
-    glm::vec3 unit_dir_;
-    glm::vec3 pos_;
-    float last_;
-};
+void Paths::add(unsigned int rng_seed) {
+    Subpath sub;
+    sub.rng.seed(rng_seed);
+
+    std::uniform_real_distribution<float> origin(0.0f, 2.0f);
+    sub.origin = glm::vec3(origin(sub.rng), origin(sub.rng), origin(sub.rng));
+
+    // an empty subpath at the origin, so that the first update generates a real one
+    sub.type = CURVE_RANDOM;
+    sub.start = 0.0f;
+    sub.end = 0.0f;
+    sub.segment_end = 0.0f;
+
+    now_.push_back(0.0f);
+    next_event_.push_back(0.0f);
+
+    base_x_.push_back(sub.origin.x);
+    base_y_.push_back(sub.origin.y);
+    base_z_.push_back(sub.origin.z);
+    a_x_.push_back(0.0f);
+    a_y_.push_back(0.0f);
+    a_z_.push_back(0.0f);
+    b_x_.push_back(0.0f);
+    b_y_.push_back(0.0f);
+    b_z_.push_back(0.0f);
+    cos_.push_back(1.0f);
+    sin_.push_back(0.0f);
+    velocity_x_.push_back(0.0f);
+    velocity_y_.push_back(0.0f);
+    velocity_z_.push_back(0.0f);
+    piece_start_.push_back(0.0f);
+
+    subpaths_.push_back(sub);
+}
 
-class CircleCurve : public Curve {
-   public:
-    CircleCurve(float radius, glm::vec3 axis) : r_(radius) {
-        glm::vec3 a;
-
-        if (axis.x != 0.0f) {
-            a.x = -axis.z / axis.x;
-            a.y = 0.0f;
-            a.z = 1.0f;
-        } else if (axis.y != 0.0f) {
-            a.x = 1.0f;
-            a.y = -axis.x / axis.y;
-            a.z = 0.0f;
-        } else {
-            a.x = 1.0f;
-            a.y = 0.0f;
-            a.z = -axis.x / axis.z;
-        }
+void Paths::update(float t, int begin, int end, glm::mat4 *models) {
+    // circles turn at one radian per second, so all of them share the step
+    const float step_cos = std::cos(t);
+    const float step_sin = std::sin(t);
 
-        a_ = glm::normalize(a);
-        b_ = glm::normalize(glm::cross(a_, axis));
+    for (int i = begin; i < end; i++) {
+        now_[i] += t;
+        turn(cos_[i], sin_[i], step_cos, step_sin);
     }
 
-    glm::vec3 evaluate(float t) {
-        return (a_ * (glm::vec3(std::cos(t)) - glm::vec3(1.0f)) + b_ * glm::vec3(std::sin(t))) * glm::vec3(r_);
+    for (int i = begin; i < end; i++) {
+        if (now_[i] >= next_event_[i]) next_piece(i);
     }
 
-   private:
-    float r_;
-    glm::vec3 a_;
-    glm::vec3 b_;
-};
-
-}  // namespace
-
-Path::Path(unsigned int rng_seed) : rng_(rng_seed), type_(0, CURVE_COUNT - 1), duration_(5.0f, 20.0f) {
-    // trigger a subpath generation
-    current_.end = -1.0f;
-    current_.now = 0.0f;
+    for (int i = begin; i < end; i++) {
+        const float c = cos_[i] - 1.0f;
+        const float s = sin_[i];
+        const float u = now_[i] - piece_start_[i];
+
+        glm::mat4 &m = models[i];
+        m[3][0] = base_x_[i] + a_x_[i] * c + b_x_[i] * s + velocity_x_[i] * u;
+        m[3][1] = base_y_[i] + a_y_[i] * c + b_y_[i] * s + velocity_y_[i] * u;
+        m[3][2] = base_z_[i] + a_z_[i] * c + b_z_[i] * s + velocity_z_[i] * u;
+        m[3][3] = 1.0f;
+    }
 }
 
-glm::vec3 Path::position(float t) {
-    current_.now += t;
+glm::vec3 Paths::position(int index, float now) const {
+    const float u = now - subpaths_[index].start;
+    const float c = std::cos(u) - 1.0f;
+    const float s = std::sin(u);
+    const float v = now - piece_start_[index];
 
-    while (current_.now >= current_.end) generate_subpath();
-
-    return current_.origin + current_.curve->evaluate(current_.now - current_.start);
+    return glm::vec3(base_x_[index] + a_x_[index] * c + b_x_[index] * s + velocity_x_[index] * v,
+                     base_y_[index] + a_y_[index] * c + b_y_[index] * s + velocity_y_[index] * v,
+                     base_z_[index] + a_z_[index] * c + b_z_[index] * s + velocity_z_[index] * v);
 }
 
-void Path::generate_subpath() {
-    float duration = duration_(rng_);
-    CurveType type = static_cast<CurveType>(type_(rng_));
+void Paths::next_piece(int index) {
+    Subpath &sub = subpaths_[index];
+    const float now = now_[index];
+
+    while (now >= sub.end) generate_subpath(index);
 
-    if (current_.curve) {
-        current_.origin += current_.curve->evaluate(current_.end - current_.start);
-        current_.start = current_.end;
+    if (sub.type == CURVE_CIRCLE) {
+        cos_[index] = std::cos(now - sub.start);
+        sin_[index] = std::sin(now - sub.start);
     } else {
-        std::uniform_real_distribution<float> origin(0.0f, 2.0f);
-        current_.origin = glm::vec3(origin(rng_), origin(rng_), origin(rng_));
-        current_.start = current_.now;
+        while (now >= sub.segment_end) generate_segment(index);
     }
 
-    current_.end = current_.start + duration;
+    next_event_[index] = std::min(sub.end, sub.segment_end);
+}
+
+void Paths::generate_subpath(int index) {
+    Subpath &sub = subpaths_[index];
+    std::uniform_int_distribution<> type(0, CURVE_COUNT - 1);
+    std::uniform_real_distribution<float> duration(5.0f, 20.0f);
+
+    // pick up where the last subpath ended
+    sub.origin = position(index, sub.end);
+    sub.start = sub.end;
+    sub.end = sub.start + duration(sub.rng);
+    sub.type = static_cast<CurveType>(type(sub.rng));
 
-    Curve *curve;
+    glm::vec3 a(0.0f);
+    glm::vec3 b(0.0f);
 
-    switch (type) {
+    switch (sub.type) {
         case CURVE_RANDOM:
-            curve = new RandomCurve(rng_());
+            // the first segment is generated right away
+            sub.segment_end = sub.start;
             break;
         case CURVE_CIRCLE: {
             std::uniform_real_distribution<float> dir(-1.0f, 1.0f);
-            glm::vec3 axis(dir(rng_), dir(rng_), dir(rng_));
+            glm::vec3 axis(dir(sub.rng), dir(sub.rng), dir(sub.rng));
             if (axis.x == 0.0f && axis.y == 0.0f && axis.z == 0.0f) axis.x = 1.0f;
 
-            std::uniform_real_distribution<float> radius_(0.02f, 0.2f);
-            curve = new CircleCurve(radius_(rng_), axis);
+            std::uniform_real_distribution<float> radius(0.02f, 0.2f);
+            const float r = radius(sub.rng);
+            circle_basis(axis, a, b);
+            a *= r;
+            b *= r;
+
+            sub.segment_end = sub.end;
         } break;
         default:
             assert(!"unreachable");
-            curve = nullptr;
             break;
     }
 
-    current_.curve.reset(curve);
+    base_x_[index] = sub.origin.x;
+    base_y_[index] = sub.origin.y;
+    base_z_[index] = sub.origin.z;
+    a_x_[index] = a.x;
+    a_y_[index] = a.y;
+    a_z_[index] = a.z;
+    b_x_[index] = b.x;
+    b_y_[index] = b.y;
+    b_z_[index] = b.z;
+    cos_[index] = 1.0f;
+    sin_[index] = 0.0f;
+    velocity_x_[index] = 0.0f;
+    velocity_y_[index] = 0.0f;
+    velocity_z_[index] = 0.0f;
+    piece_start_[index] = sub.start;
+}
+
+void Paths::generate_segment(int index) {
+    Subpath &sub = subpaths_[index];
+    std::uniform_real_distribution<float> direction(-0.3f, 0.3f);
+    std::uniform_real_distribution<float> duration(1.0f, 5.0f);
+
+    // pick up where the last segment ended
+    const glm::vec3 pos = position(index, sub.segment_end);
+    const glm::vec3 dir(direction(sub.rng), direction(sub.rng), direction(sub.rng));
+    const float d = duration(sub.rng);
+
+    base_x_[index] = pos.x;
+    base_y_[index] = pos.y;
+    base_z_[index] = pos.z;
+    velocity_x_[index] = dir.x / d;
+    velocity_y_[index] = dir.y / d;
+    velocity_z_[index] = dir.z / d;
+    piece_start_[index] = sub.segment_end;
+
+    sub.segment_end += d;
 }
 
 Simulation::Simulation(int object_count) : random_dev_() {
     MeshPicker mesh;
     ColorPicker color(random_dev_());
 
-    objects_.reserve(object_count);
+    meshes_.reserve(object_count);
+    light_positions_.reserve(object_count);
+    light_colors_.reserve(object_count);
     for (int i = 0; i < object_count; i++) {
         Meshes::Type type = mesh.pick();
         float scale = mesh.scale(type);
 
-        objects_.emplace_back(Object{
-            type, glm::vec3(0.5f + 0.5f * (float)i / object_count), color.pick(), Animation(random_dev_(), scale),
-            Path(random_dev_()),
-        });
+        meshes_.push_back(type);
+        light_positions_.push_back(glm::vec3(0.5f + 0.5f * (float)i / object_count));
+        light_colors_.push_back(color.pick());
+        animations_.add(random_dev_(), scale);
+        paths_.add(random_dev_());
     }
+
+    frame_data_offsets_.resize(object_count, 0);
+    models_.resize(object_count, glm::mat4(1.0f));
 }
 
 void Simulation::set_frame_data_size(uint32_t size) {
     uint32_t offset = 0;
-    for (auto &obj : objects_) {
-        obj.frame_data_offset = offset;
+    for (auto &frame_data_offset : frame_data_offsets_) {
+        frame_data_offset = offset;
         offset += size;
     }
 }
 
 void Simulation::update(float time, int begin, int end) {
-    for (int i = begin; i < end; i++) {
-        auto &obj = objects_[i];
-
-        glm::vec3 pos = obj.path.position(time);
-        glm::mat4 trans = obj.animation.transformation(time);
-        obj.model = glm::translate(glm::mat4(1.0f), pos) * trans;
-    }
+    animations_.update(time, begin, end, models_.data());
+    paths_.update(time, begin, end, models_.data());
 }
@@ -17,7 +17,6 @@
 #ifndef SIMULATION_H
 #define SIMULATION_H
 
-#include <memory>
 #include <random>
 #include <vector>
 
@@ -25,73 +24,84 @@
 
 #include "Meshes.h"
 
-class Animation {
+// Objects are stored as structures of arrays, one array per field, so that each pass over a range of objects streams
+// through just the fields it needs and the arithmetic vectorizes. Per-object state that is only touched when a path
+// changes direction is kept apart, in one struct per object.
+
+// Spins each object about a fixed random axis at a random speed
+class Animations {
    public:
-    Animation(unsigned rng_seed, float scale);
+    void add(unsigned rng_seed, float scale);
 
-    glm::mat4 transformation(float t);
+    // Advance objects [begin, end) by t and write their scaled rotations to the upper 3x3 of models
+    void update(float t, int begin, int end, glm::mat4 *models);
 
    private:
-    struct Data {
-        glm::vec3 axis;
-        float speed;
-        float scale;
-
-        glm::mat4 matrix;
-    };
-
-    std::mt19937 rng_;
-    std::uniform_real_distribution<float> dir_;
-    std::uniform_real_distribution<float> speed_;
+    std::vector<float> axis_x_, axis_y_, axis_z_;
+    std::vector<float> speed_;
+    std::vector<float> scale_;
 
-    Data current_;
+    // cosine and sine of the angle turned so far, advanced by the per-tick step rather than recomputed
+    std::vector<float> cos_, sin_;
+    std::vector<float> step_t_, step_cos_, step_sin_;
 };
 
-class Curve;
-
-class Path {
+// Moves each object along a series of subpaths, each either a circle or a chain of random straight segments. Every piece
+// of a path has the form base + a * (cos(u) - 1) + b * sin(u) + velocity * (now - piece_start), with a and b zero for
+// segments and velocity zero for circles, so that all objects are positioned by the same arithmetic.
+class Paths {
    public:
-    Path(unsigned rng_seed);
+    void add(unsigned rng_seed);
 
-    glm::vec3 position(float t);
+    // Advance objects [begin, end) by t and write their positions to the translation column of models
+    void update(float t, int begin, int end, glm::mat4 *models);
 
    private:
+    enum CurveType {
+        CURVE_RANDOM,
+        CURVE_CIRCLE,
+        CURVE_COUNT,
+    };
+
     struct Subpath {
+        std::minstd_rand rng;
+
+        CurveType type;
         glm::vec3 origin;
         float start;
         float end;
-        float now;
-
-        std::shared_ptr<Curve> curve;
+        float segment_end;  // end of the current straight segment of a random curve
     };
 
-    void generate_subpath();
+    void next_piece(int index);
+    void generate_subpath(int index);
+    void generate_segment(int index);
+    glm::vec3 position(int index, float now) const;
+
+    std::vector<float> now_;
+    std::vector<float> next_event_;  // earliest of the subpath and segment ends
 
-    std::mt19937 rng_;
-    std::uniform_int_distribution<> type_;
-    std::uniform_real_distribution<float> duration_;
+    std::vector<float> base_x_, base_y_, base_z_;
+    std::vector<float> a_x_, a_y_, a_z_;
+    std::vector<float> b_x_, b_y_, b_z_;
+    std::vector<float> cos_, sin_;
+    std::vector<float> velocity_x_, velocity_y_, velocity_z_;
+    std::vector<float> piece_start_;
 
-    Subpath current_;
+    std::vector<Subpath> subpaths_;
 };
 
 class Simulation {
    public:
     Simulation(int object_count);
 
-    struct Object {
-        Meshes::Type mesh;
-        glm::vec3 light_pos;
-        glm::vec3 light_color;
-
-        Animation animation;
-        Path path;
-
-        uint32_t frame_data_offset;
+    int object_count() const { return static_cast<int>(meshes_.size()); }
 
-        glm::mat4 model;
-    };
-
-    const std::vector<Object> &objects() const { return objects_; }
+    const std::vector<Meshes::Type> &meshes() const { return meshes_; }
+    const std::vector<glm::vec3> &light_positions() const { return light_positions_; }
+    const std::vector<glm::vec3> &light_colors() const { return light_colors_; }
+    const std::vector<uint32_t> &frame_data_offsets() const { return frame_data_offsets_; }
+    const std::vector<glm::mat4> &models() const { return models_; }
 
     unsigned int rng_seed() { return random_dev_(); }
 
@@ -100,7 +110,15 @@ class Simulation {
 
    private:
     std::random_device random_dev_;
-    std::vector<Object> objects_;
+
+    std::vector<Meshes::Type> meshes_;
+    std::vector<glm::vec3> light_positions_;
+    std::vector<glm::vec3> light_colors_;
+    std::vector<uint32_t> frame_data_offsets_;
+    std::vector<glm::mat4> models_;
+
+    Animations animations_;
+    Paths paths_;
 };
 
 #endif  // SIMULATION_H
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <array>
 
 #include <glm/gtc/type_ptr.hpp>
@@ -35,14 +36,47 @@ struct ShaderParamBlock {
     float view_projection[4 * 4];
 };
 
+// Workers take objects in chunks of this many. Small enough to even out the load, and large enough for the per-object
+// loops in Simulation::update to vectorize and for contention on the shares to stay low.
+const int object_chunk_size = 256;
+
+int object_count(const std::vector<std::string> &args) {
+    auto it = std::find(args.begin(), args.end(), "--objects");
+    return (it != args.end() && it + 1 != args.end()) ? std::stoi(*(it + 1)) : 5000;
+}
+
+uint64_t pack_objects(int begin, int end) { return (static_cast<uint64_t>(begin) << 32) | static_cast<uint32_t>(end); }
+
+// Take up to object_chunk_size objects off the front or back of a share
+bool take_chunk(std::atomic<uint64_t> &objects, bool from_back, int &begin, int &end) {
+    uint64_t packed = objects.load(std::memory_order_relaxed);
+    while (true) {
+        const int first = static_cast<int>(packed >> 32);
+        const int last = static_cast<int>(packed & 0xffffffff);
+        if (first >= last) return false;
+
+        if (from_back) {
+            begin = std::max(last - object_chunk_size, first);
+            end = last;
+        } else {
+            begin = first;
+            end = std::min(first + object_chunk_size, last);
+        }
+
+        const uint64_t rest = from_back ? pack_objects(first, begin) : pack_objects(end, last);
+        if (objects.compare_exchange_weak(packed, rest, std::memory_order_relaxed)) return true;
+    }
+}
+
 }  // namespace
 
 Smoke::Smoke(const std::vector<std::string> &args)
     : Game("Smoke", args),
       multithread_(true),
       use_push_constants_(false),
+      worker_count_(0),
       sim_paused_(false),
-      sim_(5000),
+      sim_(object_count(args)),
       camera_(2.5f),
       frame_data_(),
       render_pass_clear_value_({{{0.0f, 0.1f, 0.2f, 1.0f}}}),
@@ -54,6 +88,8 @@ Smoke::Smoke(const std::vector<std::string> &args)
             multithread_ = false;
         else if (*it == "-p")
             use_push_constants_ = true;
+        else if (*it == "--workers")
+            worker_count_ = std::stoi(*++it);
     }
 
     init_workers();
@@ -62,7 +98,7 @@ Smoke::Smoke(const std::vector<std::string> &args)
 Smoke::~Smoke() {}
 
 void Smoke::init_workers() {
-    int worker_count = std::thread::hardware_concurrency();
+    int worker_count = (worker_count_ > 0) ? worker_count_ : static_cast<int>(std::thread::hardware_concurrency());
 
     // not enough cores
     if (!multithread_ || worker_count < 2) {
@@ -70,7 +106,7 @@ void Smoke::init_workers() {
         worker_count = 1;
     }
 
-    const int object_per_worker = static_cast<int>(sim_.objects().size()) / worker_count;
+    const int object_per_worker = sim_.object_count() / worker_count;
     int object_begin = 0, object_end = 0;
 
     workers_.reserve(worker_count);
@@ -79,7 +115,7 @@ void Smoke::init_workers() {
         if (i < worker_count - 1)
             object_end += object_per_worker;
         else
-            object_end = static_cast<int>(sim_.objects().size());
+            object_end = sim_.object_count();
 
         Worker *worker = new Worker(*this, i, object_begin, object_end);
         workers_.emplace_back(std::unique_ptr<Worker>(worker));
@@ -166,7 +202,8 @@ void Smoke::create_render_pass() {
     attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
     attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
     attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    attachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    // offscreen images are never presented, and PRESENT_SRC_KHR needs VK_KHR_swapchain
+    attachment.finalLayout = settings_.headless ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
     VkAttachmentReference attachment_ref = {};
     attachment_ref.attachment = 0;
@@ -436,7 +473,7 @@ void Smoke::create_buffers() {
 
     VkBufferCreateInfo buf_info = {};
     buf_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    buf_info.size = object_data_size * sim_.objects().size();
+    buf_info.size = object_data_size * sim_.object_count();
     buf_info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
     buf_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
@@ -535,7 +572,7 @@ void Smoke::attach_swapchain() {
     const Shell::Context &ctx = shell_->context();
 
     prepare_viewport(ctx.extent);
-    prepare_framebuffers(ctx.swapchain);
+    prepare_framebuffers(ctx.images);
 
     update_camera();
 }
@@ -563,9 +600,8 @@ void Smoke::prepare_viewport(const VkExtent2D &extent) {
     scissor_.extent = extent_;
 }
 
-void Smoke::prepare_framebuffers(VkSwapchainKHR swapchain) {
-    // get swapchain images
-    vk::get(dev_, swapchain, images_);
+void Smoke::prepare_framebuffers(const std::vector<VkImage> &images) {
+    images_ = images;
 
     assert(framebuffers_.empty());
     image_views_.reserve(images_.size());
@@ -613,31 +649,37 @@ void Smoke::update_camera() {
     camera_.view_projection = clip * projection * view;
 }
 
-void Smoke::draw_object(const Simulation::Object &obj, FrameData &data, VkCommandBuffer cmd) const {
+void Smoke::draw_object(int index, FrameData &data, VkCommandBuffer cmd) const {
+    const glm::vec3 &light_pos = sim_.light_positions()[index];
+    const glm::vec3 &light_color = sim_.light_colors()[index];
+    const glm::mat4 &model = sim_.models()[index];
+    const uint32_t &frame_data_offset = sim_.frame_data_offsets()[index];
+
     if (use_push_constants_) {
         ShaderParamBlock params;
-        memcpy(params.light_pos, glm::value_ptr(obj.light_pos), sizeof(obj.light_pos));
-        memcpy(params.light_color, glm::value_ptr(obj.light_color), sizeof(obj.light_color));
-        memcpy(params.model, glm::value_ptr(obj.model), sizeof(obj.model));
+        memcpy(params.light_pos, glm::value_ptr(light_pos), sizeof(light_pos));
+        memcpy(params.light_color, glm::value_ptr(light_color), sizeof(light_color));
+        memcpy(params.model, glm::value_ptr(model), sizeof(model));
         memcpy(params.view_projection, glm::value_ptr(camera_.view_projection), sizeof(camera_.view_projection));
 
         vk::CmdPushConstants(cmd, pipeline_layout_, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(params), &params);
     } else {
-        ShaderParamBlock *params = reinterpret_cast<ShaderParamBlock *>(data.base + obj.frame_data_offset);
-        memcpy(params->light_pos, glm::value_ptr(obj.light_pos), sizeof(obj.light_pos));
-        memcpy(params->light_color, glm::value_ptr(obj.light_color), sizeof(obj.light_color));
-        memcpy(params->model, glm::value_ptr(obj.model), sizeof(obj.model));
+        ShaderParamBlock *params = reinterpret_cast<ShaderParamBlock *>(data.base + frame_data_offset);
+        memcpy(params->light_pos, glm::value_ptr(light_pos), sizeof(light_pos));
+        memcpy(params->light_color, glm::value_ptr(light_color), sizeof(light_color));
+        memcpy(params->model, glm::value_ptr(model), sizeof(model));
         memcpy(params->view_projection, glm::value_ptr(camera_.view_projection), sizeof(camera_.view_projection));
 
         vk::CmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout_, 0, 1, &data.desc_set, 1,
-                                  &obj.frame_data_offset);
+                                  &frame_data_offset);
     }
 
-    meshes_->cmd_draw(cmd, obj.mesh);
+    meshes_->cmd_draw(cmd, sim_.meshes()[index]);
 }
 
-void Smoke::update_simulation(const Worker &worker) {
-    sim_.update(worker.tick_interval_, worker.object_begin_, worker.object_end_);
+void Smoke::update_simulation(Worker &worker) {
+    int begin, end;
+    while (worker.take_objects(begin, end)) sim_.update(worker.tick_interval_, begin, end);
 }
 
 void Smoke::draw_objects(Worker &worker) {
@@ -663,10 +705,9 @@ void Smoke::draw_objects(Worker &worker) {
 
     meshes_->cmd_bind_buffers(cmd);
 
-    for (int i = worker.object_begin_; i < worker.object_end_; i++) {
-        auto &obj = sim_.objects()[i];
-
-        draw_object(obj, data, cmd);
+    int begin, end;
+    while (worker.take_objects(begin, end)) {
+        for (int i = begin; i < end; i++) draw_object(i, data, cmd);
     }
 
     vk::EndCommandBuffer(cmd);
@@ -697,27 +738,40 @@ void Smoke::on_key(Key key) {
 void Smoke::on_tick() {
     if (sim_paused_) return;
 
+    const auto start = std::chrono::steady_clock::now();
+
+    // a step left running by the previous tick still owns the shares
+    for (auto &worker : workers_) worker->wait_idle();
+    for (auto &worker : workers_) worker->reset_objects();
     for (auto &worker : workers_) worker->update_simulation();
+
+    // the step otherwise overlaps whatever the shell does before on_frame; wait for it so that it's timed on its own
+    if (settings_.headless) {
+        for (auto &worker : workers_) worker->wait_idle();
+    }
+
+    add_frame_phase_time(FRAME_PHASE_SIMULATE, std::chrono::steady_clock::now() - start);
 }
 
 void Smoke::on_frame(float frame_pred) {
     frame_count++;
 
-    // Limit number of frames if argument was specified
-    if (settings_.max_frame_count != -1 && frame_count == settings_.max_frame_count) {
-        // Tell the Game we're done after this frame is drawn.
-        Game::quit();
-    }
-
     auto &data = frame_data_[frame_data_index_];
 
+    const auto wait_start = std::chrono::steady_clock::now();
+
     // wait for the last submission since we reuse frame data
     vk::assert_success(vk::WaitForFences(dev_, 1, &data.fence, true, UINT64_MAX));
     vk::assert_success(vk::ResetFences(dev_, 1, &data.fence));
 
+    const auto record_start = std::chrono::steady_clock::now();
+    add_frame_phase_time(FRAME_PHASE_WAIT, record_start - wait_start);
+
     const Shell::BackBuffer &back = shell_->context().acquired_back_buffer;
 
     // ignore frame_pred
+    for (auto &worker : workers_) worker->wait_idle();
+    for (auto &worker : workers_) worker->reset_objects();
     for (auto &worker : workers_) worker->draw_objects(framebuffers_[back.image_index]);
 
     VkResult res = vk::BeginCommandBuffer(data.primary_cmd, &primary_cmd_begin_info_);
@@ -765,10 +819,21 @@ void Smoke::on_frame(float frame_pred) {
     primary_cmd_submit_info_.pCommandBuffers = &data.primary_cmd;
     primary_cmd_submit_info_.pSignalSemaphores = &back.render_semaphore;
 
+    const auto submit_start = std::chrono::steady_clock::now();
+    add_frame_phase_time(FRAME_PHASE_RECORD, submit_start - record_start);
+
     res = vk::QueueSubmit(queue_, 1, &primary_cmd_submit_info_, data.fence);
 
+    add_frame_phase_time(FRAME_PHASE_SUBMIT, std::chrono::steady_clock::now() - submit_start);
+
     frame_data_index_ = (frame_data_index_ + 1) % frame_data_.size();
 
+    // Limit number of frames if argument was specified. Checked last so that the stats include this frame's times.
+    if (settings_.max_frame_count != -1 && frame_count == settings_.max_frame_count) {
+        // Tell the Game we're done after this frame is drawn.
+        Game::quit();
+    }
+
     (void)res;
 }
 
@@ -778,7 +843,8 @@ Smoke::Worker::Worker(Smoke &smoke, int index, int object_begin, int object_end)
       object_begin_(object_begin),
       object_end_(object_end),
       tick_interval_(1.0f / smoke.settings_.ticks_per_second),
-      state_(INIT) {}
+      state_(INIT),
+      objects_(pack_objects(object_begin, object_end)) {}
 
 void Smoke::Worker::start() {
     state_ = IDLE;
@@ -838,6 +904,20 @@ void Smoke::Worker::wait_idle() {
     if (started) state_cv_.wait(lock, [this] { return (state_ == IDLE); });
 }
 
+void Smoke::Worker::reset_objects() { objects_.store(pack_objects(object_begin_, object_end_), std::memory_order_relaxed); }
+
+bool Smoke::Worker::take_objects(int &begin, int &end) {
+    if (take_chunk(objects_, false, begin, end)) return true;
+
+    const int worker_count = static_cast<int>(smoke_.workers_.size());
+    for (int i = 1; i < worker_count; i++) {
+        Worker &victim = *smoke_.workers_[(index_ + i) % worker_count];
+        if (take_chunk(victim.objects_, true, begin, end)) return true;
+    }
+
+    return false;
+}
+
 void Smoke::Worker::update_loop() {
     while (true) {
         std::unique_lock<std::mutex> lock(mutex_);
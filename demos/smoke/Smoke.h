@@ -17,6 +17,7 @@
 #ifndef SMOKE_H
 #define SMOKE_H
 
+#include <atomic>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
@@ -59,6 +60,12 @@ class Smoke : public Game {
         void draw_objects(VkFramebuffer fb);
         void wait_idle();
 
+        // Hand this worker its own share of the objects again, ready for the next step or draw. Workers must be idle.
+        void reset_objects();
+        // Take the next chunk of objects, from the front of this worker's share or, once that is used up, from the back of
+        // another worker's. Returns false when no objects are left.
+        bool take_objects(int &begin, int &end);
+
         Smoke &smoke_;
 
         const int index_;
@@ -85,6 +92,9 @@ class Smoke : public Game {
         std::mutex mutex_;
         std::condition_variable state_cv_;
         State state_;
+
+        // what is left of this worker's share, packed as begin << 32 | end so that the front and back move together
+        std::atomic<uint64_t> objects_;
     };
 
     struct Camera {
@@ -111,6 +121,7 @@ class Smoke : public Game {
 
     bool multithread_;
     bool use_push_constants_;
+    int worker_count_;  // 0 to use one per hardware thread
 
     // called mostly by on_key
     void update_camera();
@@ -171,7 +182,7 @@ class Smoke : public Game {
 
     // called by attach_swapchain
     void prepare_viewport(const VkExtent2D &extent);
-    void prepare_framebuffers(VkSwapchainKHR swapchain);
+    void prepare_framebuffers(const std::vector<VkImage> &images);
 
     VkExtent2D extent_;
     VkViewport viewport_;
@@ -182,8 +193,8 @@ class Smoke : public Game {
     std::vector<VkFramebuffer> framebuffers_;
 
     // called by workers
-    void update_simulation(const Worker &worker);
-    void draw_object(const Simulation::Object &obj, FrameData &data, VkCommandBuffer cmd) const;
+    void update_simulation(Worker &worker);
+    void draw_object(int index, FrameData &data, VkCommandBuffer cmd) const;
     void draw_objects(Worker &worker);
 };
 
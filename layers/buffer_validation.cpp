@@ -351,29 +351,14 @@ void TransitionSubpassLayouts(layer_data *device_data, GLOBAL_CB_NODE *pCB, cons
     }
 }
 
-bool ValidateImageAspectLayout(layer_data *device_data, GLOBAL_CB_NODE *pCB, const VkImageMemoryBarrier *mem_barrier,
-                               uint32_t level, uint32_t layer, VkImageAspectFlags aspect) {
-    if (!(mem_barrier->subresourceRange.aspectMask & aspect)) {
-        return false;
-    }
-    VkImageSubresource sub = {aspect, level, layer};
-    IMAGE_CMD_BUF_LAYOUT_NODE node;
-    if (!FindCmdBufLayout(device_data, pCB, mem_barrier->image, sub, node)) {
-        return false;
-    }
-    bool skip = false;
-    if (mem_barrier->oldLayout == VK_IMAGE_LAYOUT_UNDEFINED) {
-        // TODO: Set memory invalid which is in mem_tracker currently
-    } else if (node.layout != mem_barrier->oldLayout) {
-        skip |=
-            log_msg(core_validation::GetReportData(device_data), VK_DEBUG_REPORT_ERROR_BIT_EXT,
-                    VK_DEBUG_REPORT_OBJECT_TYPE_COMMAND_BUFFER_EXT, HandleToUint64(pCB->commandBuffer), __LINE__,
-                    DRAWSTATE_INVALID_IMAGE_LAYOUT, "DS",
-                    "For image 0x%" PRIxLEAST64 " you cannot transition the layout of aspect %d from %s when current layout is %s.",
-                    HandleToUint64(mem_barrier->image), aspect, string_VkImageLayout(mem_barrier->oldLayout),
-                    string_VkImageLayout(node.layout));
-    }
-    return skip;
+// The aspects that layouts are tracked for, in the order they're checked and transitioned
+static const VkImageAspectFlagBits layout_aspects[] = {VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_ASPECT_DEPTH_BIT,
+                                                       VK_IMAGE_ASPECT_STENCIL_BIT, VK_IMAGE_ASPECT_METADATA_BIT};
+
+// The layout a command buffer has recorded for an image as a whole, which applies to the subresources with none of their own
+static IMAGE_CMD_BUF_LAYOUT_NODE const *FindWholeImageCmdBufLayout(GLOBAL_CB_NODE const *pCB, VkImage image) {
+    auto it = pCB->imageLayoutMap.find({image, false, VkImageSubresource()});
+    return it != pCB->imageLayoutMap.end() ? &it->second : nullptr;
 }
 
 // Transition the layout state for renderpass attachments based on the BeginRenderPass() call. This includes:
@@ -391,24 +376,6 @@ void TransitionBeginRenderPassLayouts(layer_data *device_data, GLOBAL_CB_NODE *c
     TransitionSubpassLayouts(device_data, cb_state, render_pass_state, 0, framebuffer_state);
 }
 
-void TransitionImageAspectLayout(layer_data *device_data, GLOBAL_CB_NODE *pCB, const VkImageMemoryBarrier *mem_barrier,
-                                 uint32_t level, uint32_t layer, VkImageAspectFlags aspect) {
-    if (!(mem_barrier->subresourceRange.aspectMask & aspect)) {
-        return;
-    }
-    VkImageSubresource sub = {aspect, level, layer};
-    IMAGE_CMD_BUF_LAYOUT_NODE node;
-    if (!FindCmdBufLayout(device_data, pCB, mem_barrier->image, sub, node)) {
-        SetLayout(device_data, pCB, mem_barrier->image, sub,
-                  IMAGE_CMD_BUF_LAYOUT_NODE(mem_barrier->oldLayout, mem_barrier->newLayout));
-        return;
-    }
-    if (mem_barrier->oldLayout == VK_IMAGE_LAYOUT_UNDEFINED) {
-        // TODO: Set memory invalid
-    }
-    SetLayout(device_data, pCB, mem_barrier->image, sub, mem_barrier->newLayout);
-}
-
 bool VerifyAspectsPresent(VkImageAspectFlags aspect_mask, VkFormat format) {
     if ((aspect_mask & VK_IMAGE_ASPECT_COLOR_BIT) != 0) {
         if (!FormatIsColor(format)) return false;
@@ -477,7 +444,7 @@ bool ValidateBarrierLayoutToImageUsage(layer_data *device_data, const VkImageMem
     return skip;
 }
 
-// Verify image barriers are compatible with the images they reference.
+// Verify image barriers are compatible with the images they reference, and that their old layouts match what's been recorded
 bool ValidateBarriersToImages(layer_data *device_data, VkCommandBuffer cmdBuffer, uint32_t imageMemoryBarrierCount,
                               const VkImageMemoryBarrier *pImageMemoryBarriers, const char *func_name) {
     GLOBAL_CB_NODE *pCB = GetCBNode(device_data, cmdBuffer);
@@ -488,25 +455,25 @@ bool ValidateBarriersToImages(layer_data *device_data, VkCommandBuffer cmdBuffer
         if (!img_barrier) continue;
 
         auto image_state = GetImageState(device_data, img_barrier->image);
-        if (image_state) {
-            VkImageUsageFlags usage_flags = image_state->createInfo.usage;
-            skip |= ValidateBarrierLayoutToImageUsage(device_data, img_barrier, false, usage_flags, func_name);
-            skip |= ValidateBarrierLayoutToImageUsage(device_data, img_barrier, true, usage_flags, func_name);
-
-            // Make sure layout is able to be transitioned, currently only presented shared presentable images are locked
-            if (image_state->layout_locked) {
-                // TODO: Add unique id for error when available
-                skip |= log_msg(
-                    core_validation::GetReportData(device_data), VK_DEBUG_REPORT_ERROR_BIT_EXT,
-                    VK_DEBUG_REPORT_OBJECT_TYPE_UNKNOWN_EXT, 0, __LINE__, 0, "DS",
-                    "Attempting to transition shared presentable image 0x%" PRIxLEAST64
-                    " from layout %s to layout %s, but image has already been presented and cannot have its layout transitioned.",
-                    reinterpret_cast<const uint64_t &>(img_barrier->image), string_VkImageLayout(img_barrier->oldLayout),
-                    string_VkImageLayout(img_barrier->newLayout));
-            }
+        if (!image_state) continue;
+
+        VkImageUsageFlags usage_flags = image_state->createInfo.usage;
+        skip |= ValidateBarrierLayoutToImageUsage(device_data, img_barrier, false, usage_flags, func_name);
+        skip |= ValidateBarrierLayoutToImageUsage(device_data, img_barrier, true, usage_flags, func_name);
+
+        // Make sure layout is able to be transitioned, currently only presented shared presentable images are locked
+        if (image_state->layout_locked) {
+            // TODO: Add unique id for error when available
+            skip |= log_msg(
+                core_validation::GetReportData(device_data), VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_UNKNOWN_EXT,
+                0, __LINE__, 0, "DS",
+                "Attempting to transition shared presentable image 0x%" PRIxLEAST64
+                " from layout %s to layout %s, but image has already been presented and cannot have its layout transitioned.",
+                reinterpret_cast<const uint64_t &>(img_barrier->image), string_VkImageLayout(img_barrier->oldLayout),
+                string_VkImageLayout(img_barrier->newLayout));
         }
 
-        VkImageCreateInfo *image_create_info = &(GetImageState(device_data, img_barrier->image)->createInfo);
+        const VkImageCreateInfo *image_create_info = &image_state->createInfo;
         // For a Depth/Stencil image both aspects MUST be set
         if (FormatIsDepthAndStencil(image_create_info->format)) {
             auto const aspect_mask = img_barrier->subresourceRange.aspectMask;
@@ -523,23 +490,42 @@ bool ValidateBarriersToImages(layer_data *device_data, VkCommandBuffer cmdBuffer
                             aspect_mask, validation_error_map[VALIDATION_ERROR_0a00096e]);
             }
         }
+
+        // Any old layout can be transitioned from UNDEFINED, so there's nothing to look up
+        if (img_barrier->oldLayout == VK_IMAGE_LAYOUT_UNDEFINED) continue;
+
+        // TODO: Set memory invalid which is in mem_tracker currently
         uint32_t level_count = ResolveRemainingLevels(&img_barrier->subresourceRange, image_create_info->mipLevels);
         uint32_t layer_count = ResolveRemainingLayers(&img_barrier->subresourceRange, image_create_info->arrayLayers);
+        auto whole_image_node = FindWholeImageCmdBufLayout(pCB, img_barrier->image);
+        ImageSubresourcePair imgpair = {img_barrier->image, true, VkImageSubresource()};
 
         for (uint32_t j = 0; j < level_count; j++) {
-            uint32_t level = img_barrier->subresourceRange.baseMipLevel + j;
+            imgpair.subresource.mipLevel = img_barrier->subresourceRange.baseMipLevel + j;
             for (uint32_t k = 0; k < layer_count; k++) {
-                uint32_t layer = img_barrier->subresourceRange.baseArrayLayer + k;
-                skip |= ValidateImageAspectLayout(device_data, pCB, img_barrier, level, layer, VK_IMAGE_ASPECT_COLOR_BIT);
-                skip |= ValidateImageAspectLayout(device_data, pCB, img_barrier, level, layer, VK_IMAGE_ASPECT_DEPTH_BIT);
-                skip |= ValidateImageAspectLayout(device_data, pCB, img_barrier, level, layer, VK_IMAGE_ASPECT_STENCIL_BIT);
-                skip |= ValidateImageAspectLayout(device_data, pCB, img_barrier, level, layer, VK_IMAGE_ASPECT_METADATA_BIT);
+                imgpair.subresource.arrayLayer = img_barrier->subresourceRange.baseArrayLayer + k;
+                for (auto aspect : layout_aspects) {
+                    if (!(img_barrier->subresourceRange.aspectMask & aspect)) continue;
+                    imgpair.subresource.aspectMask = aspect;
+                    auto it = pCB->imageLayoutMap.find(imgpair);
+                    auto node = it != pCB->imageLayoutMap.end() ? &it->second : whole_image_node;
+                    if (node && node->layout != img_barrier->oldLayout) {
+                        skip |= log_msg(core_validation::GetReportData(device_data), VK_DEBUG_REPORT_ERROR_BIT_EXT,
+                                        VK_DEBUG_REPORT_OBJECT_TYPE_COMMAND_BUFFER_EXT, HandleToUint64(pCB->commandBuffer),
+                                        __LINE__, DRAWSTATE_INVALID_IMAGE_LAYOUT, "DS",
+                                        "For image 0x%" PRIxLEAST64
+                                        " you cannot transition the layout of aspect %d from %s when current layout is %s.",
+                                        HandleToUint64(img_barrier->image), aspect, string_VkImageLayout(img_barrier->oldLayout),
+                                        string_VkImageLayout(node->layout));
+                    }
+                }
             }
         }
     }
     return skip;
 }
 
+// Apply the barriers' layout transitions to the command buffer's layout map, with a single lookup per subresource aspect
 void TransitionImageLayouts(layer_data *device_data, VkCommandBuffer cmdBuffer, uint32_t memBarrierCount,
                             const VkImageMemoryBarrier *pImgMemBarriers) {
     GLOBAL_CB_NODE *pCB = GetCBNode(device_data, cmdBuffer);
@@ -548,18 +534,29 @@ void TransitionImageLayouts(layer_data *device_data, VkCommandBuffer cmdBuffer,
         auto mem_barrier = &pImgMemBarriers[i];
         if (!mem_barrier) continue;
 
-        VkImageCreateInfo *image_create_info = &(GetImageState(device_data, mem_barrier->image)->createInfo);
+        auto image_state = GetImageState(device_data, mem_barrier->image);
+        if (!image_state) continue;
+
+        VkImageCreateInfo *image_create_info = &image_state->createInfo;
         uint32_t level_count = ResolveRemainingLevels(&mem_barrier->subresourceRange, image_create_info->mipLevels);
         uint32_t layer_count = ResolveRemainingLayers(&mem_barrier->subresourceRange, image_create_info->arrayLayers);
+        // Subresources seen for the first time start from the layout recorded for the whole image, if there is one
+        auto whole_image_node = FindWholeImageCmdBufLayout(pCB, mem_barrier->image);
+        VkImageLayout initial_layout = whole_image_node ? whole_image_node->initialLayout : mem_barrier->oldLayout;
+        ImageSubresourcePair imgpair = {mem_barrier->image, true, VkImageSubresource()};
 
         for (uint32_t j = 0; j < level_count; j++) {
-            uint32_t level = mem_barrier->subresourceRange.baseMipLevel + j;
+            imgpair.subresource.mipLevel = mem_barrier->subresourceRange.baseMipLevel + j;
             for (uint32_t k = 0; k < layer_count; k++) {
-                uint32_t layer = mem_barrier->subresourceRange.baseArrayLayer + k;
-                TransitionImageAspectLayout(device_data, pCB, mem_barrier, level, layer, VK_IMAGE_ASPECT_COLOR_BIT);
-                TransitionImageAspectLayout(device_data, pCB, mem_barrier, level, layer, VK_IMAGE_ASPECT_DEPTH_BIT);
-                TransitionImageAspectLayout(device_data, pCB, mem_barrier, level, layer, VK_IMAGE_ASPECT_STENCIL_BIT);
-                TransitionImageAspectLayout(device_data, pCB, mem_barrier, level, layer, VK_IMAGE_ASPECT_METADATA_BIT);
+                imgpair.subresource.arrayLayer = mem_barrier->subresourceRange.baseArrayLayer + k;
+                for (auto aspect : layout_aspects) {
+                    if (!(mem_barrier->subresourceRange.aspectMask & aspect)) continue;
+                    imgpair.subresource.aspectMask = aspect;
+                    // TODO: Set memory invalid if oldLayout is UNDEFINED
+                    auto inserted =
+                        pCB->imageLayoutMap.emplace(imgpair, IMAGE_CMD_BUF_LAYOUT_NODE(initial_layout, mem_barrier->newLayout));
+                    if (!inserted.second) inserted.first->second.layout = mem_barrier->newLayout;
+                }
             }
         }
     }
@@ -67,6 +67,7 @@
 #include "vk_layer_data.h"
 #include "vk_layer_extension_utils.h"
 #include "vk_layer_utils.h"
+#include "vk_layer_state_stats.h"
 
 #if defined __ANDROID__
 #include <android/log.h>
@@ -130,6 +131,11 @@ struct instance_layer_data {
     CALL_STATE vkEnumeratePhysicalDeviceGroupsState = UNCALLED;
     uint32_t physical_device_groups_count = 0;
     CHECK_DISABLED disabled = {};
+    VALIDATION_SAMPLING sampling;
+    bool noncoherent_page_guard = false;  // lunarg_core_validation.noncoherent_memory_guard = pages
+    bool compact_shader_modules = false;  // lunarg_core_validation.shader_module_storage = compact
+    uint32_t deferred_shader_validation_threads = 0;  // lunarg_core_validation.deferred_shader_validation_threads
+    StateStatsSettings state_stats = {};  // lunarg_core_validation.state_stats_*
 
     unordered_map<VkPhysicalDevice, PHYSICAL_DEVICE_STATE> physical_device_map;
     unordered_map<VkSurfaceKHR, SURFACE_STATE> surface_map;
@@ -143,38 +149,44 @@ struct layer_data {
 
     DeviceExtensions extensions = {};
     unordered_set<VkQueue> queues;  // All queues under given device
-    // Layer specific data
-    unordered_map<VkSampler, unique_ptr<SAMPLER_STATE>> samplerMap;
-    unordered_map<VkImageView, unique_ptr<IMAGE_VIEW_STATE>> imageViewMap;
-    unordered_map<VkImage, unique_ptr<IMAGE_STATE>> imageMap;
-    unordered_map<VkBufferView, unique_ptr<BUFFER_VIEW_STATE>> bufferViewMap;
-    unordered_map<VkBuffer, unique_ptr<BUFFER_STATE>> bufferMap;
-    unordered_map<VkPipeline, PIPELINE_STATE *> pipelineMap;
+    // Layer specific data. Handle-keyed tables whose state lives behind a pointer use FlatHashMap; tables that hold state
+    // by value need std::unordered_map's pointer stability.
+    FlatHashMap<VkSampler, unique_ptr<SAMPLER_STATE>> samplerMap;
+    FlatHashMap<VkImageView, unique_ptr<IMAGE_VIEW_STATE>> imageViewMap;
+    FlatHashMap<VkImage, unique_ptr<IMAGE_STATE>> imageMap;
+    FlatHashMap<VkBufferView, unique_ptr<BUFFER_VIEW_STATE>> bufferViewMap;
+    FlatHashMap<VkBuffer, unique_ptr<BUFFER_STATE>> bufferMap;
+    FlatHashMap<VkPipeline, PIPELINE_STATE *> pipelineMap;
     unordered_map<VkCommandPool, COMMAND_POOL_NODE> commandPoolMap;
-    unordered_map<VkDescriptorPool, DESCRIPTOR_POOL_STATE *> descriptorPoolMap;
-    unordered_map<VkDescriptorSet, cvdescriptorset::DescriptorSet *> setMap;
-    unordered_map<VkDescriptorSetLayout, std::shared_ptr<cvdescriptorset::DescriptorSetLayout const>> descriptorSetLayoutMap;
-    unordered_map<VkPipelineLayout, PIPELINE_LAYOUT_NODE> pipelineLayoutMap;
-    unordered_map<VkDeviceMemory, unique_ptr<DEVICE_MEM_INFO>> memObjMap;
+    FlatHashMap<VkDescriptorPool, DESCRIPTOR_POOL_STATE *> descriptorPoolMap;
+    FlatHashMap<VkDescriptorSet, cvdescriptorset::DescriptorSet *> setMap;
+    FlatHashMap<VkDescriptorSetLayout, std::shared_ptr<cvdescriptorset::DescriptorSetLayout const>> descriptorSetLayoutMap;
+    FlatHashMap<VkPipelineLayout, std::shared_ptr<PIPELINE_LAYOUT_NODE const>> pipelineLayoutMap;
+    FlatHashMap<VkDeviceMemory, unique_ptr<DEVICE_MEM_INFO>> memObjMap;
     unordered_map<VkFence, FENCE_NODE> fenceMap;
     unordered_map<VkQueue, QUEUE_STATE> queueMap;
     unordered_map<VkEvent, EVENT_STATE> eventMap;
-    unordered_map<QueryObject, bool> queryToStateMap;
     unordered_map<VkQueryPool, QUERY_POOL_NODE> queryPoolMap;
     unordered_map<VkSemaphore, SEMAPHORE_NODE> semaphoreMap;
-    unordered_map<VkCommandBuffer, GLOBAL_CB_NODE *> commandBufferMap;
-    unordered_map<VkFramebuffer, unique_ptr<FRAMEBUFFER_STATE>> frameBufferMap;
+    FlatHashMap<VkCommandBuffer, GLOBAL_CB_NODE *> commandBufferMap;
+    FlatHashMap<VkFramebuffer, unique_ptr<FRAMEBUFFER_STATE>> frameBufferMap;
     unordered_map<VkImage, vector<ImageSubresourcePair>> imageSubresourceMap;
     unordered_map<ImageSubresourcePair, IMAGE_LAYOUT_NODE> imageLayoutMap;
-    unordered_map<VkRenderPass, unique_ptr<RENDER_PASS_STATE>> renderPassMap;
-    unordered_map<VkShaderModule, unique_ptr<shader_module>> shaderModuleMap;
-    unordered_map<VkDescriptorUpdateTemplateKHR, unique_ptr<TEMPLATE_STATE>> desc_template_map;
-    unordered_map<VkSwapchainKHR, std::unique_ptr<SWAPCHAIN_NODE>> swapchainMap;
+    FlatHashMap<VkRenderPass, std::shared_ptr<RENDER_PASS_STATE>> renderPassMap;
+    FlatHashMap<VkShaderModule, unique_ptr<shader_module>> shaderModuleMap;
+    FlatHashMap<VkDescriptorUpdateTemplateKHR, unique_ptr<TEMPLATE_STATE>> desc_template_map;
+    FlatHashMap<VkSwapchainKHR, std::unique_ptr<SWAPCHAIN_NODE>> swapchainMap;
 
     VkDevice device = VK_NULL_HANDLE;
     VkPhysicalDevice physical_device = VK_NULL_HANDLE;
 
     instance_layer_data *instance_data = nullptr;  // from device to enclosing instance
+    std::vector<QUEUE_STATE *> queue_worklist;     // Scratch list for walking semaphore waits between queues
+    std::vector<std::pair<QUEUE_STATE *, uint64_t>> queue_verify_undo;  // Scratch: verified_seq before each advance
+    uint64_t dependency_generation = 0;            // Last dependency_generation stamped on an image or image view
+    VALIDATION_SAMPLING_STATE sampling_state;
+    std::unique_ptr<PeriodicTask> state_stats_task;  // Logs the state stats every state_stats.log_interval seconds
+    std::unique_ptr<ShaderValidationPool> shader_validation_pool;  // Set for deferred_shader_validation_threads
 
     VkPhysicalDeviceFeatures enabled_features = {};
     // Device specific data
@@ -183,9 +195,8 @@ struct layer_data {
     VkPhysicalDeviceProperties phys_dev_props = {};
 };
 
-// TODO : Do we need to guard access to layer_data_map w/ lock?
-static unordered_map<void *, layer_data *> layer_data_map;
-static unordered_map<void *, instance_layer_data *> instance_layer_data_map;
+static LayerDataMap<layer_data> layer_data_map;
+static LayerDataMap<instance_layer_data> instance_layer_data_map;
 
 static uint32_t loader_layer_if_version = CURRENT_LOADER_LAYER_INTERFACE_VERSION;
 
@@ -705,6 +716,15 @@ RENDER_PASS_STATE *GetRenderPassState(layer_data const *dev_data, VkRenderPass r
     return it->second.get();
 }
 
+// Return a shared reference to the render pass state for a pipeline or framebuffer to hold, or null if it is unknown
+static std::shared_ptr<RENDER_PASS_STATE const> GetRenderPassReference(layer_data const *dev_data, VkRenderPass renderpass) {
+    auto it = dev_data->renderPassMap.find(renderpass);
+    if (it == dev_data->renderPassMap.end()) {
+        return nullptr;
+    }
+    return it->second;
+}
+
 FRAMEBUFFER_STATE *GetFramebufferState(const layer_data *dev_data, VkFramebuffer framebuffer) {
     auto it = dev_data->frameBufferMap.find(framebuffer);
     if (it == dev_data->frameBufferMap.end()) {
@@ -727,7 +747,18 @@ static PIPELINE_LAYOUT_NODE const *getPipelineLayout(layer_data const *dev_data,
     if (it == dev_data->pipelineLayoutMap.end()) {
         return nullptr;
     }
-    return &it->second;
+    return it->second.get();
+}
+
+// Return a shared reference to the layout state for a pipeline to hold. An unknown layout gets an empty node so that
+// pipeline_layout is never null.
+static std::shared_ptr<PIPELINE_LAYOUT_NODE const> GetPipelineLayoutReference(layer_data const *dev_data,
+                                                                              VkPipelineLayout pipeLayout) {
+    auto it = dev_data->pipelineLayoutMap.find(pipeLayout);
+    if (it == dev_data->pipelineLayoutMap.end()) {
+        return std::make_shared<PIPELINE_LAYOUT_NODE const>();
+    }
+    return it->second;
 }
 
 shader_module const *GetShaderModuleState(layer_data const *dev_data, VkShaderModule module) {
@@ -888,6 +919,18 @@ static bool verify_renderpass_compatibility(const layer_data *dev_data, const Vk
     return true;
 }
 
+// verify_renderpass_compatibility() for two render pass states, remembering the pairs found compatible
+static bool verifyRenderPassStateCompatibility(const layer_data *dev_data, RENDER_PASS_STATE const *primary_rp,
+                                               RENDER_PASS_STATE const *secondary_rp, string &errorMsg) {
+    if (primary_rp == secondary_rp || primary_rp->compatible_render_passes.count(secondary_rp)) return true;
+    if (!verify_renderpass_compatibility(dev_data, primary_rp->createInfo.ptr(), secondary_rp->createInfo.ptr(), errorMsg)) {
+        return false;
+    }
+    primary_rp->compatible_render_passes.insert(secondary_rp);
+    secondary_rp->compatible_render_passes.insert(primary_rp);
+    return true;
+}
+
 // Return Set node ptr for specified set or else NULL
 cvdescriptorset::DescriptorSet *GetSetNode(const layer_data *dev_data, VkDescriptorSet set) {
     auto set_it = dev_data->setMap.find(set);
@@ -1026,8 +1069,7 @@ static bool ValidatePipelineDrawtimeState(layer_data const *dev_data, LAST_BOUND
     if (pCB->activeRenderPass) {
         std::string err_string;
         if ((pCB->activeRenderPass->renderPass != pPipeline->graphicsPipelineCI.renderPass) &&
-            !verify_renderpass_compatibility(dev_data, pCB->activeRenderPass->createInfo.ptr(), pPipeline->render_pass_ci.ptr(),
-                                             err_string)) {
+            !verifyRenderPassStateCompatibility(dev_data, pCB->activeRenderPass, pPipeline->rp_state.get(), err_string)) {
             // renderPass that PSO was created with must be compatible with active renderPass that PSO is being used with
             skip |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_PIPELINE_EXT,
                             HandleToUint64(pPipeline->pipeline), __LINE__, DRAWSTATE_RENDERPASS_INCOMPATIBLE, "DS",
@@ -1068,10 +1110,11 @@ static bool verify_set_layout_compatibility(const cvdescriptorset::DescriptorSet
     return descriptor_set->IsCompatible(layout_node.get(), &errorMsg);
 }
 
-// Validate overall state at the time of a draw call
+// Validate overall state at the time of a draw call. When full_validation is false only the checks that the state
+// update in UpdateDrawState depends on (a bound pipeline and bound descriptor sets) are performed.
 static bool ValidateDrawState(layer_data *dev_data, GLOBAL_CB_NODE *cb_node, const bool indexed,
                               const VkPipelineBindPoint bind_point, const char *function,
-                              UNIQUE_VALIDATION_ERROR_CODE const msg_code) {
+                              UNIQUE_VALIDATION_ERROR_CODE const msg_code, const bool full_validation) {
     bool result = false;
     auto const &state = cb_node->lastBound[bind_point];
     PIPELINE_STATE *pPipe = state.pipeline_state;
@@ -1084,13 +1127,13 @@ static bool ValidateDrawState(layer_data *dev_data, GLOBAL_CB_NODE *cb_node, con
         if (result) return true;
     }
     // First check flag states
-    if (VK_PIPELINE_BIND_POINT_GRAPHICS == bind_point)
+    if (full_validation && (VK_PIPELINE_BIND_POINT_GRAPHICS == bind_point))
         result = validate_draw_state_flags(dev_data, cb_node, pPipe, indexed, msg_code);
 
     // Now complete other state checks
     if (VK_NULL_HANDLE != state.pipeline_layout.layout) {
         string errorString;
-        auto pipeline_layout = pPipe->pipeline_layout;
+        auto pipeline_layout = pPipe->pipeline_layout.get();
 
         for (const auto &set_binding_pair : pPipe->active_slots) {
             uint32_t setIndex = set_binding_pair.first;
@@ -1101,7 +1144,9 @@ static bool ValidateDrawState(layer_data *dev_data, GLOBAL_CB_NODE *cb_node, con
                             HandleToUint64(cb_node->commandBuffer), __LINE__, DRAWSTATE_DESCRIPTOR_SET_NOT_BOUND, "DS",
                             "VkPipeline 0x%" PRIxLEAST64 " uses set #%u but that set is not bound.",
                             HandleToUint64(pPipe->pipeline), setIndex);
-            } else if (!verify_set_layout_compatibility(state.boundDescriptorSets[setIndex], &pipeline_layout, setIndex,
+            } else if (!full_validation) {
+                continue;
+            } else if (!verify_set_layout_compatibility(state.boundDescriptorSets[setIndex], pipeline_layout, setIndex,
                                                         errorString)) {
                 // Set is bound but not compatible w/ overlapping pipeline_layout from PSO
                 VkDescriptorSet setHandle = state.boundDescriptorSets[setIndex]->GetSet();
@@ -1110,7 +1155,7 @@ static bool ValidateDrawState(layer_data *dev_data, GLOBAL_CB_NODE *cb_node, con
                             HandleToUint64(setHandle), __LINE__, DRAWSTATE_PIPELINE_LAYOUTS_INCOMPATIBLE, "DS",
                             "VkDescriptorSet (0x%" PRIxLEAST64
                             ") bound as set #%u is not compatible with overlapping VkPipelineLayout 0x%" PRIxLEAST64 " due to: %s",
-                            HandleToUint64(setHandle), setIndex, HandleToUint64(pipeline_layout.layout), errorString.c_str());
+                            HandleToUint64(setHandle), setIndex, HandleToUint64(pipeline_layout->layout), errorString.c_str());
             } else {  // Valid set is bound and layout compatible, validate that it's updated
                 // Pull the set node
                 cvdescriptorset::DescriptorSet *descriptor_set = state.boundDescriptorSets[setIndex];
@@ -1130,7 +1175,8 @@ static bool ValidateDrawState(layer_data *dev_data, GLOBAL_CB_NODE *cb_node, con
     }
 
     // Check general pipeline state that needs to be validated at drawtime
-    if (VK_PIPELINE_BIND_POINT_GRAPHICS == bind_point) result |= ValidatePipelineDrawtimeState(dev_data, state, cb_node, pPipe);
+    if (full_validation && (VK_PIPELINE_BIND_POINT_GRAPHICS == bind_point))
+        result |= ValidatePipelineDrawtimeState(dev_data, state, cb_node, pPipe);
 
     return result;
 }
@@ -1231,13 +1277,13 @@ static bool ValidatePipelineUnlocked(layer_data *dev_data, std::vector<PIPELINE_
     // Ensure the subpass index is valid. If not, then validate_and_capture_pipeline_shader_state
     // produces nonsense errors that confuse users. Other layers should already
     // emit errors for renderpass being invalid.
-    auto subpass_desc = &pPipeline->render_pass_ci.pSubpasses[pPipeline->graphicsPipelineCI.subpass];
-    if (pPipeline->graphicsPipelineCI.subpass >= pPipeline->render_pass_ci.subpassCount) {
+    auto subpass_desc = &pPipeline->rp_state->createInfo.pSubpasses[pPipeline->graphicsPipelineCI.subpass];
+    if (pPipeline->graphicsPipelineCI.subpass >= pPipeline->rp_state->createInfo.subpassCount) {
         skip |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_PIPELINE_EXT,
                         HandleToUint64(pPipeline->pipeline), __LINE__, VALIDATION_ERROR_096005ee, "DS",
                         "Invalid Pipeline CreateInfo State: Subpass index %u "
                             "is out of range for this renderpass (0..%u). %s",
-                        pPipeline->graphicsPipelineCI.subpass, pPipeline->render_pass_ci.subpassCount - 1,
+                        pPipeline->graphicsPipelineCI.subpass, pPipeline->rp_state->createInfo.subpassCount - 1,
                         validation_error_map[VALIDATION_ERROR_096005ee]);
         subpass_desc = nullptr;
     }
@@ -1709,6 +1755,7 @@ static void resetCB(layer_data *dev_data, const VkCommandBuffer cb) {
         memset(&pCB->beginInfo, 0, sizeof(VkCommandBufferBeginInfo));
         memset(&pCB->inheritanceInfo, 0, sizeof(VkCommandBufferInheritanceInfo));
         pCB->hasDrawCmd = false;
+        pCB->validation_sampled = true;
         pCB->state = CB_NEW;
         pCB->submitCount = 0;
         pCB->status = 0;
@@ -1841,8 +1888,77 @@ bool outsideRenderPass(const layer_data *dev_data, GLOBAL_CB_NODE *pCB, const ch
     return outside;
 }
 
+// Read the lunarg_core_validation.sampling_* settings. Unset or out-of-range values leave full validation in place.
+static void InitValidationSampling(VALIDATION_SAMPLING *sampling) {
+    const char *cb_interval = getLayerOption("lunarg_core_validation.sampling_command_buffer_interval");
+    if (*cb_interval) sampling->command_buffer_interval = std::max(1u, static_cast<uint32_t>(strtoul(cb_interval, nullptr, 10)));
+
+    const char *frame_interval = getLayerOption("lunarg_core_validation.sampling_frame_interval");
+    if (*frame_interval) sampling->frame_interval = std::max(1u, static_cast<uint32_t>(strtoul(frame_interval, nullptr, 10)));
+
+    const char *draw_fraction = getLayerOption("lunarg_core_validation.sampling_draw_fraction");
+    if (*draw_fraction) {
+        double fraction = strtod(draw_fraction, nullptr);
+        if (fraction >= 0.0 && fraction < 1.0) sampling->draw_threshold = static_cast<uint64_t>(fraction * 4294967296.0);
+    }
+
+    sampling->enabled =
+        (sampling->command_buffer_interval > 1) || (sampling->frame_interval > 1) || (sampling->draw_threshold < (1ull << 32));
+}
+
 static void init_core_validation(instance_layer_data *instance_data, const VkAllocationCallbacks *pAllocator) {
     layer_debug_actions(instance_data->report_data, instance_data->logging_callback, pAllocator, "lunarg_core_validation");
+    InitValidationSampling(&instance_data->sampling);
+    instance_data->noncoherent_page_guard = !strcmp(getLayerOption("lunarg_core_validation.noncoherent_memory_guard"), "pages");
+    instance_data->compact_shader_modules = !strcmp(getLayerOption("lunarg_core_validation.shader_module_storage"), "compact");
+    instance_data->deferred_shader_validation_threads =
+        static_cast<uint32_t>(strtoul(getLayerOption("lunarg_core_validation.deferred_shader_validation_threads"), nullptr, 10));
+    instance_data->state_stats = GetStateStatsSettings("lunarg_core_validation");
+}
+
+// Decide whether a command buffer recording that is just beginning falls in the validation sample
+static bool SampleCommandBufferValidation(layer_data *dev_data) {
+    auto const &sampling = dev_data->instance_data->sampling;
+    if (!sampling.enabled) return true;
+    return (dev_data->sampling_state.command_buffer_count++ % sampling.command_buffer_interval) == 0;
+}
+
+// Decide whether a draw or dispatch recorded into cb_node gets the full set of draw-time checks
+static bool SampleDrawValidation(layer_data *dev_data, const GLOBAL_CB_NODE *cb_node) {
+    auto const &sampling = dev_data->instance_data->sampling;
+    if (!sampling.enabled) return true;
+    if (!cb_node->validation_sampled || !dev_data->sampling_state.frame_sampled) return false;
+    if (sampling.draw_threshold >= (1ull << 32)) return true;
+    // xorshift32, good enough to spread the sample and cheap enough to run on every draw
+    uint32_t &x = dev_data->sampling_state.draw_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x < sampling.draw_threshold;
+}
+
+// Decide whether a vkQueueSubmit() call gets the full set of submit-time checks. The decision covers the whole call so that
+// image layout transitions are tracked consistently across all of its command buffers.
+static bool SampleSubmitValidation(layer_data *dev_data, uint32_t submitCount, const VkSubmitInfo *pSubmits) {
+    auto const &sampling = dev_data->instance_data->sampling;
+    if (!sampling.enabled) return true;
+    if (!dev_data->sampling_state.frame_sampled) return false;
+    for (uint32_t submit_idx = 0; submit_idx < submitCount; submit_idx++) {
+        for (uint32_t i = 0; i < pSubmits[submit_idx].commandBufferCount; i++) {
+            auto cb_node = GetCBNode(dev_data, pSubmits[submit_idx].pCommandBuffers[i]);
+            if (cb_node && cb_node->validation_sampled) return true;
+        }
+    }
+    return false;
+}
+
+// Advance the frame counter used for sampling at the end of a vkQueuePresentKHR() call
+static void AdvanceSampledFrame(layer_data *dev_data) {
+    auto const &sampling = dev_data->instance_data->sampling;
+    if (!sampling.enabled) return;
+    auto &sampling_state = dev_data->sampling_state;
+    sampling_state.frame_count++;
+    sampling_state.frame_sampled = (sampling_state.frame_count % sampling.frame_interval) == 0;
 }
 
 // For the given ValidationCheck enum, set all relevant instance disabled flags to true
@@ -2028,6 +2144,154 @@ static bool ValidateRequestedFeatures(instance_layer_data *instance_data, const
     return skip;
 }
 
+// Approximate host memory held by a command buffer's recorded state
+static size_t CommandBufferStateBytes(GLOBAL_CB_NODE const *cb_node) {
+    size_t bytes = sizeof(*cb_node) + ContainerBytes(cb_node->cb_bindings) + ContainerBytes(cb_node->framebuffers) +
+                   ContainerBytes(cb_node->object_bindings) + ContainerBytes(cb_node->broken_bindings) +
+                   ContainerBytes(cb_node->waitedEvents) + ContainerBytes(cb_node->writeEventsBeforeWait) +
+                   ContainerBytes(cb_node->events) + ContainerBytes(cb_node->waitedEventsBeforeQueryReset) +
+                   cb_node->queryToStateMap.HeapBytes() + ContainerBytes(cb_node->activeQueries) +
+                   ContainerBytes(cb_node->startedQueries) + ContainerBytes(cb_node->imageLayoutMap) +
+                   ContainerBytes(cb_node->eventToStageMap) + ContainerBytes(cb_node->drawData) +
+                   ContainerBytes(cb_node->currentDrawData.buffers) + ContainerBytes(cb_node->updateImages) +
+                   ContainerBytes(cb_node->updateBuffers) + ContainerBytes(cb_node->linkedCommandBuffers) +
+                   ContainerBytes(cb_node->validate_functions) + ContainerBytes(cb_node->memObjs) +
+                   ContainerBytes(cb_node->eventUpdates) + ContainerBytes(cb_node->queryUpdates);
+    for (auto const &last_bound : cb_node->lastBound) {
+        bytes += ContainerBytes(last_bound.boundDescriptorSets) + ContainerBytes(last_bound.dynamicOffsets);
+        for (auto const &offsets : last_bound.dynamicOffsets) bytes += ContainerBytes(offsets);
+    }
+    for (auto const &reset : cb_node->waitedEventsBeforeQueryReset) bytes += ContainerBytes(reset.events);
+    for (auto const &draw : cb_node->drawData) bytes += ContainerBytes(draw.buffers);
+    return bytes;
+}
+
+// Adds a category for one of the state tables: the table itself plus entry_bytes() of each of its values
+template <typename Map, typename EntryBytes>
+static void AddTableStats(StateStats *stats, const char *category, Map const &map, EntryBytes entry_bytes) {
+    uint64_t bytes = ContainerBytes(map);
+    for (auto const &entry : map) bytes += entry_bytes(entry.second);
+    stats->Add(category, map.size(), bytes);
+}
+
+// Tally the state tracked for a device. Create info copies and other data owned through raw pointers aren't counted, so
+// the byte counts are lower bounds. Must be called with global_lock held.
+static StateStats GatherStateStats(layer_data const *dev_data) {
+    StateStats stats(global_layer.layerName);
+    AddTableStats(&stats, "command buffers", dev_data->commandBufferMap,
+                  [](GLOBAL_CB_NODE const *cb_node) { return CommandBufferStateBytes(cb_node); });
+    AddTableStats(&stats, "command pools", dev_data->commandPoolMap, [](COMMAND_POOL_NODE const &pool) {
+        return ContainerBytes(pool.cb_bindings) + ContainerBytes(pool.commandBuffers);
+    });
+    AddTableStats(&stats, "descriptor pools", dev_data->descriptorPoolMap, [](DESCRIPTOR_POOL_STATE const *pool) {
+        return sizeof(*pool) + ContainerBytes(pool->cb_bindings) + ContainerBytes(pool->sets) +
+               ContainerBytes(pool->maxDescriptorTypeCount) + ContainerBytes(pool->availableDescriptorTypeCount);
+    });
+    AddTableStats(&stats, "descriptor sets", dev_data->setMap,
+                  [](cvdescriptorset::DescriptorSet const *set) { return set->GetStateBytes(); });
+    AddTableStats(&stats, "descriptor set layouts", dev_data->descriptorSetLayoutMap,
+                  [](std::shared_ptr<cvdescriptorset::DescriptorSetLayout const> const &layout) {
+                      return layout->GetStateBytes();
+                  });
+    AddTableStats(&stats, "descriptor update templates", dev_data->desc_template_map, [](unique_ptr<TEMPLATE_STATE> const &state) {
+        return sizeof(*state) + ContainerBytes(state->decoded_writes) + ContainerBytes(state->decoded_offsets);
+    });
+    AddTableStats(&stats, "shader modules", dev_data->shaderModuleMap, [](unique_ptr<shader_module> const &module) {
+        if (module->deferred && module->deferred->done.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return sizeof(*module) + sizeof(*module->deferred);  // Still on the pool
+        }
+        size_t bytes = sizeof(*module) + ContainerBytes(module->words) + ContainerBytes(module->def_index) +
+                       ContainerBytes(module->function_refs);
+        for (auto const &refs : module->function_refs) bytes += ContainerBytes(refs.second);
+        return bytes;
+    });
+    AddTableStats(&stats, "pipelines", dev_data->pipelineMap, [](PIPELINE_STATE const *pipeline) {
+        size_t bytes = sizeof(*pipeline) + ContainerBytes(pipeline->cb_bindings) + ContainerBytes(pipeline->active_slots) +
+                       ContainerBytes(pipeline->vertexBindingDescriptions) + ContainerBytes(pipeline->attachments);
+        for (auto const &slot : pipeline->active_slots) bytes += ContainerBytes(slot.second);
+        return bytes;
+    });
+    AddTableStats(&stats, "pipeline layouts", dev_data->pipelineLayoutMap,
+                  [](std::shared_ptr<PIPELINE_LAYOUT_NODE const> const &layout) {
+                      return sizeof(*layout) + ContainerBytes(layout->set_layouts) + ContainerBytes(layout->push_constant_ranges);
+                  });
+    AddTableStats(&stats, "render passes", dev_data->renderPassMap, [](std::shared_ptr<RENDER_PASS_STATE> const &render_pass) {
+        size_t bytes = sizeof(*render_pass) + ContainerBytes(render_pass->cb_bindings) +
+                       ContainerBytes(render_pass->hasSelfDependency) + ContainerBytes(render_pass->subpassToNode) +
+                       ContainerBytes(render_pass->attachment_first_read) +
+                       ContainerBytes(render_pass->compatible_render_passes);
+        for (auto const &node : render_pass->subpassToNode) bytes += ContainerBytes(node.prev) + ContainerBytes(node.next);
+        return bytes;
+    });
+    AddTableStats(&stats, "framebuffers", dev_data->frameBufferMap, [](unique_ptr<FRAMEBUFFER_STATE> const &framebuffer) {
+        size_t bytes = sizeof(*framebuffer) + ContainerBytes(framebuffer->cb_bindings) +
+                       ContainerBytes(framebuffer->attachments) + ContainerBytes(framebuffer->dependency_analyses);
+        for (auto const &analysis : framebuffer->dependency_analyses) {
+            bytes += ContainerBytes(analysis.attachment_generations) + ContainerBytes(analysis.errors);
+        }
+        return bytes;
+    });
+    AddTableStats(&stats, "images", dev_data->imageMap, [](unique_ptr<IMAGE_STATE> const &image) {
+        return sizeof(*image) + ContainerBytes(image->cb_bindings) + ContainerBytes(image->sparse_bindings);
+    });
+    AddTableStats(&stats, "image subresources", dev_data->imageSubresourceMap,
+                  [](vector<ImageSubresourcePair> const &subresources) { return ContainerBytes(subresources); });
+    AddTableStats(&stats, "image layouts", dev_data->imageLayoutMap, [](IMAGE_LAYOUT_NODE const &) { return 0; });
+    AddTableStats(&stats, "image views", dev_data->imageViewMap, [](unique_ptr<IMAGE_VIEW_STATE> const &view) {
+        return sizeof(*view) + ContainerBytes(view->cb_bindings);
+    });
+    AddTableStats(&stats, "buffers", dev_data->bufferMap, [](unique_ptr<BUFFER_STATE> const &buffer) {
+        return sizeof(*buffer) + ContainerBytes(buffer->cb_bindings) + ContainerBytes(buffer->sparse_bindings);
+    });
+    AddTableStats(&stats, "buffer views", dev_data->bufferViewMap, [](unique_ptr<BUFFER_VIEW_STATE> const &view) {
+        return sizeof(*view) + ContainerBytes(view->cb_bindings);
+    });
+    AddTableStats(&stats, "samplers", dev_data->samplerMap, [](unique_ptr<SAMPLER_STATE> const &sampler) {
+        return sizeof(*sampler) + ContainerBytes(sampler->cb_bindings);
+    });
+    // Includes the shadow copies and guarded mappings of memory that's mapped
+    AddTableStats(&stats, "device memory", dev_data->memObjMap, [](unique_ptr<DEVICE_MEM_INFO> const &mem_info) {
+        size_t bytes = sizeof(*mem_info) + ContainerBytes(mem_info->cb_bindings) + ContainerBytes(mem_info->obj_bindings) +
+                       ContainerBytes(mem_info->bound_ranges) + ContainerBytes(mem_info->bound_images) +
+                       ContainerBytes(mem_info->bound_buffers);
+        for (auto const &range : mem_info->bound_ranges) bytes += ContainerBytes(range.second.aliases);
+        if (mem_info->shadow_copy_base) {
+            VkDeviceSize size = mem_info->mem_range.size == VK_WHOLE_SIZE
+                                    ? mem_info->alloc_info.allocationSize - mem_info->mem_range.offset
+                                    : mem_info->mem_range.size;
+            bytes += static_cast<size_t>(2 * mem_info->shadow_pad_size + size);
+        }
+        if (mem_info->guarded_mapping) bytes += mem_info->guarded_mapping->MappedBytes();
+        return bytes;
+    });
+    AddTableStats(&stats, "fences", dev_data->fenceMap, [](FENCE_NODE const &) { return 0; });
+    AddTableStats(&stats, "semaphores", dev_data->semaphoreMap,
+                  [](SEMAPHORE_NODE const &semaphore) { return ContainerBytes(semaphore.cb_bindings); });
+    AddTableStats(&stats, "events", dev_data->eventMap,
+                  [](EVENT_STATE const &event) { return ContainerBytes(event.cb_bindings); });
+    AddTableStats(&stats, "query pools", dev_data->queryPoolMap, [](QUERY_POOL_NODE const &query_pool) {
+        return ContainerBytes(query_pool.cb_bindings) + query_pool.query_state.HeapBytes();
+    });
+    AddTableStats(&stats, "queues", dev_data->queueMap, [](QUEUE_STATE const &queue) {
+        size_t bytes =
+            ContainerBytes(queue.eventToStageMap) + queue.queryToStateMap.HeapBytes() + ContainerBytes(queue.submissions);
+        for (auto const &submission : queue.submissions) {
+            bytes += ContainerBytes(submission.cbs) + ContainerBytes(submission.waitSemaphores) +
+                     ContainerBytes(submission.signalSemaphores);
+        }
+        return bytes;
+    });
+    AddTableStats(&stats, "swapchains", dev_data->swapchainMap, [](unique_ptr<SWAPCHAIN_NODE> const &swapchain) {
+        return sizeof(*swapchain) + ContainerBytes(swapchain->images);
+    });
+    return stats;
+}
+
+static void LogStateStats(layer_data const *dev_data) {
+    lock_guard_t lock(global_lock);
+    GatherStateStats(dev_data).Log(dev_data->report_data, dev_data->device);
+}
+
 VKAPI_ATTR VkResult VKAPI_CALL CreateDevice(VkPhysicalDevice gpu, const VkDeviceCreateInfo *pCreateInfo,
                                             const VkAllocationCallbacks *pAllocator, VkDevice *pDevice) {
     bool skip = false;
@@ -2102,6 +2366,13 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateDevice(VkPhysicalDevice gpu, const VkDevice
     // Store physical device properties and physical device mem limits into device layer_data structs
     instance_data->dispatch_table.GetPhysicalDeviceMemoryProperties(gpu, &device_data->phys_dev_mem_props);
     instance_data->dispatch_table.GetPhysicalDeviceProperties(gpu, &device_data->phys_dev_props);
+    if (instance_data->state_stats.log_interval) {
+        device_data->state_stats_task.reset(
+            new PeriodicTask(instance_data->state_stats.log_interval, [device_data]() { LogStateStats(device_data); }));
+    }
+    if (instance_data->deferred_shader_validation_threads && !instance_data->disabled.shader_validation) {
+        device_data->shader_validation_pool.reset(new ShaderValidationPool(instance_data->deferred_shader_validation_threads));
+    }
     lock.unlock();
 
     ValidateLayerOrdering(*pCreateInfo);
@@ -2114,8 +2385,16 @@ VKAPI_ATTR void VKAPI_CALL DestroyDevice(VkDevice device, const VkAllocationCall
     // TODOSC : Shouldn't need any customization here
     dispatch_key key = get_dispatch_key(device);
     layer_data *dev_data = GetLayerDataPtr(key, layer_data_map);
+    dev_data->state_stats_task.reset();
+    if (dev_data->instance_data->state_stats.log_on_destroy) LogStateStats(dev_data);
+    // Let the pool finish with the shader modules before they go
+    dev_data->shader_validation_pool.reset();
     // Free all the memory
     unique_lock_t lock(global_lock);
+    // Deferred modules that were never used by a pipeline or destroyed still have their SPIR-V errors reported
+    for (auto &entry : dev_data->shaderModuleMap) {
+        WaitForShaderModule(dev_data, entry.first, entry.second.get());
+    }
     deletePipelines(dev_data);
     dev_data->renderPassMap.clear();
     for (auto ii = dev_data->commandBufferMap.begin(); ii != dev_data->commandBufferMap.end(); ++ii) {
@@ -2210,38 +2489,41 @@ static void incrementResources(layer_data *dev_data, GLOBAL_CB_NODE *cb_node) {
 // For the given queue, verify the queue state up to the given seq number.
 // Currently the only check is to make sure that if there are events to be waited on prior to
 //  a QueryReset, make sure that all such events have been signalled.
+// Each submission is only verified once; verified_seq records how far each queue has been checked, so repeated fence
+//  polling only walks submissions that are new since the last call. If an error was found, no queue's verified_seq
+//  moves, so that a retried wait reports the same errors again.
 static bool VerifyQueueStateToSeq(layer_data *dev_data, QUEUE_STATE *initial_queue, uint64_t initial_seq) {
     bool skip = false;
+    bool error_found = false;
 
-    // sequence number we want to validate up to, per queue
-    std::unordered_map<QUEUE_STATE *, uint64_t> target_seqs { { initial_queue, initial_seq } };
-    // sequence number we've completed validation for, per queue
-    std::unordered_map<QUEUE_STATE *, uint64_t> done_seqs;
-    std::vector<QUEUE_STATE *> worklist { initial_queue };
+    auto &worklist = dev_data->queue_worklist;
+    auto &undo = dev_data->queue_verify_undo;
+    if (std::max(initial_queue->verified_seq, initial_queue->seq) >= initial_seq) return skip;
+    initial_queue->verify_target = initial_seq;
+    worklist.push_back(initial_queue);
 
     while (worklist.size()) {
         auto queue = worklist.back();
         worklist.pop_back();
 
-        auto target_seq = target_seqs[queue];
-        auto seq = std::max(done_seqs[queue], queue->seq);
+        auto target_seq = queue->verify_target;
+        auto seq = std::max(queue->verified_seq, queue->seq);
+        if (seq >= target_seq) continue;  // Queue was pushed more than once and is already done
         auto sub_it = queue->submissions.begin() + int(seq - queue->seq);  // seq >= queue->seq
 
         for (; seq < target_seq; ++sub_it, ++seq) {
             for (auto &wait : sub_it->waitSemaphores) {
-                auto other_queue = GetQueueState(dev_data, wait.queue);
+                auto other_queue = wait.queue_state;
 
                 if (other_queue == queue)
                     continue;   // semaphores /always/ point backwards, so no point here.
 
-                auto other_target_seq = std::max(target_seqs[other_queue], wait.seq);
-                auto other_done_seq = std::max(done_seqs[other_queue], other_queue->seq);
-
                 // if this wait is for another queue, and covers new sequence
                 // numbers beyond what we've already validated, mark the new
                 // target seq and (possibly-re)add the queue to the worklist.
-                if (other_done_seq < other_target_seq) {
-                    target_seqs[other_queue] = other_target_seq;
+                auto other_done_seq = std::max(other_queue->verified_seq, other_queue->seq);
+                if (other_done_seq < wait.seq && other_queue->verify_target < wait.seq) {
+                    other_queue->verify_target = wait.seq;
                     worklist.push_back(other_queue);
                 }
             }
@@ -2249,15 +2531,16 @@ static bool VerifyQueueStateToSeq(layer_data *dev_data, QUEUE_STATE *initial_que
             for (auto cb : sub_it->cbs) {
                 auto cb_node = GetCBNode(dev_data, cb);
                 if (cb_node) {
-                    for (auto queryEventsPair : cb_node->waitedEventsBeforeQueryReset) {
-                        for (auto event : queryEventsPair.second) {
-                            if (dev_data->eventMap[event].needsSignaled) {
+                    for (auto const &reset : cb_node->waitedEventsBeforeQueryReset) {
+                        for (auto event : reset.events) {
+                            if (!dev_data->eventMap[event].needsSignaled) continue;
+                            error_found = true;
+                            for (uint32_t index = reset.first; index < reset.first + reset.count; ++index) {
                                 skip |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT,
                                                 VK_DEBUG_REPORT_OBJECT_TYPE_QUERY_POOL_EXT, 0, 0, DRAWSTATE_INVALID_QUERY, "DS",
                                                 "Cannot get query results on queryPool 0x%" PRIx64
                                                 " with index %d which was guarded by unsignaled event 0x%" PRIx64 ".",
-                                                HandleToUint64(queryEventsPair.first.pool), queryEventsPair.first.index,
-                                                HandleToUint64(event));
+                                                HandleToUint64(reset.pool), index, HandleToUint64(event));
                             }
                         }
                     }
@@ -2266,8 +2549,18 @@ static bool VerifyQueueStateToSeq(layer_data *dev_data, QUEUE_STATE *initial_que
         }
 
         // finally mark the point we've now validated this queue to.
-        done_seqs[queue] = seq;
+        undo.emplace_back(queue, queue->verified_seq);
+        queue->verified_seq = seq;
+    }
+
+    if (error_found) {
+        // Restore in reverse so that each queue ends up at the value it had before this call
+        for (auto it = undo.rbegin(); it != undo.rend(); ++it) {
+            it->first->verified_seq = it->second;
+            it->first->verify_target = it->second;
+        }
     }
+    undo.clear();
 
     return skip;
 }
@@ -2292,72 +2585,82 @@ static void DecrementBoundResources(layer_data *dev_data, GLOBAL_CB_NODE const *
     }
 }
 
+// Retire all work on pQueue up to seq, along with any work on other queues that it waited on through semaphores. Only
+// submissions that are actually retired are visited, so polling a fence that has already retired costs nothing.
 static void RetireWorkOnQueue(layer_data *dev_data, QUEUE_STATE *pQueue, uint64_t seq) {
-    std::unordered_map<VkQueue, uint64_t> otherQueueSeqs;
+    auto &worklist = dev_data->queue_worklist;
+    if (pQueue->seq >= seq) return;
+    pQueue->retire_target = seq;
+    worklist.push_back(pQueue);
 
-    // Roll this queue forward, one submission at a time.
-    while (pQueue->seq < seq) {
-        auto &submission = pQueue->submissions.front();
+    while (worklist.size()) {
+        auto queue = worklist.back();
+        worklist.pop_back();
 
-        for (auto &wait : submission.waitSemaphores) {
-            auto pSemaphore = GetSemaphoreNode(dev_data, wait.semaphore);
-            if (pSemaphore) {
-                pSemaphore->in_use.fetch_sub(1);
-            }
-            auto &lastSeq = otherQueueSeqs[wait.queue];
-            lastSeq = std::max(lastSeq, wait.seq);
-        }
+        // Roll this queue forward, one submission at a time.
+        while (queue->seq < queue->retire_target) {
+            auto &submission = queue->submissions.front();
 
-        for (auto &semaphore : submission.signalSemaphores) {
-            auto pSemaphore = GetSemaphoreNode(dev_data, semaphore);
-            if (pSemaphore) {
-                pSemaphore->in_use.fetch_sub(1);
+            for (auto &wait : submission.waitSemaphores) {
+                auto pSemaphore = GetSemaphoreNode(dev_data, wait.semaphore);
+                if (pSemaphore) {
+                    pSemaphore->in_use.fetch_sub(1);
+                }
+                // Roll other queues forward to the highest seq we saw a wait for
+                auto other_queue = wait.queue_state;
+                if (other_queue->seq < wait.seq && other_queue->retire_target < wait.seq) {
+                    other_queue->retire_target = wait.seq;
+                    worklist.push_back(other_queue);
+                }
             }
-        }
 
-        for (auto cb : submission.cbs) {
-            auto cb_node = GetCBNode(dev_data, cb);
-            if (!cb_node) {
-                continue;
+            for (auto &semaphore : submission.signalSemaphores) {
+                auto pSemaphore = GetSemaphoreNode(dev_data, semaphore);
+                if (pSemaphore) {
+                    pSemaphore->in_use.fetch_sub(1);
+                }
             }
-            // First perform decrement on general case bound objects
-            DecrementBoundResources(dev_data, cb_node);
-            for (auto drawDataElement : cb_node->drawData) {
-                for (auto buffer : drawDataElement.buffers) {
-                    auto buffer_state = GetBufferState(dev_data, buffer);
-                    if (buffer_state) {
-                        buffer_state->in_use.fetch_sub(1);
+
+            for (auto cb : submission.cbs) {
+                auto cb_node = GetCBNode(dev_data, cb);
+                if (!cb_node) {
+                    continue;
+                }
+                // First perform decrement on general case bound objects
+                DecrementBoundResources(dev_data, cb_node);
+                for (auto drawDataElement : cb_node->drawData) {
+                    for (auto buffer : drawDataElement.buffers) {
+                        auto buffer_state = GetBufferState(dev_data, buffer);
+                        if (buffer_state) {
+                            buffer_state->in_use.fetch_sub(1);
+                        }
                     }
                 }
-            }
-            for (auto event : cb_node->writeEventsBeforeWait) {
-                auto eventNode = dev_data->eventMap.find(event);
-                if (eventNode != dev_data->eventMap.end()) {
-                    eventNode->second.write_in_use--;
+                for (auto event : cb_node->writeEventsBeforeWait) {
+                    auto eventNode = dev_data->eventMap.find(event);
+                    if (eventNode != dev_data->eventMap.end()) {
+                        eventNode->second.write_in_use--;
+                    }
                 }
-            }
-            for (auto queryStatePair : cb_node->queryToStateMap) {
-                dev_data->queryToStateMap[queryStatePair.first] = queryStatePair.second;
-            }
-            for (auto eventStagePair : cb_node->eventToStageMap) {
-                dev_data->eventMap[eventStagePair.first].stageMask = eventStagePair.second;
+                for (auto const &pool_state : cb_node->queryToStateMap) {
+                    auto query_pool_node = GetQueryPoolNode(dev_data, pool_state.first);
+                    if (query_pool_node) query_pool_node->query_state.Merge(pool_state.second);
+                }
+                for (auto eventStagePair : cb_node->eventToStageMap) {
+                    dev_data->eventMap[eventStagePair.first].stageMask = eventStagePair.second;
+                }
+
+                cb_node->in_use.fetch_sub(1);
             }
 
-            cb_node->in_use.fetch_sub(1);
-        }
+            auto pFence = GetFenceNode(dev_data, submission.fence);
+            if (pFence) {
+                pFence->state = FENCE_RETIRED;
+            }
 
-        auto pFence = GetFenceNode(dev_data, submission.fence);
-        if (pFence) {
-            pFence->state = FENCE_RETIRED;
+            queue->submissions.pop_front();
+            queue->seq++;
         }
-
-        pQueue->submissions.pop_front();
-        pQueue->seq++;
-    }
-
-    // Roll other queues forward to the highest seq we saw a wait for
-    for (auto qs : otherQueueSeqs) {
-        RetireWorkOnQueue(dev_data, GetQueueState(dev_data, qs.first), qs.second);
     }
 }
 
@@ -2504,7 +2807,8 @@ static bool validateQueueFamilyIndices(layer_data *dev_data, GLOBAL_CB_NODE *pCB
     return skip;
 }
 
-static bool validatePrimaryCommandBufferState(layer_data *dev_data, GLOBAL_CB_NODE *pCB, int current_submit_count) {
+static bool validatePrimaryCommandBufferState(layer_data *dev_data, GLOBAL_CB_NODE *pCB, int current_submit_count,
+                                              bool full_validation) {
     // Track in-use for resources off of primary and any secondary CBs
     bool skip = false;
 
@@ -2512,10 +2816,10 @@ static bool validatePrimaryCommandBufferState(layer_data *dev_data, GLOBAL_CB_NO
     // on device
     skip |= validateCommandBufferSimultaneousUse(dev_data, pCB, current_submit_count);
 
-    skip |= validateResources(dev_data, pCB);
+    if (full_validation) skip |= validateResources(dev_data, pCB);
 
     for (auto pSubCB : pCB->linkedCommandBuffers) {
-        skip |= validateResources(dev_data, pSubCB);
+        if (full_validation) skip |= validateResources(dev_data, pSubCB);
         // TODO: replace with invalidateCommandBuffers() at recording.
         if ((pSubCB->primaryCommandBuffer != pCB->commandBuffer) &&
             !(pSubCB->beginInfo.flags & VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT)) {
@@ -2577,7 +2881,8 @@ static void PostCallRecordQueueSubmit(layer_data *dev_data, VkQueue queue, uint3
             auto pSemaphore = GetSemaphoreNode(dev_data, semaphore);
             if (pSemaphore) {
                 if (pSemaphore->signaler.first != VK_NULL_HANDLE) {
-                    semaphore_waits.push_back({semaphore, pSemaphore->signaler.first, pSemaphore->signaler.second});
+                    semaphore_waits.push_back({semaphore, pSemaphore->signaler.first, pSemaphore->signaler.second,
+                                               GetQueueState(dev_data, pSemaphore->signaler.first)});
                     pSemaphore->in_use.fetch_add(1);
                 }
                 pSemaphore->signaler.first = VK_NULL_HANDLE;
@@ -2634,6 +2939,8 @@ static bool PreCallValidateQueueSubmit(layer_data *dev_data, VkQueue queue, uint
     unordered_set<VkSemaphore> unsignaled_semaphores;
     vector<VkCommandBuffer> current_cmds;
     unordered_map<ImageSubresourcePair, IMAGE_LAYOUT_NODE> localImageLayoutMap;
+    // Work outside the validation sample skips the pure checks below; the submit-time callbacks still run as they update state
+    const bool full_validation = SampleSubmitValidation(dev_data, submitCount, pSubmits);
     // Now verify each individual submit
     for (uint32_t submit_idx = 0; submit_idx < submitCount; submit_idx++) {
         const VkSubmitInfo *submit = &pSubmits[submit_idx];
@@ -2674,11 +2981,14 @@ static bool PreCallValidateQueueSubmit(layer_data *dev_data, VkQueue queue, uint
         for (uint32_t i = 0; i < submit->commandBufferCount; i++) {
             auto cb_node = GetCBNode(dev_data, submit->pCommandBuffers[i]);
             if (cb_node) {
-                skip |= ValidateCmdBufImageLayouts(dev_data, cb_node, dev_data->imageLayoutMap, localImageLayoutMap);
+                if (full_validation) {
+                    skip |= ValidateCmdBufImageLayouts(dev_data, cb_node, dev_data->imageLayoutMap, localImageLayoutMap);
+                }
                 current_cmds.push_back(submit->pCommandBuffers[i]);
                 skip |= validatePrimaryCommandBufferState(
-                    dev_data, cb_node, (int)std::count(current_cmds.begin(), current_cmds.end(), submit->pCommandBuffers[i]));
-                skip |= validateQueueFamilyIndices(dev_data, cb_node, queue);
+                    dev_data, cb_node, (int)std::count(current_cmds.begin(), current_cmds.end(), submit->pCommandBuffers[i]),
+                    full_validation);
+                if (full_validation) skip |= validateQueueFamilyIndices(dev_data, cb_node, queue);
 
                 // Potential early exit here as bad object state may crash in delayed function calls
                 if (skip) {
@@ -2788,6 +3098,7 @@ static void PostCallRecordFreeMemory(layer_data *dev_data, VkDeviceMemory mem, D
                 auto image_state = GetImageState(dev_data, reinterpret_cast<VkImage &>(obj.handle));
                 assert(image_state);  // Any destroyed images should already be removed from bindings
                 image_state->binding.mem = MEMORY_UNBOUND;
+                image_state->dependency_generation = ++dev_data->dependency_generation;
                 break;
             }
             case kVulkanObjectTypeBuffer: {
@@ -2888,6 +3199,7 @@ static bool deleteMemRanges(layer_data *dev_data, VkDeviceMemory mem) {
                            validation_error_map[VALIDATION_ERROR_33600562]);
         }
         mem_info->mem_range.size = 0;
+        mem_info->guarded_mapping.reset();
         if (mem_info->shadow_copy) {
             free(mem_info->shadow_copy_base);
             mem_info->shadow_copy_base = 0;
@@ -2920,6 +3232,15 @@ static void initializeAndTrackMemory(layer_data *dev_data, VkDeviceMemory mem, V
 
             // From spec: (ppData - offset) must be aligned to at least limits::minMemoryMapAlignment.
             uint64_t start_offset = offset % map_alignment;
+            if (dev_data->instance_data->noncoherent_page_guard) {
+                mem_info->guarded_mapping =
+                    GuardedMapping::Create(*ppData, static_cast<size_t>(size), static_cast<size_t>(start_offset),
+                                           static_cast<size_t>(map_alignment));
+                if (mem_info->guarded_mapping) {
+                    *ppData = mem_info->guarded_mapping->data();
+                    return;
+                }
+            }
             // Data passed to driver will be wrapped by a guardband of data to detect over- or under-writes.
             mem_info->shadow_copy_base =
                 malloc(static_cast<size_t>(2 * mem_info->shadow_pad_size + size + map_alignment + start_offset));
@@ -3216,6 +3537,9 @@ static bool PreCallValidateDestroyQueryPool(layer_data *dev_data, VkQueryPool qu
 static void PostCallRecordDestroyQueryPool(layer_data *dev_data, VkQueryPool query_pool, QUERY_POOL_NODE *qp_state,
                                            VK_OBJECT obj_struct) {
     invalidateCommandBuffers(dev_data, qp_state->cb_bindings, obj_struct);
+    for (auto &queue : dev_data->queueMap) {
+        queue.second.queryToStateMap.erase(query_pool);
+    }
     dev_data->queryPoolMap.erase(query_pool);
 }
 
@@ -3234,90 +3558,89 @@ VKAPI_ATTR void VKAPI_CALL DestroyQueryPool(VkDevice device, VkQueryPool queryPo
         }
     }
 }
+// Returns the events cb_node had waited on when it last reset query, or nullptr if it hasn't reset query
+static std::unordered_set<VkEvent> const *GetQueryResetEvents(GLOBAL_CB_NODE const *cb_node, QueryObject query) {
+    auto const &resets = cb_node->waitedEventsBeforeQueryReset;
+    for (auto reset = resets.rbegin(); reset != resets.rend(); ++reset) {
+        if (reset->pool == query.pool && query.index >= reset->first && query.index - reset->first < reset->count) {
+            return &reset->events;
+        }
+    }
+    return nullptr;
+}
+
 static bool PreCallValidateGetQueryPoolResults(layer_data *dev_data, VkQueryPool query_pool, uint32_t first_query,
                                                uint32_t query_count, VkQueryResultFlags flags,
-                                               unordered_map<QueryObject, vector<VkCommandBuffer>> *queries_in_flight) {
-    // TODO: clean this up, it's insanely wasteful.
+                                               vector<vector<GLOBAL_CB_NODE *>> *queries_in_flight) {
+    // For each query, the command buffers in flight that use it
+    queries_in_flight->resize(query_count);
     for (auto cmd_buffer : dev_data->commandBufferMap) {
-        if (cmd_buffer.second->in_use.load()) {
-            for (auto query_state_pair : cmd_buffer.second->queryToStateMap) {
-                (*queries_in_flight)[query_state_pair.first].push_back(
-                    cmd_buffer.first);
-            }
+        if (!cmd_buffer.second->in_use.load()) continue;
+        auto pool_state = cmd_buffer.second->queryToStateMap.GetPool(query_pool);
+        if (!pool_state) continue;
+        bool available;
+        for (uint32_t i = 0; i < query_count; ++i) {
+            if (pool_state->Get(first_query + i, &available)) (*queries_in_flight)[i].push_back(cmd_buffer.second);
         }
     }
     if (dev_data->instance_data->disabled.get_query_pool_results) return false;
+    auto query_pool_node = GetQueryPoolNode(dev_data, query_pool);
+    if (!query_pool_node) return false;
     bool skip = false;
     for (uint32_t i = 0; i < query_count; ++i) {
         QueryObject query = {query_pool, first_query + i};
-        auto qif_pair = queries_in_flight->find(query);
-        auto query_state_pair = dev_data->queryToStateMap.find(query);
-        if (query_state_pair != dev_data->queryToStateMap.end()) {
+        bool available;
+        if (!query_pool_node->query_state.Get(query.index, &available)) continue;
+        auto const &in_flight = (*queries_in_flight)[i];
+        if (!in_flight.empty() && available) {
             // Available and in flight
-            if (qif_pair != queries_in_flight->end() && query_state_pair != dev_data->queryToStateMap.end() &&
-                query_state_pair->second) {
-                for (auto cmd_buffer : qif_pair->second) {
-                    auto cb = GetCBNode(dev_data, cmd_buffer);
-                    auto query_event_pair = cb->waitedEventsBeforeQueryReset.find(query);
-                    if (query_event_pair == cb->waitedEventsBeforeQueryReset.end()) {
-                        skip |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT,
-                                        VK_DEBUG_REPORT_OBJECT_TYPE_QUERY_POOL_EXT, 0, __LINE__, DRAWSTATE_INVALID_QUERY, "DS",
-                                        "Cannot get query results on queryPool 0x%" PRIx64 " with index %d which is in flight.",
-                                        HandleToUint64(query_pool), first_query + i);
-                    }
-                }
-                // Unavailable and in flight
-            } else if (qif_pair != queries_in_flight->end() && query_state_pair != dev_data->queryToStateMap.end() &&
-                       !query_state_pair->second) {
-                // TODO : Can there be the same query in use by multiple command buffers in flight?
-                bool make_available = false;
-                for (auto cmd_buffer : qif_pair->second) {
-                    auto cb = GetCBNode(dev_data, cmd_buffer);
-                    make_available |= cb->queryToStateMap[query];
-                }
-                if (!(((flags & VK_QUERY_RESULT_PARTIAL_BIT) || (flags & VK_QUERY_RESULT_WAIT_BIT)) && make_available)) {
+            for (auto cb : in_flight) {
+                if (!GetQueryResetEvents(cb, query)) {
                     skip |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT,
                                     VK_DEBUG_REPORT_OBJECT_TYPE_QUERY_POOL_EXT, 0, __LINE__, DRAWSTATE_INVALID_QUERY, "DS",
-                                    "Cannot get query results on queryPool 0x%" PRIx64 " with index %d which is unavailable.",
-                                    HandleToUint64(query_pool), first_query + i);
+                                    "Cannot get query results on queryPool 0x%" PRIx64 " with index %d which is in flight.",
+                                    HandleToUint64(query_pool), query.index);
                 }
-                // Unavailable
-            } else if (query_state_pair != dev_data->queryToStateMap.end() && !query_state_pair->second) {
+            }
+        } else if (!in_flight.empty()) {
+            // Unavailable and in flight
+            // TODO : Can there be the same query in use by multiple command buffers in flight?
+            bool make_available = false;
+            for (auto cb : in_flight) {
+                bool cb_available;
+                make_available |= cb->queryToStateMap.Get(query, &cb_available) && cb_available;
+            }
+            if (!(((flags & VK_QUERY_RESULT_PARTIAL_BIT) || (flags & VK_QUERY_RESULT_WAIT_BIT)) && make_available)) {
                 skip |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_QUERY_POOL_EXT, 0,
                                 __LINE__, DRAWSTATE_INVALID_QUERY, "DS",
                                 "Cannot get query results on queryPool 0x%" PRIx64 " with index %d which is unavailable.",
-                                HandleToUint64(query_pool), first_query + i);
-                // Uninitialized
-            } else if (query_state_pair == dev_data->queryToStateMap.end()) {
-                skip |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_QUERY_POOL_EXT, 0,
-                                __LINE__, DRAWSTATE_INVALID_QUERY, "DS",
-                                "Cannot get query results on queryPool 0x%" PRIx64
-                                " with index %d as data has not been collected for this index.",
-                                HandleToUint64(query_pool), first_query + i);
+                                HandleToUint64(query_pool), query.index);
             }
+        } else if (!available) {
+            // Unavailable
+            skip |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_QUERY_POOL_EXT, 0,
+                            __LINE__, DRAWSTATE_INVALID_QUERY, "DS",
+                            "Cannot get query results on queryPool 0x%" PRIx64 " with index %d which is unavailable.",
+                            HandleToUint64(query_pool), query.index);
         }
     }
     return skip;
 }
 
 static void PostCallRecordGetQueryPoolResults(layer_data *dev_data, VkQueryPool query_pool, uint32_t first_query,
-                                              uint32_t query_count,
-                                              unordered_map<QueryObject, vector<VkCommandBuffer>> *queries_in_flight) {
+                                              uint32_t query_count, vector<vector<GLOBAL_CB_NODE *>> *queries_in_flight) {
+    auto query_pool_node = GetQueryPoolNode(dev_data, query_pool);
+    if (!query_pool_node) return;
     for (uint32_t i = 0; i < query_count; ++i) {
         QueryObject query = {query_pool, first_query + i};
-        auto qif_pair = queries_in_flight->find(query);
-        auto query_state_pair = dev_data->queryToStateMap.find(query);
-        if (query_state_pair != dev_data->queryToStateMap.end()) {
-            // Available and in flight
-            if (qif_pair != queries_in_flight->end() && query_state_pair != dev_data->queryToStateMap.end() &&
-                query_state_pair->second) {
-                for (auto cmd_buffer : qif_pair->second) {
-                    auto cb = GetCBNode(dev_data, cmd_buffer);
-                    auto query_event_pair = cb->waitedEventsBeforeQueryReset.find(query);
-                    if (query_event_pair != cb->waitedEventsBeforeQueryReset.end()) {
-                        for (auto event : query_event_pair->second) {
-                            dev_data->eventMap[event].needsSignaled = true;
-                        }
+        bool available;
+        // Available and in flight
+        if (query_pool_node->query_state.Get(query.index, &available) && available) {
+            for (auto cb : (*queries_in_flight)[i]) {
+                auto events = GetQueryResetEvents(cb, query);
+                if (events) {
+                    for (auto event : *events) {
+                        dev_data->eventMap[event].needsSignaled = true;
                     }
                 }
             }
@@ -3328,7 +3651,7 @@ static void PostCallRecordGetQueryPoolResults(layer_data *dev_data, VkQueryPool
 VKAPI_ATTR VkResult VKAPI_CALL GetQueryPoolResults(VkDevice device, VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount,
                                                    size_t dataSize, void *pData, VkDeviceSize stride, VkQueryResultFlags flags) {
     layer_data *dev_data = GetLayerDataPtr(get_dispatch_key(device), layer_data_map);
-    unordered_map<QueryObject, vector<VkCommandBuffer>> queries_in_flight;
+    vector<vector<GLOBAL_CB_NODE *>> queries_in_flight;
     unique_lock_t lock(global_lock);
     bool skip = PreCallValidateGetQueryPoolResults(dev_data, queryPool, firstQuery, queryCount, flags, &queries_in_flight);
     lock.unlock();
@@ -3762,9 +4085,17 @@ VKAPI_ATTR void VKAPI_CALL DestroyShaderModule(VkDevice device, VkShaderModule s
     layer_data *dev_data = GetLayerDataPtr(get_dispatch_key(device), layer_data_map);
 
     unique_lock_t lock(global_lock);
-    dev_data->shaderModuleMap.erase(shaderModule);
+    unique_ptr<shader_module> module;
+    auto it = dev_data->shaderModuleMap.find(shaderModule);
+    if (it != dev_data->shaderModuleMap.end()) {
+        module = std::move(it->second);
+        dev_data->shaderModuleMap.erase(it);
+    }
     lock.unlock();
 
+    // A deferred module that no pipeline used still has its SPIR-V errors reported
+    if (module) WaitForShaderModule(dev_data, shaderModule, module.get());
+
     dev_data->dispatch_table.DestroyShaderModule(device, shaderModule, pAllocator);
 }
 
@@ -4232,9 +4563,23 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateBufferView(VkDevice device, const VkBufferV
 
 // Access helper functions for external modules
 const VkFormatProperties *GetFormatProperties(core_validation::layer_data *device_data, VkFormat format) {
-    VkFormatProperties *format_properties = new VkFormatProperties;
-    instance_layer_data *instance_data =
-        GetLayerDataPtr(get_dispatch_key(device_data->instance_data->instance), instance_layer_data_map);
+    instance_layer_data *instance_data = device_data->instance_data;
+    auto physical_device_state = GetPhysicalDeviceState(instance_data, device_data->physical_device);
+    std::lock_guard<std::mutex> lock(physical_device_state->format_properties_lock);
+    VkFormatProperties *format_properties = nullptr;
+    if (format >= VK_FORMAT_BEGIN_RANGE && format <= VK_FORMAT_END_RANGE) {
+        if (physical_device_state->format_properties.empty()) {
+            physical_device_state->format_properties.resize(VK_FORMAT_RANGE_SIZE);
+            physical_device_state->format_properties_cached.resize(VK_FORMAT_RANGE_SIZE, false);
+        }
+        format_properties = &physical_device_state->format_properties[format];
+        if (physical_device_state->format_properties_cached[format]) return format_properties;
+        physical_device_state->format_properties_cached[format] = true;
+    } else {
+        auto result = physical_device_state->extension_format_properties.emplace(format, VkFormatProperties{});
+        format_properties = &result.first->second;
+        if (!result.second) return format_properties;
+    }
     instance_data->dispatch_table.GetPhysicalDeviceFormatProperties(device_data->physical_device, format, format_properties);
     return format_properties;
 }
@@ -4242,11 +4587,16 @@ const VkFormatProperties *GetFormatProperties(core_validation::layer_data *devic
 const VkImageFormatProperties *GetImageFormatProperties(core_validation::layer_data *device_data, VkFormat format,
                                                         VkImageType image_type, VkImageTiling tiling, VkImageUsageFlags usage,
                                                         VkImageCreateFlags flags) {
-    VkImageFormatProperties *image_format_properties = new VkImageFormatProperties;
-    instance_layer_data *instance_data =
-        GetLayerDataPtr(get_dispatch_key(device_data->instance_data->instance), instance_layer_data_map);
-    instance_data->dispatch_table.GetPhysicalDeviceImageFormatProperties(device_data->physical_device, format, image_type, tiling,
-                                                                         usage, flags, image_format_properties);
+    instance_layer_data *instance_data = device_data->instance_data;
+    auto physical_device_state = GetPhysicalDeviceState(instance_data, device_data->physical_device);
+    ImageFormatQuery query = {format, image_type, tiling, usage, flags};
+    std::lock_guard<std::mutex> lock(physical_device_state->format_properties_lock);
+    auto result = physical_device_state->image_format_properties.emplace(query, VkImageFormatProperties{});
+    VkImageFormatProperties *image_format_properties = &result.first->second;
+    if (result.second) {
+        instance_data->dispatch_table.GetPhysicalDeviceImageFormatProperties(device_data->physical_device, format, image_type,
+                                                                             tiling, usage, flags, image_format_properties);
+    }
     return image_format_properties;
 }
 
@@ -4258,7 +4608,11 @@ const VkPhysicalDeviceProperties *GetPhysicalDeviceProperties(core_validation::l
 
 const CHECK_DISABLED *GetDisables(core_validation::layer_data *device_data) { return &device_data->instance_data->disabled; }
 
-std::unordered_map<VkImage, std::unique_ptr<IMAGE_STATE>> *GetImageMap(core_validation::layer_data *device_data) {
+ShaderValidationPool *GetShaderValidationPool(core_validation::layer_data *device_data) {
+    return device_data->shader_validation_pool.get();
+}
+
+FlatHashMap<VkImage, std::unique_ptr<IMAGE_STATE>> *GetImageMap(core_validation::layer_data *device_data) {
     return &device_data->imageMap;
 }
 
@@ -4274,15 +4628,15 @@ std::unordered_map<ImageSubresourcePair, IMAGE_LAYOUT_NODE> const *GetImageLayou
     return &device_data->imageLayoutMap;
 }
 
-std::unordered_map<VkBuffer, std::unique_ptr<BUFFER_STATE>> *GetBufferMap(layer_data *device_data) {
+FlatHashMap<VkBuffer, std::unique_ptr<BUFFER_STATE>> *GetBufferMap(layer_data *device_data) {
     return &device_data->bufferMap;
 }
 
-std::unordered_map<VkBufferView, std::unique_ptr<BUFFER_VIEW_STATE>> *GetBufferViewMap(layer_data *device_data) {
+FlatHashMap<VkBufferView, std::unique_ptr<BUFFER_VIEW_STATE>> *GetBufferViewMap(layer_data *device_data) {
     return &device_data->bufferViewMap;
 }
 
-std::unordered_map<VkImageView, std::unique_ptr<IMAGE_VIEW_STATE>> *GetImageViewMap(layer_data *device_data) {
+FlatHashMap<VkImageView, std::unique_ptr<IMAGE_VIEW_STATE>> *GetImageViewMap(layer_data *device_data) {
     return &device_data->imageViewMap;
 }
 
@@ -4307,6 +4661,7 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateImage(VkDevice device, const VkImageCreateI
     if (VK_SUCCESS == result) {
         lock_guard_t lock(global_lock);
         PostCallRecordCreateImage(dev_data, pCreateInfo, pImage);
+        GetImageState(dev_data, *pImage)->dependency_generation = ++dev_data->dependency_generation;
     }
     return result;
 }
@@ -4322,6 +4677,7 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateImageView(VkDevice device, const VkImageVie
     if (VK_SUCCESS == result) {
         lock.lock();
         PostCallRecordCreateImageView(dev_data, pCreateInfo, *pView);
+        GetImageViewState(dev_data, *pView)->dependency_generation = ++dev_data->dependency_generation;
         lock.unlock();
     }
 
@@ -4417,6 +4773,25 @@ bool validate_dual_src_blend_feature(layer_data *device_data, PIPELINE_STATE *pi
     return skip;
 }
 
+// Waits for the deferred SPIR-V validation of the stages' modules with global_lock released, so that other threads aren't
+// held up behind spvValidate. validate_pipeline_shader_stage then only has to report what was found. Called with the lock
+// held, before any state for the pipeline has been looked up.
+static void WaitForDeferredShaderModules(layer_data *dev_data, unique_lock_t &lock, uint32_t stage_count,
+                                         VkPipelineShaderStageCreateInfo const *pStages) {
+    if (!dev_data->shader_validation_pool) return;
+    std::vector<std::shared_future<void>> pending;
+    for (uint32_t i = 0; i < stage_count; i++) {
+        auto module = GetShaderModuleState(dev_data, pStages[i].module);
+        if (module && module->deferred && module->deferred->done.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            pending.push_back(module->deferred->done);
+        }
+    }
+    if (pending.empty()) return;
+    lock.unlock();
+    for (auto &done : pending) done.wait();
+    lock.lock();
+}
+
 VKAPI_ATTR VkResult VKAPI_CALL CreateGraphicsPipelines(VkDevice device, VkPipelineCache pipelineCache, uint32_t count,
                                                        const VkGraphicsPipelineCreateInfo *pCreateInfos,
                                                        const VkAllocationCallbacks *pAllocator, VkPipeline *pPipelines) {
@@ -4433,11 +4808,15 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateGraphicsPipelines(VkDevice device, VkPipeli
     uint32_t i = 0;
     unique_lock_t lock(global_lock);
 
+    for (i = 0; i < count; i++) {
+        WaitForDeferredShaderModules(dev_data, lock, pCreateInfos[i].stageCount, pCreateInfos[i].pStages);
+    }
+
     for (i = 0; i < count; i++) {
         pipe_state[i] = new PIPELINE_STATE;
         pipe_state[i]->initGraphicsPipeline(&pCreateInfos[i]);
-        pipe_state[i]->render_pass_ci.initialize(GetRenderPassState(dev_data, pCreateInfos[i].renderPass)->createInfo.ptr());
-        pipe_state[i]->pipeline_layout = *getPipelineLayout(dev_data, pCreateInfos[i].layout);
+        pipe_state[i]->rp_state = GetRenderPassReference(dev_data, pCreateInfos[i].renderPass);
+        pipe_state[i]->pipeline_layout = GetPipelineLayoutReference(dev_data, pCreateInfos[i].layout);
     }
 
     for (i = 0; i < count; i++) {
@@ -4484,13 +4863,17 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateComputePipelines(VkDevice device, VkPipelin
 
     uint32_t i = 0;
     unique_lock_t lock(global_lock);
+    for (i = 0; i < count; i++) {
+        WaitForDeferredShaderModules(dev_data, lock, 1, &pCreateInfos[i].stage);
+    }
+
     for (i = 0; i < count; i++) {
         // TODO: Verify compute stage bits
 
         // Create and initialize internal tracking data structure
         pPipeState[i] = new PIPELINE_STATE;
         pPipeState[i]->initComputePipeline(&pCreateInfos[i]);
-        pPipeState[i]->pipeline_layout = *getPipelineLayout(dev_data, pCreateInfos[i].layout);
+        pPipeState[i]->pipeline_layout = GetPipelineLayoutReference(dev_data, pCreateInfos[i].layout);
 
         // TODO: Add Compute Pipeline Verification
         skip |= validate_compute_pipeline(dev_data, pPipeState[i]);
@@ -4700,16 +5083,15 @@ VKAPI_ATTR VkResult VKAPI_CALL CreatePipelineLayout(VkDevice device, const VkPip
     VkResult result = dev_data->dispatch_table.CreatePipelineLayout(device, pCreateInfo, pAllocator, pPipelineLayout);
     if (VK_SUCCESS == result) {
         lock_guard_t lock(global_lock);
-        PIPELINE_LAYOUT_NODE &plNode = dev_data->pipelineLayoutMap[*pPipelineLayout];
-        plNode.layout = *pPipelineLayout;
-        plNode.set_layouts.resize(pCreateInfo->setLayoutCount);
+        auto plNode = std::make_shared<PIPELINE_LAYOUT_NODE>();
+        plNode->layout = *pPipelineLayout;
+        plNode->set_layouts.resize(pCreateInfo->setLayoutCount);
         for (i = 0; i < pCreateInfo->setLayoutCount; ++i) {
-            plNode.set_layouts[i] = GetDescriptorSetLayout(dev_data, pCreateInfo->pSetLayouts[i]);
-        }
-        plNode.push_constant_ranges.resize(pCreateInfo->pushConstantRangeCount);
-        for (i = 0; i < pCreateInfo->pushConstantRangeCount; ++i) {
-            plNode.push_constant_ranges[i] = pCreateInfo->pPushConstantRanges[i];
+            plNode->set_layouts[i] = GetDescriptorSetLayout(dev_data, pCreateInfo->pSetLayouts[i]);
         }
+        plNode->push_constant_ranges.assign(pCreateInfo->pPushConstantRanges,
+                                            pCreateInfo->pPushConstantRanges + pCreateInfo->pushConstantRangeCount);
+        dev_data->pipelineLayoutMap[*pPipelineLayout] = std::move(plNode);
     }
     return result;
 }
@@ -4968,9 +5350,8 @@ VKAPI_ATTR VkResult VKAPI_CALL BeginCommandBuffer(VkCommandBuffer commandBuffer,
                     auto framebuffer = GetFramebufferState(dev_data, pInfo->framebuffer);
                     if (framebuffer) {
                         if ((framebuffer->createInfo.renderPass != pInfo->renderPass) &&
-                            !verify_renderpass_compatibility(dev_data, framebuffer->renderPassCreateInfo.ptr(),
-                                                             GetRenderPassState(dev_data, pInfo->renderPass)->createInfo.ptr(),
-                                                             errorString)) {
+                            !verifyRenderPassStateCompatibility(dev_data, framebuffer->rp_state.get(),
+                                                                GetRenderPassState(dev_data, pInfo->renderPass), errorString)) {
                             // renderPass that framebuffer was created with must be compatible with local renderPass
                             skip |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT,
                                             VK_DEBUG_REPORT_OBJECT_TYPE_COMMAND_BUFFER_EXT, HandleToUint64(commandBuffer), __LINE__,
@@ -5035,6 +5416,7 @@ VKAPI_ATTR VkResult VKAPI_CALL BeginCommandBuffer(VkCommandBuffer commandBuffer,
         }
         // Set updated state here in case implicit reset occurs above
         cb_node->state = CB_RECORDING;
+        cb_node->validation_sampled = SampleCommandBufferValidation(dev_data);
         cb_node->beginInfo = *pBeginInfo;
         if (cb_node->beginInfo.pInheritanceInfo) {
             cb_node->inheritanceInfo = *(cb_node->beginInfo.pInheritanceInfo);
@@ -5611,7 +5993,8 @@ static bool ValidateCmdDrawType(layer_data *dev_data, VkCommandBuffer cmd_buffer
     if (*cb_state) {
         skip |= ValidateCmdQueueFlags(dev_data, *cb_state, caller, queue_flags, queue_flag_code);
         skip |= ValidateCmd(dev_data, *cb_state, cmd_type, caller);
-        skip |= ValidateDrawState(dev_data, *cb_state, indexed, bind_point, caller, dynamic_state_msg_code);
+        skip |= ValidateDrawState(dev_data, *cb_state, indexed, bind_point, caller, dynamic_state_msg_code,
+                                  SampleDrawValidation(dev_data, *cb_state));
         skip |= (VK_PIPELINE_BIND_POINT_GRAPHICS == bind_point) ? outsideRenderPass(dev_data, *cb_state, caller, msg_code)
                                                                 : insideRenderPass(dev_data, *cb_state, caller, msg_code);
     }
@@ -6226,9 +6609,10 @@ static bool ValidateBarriers(const char *funcName, VkCommandBuffer cmdBuffer, ui
             auto aspect_mask = mem_barrier->subresourceRange.aspectMask;
             skip |= ValidateImageAspectMask(dev_data, image_data->image, image_data->createInfo.format, aspect_mask, funcName);
 
-            std::string param_name = "pImageMemoryBarriers[" + std::to_string(i) + "].subresourceRange";
-            skip |= ValidateImageSubresourceRange(dev_data, image_data, false, mem_barrier->subresourceRange, funcName,
-                                                  param_name.c_str());
+            // Formatted on the stack, as a heap-allocated string per barrier was a noticeable share of the time spent here
+            char param_name[64];
+            snprintf(param_name, sizeof(param_name), "pImageMemoryBarriers[%" PRIu32 "].subresourceRange", i);
+            skip |= ValidateImageSubresourceRange(dev_data, image_data, false, mem_barrier->subresourceRange, funcName, param_name);
         }
     }
 
@@ -6499,15 +6883,16 @@ VKAPI_ATTR void VKAPI_CALL CmdPipelineBarrier(VkCommandBuffer commandBuffer, VkP
     }
 }
 
-static bool setQueryState(VkQueue queue, VkCommandBuffer commandBuffer, QueryObject object, bool value) {
+static bool setQueryState(VkQueue queue, VkCommandBuffer commandBuffer, VkQueryPool queryPool, uint32_t firstQuery,
+                          uint32_t queryCount, bool value) {
     layer_data *dev_data = GetLayerDataPtr(get_dispatch_key(commandBuffer), layer_data_map);
     GLOBAL_CB_NODE *pCB = GetCBNode(dev_data, commandBuffer);
     if (pCB) {
-        pCB->queryToStateMap[object] = value;
+        pCB->queryToStateMap.Set(queryPool, firstQuery, queryCount, value);
     }
     auto queue_data = dev_data->queueMap.find(queue);
     if (queue_data != dev_data->queueMap.end()) {
-        queue_data->second.queryToStateMap[object] = value;
+        queue_data->second.queryToStateMap.Set(queryPool, firstQuery, queryCount, value);
     }
     return false;
 }
@@ -6564,7 +6949,7 @@ VKAPI_ATTR void VKAPI_CALL CmdEndQuery(VkCommandBuffer commandBuffer, VkQueryPoo
     lock.lock();
     if (cb_state) {
         cb_state->activeQueries.erase(query);
-        cb_state->queryUpdates.emplace_back([=](VkQueue q){return setQueryState(q, commandBuffer, query, true);});
+        cb_state->queryUpdates.emplace_back([=](VkQueue q) { return setQueryState(q, commandBuffer, queryPool, slot, 1, true); });
         addCommandBufferBinding(&GetQueryPoolNode(dev_data, queryPool)->cb_bindings,
                                 {HandleToUint64(queryPool), kVulkanObjectTypeQueryPool}, cb_state);
     }
@@ -6587,27 +6972,18 @@ VKAPI_ATTR void VKAPI_CALL CmdResetQueryPool(VkCommandBuffer commandBuffer, VkQu
     dev_data->dispatch_table.CmdResetQueryPool(commandBuffer, queryPool, firstQuery, queryCount);
 
     lock.lock();
-    for (uint32_t i = 0; i < queryCount; i++) {
-        QueryObject query = {queryPool, firstQuery + i};
-        cb_state->waitedEventsBeforeQueryReset[query] = cb_state->waitedEvents;
-        cb_state->queryUpdates.emplace_back([=](VkQueue q){return setQueryState(q, commandBuffer, query, false);});
-    }
+    cb_state->waitedEventsBeforeQueryReset.push_back({queryPool, firstQuery, queryCount, cb_state->waitedEvents});
+    cb_state->queryUpdates.emplace_back(
+        [=](VkQueue q) { return setQueryState(q, commandBuffer, queryPool, firstQuery, queryCount, false); });
     addCommandBufferBinding(&GetQueryPoolNode(dev_data, queryPool)->cb_bindings,
                             {HandleToUint64(queryPool), kVulkanObjectTypeQueryPool}, cb_state);
 }
 
-static bool IsQueryInvalid(layer_data *dev_data, QUEUE_STATE *queue_data, VkQueryPool queryPool, uint32_t queryIndex) {
-    QueryObject query = {queryPool, queryIndex};
-    auto query_data = queue_data->queryToStateMap.find(query);
-    if (query_data != queue_data->queryToStateMap.end()) {
-        if (!query_data->second) return true;
-    } else {
-        auto it = dev_data->queryToStateMap.find(query);
-        if (it == dev_data->queryToStateMap.end() || !it->second)
-            return true;
-    }
-
-    return false;
+static bool IsQueryInvalid(QueryStateBits const *queue_pool_state, QUERY_POOL_NODE const *query_pool_node,
+                           uint32_t queryIndex) {
+    bool available;
+    if (queue_pool_state && queue_pool_state->Get(queryIndex, &available)) return !available;
+    return !query_pool_node || !query_pool_node->query_state.Get(queryIndex, &available) || !available;
 }
 
 static bool validateQuery(VkQueue queue, GLOBAL_CB_NODE *pCB, VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount) {
@@ -6615,8 +6991,10 @@ static bool validateQuery(VkQueue queue, GLOBAL_CB_NODE *pCB, VkQueryPool queryP
     layer_data *dev_data = GetLayerDataPtr(get_dispatch_key(pCB->commandBuffer), layer_data_map);
     auto queue_data = GetQueueState(dev_data, queue);
     if (!queue_data) return false;
+    auto queue_pool_state = queue_data->queryToStateMap.GetPool(queryPool);
+    auto query_pool_node = GetQueryPoolNode(dev_data, queryPool);
     for (uint32_t i = 0; i < queryCount; i++) {
-        if (IsQueryInvalid(dev_data, queue_data, queryPool, firstQuery + i)) {
+        if (IsQueryInvalid(queue_pool_state, query_pool_node, firstQuery + i)) {
             skip |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_COMMAND_BUFFER_EXT,
                             HandleToUint64(pCB->commandBuffer), __LINE__, DRAWSTATE_INVALID_QUERY, "DS",
                             "Requesting a copy from query to buffer with invalid query: queryPool 0x%" PRIx64 ", index %d",
@@ -6732,8 +7110,7 @@ VKAPI_ATTR void VKAPI_CALL CmdWriteTimestamp(VkCommandBuffer commandBuffer, VkPi
 
     lock.lock();
     if (cb_state) {
-        QueryObject query = {queryPool, slot};
-        cb_state->queryUpdates.emplace_back([=](VkQueue q) {return setQueryState(q, commandBuffer, query, true);});
+        cb_state->queryUpdates.emplace_back([=](VkQueue q) { return setQueryState(q, commandBuffer, queryPool, slot, 1, true); });
     }
 }
 
@@ -6942,7 +7319,7 @@ static bool PreCallValidateCreateFramebuffer(layer_data *dev_data, const VkFrame
 static void PostCallRecordCreateFramebuffer(layer_data *dev_data, const VkFramebufferCreateInfo *pCreateInfo, VkFramebuffer fb) {
     // Shadow create info and store in map
     std::unique_ptr<FRAMEBUFFER_STATE> fb_state(
-        new FRAMEBUFFER_STATE(fb, pCreateInfo, dev_data->renderPassMap[pCreateInfo->renderPass]->createInfo.ptr()));
+        new FRAMEBUFFER_STATE(fb, pCreateInfo, GetRenderPassReference(dev_data, pCreateInfo->renderPass)));
 
     for (uint32_t i = 0; i < pCreateInfo->attachmentCount; ++i) {
         VkImageView view = pCreateInfo->pAttachments[i];
@@ -6994,9 +7371,8 @@ static bool FindDependency(const uint32_t index, const uint32_t dependent, const
     return false;
 }
 
-static bool CheckDependencyExists(const layer_data *dev_data, const uint32_t subpass,
-                                  const std::vector<uint32_t> &dependent_subpasses, const std::vector<DAGNode> &subpass_to_node,
-                                  bool &skip) {
+static bool CheckDependencyExists(const uint32_t subpass, const std::vector<uint32_t> &dependent_subpasses,
+                                  const std::vector<DAGNode> &subpass_to_node, std::vector<RENDER_PASS_DEPENDENCY_ERROR> &errors) {
     bool result = true;
     // Loop through all subpasses that share the same attachment and make sure a dependency exists
     for (uint32_t k = 0; k < dependent_subpasses.size(); ++k) {
@@ -7010,10 +7386,7 @@ static bool CheckDependencyExists(const layer_data *dev_data, const uint32_t sub
             std::unordered_set<uint32_t> processed_nodes;
             if (!(FindDependency(subpass, dependent_subpasses[k], subpass_to_node, processed_nodes) ||
                   FindDependency(dependent_subpasses[k], subpass, subpass_to_node, processed_nodes))) {
-                skip |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_UNKNOWN_EXT, 0,
-                                __LINE__, DRAWSTATE_INVALID_RENDERPASS, "DS",
-                                "A dependency between subpasses %d and %d must exist but one is not specified.", subpass,
-                                dependent_subpasses[k]);
+                errors.push_back({RENDER_PASS_DEPENDENCY_ERROR::MISSING_DEPENDENCY, subpass, dependent_subpasses[k]});
                 result = false;
             }
         }
@@ -7021,8 +7394,9 @@ static bool CheckDependencyExists(const layer_data *dev_data, const uint32_t sub
     return result;
 }
 
-static bool CheckPreserved(const layer_data *dev_data, const VkRenderPassCreateInfo *pCreateInfo, const int index,
-                           const uint32_t attachment, const std::vector<DAGNode> &subpass_to_node, int depth, bool &skip) {
+static bool CheckPreserved(const VkRenderPassCreateInfo *pCreateInfo, const int index, const uint32_t attachment,
+                           const std::vector<DAGNode> &subpass_to_node, int depth,
+                           std::vector<RENDER_PASS_DEPENDENCY_ERROR> &errors) {
     const DAGNode &node = subpass_to_node[index];
     // If this node writes to the attachment return true as next nodes need to preserve the attachment.
     const VkSubpassDescription &subpass = pCreateInfo->pSubpasses[index];
@@ -7038,7 +7412,7 @@ static bool CheckPreserved(const layer_data *dev_data, const VkRenderPassCreateI
     bool result = false;
     // Loop through previous nodes and see if any of them write to the attachment.
     for (auto elem : node.prev) {
-        result |= CheckPreserved(dev_data, pCreateInfo, elem, attachment, subpass_to_node, depth + 1, skip);
+        result |= CheckPreserved(pCreateInfo, elem, attachment, subpass_to_node, depth + 1, errors);
     }
     // If the attachment was written to by a previous node than this node needs to preserve it.
     if (result && depth > 0) {
@@ -7050,9 +7424,7 @@ static bool CheckPreserved(const layer_data *dev_data, const VkRenderPassCreateI
             }
         }
         if (!has_preserved) {
-            skip |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_UNKNOWN_EXT, 0,
-                            __LINE__, DRAWSTATE_INVALID_RENDERPASS, "DS",
-                            "Attachment %d is used by a later subpass and must be preserved in subpass %d.", attachment, index);
+            errors.push_back({RENDER_PASS_DEPENDENCY_ERROR::NOT_PRESERVED, attachment, static_cast<uint32_t>(index)});
         }
     }
     return result;
@@ -7069,9 +7441,10 @@ bool isRegionOverlapping(VkImageSubresourceRange range1, VkImageSubresourceRange
             isRangeOverlapping(range1.baseArrayLayer, range1.layerCount, range2.baseArrayLayer, range2.layerCount));
 }
 
-static bool ValidateDependencies(const layer_data *dev_data, FRAMEBUFFER_STATE const *framebuffer,
-                                 RENDER_PASS_STATE const *renderPass) {
-    bool skip = false;
+// Finds the attachments of framebuffer that alias each other and the subpass dependencies and preserved attachments that
+//  renderPass then needs. This looks up every pair of attachment views, so its result is cached; see ValidateDependencies().
+static void AnalyzeDependencies(const layer_data *dev_data, FRAMEBUFFER_STATE const *framebuffer,
+                                RENDER_PASS_STATE const *renderPass, std::vector<RENDER_PASS_DEPENDENCY_ERROR> &errors) {
     auto const pFramebufferInfo = framebuffer->createInfo.ptr();
     auto const pCreateInfo = renderPass->createInfo.ptr();
     auto const &subpass_to_node = renderPass->subpassToNode;
@@ -7117,18 +7490,10 @@ static bool ValidateDependencies(const layer_data *dev_data, FRAMEBUFFER_STATE c
         uint32_t attachment = i;
         for (auto other_attachment : overlapping_attachments[i]) {
             if (!(pCreateInfo->pAttachments[attachment].flags & VK_ATTACHMENT_DESCRIPTION_MAY_ALIAS_BIT)) {
-                skip |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_FRAMEBUFFER_EXT,
-                                HandleToUint64(framebuffer->framebuffer), __LINE__, VALIDATION_ERROR_12200682, "DS",
-                                "Attachment %d aliases attachment %d but doesn't "
-                                "set VK_ATTACHMENT_DESCRIPTION_MAY_ALIAS_BIT. %s",
-                                attachment, other_attachment, validation_error_map[VALIDATION_ERROR_12200682]);
+                errors.push_back({RENDER_PASS_DEPENDENCY_ERROR::ATTACHMENT_ALIASED, attachment, other_attachment});
             }
             if (!(pCreateInfo->pAttachments[other_attachment].flags & VK_ATTACHMENT_DESCRIPTION_MAY_ALIAS_BIT)) {
-                skip |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_FRAMEBUFFER_EXT,
-                                HandleToUint64(framebuffer->framebuffer), __LINE__, VALIDATION_ERROR_12200682, "DS",
-                                "Attachment %d aliases attachment %d but doesn't "
-                                "set VK_ATTACHMENT_DESCRIPTION_MAY_ALIAS_BIT. %s",
-                                other_attachment, attachment, validation_error_map[VALIDATION_ERROR_12200682]);
+                errors.push_back({RENDER_PASS_DEPENDENCY_ERROR::ATTACHMENT_ALIASED, other_attachment, attachment});
             }
         }
     }
@@ -7162,10 +7527,7 @@ static bool ValidateDependencies(const layer_data *dev_data, FRAMEBUFFER_STATE c
             }
 
             if (attachmentIndices.count(attachment)) {
-                skip |=
-                    log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_UNKNOWN_EXT, 0,
-                            __LINE__, DRAWSTATE_INVALID_RENDERPASS, "DS",
-                            "Cannot use same attachment (%u) as both color and depth output in same subpass (%u).", attachment, i);
+                errors.push_back({RENDER_PASS_DEPENDENCY_ERROR::COLOR_AND_DEPTH, attachment, i});
             }
         }
     }
@@ -7176,19 +7538,19 @@ static bool ValidateDependencies(const layer_data *dev_data, FRAMEBUFFER_STATE c
         for (uint32_t j = 0; j < subpass.inputAttachmentCount; ++j) {
             uint32_t attachment = subpass.pInputAttachments[j].attachment;
             if (attachment == VK_ATTACHMENT_UNUSED) continue;
-            CheckDependencyExists(dev_data, i, output_attachment_to_subpass[attachment], subpass_to_node, skip);
+            CheckDependencyExists(i, output_attachment_to_subpass[attachment], subpass_to_node, errors);
         }
         // If the attachment is an output then all subpasses that use the attachment must have a dependency relationship
         for (uint32_t j = 0; j < subpass.colorAttachmentCount; ++j) {
             uint32_t attachment = subpass.pColorAttachments[j].attachment;
             if (attachment == VK_ATTACHMENT_UNUSED) continue;
-            CheckDependencyExists(dev_data, i, output_attachment_to_subpass[attachment], subpass_to_node, skip);
-            CheckDependencyExists(dev_data, i, input_attachment_to_subpass[attachment], subpass_to_node, skip);
+            CheckDependencyExists(i, output_attachment_to_subpass[attachment], subpass_to_node, errors);
+            CheckDependencyExists(i, input_attachment_to_subpass[attachment], subpass_to_node, errors);
         }
         if (subpass.pDepthStencilAttachment && subpass.pDepthStencilAttachment->attachment != VK_ATTACHMENT_UNUSED) {
             const uint32_t &attachment = subpass.pDepthStencilAttachment->attachment;
-            CheckDependencyExists(dev_data, i, output_attachment_to_subpass[attachment], subpass_to_node, skip);
-            CheckDependencyExists(dev_data, i, input_attachment_to_subpass[attachment], subpass_to_node, skip);
+            CheckDependencyExists(i, output_attachment_to_subpass[attachment], subpass_to_node, errors);
+            CheckDependencyExists(i, input_attachment_to_subpass[attachment], subpass_to_node, errors);
         }
     }
     // Loop through implicit dependencies, if this pass reads make sure the attachment is preserved for all passes after it was
@@ -7196,7 +7558,89 @@ static bool ValidateDependencies(const layer_data *dev_data, FRAMEBUFFER_STATE c
     for (uint32_t i = 0; i < pCreateInfo->subpassCount; ++i) {
         const VkSubpassDescription &subpass = pCreateInfo->pSubpasses[i];
         for (uint32_t j = 0; j < subpass.inputAttachmentCount; ++j) {
-            CheckPreserved(dev_data, pCreateInfo, i, subpass.pInputAttachments[j].attachment, subpass_to_node, 0, skip);
+            CheckPreserved(pCreateInfo, i, subpass.pInputAttachments[j].attachment, subpass_to_node, 0, errors);
+        }
+    }
+}
+
+// Brings generations up to date with the dependency_generation of each attachment view of framebuffer and of the image
+//  it views, and returns whether any of them changed
+static bool UpdateAttachmentGenerations(const layer_data *dev_data, FRAMEBUFFER_STATE const *framebuffer,
+                                        std::vector<uint64_t> &generations) {
+    auto const pFramebufferInfo = framebuffer->createInfo.ptr();
+    bool changed = false;
+    generations.resize(2 * pFramebufferInfo->attachmentCount, 0);
+    for (uint32_t i = 0; i < pFramebufferInfo->attachmentCount; ++i) {
+        auto view_state = GetImageViewState(dev_data, pFramebufferInfo->pAttachments[i]);
+        auto image_state = view_state ? GetImageState(dev_data, view_state->create_info.image) : nullptr;
+        uint64_t view_generation = view_state ? view_state->dependency_generation : 0;
+        uint64_t image_generation = image_state ? image_state->dependency_generation : 0;
+        if (generations[2 * i] != view_generation || generations[2 * i + 1] != image_generation) {
+            generations[2 * i] = view_generation;
+            generations[2 * i + 1] = image_generation;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// The dependency analysis depends only on the framebuffer, the render pass and the memory bindings of the attachments, so
+//  it's made once per pair and kept on the framebuffer; repeated begins just report what it found, unless one of the
+//  attachments' views or images has changed since.
+static bool ValidateDependencies(const layer_data *dev_data, FRAMEBUFFER_STATE *framebuffer, RENDER_PASS_STATE const *renderPass) {
+    RENDER_PASS_DEPENDENCY_ANALYSIS *analysis = nullptr;
+    for (auto &entry : framebuffer->dependency_analyses) {
+        if (entry.rp_state.get() == renderPass) {
+            analysis = &entry;
+            break;
+        }
+    }
+    bool stale = !analysis;
+    if (!analysis) {
+        // Drop analyses whose render passes have been destroyed
+        auto &analyses = framebuffer->dependency_analyses;
+        analyses.erase(std::remove_if(analyses.begin(), analyses.end(),
+                                      [dev_data](RENDER_PASS_DEPENDENCY_ANALYSIS const &entry) {
+                                          return GetRenderPassState(dev_data, entry.rp_state->renderPass) != entry.rp_state.get();
+                                      }),
+                       analyses.end());
+        analyses.push_back({GetRenderPassReference(dev_data, renderPass->renderPass), {}, {}});
+        analysis = &analyses.back();
+    }
+    if (UpdateAttachmentGenerations(dev_data, framebuffer, analysis->attachment_generations)) stale = true;
+    if (stale) {
+        analysis->errors.clear();
+        AnalyzeDependencies(dev_data, framebuffer, renderPass, analysis->errors);
+    }
+
+    bool skip = false;
+    for (auto const &error : analysis->errors) {
+        switch (error.kind) {
+            case RENDER_PASS_DEPENDENCY_ERROR::ATTACHMENT_ALIASED:
+                skip |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_FRAMEBUFFER_EXT,
+                                HandleToUint64(framebuffer->framebuffer), __LINE__, VALIDATION_ERROR_12200682, "DS",
+                                "Attachment %d aliases attachment %d but doesn't "
+                                "set VK_ATTACHMENT_DESCRIPTION_MAY_ALIAS_BIT. %s",
+                                error.first, error.second, validation_error_map[VALIDATION_ERROR_12200682]);
+                break;
+            case RENDER_PASS_DEPENDENCY_ERROR::COLOR_AND_DEPTH:
+                skip |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_UNKNOWN_EXT, 0,
+                                __LINE__, DRAWSTATE_INVALID_RENDERPASS, "DS",
+                                "Cannot use same attachment (%u) as both color and depth output in same subpass (%u).", error.first,
+                                error.second);
+                break;
+            case RENDER_PASS_DEPENDENCY_ERROR::MISSING_DEPENDENCY:
+                skip |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_UNKNOWN_EXT, 0,
+                                __LINE__, DRAWSTATE_INVALID_RENDERPASS, "DS",
+                                "A dependency between subpasses %d and %d must exist but one is not specified.", error.first,
+                                error.second);
+                break;
+            case RENDER_PASS_DEPENDENCY_ERROR::NOT_PRESERVED:
+                skip |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_UNKNOWN_EXT, 0,
+                                __LINE__, DRAWSTATE_INVALID_RENDERPASS, "DS",
+                                "Attachment %d is used by a later subpass and must be preserved in subpass %d.", error.first,
+                                error.second);
+                break;
         }
     }
     return skip;
@@ -7242,8 +7686,18 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateShaderModule(VkDevice device, const VkShade
     VkResult res = dev_data->dispatch_table.CreateShaderModule(device, pCreateInfo, pAllocator, pShaderModule);
 
     if (res == VK_SUCCESS) {
+        // Parse the module before taking the lock; only the map insertion needs it
+        bool keep_function_bodies = !dev_data->instance_data->compact_shader_modules;
+        unique_ptr<shader_module> new_shader_module;
+        if (!spirv_valid) {
+            new_shader_module.reset(new shader_module());
+        } else if (dev_data->shader_validation_pool) {
+            new_shader_module.reset(
+                DeferShaderModuleValidation(dev_data, dev_data->shader_validation_pool.get(), pCreateInfo, keep_function_bodies));
+        } else {
+            new_shader_module.reset(new shader_module(pCreateInfo, keep_function_bodies));
+        }
         lock_guard_t lock(global_lock);
-        unique_ptr<shader_module> new_shader_module(spirv_valid ? new shader_module(pCreateInfo) : new shader_module());
         dev_data->shaderModuleMap[*pShaderModule] = std::move(new_shader_module);
     }
     return res;
@@ -7431,7 +7885,7 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateRenderPass(VkDevice device, const VkRenderP
         std::vector<DAGNode> subpass_to_node(pCreateInfo->subpassCount);
         skip |= CreatePassDAG(dev_data, pCreateInfo, subpass_to_node, has_self_dependency);
 
-        auto render_pass = unique_ptr<RENDER_PASS_STATE>(new RENDER_PASS_STATE(pCreateInfo));
+        auto render_pass = std::make_shared<RENDER_PASS_STATE>(pCreateInfo);
         render_pass->renderPass = *pRenderPass;
         render_pass->hasSelfDependency = has_self_dependency;
         render_pass->subpassToNode = subpass_to_node;
@@ -7565,8 +8019,7 @@ VKAPI_ATTR void VKAPI_CALL CmdBeginRenderPass(VkCommandBuffer commandBuffer, con
                     clear_op_size - 1, validation_error_map[VALIDATION_ERROR_1200070c]);
             }
             skip |= VerifyRenderAreaBounds(dev_data, pRenderPassBegin);
-            skip |= VerifyFramebufferAndRenderPassLayouts(dev_data, cb_node, pRenderPassBegin,
-                                                          GetFramebufferState(dev_data, pRenderPassBegin->framebuffer));
+            skip |= VerifyFramebufferAndRenderPassLayouts(dev_data, cb_node, pRenderPassBegin, framebuffer);
             skip |= insideRenderPass(dev_data, cb_node, "vkCmdBeginRenderPass()", VALIDATION_ERROR_17a00017);
             skip |= ValidateDependencies(dev_data, framebuffer, render_pass_state);
             skip |= validatePrimaryCommandBuffer(dev_data, cb_node, "vkCmdBeginRenderPass()", VALIDATION_ERROR_17a00019);
@@ -7694,6 +8147,25 @@ static bool logInvalidAttachmentMessage(layer_data *dev_data, VkCommandBuffer se
                    validation_error_map[VALIDATION_ERROR_1b2000c4]);
 }
 
+// Return true if validateAttachmentCompatibility() would find nothing to report for the given pair of attachments
+static bool attachmentsCompatibleForExecute(VkRenderPassCreateInfo const *primaryPassCI, uint32_t primaryAttach,
+                                            VkRenderPassCreateInfo const *secondaryPassCI, uint32_t secondaryAttach,
+                                            bool is_multi) {
+    if (primaryPassCI->attachmentCount <= primaryAttach) {
+        primaryAttach = VK_ATTACHMENT_UNUSED;
+    }
+    if (secondaryPassCI->attachmentCount <= secondaryAttach) {
+        secondaryAttach = VK_ATTACHMENT_UNUSED;
+    }
+    if (primaryAttach == VK_ATTACHMENT_UNUSED || secondaryAttach == VK_ATTACHMENT_UNUSED) {
+        return primaryAttach == secondaryAttach;
+    }
+    auto const &primary_desc = primaryPassCI->pAttachments[primaryAttach];
+    auto const &secondary_desc = secondaryPassCI->pAttachments[secondaryAttach];
+    return (primary_desc.format == secondary_desc.format) && (primary_desc.samples == secondary_desc.samples) &&
+           (!is_multi || primary_desc.flags == secondary_desc.flags);
+}
+
 static bool validateAttachmentCompatibility(layer_data *dev_data, VkCommandBuffer primaryBuffer,
                                             VkRenderPassCreateInfo const *primaryPassCI, uint32_t primaryAttach,
                                             VkCommandBuffer secondaryBuffer, VkRenderPassCreateInfo const *secondaryPassCI,
@@ -7733,10 +8205,11 @@ static bool validateAttachmentCompatibility(layer_data *dev_data, VkCommandBuffe
     return skip;
 }
 
-static bool validateSubpassCompatibility(layer_data *dev_data, VkCommandBuffer primaryBuffer,
-                                         VkRenderPassCreateInfo const *primaryPassCI, VkCommandBuffer secondaryBuffer,
-                                         VkRenderPassCreateInfo const *secondaryPassCI, const int subpass, bool is_multi) {
-    bool skip = false;
+// Call check(primary_attach, secondary_attach) for each pair of input, color, resolve and depth/stencil attachments of the
+//  given subpass that must be compatible, with VK_ATTACHMENT_UNUSED standing in for references missing from either side
+template <typename CHECK>
+static void forEachSubpassAttachmentPair(VkRenderPassCreateInfo const *primaryPassCI, VkRenderPassCreateInfo const *secondaryPassCI,
+                                         const int subpass, CHECK check) {
     const VkSubpassDescription &primary_desc = primaryPassCI->pSubpasses[subpass];
     const VkSubpassDescription &secondary_desc = secondaryPassCI->pSubpasses[subpass];
     uint32_t maxInputAttachmentCount = std::max(primary_desc.inputAttachmentCount, secondary_desc.inputAttachmentCount);
@@ -7748,8 +8221,7 @@ static bool validateSubpassCompatibility(layer_data *dev_data, VkCommandBuffer p
         if (i < secondary_desc.inputAttachmentCount) {
             secondary_input_attach = secondary_desc.pInputAttachments[i].attachment;
         }
-        skip |= validateAttachmentCompatibility(dev_data, primaryBuffer, primaryPassCI, primary_input_attach, secondaryBuffer,
-                                                secondaryPassCI, secondary_input_attach, is_multi);
+        check(primary_input_attach, secondary_input_attach);
     }
     uint32_t maxColorAttachmentCount = std::max(primary_desc.colorAttachmentCount, secondary_desc.colorAttachmentCount);
     for (uint32_t i = 0; i < maxColorAttachmentCount; ++i) {
@@ -7760,8 +8232,7 @@ static bool validateSubpassCompatibility(layer_data *dev_data, VkCommandBuffer p
         if (i < secondary_desc.colorAttachmentCount) {
             secondary_color_attach = secondary_desc.pColorAttachments[i].attachment;
         }
-        skip |= validateAttachmentCompatibility(dev_data, primaryBuffer, primaryPassCI, primary_color_attach, secondaryBuffer,
-                                                secondaryPassCI, secondary_color_attach, is_multi);
+        check(primary_color_attach, secondary_color_attach);
         uint32_t primary_resolve_attach = VK_ATTACHMENT_UNUSED, secondary_resolve_attach = VK_ATTACHMENT_UNUSED;
         if (i < primary_desc.colorAttachmentCount && primary_desc.pResolveAttachments) {
             primary_resolve_attach = primary_desc.pResolveAttachments[i].attachment;
@@ -7769,8 +8240,7 @@ static bool validateSubpassCompatibility(layer_data *dev_data, VkCommandBuffer p
         if (i < secondary_desc.colorAttachmentCount && secondary_desc.pResolveAttachments) {
             secondary_resolve_attach = secondary_desc.pResolveAttachments[i].attachment;
         }
-        skip |= validateAttachmentCompatibility(dev_data, primaryBuffer, primaryPassCI, primary_resolve_attach, secondaryBuffer,
-                                                secondaryPassCI, secondary_resolve_attach, is_multi);
+        check(primary_resolve_attach, secondary_resolve_attach);
     }
     uint32_t primary_depthstencil_attach = VK_ATTACHMENT_UNUSED, secondary_depthstencil_attach = VK_ATTACHMENT_UNUSED;
     if (primary_desc.pDepthStencilAttachment) {
@@ -7779,8 +8249,19 @@ static bool validateSubpassCompatibility(layer_data *dev_data, VkCommandBuffer p
     if (secondary_desc.pDepthStencilAttachment) {
         secondary_depthstencil_attach = secondary_desc.pDepthStencilAttachment[0].attachment;
     }
-    skip |= validateAttachmentCompatibility(dev_data, primaryBuffer, primaryPassCI, primary_depthstencil_attach, secondaryBuffer,
-                                            secondaryPassCI, secondary_depthstencil_attach, is_multi);
+    check(primary_depthstencil_attach, secondary_depthstencil_attach);
+}
+
+static bool validateSubpassCompatibility(layer_data *dev_data, VkCommandBuffer primaryBuffer,
+                                         VkRenderPassCreateInfo const *primaryPassCI, VkCommandBuffer secondaryBuffer,
+                                         VkRenderPassCreateInfo const *secondaryPassCI, const int subpass, bool is_multi) {
+    bool skip = false;
+    forEachSubpassAttachmentPair(primaryPassCI, secondaryPassCI, subpass,
+                                 [&](uint32_t primary_attach, uint32_t secondary_attach) {
+                                     skip |= validateAttachmentCompatibility(dev_data, primaryBuffer, primaryPassCI, primary_attach,
+                                                                             secondaryBuffer, secondaryPassCI, secondary_attach,
+                                                                             is_multi);
+                                 });
     return skip;
 }
 
@@ -7809,6 +8290,30 @@ static bool validateRenderPassCompatibility(layer_data *dev_data, VkCommandBuffe
     return skip;
 }
 
+// validateRenderPassCompatibility() for two render pass states. Pairs that pass are remembered, so a secondary executed over and
+//  over within the same render pass is compared attachment by attachment only once.
+static bool validateRenderPassStateCompatibility(layer_data *dev_data, VkCommandBuffer primaryBuffer,
+                                                 RENDER_PASS_STATE const *primary_rp, VkCommandBuffer secondaryBuffer,
+                                                 RENDER_PASS_STATE const *secondary_rp) {
+    if (primary_rp == secondary_rp || primary_rp->execute_compatible_render_passes.count(secondary_rp)) return false;
+    auto primaryPassCI = primary_rp->createInfo.ptr();
+    auto secondaryPassCI = secondary_rp->createInfo.ptr();
+    bool compatible = (primaryPassCI->subpassCount == secondaryPassCI->subpassCount);
+    bool is_multi = primaryPassCI->subpassCount > 1;
+    for (uint32_t i = 0; compatible && i < primaryPassCI->subpassCount; ++i) {
+        forEachSubpassAttachmentPair(primaryPassCI, secondaryPassCI, i, [&](uint32_t primary_attach, uint32_t secondary_attach) {
+            compatible = compatible && attachmentsCompatibleForExecute(primaryPassCI, primary_attach, secondaryPassCI,
+                                                                       secondary_attach, is_multi);
+        });
+    }
+    if (!compatible) {
+        return validateRenderPassCompatibility(dev_data, primaryBuffer, primaryPassCI, secondaryBuffer, secondaryPassCI);
+    }
+    primary_rp->execute_compatible_render_passes.insert(secondary_rp);
+    secondary_rp->execute_compatible_render_passes.insert(primary_rp);
+    return false;
+}
+
 static bool validateFramebuffer(layer_data *dev_data, VkCommandBuffer primaryBuffer, const GLOBAL_CB_NODE *pCB,
                                 VkCommandBuffer secondaryBuffer, const GLOBAL_CB_NODE *pSubCB) {
     bool skip = false;
@@ -7838,8 +8343,8 @@ static bool validateFramebuffer(layer_data *dev_data, VkCommandBuffer primaryBuf
         }
         auto cb_renderpass = GetRenderPassState(dev_data, pSubCB->beginInfo.pInheritanceInfo->renderPass);
         if (cb_renderpass->renderPass != fb->createInfo.renderPass) {
-            skip |= validateRenderPassCompatibility(dev_data, secondaryBuffer, fb->renderPassCreateInfo.ptr(), secondaryBuffer,
-                                                    cb_renderpass->createInfo.ptr());
+            skip |= validateRenderPassStateCompatibility(dev_data, secondaryBuffer, fb->rp_state.get(), secondaryBuffer,
+                                                         cb_renderpass);
         }
     }
     return skip;
@@ -7929,9 +8434,8 @@ VKAPI_ATTR void VKAPI_CALL CmdExecuteCommands(VkCommandBuffer commandBuffer, uin
                     } else {
                         // Make sure render pass is compatible with parent command buffer pass if has continue
                         if (pCB->activeRenderPass->renderPass != secondary_rp_state->renderPass) {
-                            skip |=
-                                validateRenderPassCompatibility(dev_data, commandBuffer, pCB->activeRenderPass->createInfo.ptr(),
-                                                                pCommandBuffers[i], secondary_rp_state->createInfo.ptr());
+                            skip |= validateRenderPassStateCompatibility(dev_data, commandBuffer, pCB->activeRenderPass,
+                                                                         pCommandBuffers[i], secondary_rp_state);
                         }
                         //  If framebuffer for secondary CB is not NULL, then it must match active FB from primaryCB
                         skip |= validateFramebuffer(dev_data, commandBuffer, pCB, pCommandBuffers[i], pSubCB);
@@ -7939,8 +8443,7 @@ VKAPI_ATTR void VKAPI_CALL CmdExecuteCommands(VkCommandBuffer commandBuffer, uin
                     string errorString = "";
                     // secondaryCB must have been created w/ RP compatible w/ primaryCB active renderpass
                     if ((pCB->activeRenderPass->renderPass != secondary_rp_state->renderPass) &&
-                        !verify_renderpass_compatibility(dev_data, pCB->activeRenderPass->createInfo.ptr(),
-                                                         secondary_rp_state->createInfo.ptr(), errorString)) {
+                        !verifyRenderPassStateCompatibility(dev_data, pCB->activeRenderPass, secondary_rp_state, errorString)) {
                         skip |= log_msg(
                             dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_COMMAND_BUFFER_EXT,
                             HandleToUint64(pCommandBuffers[i]), __LINE__, DRAWSTATE_RENDERPASS_INCOMPATIBLE, "DS",
@@ -7988,7 +8491,7 @@ VKAPI_ATTR void VKAPI_CALL CmdExecuteCommands(VkCommandBuffer commandBuffer, uin
             }
             // TODO: separate validate from update! This is very tangled.
             // Propagate layout transitions to the primary cmd buffer
-            for (auto ilm_entry : pSubCB->imageLayoutMap) {
+            for (auto const &ilm_entry : pSubCB->imageLayoutMap) {
                 SetLayout(dev_data, pCB, ilm_entry.first, ilm_entry.second);
             }
             pSubCB->primaryCommandBuffer = pCB->commandBuffer;
@@ -8104,7 +8607,22 @@ static bool ValidateAndCopyNoncoherentMemoryToDriver(layer_data *dev_data, uint3
     for (uint32_t i = 0; i < mem_range_count; ++i) {
         auto mem_info = GetMemObjInfo(dev_data, mem_ranges[i].memory);
         if (mem_info) {
-            if (mem_info->shadow_copy) {
+            if (mem_info->guarded_mapping) {
+                bool underflow, overflow;
+                mem_info->guarded_mapping->Flush(&underflow, &overflow);
+                if (underflow) {
+                    skip |= log_msg(
+                        dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_DEVICE_MEMORY_EXT,
+                        HandleToUint64(mem_ranges[i].memory), __LINE__, MEMTRACK_INVALID_MAP, "MEM",
+                        "Memory underflow was detected on mem obj 0x%" PRIxLEAST64, HandleToUint64(mem_ranges[i].memory));
+                }
+                if (overflow) {
+                    skip |= log_msg(
+                        dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_DEVICE_MEMORY_EXT,
+                        HandleToUint64(mem_ranges[i].memory), __LINE__, MEMTRACK_INVALID_MAP, "MEM",
+                        "Memory overflow was detected on mem obj 0x%" PRIxLEAST64, HandleToUint64(mem_ranges[i].memory));
+                }
+            } else if (mem_info->shadow_copy) {
                 VkDeviceSize size = (mem_info->mem_range.size != VK_WHOLE_SIZE)
                                         ? mem_info->mem_range.size
                                         : (mem_info->alloc_info.allocationSize - mem_info->mem_range.offset);
@@ -8135,7 +8653,9 @@ static bool ValidateAndCopyNoncoherentMemoryToDriver(layer_data *dev_data, uint3
 static void CopyNoncoherentMemoryFromDriver(layer_data *dev_data, uint32_t mem_range_count, const VkMappedMemoryRange *mem_ranges) {
     for (uint32_t i = 0; i < mem_range_count; ++i) {
         auto mem_info = GetMemObjInfo(dev_data, mem_ranges[i].memory);
-        if (mem_info && mem_info->shadow_copy) {
+        if (mem_info && mem_info->guarded_mapping) {
+            mem_info->guarded_mapping->Invalidate();
+        } else if (mem_info && mem_info->shadow_copy) {
             VkDeviceSize size = (mem_info->mem_range.size != VK_WHOLE_SIZE)
                                     ? mem_info->mem_range.size
                                     : (mem_info->alloc_info.allocationSize - mem_ranges[i].offset);
@@ -8293,6 +8813,7 @@ static void PostCallRecordBindImageMemory(layer_data *dev_data, VkImage image, I
         image_state->binding.mem = mem;
         image_state->binding.offset = memoryOffset;
         image_state->binding.size = image_state->requirements.size;
+        image_state->dependency_generation = ++dev_data->dependency_generation;
     }
 }
 
@@ -8394,7 +8915,8 @@ VKAPI_ATTR VkResult VKAPI_CALL QueueBindSparse(VkQueue queue, uint32_t bindInfoC
             if (pSemaphore) {
                 if (pSemaphore->signaled) {
                     if (pSemaphore->signaler.first != VK_NULL_HANDLE) {
-                        semaphore_waits.push_back({semaphore, pSemaphore->signaler.first, pSemaphore->signaler.second});
+                        semaphore_waits.push_back({semaphore, pSemaphore->signaler.first, pSemaphore->signaler.second,
+                                                   GetQueueState(dev_data, pSemaphore->signaler.first)});
                         pSemaphore->in_use.fetch_add(1);
                     }
                     pSemaphore->signaler.first = VK_NULL_HANDLE;
@@ -8853,6 +9375,7 @@ static void PostCallRecordGetSwapchainImagesKHR(layer_data *device_data, SWAPCHA
             auto &image_state = device_data->imageMap[pSwapchainImages[i]];
             image_state->valid = false;
             image_state->binding.mem = MEMTRACKER_SWAP_CHAIN_IMAGE_KEY;
+            image_state->dependency_generation = ++device_data->dependency_generation;
             swapchain_state->images[i] = pSwapchainImages[i];
             ImageSubresourcePair subpair = {pSwapchainImages[i], false, VkImageSubresource()};
             device_data->imageSubresourceMap[pSwapchainImages[i]].push_back(subpair);
@@ -9071,6 +9594,8 @@ VKAPI_ATTR VkResult VKAPI_CALL QueuePresentKHR(VkQueue queue, const VkPresentInf
         // Note: even though presentation is directed to a queue, there is no
         // direct ordering between QP and subsequent work, so QP (and its
         // semaphore waits) /never/ participate in any completion proof.
+
+        AdvanceSampledFrame(dev_data);
     }
 
     return result;
@@ -9993,6 +10518,7 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateDescriptorUpdateTemplateKHR(VkDevice device
         safe_VkDescriptorUpdateTemplateCreateInfoKHR *local_create_info =
             new safe_VkDescriptorUpdateTemplateCreateInfoKHR(pCreateInfo);
         std::unique_ptr<TEMPLATE_STATE> template_state(new TEMPLATE_STATE(*pDescriptorUpdateTemplate, local_create_info));
+        cvdescriptorset::DecodeUpdateTemplate(dev_data, template_state.get());
         dev_data->desc_template_map[*pDescriptorUpdateTemplate] = std::move(template_state);
     }
     return result;
@@ -10170,6 +10696,14 @@ VKAPI_ATTR void VKAPI_CALL CmdDebugMarkerInsertEXT(VkCommandBuffer commandBuffer
     device_data->dispatch_table.CmdDebugMarkerInsertEXT(commandBuffer, pMarkerInfo);
 }
 
+VKAPI_ATTR VkResult VKAPI_CALL GetLayerStateStatsLUNARG(VkDevice device, uint32_t *pStatCount, VkLayerStateStatLUNARG *pStats) {
+    layer_data *dev_data = GetLayerDataPtr(get_dispatch_key(device), layer_data_map);
+    unique_lock_t lock(global_lock);
+    StateStats stats = GatherStateStats(dev_data);
+    lock.unlock();
+    return stats.Report(device, dev_data->dispatch_table.GetDeviceProcAddr, pStatCount, pStats);
+}
+
 VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL GetDeviceProcAddr(VkDevice device, const char *funcName);
 VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL GetPhysicalDeviceProcAddr(VkInstance instance, const char *funcName);
 VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL GetInstanceProcAddr(VkInstance instance, const char *funcName);
@@ -10357,6 +10891,7 @@ static const std::unordered_map<std::string, void*> name_to_funcptr_map = {
     {"vkGetPhysicalDeviceDisplayPlanePropertiesKHR", (void*)GetPhysicalDeviceDisplayPlanePropertiesKHR},
     {"GetDisplayPlaneSupportedDisplaysKHR", (void*)GetDisplayPlaneSupportedDisplaysKHR},
     {"GetDisplayPlaneCapabilitiesKHR", (void*)GetDisplayPlaneCapabilitiesKHR},
+    {VK_LUNARG_STATE_STATS_FUNCTION_NAME, (void*)GetLayerStateStatsLUNARG},
 };
 
 VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL GetDeviceProcAddr(VkDevice device, const char *funcName) {
@@ -54,6 +54,7 @@
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -129,17 +130,50 @@ class QUEUE_STATE {
     VkQueue queue;
     uint32_t queueFamilyIndex;
     std::unordered_map<VkEvent, VkPipelineStageFlags> eventToStageMap;
-    std::unordered_map<QueryObject, bool> queryToStateMap;  // 0 is unavailable, 1 is available
+    QueryStateMap queryToStateMap;
 
     uint64_t seq;
     std::deque<CB_SUBMISSION> submissions;
+
+    // Submissions below verified_seq have already been through VerifyQueueStateToSeq. The targets are scratch space for
+    // walking semaphore edges between queues and never exceed verified_seq or seq between calls.
+    uint64_t verified_seq = 0;
+    uint64_t verify_target = 0;
+    uint64_t retire_target = 0;
 };
 
 class QUERY_POOL_NODE : public BASE_NODE {
    public:
     VkQueryPoolCreateInfo createInfo;
+    QueryStateBits query_state;  // Device-level state of the pool's queries, as of the last retired submission
+};
+
+// Arguments to vkGetPhysicalDeviceImageFormatProperties, used as the key for memoizing its results
+struct ImageFormatQuery {
+    VkFormat format;
+    VkImageType type;
+    VkImageTiling tiling;
+    VkImageUsageFlags usage;
+    VkImageCreateFlags flags;
 };
 
+inline bool operator==(ImageFormatQuery const &lhs, ImageFormatQuery const &rhs) {
+    return (lhs.format == rhs.format && lhs.type == rhs.type && lhs.tiling == rhs.tiling && lhs.usage == rhs.usage &&
+            lhs.flags == rhs.flags);
+}
+
+namespace std {
+template <>
+struct hash<ImageFormatQuery> {
+    size_t operator()(ImageFormatQuery const &query) const throw() {
+        uint64_t key = (static_cast<uint64_t>(query.format) << 32) ^ (static_cast<uint64_t>(query.usage) << 8) ^
+                       (static_cast<uint64_t>(query.flags) << 20) ^ (static_cast<uint64_t>(query.tiling) << 4) ^
+                       static_cast<uint64_t>(query.type);
+        return hash<uint64_t>()(key);
+    }
+};
+}
+
 struct PHYSICAL_DEVICE_STATE {
     // Track the call state and array sizes for various query functions
     CALL_STATE vkGetPhysicalDeviceQueueFamilyPropertiesState = UNCALLED;
@@ -158,6 +192,15 @@ struct PHYSICAL_DEVICE_STATE {
     std::vector<VkPresentModeKHR> present_modes;
     std::vector<VkSurfaceFormatKHR> surface_formats;
     uint32_t display_plane_property_count = 0;
+    // Format queries made during validation, filled in on first use and shared by every device created from this
+    // physical device. Core formats index format_properties directly; extension formats live in the map. Validation
+    // that queries them can run without global_lock, so they are only touched under format_properties_lock. Entries
+    // never change once filled in, so pointers to them can be read after it is released.
+    std::mutex format_properties_lock;
+    std::vector<VkFormatProperties> format_properties;
+    std::vector<bool> format_properties_cached;
+    std::unordered_map<VkFormat, VkFormatProperties, std::hash<int>> extension_format_properties;
+    std::unordered_map<ImageFormatQuery, VkImageFormatProperties> image_format_properties;
 };
 
 struct GpuQueue {
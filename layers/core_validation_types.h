@@ -52,6 +52,8 @@
 #include "vk_layer_logging.h"
 #include "vk_object_types.h"
 #include "vk_extension_helper.h"
+#include "vk_layer_flat_map.h"
+#include "memory_guard.h"
 #include <atomic>
 #include <functional>
 #include <map>
@@ -69,6 +71,7 @@ class DescriptorSet;
 };
 
 struct GLOBAL_CB_NODE;
+class QUEUE_STATE;
 
 enum CALL_STATE {
     UNCALLED,       // Function has not been called
@@ -262,8 +265,15 @@ class IMAGE_STATE : public BINDABLE {
     bool acquired;  // If this is a swapchain image, has it been acquired by the app.
     bool shared_presentable;  // True for a front-buffered swapchain image
     bool layout_locked;       // A front-buffered image that has been presented can never have layout transitioned
+    uint64_t dependency_generation;  // Restamped whenever binding changes; see RENDER_PASS_DEPENDENCY_ANALYSIS
     IMAGE_STATE(VkImage img, const VkImageCreateInfo *pCreateInfo)
-        : image(img), createInfo(*pCreateInfo), valid(false), acquired(false), shared_presentable(false), layout_locked(false) {
+        : image(img),
+          createInfo(*pCreateInfo),
+          valid(false),
+          acquired(false),
+          shared_presentable(false),
+          layout_locked(false),
+          dependency_generation(0) {
         if ((createInfo.sharingMode == VK_SHARING_MODE_CONCURRENT) && (createInfo.queueFamilyIndexCount > 0)) {
             uint32_t *pQueueFamilyIndices = new uint32_t[createInfo.queueFamilyIndexCount];
             for (uint32_t i = 0; i < createInfo.queueFamilyIndexCount; i++) {
@@ -291,7 +301,9 @@ class IMAGE_VIEW_STATE : public BASE_NODE {
    public:
     VkImageView image_view;
     VkImageViewCreateInfo create_info;
-    IMAGE_VIEW_STATE(VkImageView iv, const VkImageViewCreateInfo *ci) : image_view(iv), create_info(*ci){};
+    uint64_t dependency_generation;  // Stamped at creation; see RENDER_PASS_DEPENDENCY_ANALYSIS
+    IMAGE_VIEW_STATE(VkImageView iv, const VkImageViewCreateInfo *ci)
+        : image_view(iv), create_info(*ci), dependency_generation(0){};
     IMAGE_VIEW_STATE(const IMAGE_VIEW_STATE &rh_obj) = delete;
 };
 
@@ -331,6 +343,7 @@ struct DEVICE_MEM_INFO : public BASE_NODE {
     uint64_t shadow_pad_size;  // Size of the guard-band data before and after actual data. It MUST be a
                                // multiple of limits.minMemoryMapAlignment
     void *p_driver_data;       // Pointer to application's actual memory
+    std::unique_ptr<GuardedMapping> guarded_mapping;  // Used in place of shadow_copy when page guards are enabled
 
     DEVICE_MEM_INFO(void *disp_object, const VkDeviceMemory in_mem, const VkMemoryAllocateInfo *p_alloc_info)
         : object(disp_object),
@@ -380,8 +393,19 @@ struct RENDER_PASS_STATE : public BASE_NODE {
     std::vector<bool> hasSelfDependency;
     std::vector<DAGNode> subpassToNode;
     std::unordered_map<uint32_t, bool> attachment_first_read;
+    // Render passes already found compatible with this one, so the attachment by attachment comparison is made once per
+    //  pair rather than at every draw or vkCmdExecuteCommands(). Only successes are remembered; a failure is reported from
+    //  a full comparison. Compatibility is symmetric, so each pair is recorded on both states, and a state removes itself
+    //  from its partners when it's destroyed.
+    mutable std::unordered_set<RENDER_PASS_STATE const *> compatible_render_passes;
+    // As above, for the stricter per-attachment checks that vkCmdExecuteCommands() makes of a secondary's render pass
+    mutable std::unordered_set<RENDER_PASS_STATE const *> execute_compatible_render_passes;
 
     RENDER_PASS_STATE(VkRenderPassCreateInfo const *pCreateInfo) : createInfo(pCreateInfo) {}
+    ~RENDER_PASS_STATE() {
+        for (auto partner : compatible_render_passes) partner->compatible_render_passes.erase(this);
+        for (auto partner : execute_compatible_render_passes) partner->execute_compatible_render_passes.erase(this);
+    }
 };
 
 // Cmd Buffer Tracking
@@ -467,6 +491,11 @@ enum CBStatusFlagBits {
 struct TEMPLATE_STATE {
     VkDescriptorUpdateTemplateKHR desc_update_template;
     safe_VkDescriptorUpdateTemplateCreateInfoKHR create_info;
+    // The template entries decoded against the set layout into write updates, filled in by
+    //  cvdescriptorset::DecodeUpdateTemplate(). dstSet and the info pointers are left null; decoded_offsets[i] is the
+    //  offset into pData of the first descriptor of decoded_writes[i].
+    std::vector<VkWriteDescriptorSet> decoded_writes;
+    std::vector<size_t> decoded_offsets;
 
     TEMPLATE_STATE(VkDescriptorUpdateTemplateKHR update_template, safe_VkDescriptorUpdateTemplateCreateInfoKHR *pCreateInfo)
         : desc_update_template(update_template), create_info(*pCreateInfo) {}
@@ -490,6 +519,85 @@ struct hash<QueryObject> {
     }
 };
 }
+
+// Availability of the queries in one pool, as two bits per query: whether its state is known and, if so, whether it's
+//  available. Setting the state of a range of queries, or merging one set of states into another, works a word at a time.
+class QueryStateBits {
+   public:
+    void Set(uint32_t first, uint32_t count, bool available) {
+        if (!count) return;
+        const uint32_t last = first + count - 1;
+        if (known_.size() <= last / 64) {
+            known_.resize(last / 64 + 1, 0);
+            available_.resize(last / 64 + 1, 0);
+        }
+        for (uint32_t word = first / 64; word <= last / 64; ++word) {
+            uint64_t mask = ~0ull;
+            if (word == first / 64) mask &= ~0ull << (first % 64);
+            if (word == last / 64) mask &= ~0ull >> (63 - last % 64);
+            known_[word] |= mask;
+            available_[word] = available ? (available_[word] | mask) : (available_[word] & ~mask);
+        }
+    }
+    // Returns false if the query's state isn't known, otherwise sets *available
+    bool Get(uint32_t index, bool *available) const {
+        if (index / 64 >= known_.size() || !((known_[index / 64] >> (index % 64)) & 1)) return false;
+        *available = (available_[index / 64] >> (index % 64)) & 1;
+        return true;
+    }
+    // Takes every state known in other, leaving the rest as they were
+    void Merge(QueryStateBits const &other) {
+        if (known_.size() < other.known_.size()) {
+            known_.resize(other.known_.size(), 0);
+            available_.resize(other.known_.size(), 0);
+        }
+        for (size_t word = 0; word < other.known_.size(); ++word) {
+            known_[word] |= other.known_[word];
+            available_[word] = (available_[word] & ~other.known_[word]) | (other.available_[word] & other.known_[word]);
+        }
+    }
+    size_t HeapBytes() const { return (known_.capacity() + available_.capacity()) * sizeof(uint64_t); }
+
+   private:
+    std::vector<uint64_t> known_;
+    std::vector<uint64_t> available_;
+};
+
+// Query states of a command buffer or queue, by pool
+class QueryStateMap {
+   public:
+    typedef FlatHashMap<VkQueryPool, QueryStateBits>::const_iterator const_iterator;
+
+    void Set(VkQueryPool pool, uint32_t first, uint32_t count, bool available) { pools_[pool].Set(first, count, available); }
+    bool Get(QueryObject query, bool *available) const {
+        auto pool = pools_.find(query.pool);
+        return pool != pools_.end() && pool->second.Get(query.index, available);
+    }
+    QueryStateBits const *GetPool(VkQueryPool pool) const {
+        auto it = pools_.find(pool);
+        return it == pools_.end() ? nullptr : &it->second;
+    }
+    const_iterator begin() const { return pools_.begin(); }
+    const_iterator end() const { return pools_.end(); }
+    void erase(VkQueryPool pool) { pools_.erase(pool); }
+    void clear() { pools_.clear(); }
+    size_t HeapBytes() const {
+        size_t bytes = pools_.capacity() * (sizeof(FlatHashMap<VkQueryPool, QueryStateBits>::value_type) + 1);
+        for (auto const &pool : pools_) bytes += pool.second.HeapBytes();
+        return bytes;
+    }
+
+   private:
+    FlatHashMap<VkQueryPool, QueryStateBits> pools_;
+};
+
+// The events a command buffer had waited on when it reset a range of queries
+struct QUERY_RESET_EVENTS {
+    VkQueryPool pool;
+    uint32_t first;
+    uint32_t count;
+    std::unordered_set<VkEvent> events;
+};
 struct DRAW_DATA {
     std::vector<VkBuffer> buffers;
 };
@@ -511,14 +619,15 @@ namespace std {
 template <>
 struct hash<ImageSubresourcePair> {
     size_t operator()(ImageSubresourcePair img) const throw() {
-        size_t hashVal = hash<uint64_t>()(reinterpret_cast<uint64_t &>(img.image));
-        hashVal ^= hash<bool>()(img.hasSubresource);
+        uint64_t key = reinterpret_cast<uint64_t &>(img.image);
         if (img.hasSubresource) {
-            hashVal ^= hash<uint32_t>()(reinterpret_cast<uint32_t &>(img.subresource.aspectMask));
-            hashVal ^= hash<uint32_t>()(img.subresource.mipLevel);
-            hashVal ^= hash<uint32_t>()(img.subresource.arrayLayer);
+            // XORing the fields together put every (mip, layer) pair with the same sum in one bucket, so scramble the image
+            // handle and add the subresource to it, packed so that the fields can't cancel each other out
+            uint64_t sub = (static_cast<uint64_t>(img.subresource.aspectMask) << 48) |
+                           (static_cast<uint64_t>(img.subresource.mipLevel) << 32) | img.subresource.arrayLayer;
+            key = key * 0x9E3779B97F4A7C15ull + sub;
         }
-        return hashVal;
+        return hash<uint64_t>()(key);
     }
 };
 }
@@ -542,7 +651,8 @@ class PIPELINE_STATE : public BASE_NODE {
    public:
     VkPipeline pipeline;
     safe_VkGraphicsPipelineCreateInfo graphicsPipelineCI;
-    safe_VkComputePipelineCreateInfo computePipelineCI;
+    // Only allocated for compute pipelines
+    std::unique_ptr<safe_VkComputePipelineCreateInfo const> computePipelineCI;
     // Flag of which shader stages are active for this pipeline
     uint32_t active_shaders;
     uint32_t duplicate_shaders;
@@ -552,29 +662,27 @@ class PIPELINE_STATE : public BASE_NODE {
     std::vector<VkVertexInputBindingDescription> vertexBindingDescriptions;
     std::vector<VkPipelineColorBlendAttachmentState> attachments;
     bool blendConstantsEnabled;  // Blend constants enabled for any attachments
-    // Store RPCI b/c renderPass may be destroyed after Pipeline creation
-    safe_VkRenderPassCreateInfo render_pass_ci;
-    PIPELINE_LAYOUT_NODE pipeline_layout;
+    // Render pass and layout state are shared with every other pipeline and framebuffer that uses them, and the references
+    // keep them alive after the VkRenderPass or VkPipelineLayout is destroyed. Graphics pipelines only for rp_state.
+    std::shared_ptr<RENDER_PASS_STATE const> rp_state;
+    std::shared_ptr<PIPELINE_LAYOUT_NODE const> pipeline_layout;
 
     // Default constructor
     PIPELINE_STATE()
         : pipeline{},
           graphicsPipelineCI{},
-          computePipelineCI{},
+          computePipelineCI(),
           active_shaders(0),
           duplicate_shaders(0),
           active_slots(),
           vertexBindingDescriptions(),
           attachments(),
           blendConstantsEnabled(false),
-          render_pass_ci(),
+          rp_state(),
           pipeline_layout() {}
 
     void initGraphicsPipeline(const VkGraphicsPipelineCreateInfo *pCreateInfo) {
         graphicsPipelineCI.initialize(pCreateInfo);
-        // Make sure compute pipeline is null
-        VkComputePipelineCreateInfo emptyComputeCI = {};
-        computePipelineCI.initialize(&emptyComputeCI);
         for (uint32_t i = 0; i < pCreateInfo->stageCount; i++) {
             const VkPipelineShaderStageCreateInfo *pPSSCI = &pCreateInfo->pStages[i];
             this->duplicate_shaders |= this->active_shaders & pPSSCI->stage;
@@ -596,11 +704,11 @@ class PIPELINE_STATE : public BASE_NODE {
         }
     }
     void initComputePipeline(const VkComputePipelineCreateInfo *pCreateInfo) {
-        computePipelineCI.initialize(pCreateInfo);
+        computePipelineCI.reset(new safe_VkComputePipelineCreateInfo(pCreateInfo));
         // Make sure gfx pipeline is null
         VkGraphicsPipelineCreateInfo emptyGraphicsCI = {};
         graphicsPipelineCI.initialize(&emptyGraphicsCI);
-        switch (computePipelineCI.stage.stage) {
+        switch (computePipelineCI->stage.stage) {
             case VK_SHADER_STAGE_COMPUTE_BIT:
                 this->active_shaders |= VK_SHADER_STAGE_COMPUTE_BIT;
                 break;
@@ -636,6 +744,7 @@ struct GLOBAL_CB_NODE : public BASE_NODE {
     VkCommandBufferInheritanceInfo inheritanceInfo;
     VkDevice device;                     // device this CB belongs to
     bool hasDrawCmd;
+    bool validation_sampled;             // This recording was selected for full validation (see VALIDATION_SAMPLING)
     CB_STATE state;                      // Track cmd buffer update state
     uint64_t submitCount;                // Number of times CB has been submitted
     CBStatusFlags status;                // Track status of various bindings on cmd buffer
@@ -661,8 +770,8 @@ struct GLOBAL_CB_NODE : public BASE_NODE {
     std::unordered_set<VkEvent> waitedEvents;
     std::vector<VkEvent> writeEventsBeforeWait;
     std::vector<VkEvent> events;
-    std::unordered_map<QueryObject, std::unordered_set<VkEvent>> waitedEventsBeforeQueryReset;
-    std::unordered_map<QueryObject, bool> queryToStateMap;  // 0 is unavailable, 1 is available
+    std::vector<QUERY_RESET_EVENTS> waitedEventsBeforeQueryReset;  // One entry per vkCmdResetQueryPool(), in recording order
+    QueryStateMap queryToStateMap;
     std::unordered_set<QueryObject> activeQueries;
     std::unordered_set<QueryObject> startedQueries;
     std::unordered_map<ImageSubresourcePair, IMAGE_CMD_BUF_LAYOUT_NODE> imageLayoutMap;
@@ -687,6 +796,7 @@ struct SEMAPHORE_WAIT {
     VkSemaphore semaphore;
     VkQueue queue;
     uint64_t seq;
+    QUEUE_STATE *queue_state;  // State for queue, resolved at submit time
 };
 
 struct CB_SUBMISSION {
@@ -743,22 +853,67 @@ struct CHECK_DISABLED {
     void SetAll(bool value) { std::fill(&command_buffer_state, &shader_validation + 1, value); }
 };
 
+// VALIDATION_SAMPLING holds the lunarg_core_validation.sampling_* settings used for long soak runs. When enabled, only a
+// sampled subset of work gets the expensive draw-time and submit-time checks. State tracking is never sampled, so object
+// lifetimes, image layouts and memory bindings stay exact for the work that is validated.
+struct VALIDATION_SAMPLING {
+    bool enabled = false;
+    uint32_t command_buffer_interval = 1;  // Fully validate every Nth command buffer recording
+    uint32_t frame_interval = 1;           // Fully validate every Nth frame, frames being delimited by vkQueuePresentKHR
+    uint64_t draw_threshold = 1ull << 32;  // Fully validate a draw when a 32-bit random value falls below this
+};
+
+// Per-device counters driving VALIDATION_SAMPLING, protected by the global lock
+struct VALIDATION_SAMPLING_STATE {
+    uint64_t command_buffer_count = 0;
+    uint64_t frame_count = 0;
+    bool frame_sampled = true;
+    uint32_t draw_rng = 0x9E3779B9u;
+};
+
 struct MT_FB_ATTACHMENT_INFO {
     IMAGE_VIEW_STATE *view_state;
     VkImage image;
 };
 
+// A problem found by the attachment dependency analysis that vkCmdBeginRenderPass() makes of a framebuffer and render pass
+struct RENDER_PASS_DEPENDENCY_ERROR {
+    enum Kind {
+        ATTACHMENT_ALIASED,  // Attachment first aliases attachment second without VK_ATTACHMENT_DESCRIPTION_MAY_ALIAS_BIT
+        COLOR_AND_DEPTH,     // Attachment first is both a color and the depth attachment of subpass second
+        MISSING_DEPENDENCY,  // Subpasses first and second share an attachment but have no dependency
+        NOT_PRESERVED,       // Attachment first must be preserved in subpass second
+    } kind;
+    uint32_t first;
+    uint32_t second;
+};
+
+// Dependency analysis of a framebuffer with one render pass. Each attachment view, and the image it views, carries a
+//  dependency_generation stamp from a device-wide counter: a view is stamped when it is created, and an image when it is
+//  created and whenever its memory binding changes. A destroyed object counts as 0. The analysis is only valid while the
+//  stamps it was made with, two per attachment in attachment_generations, still match. Holding rp_state keeps a destroyed
+//  render pass's state from being reused by a new one while the analysis refers to it.
+struct RENDER_PASS_DEPENDENCY_ANALYSIS {
+    std::shared_ptr<RENDER_PASS_STATE const> rp_state;
+    std::vector<uint64_t> attachment_generations;
+    std::vector<RENDER_PASS_DEPENDENCY_ERROR> errors;
+};
+
 class FRAMEBUFFER_STATE : public BASE_NODE {
 public:
     VkFramebuffer framebuffer;
     safe_VkFramebufferCreateInfo createInfo;
-    safe_VkRenderPassCreateInfo renderPassCreateInfo;
+    std::shared_ptr<RENDER_PASS_STATE const> rp_state;
     std::vector<MT_FB_ATTACHMENT_INFO> attachments;
-    FRAMEBUFFER_STATE(VkFramebuffer fb, const VkFramebufferCreateInfo *pCreateInfo, const VkRenderPassCreateInfo *pRPCI)
-        : framebuffer(fb), createInfo(pCreateInfo), renderPassCreateInfo(pRPCI) {};
+    // One entry per render pass this framebuffer has been begun with
+    std::vector<RENDER_PASS_DEPENDENCY_ANALYSIS> dependency_analyses;
+    FRAMEBUFFER_STATE(VkFramebuffer fb, const VkFramebufferCreateInfo *pCreateInfo,
+                      std::shared_ptr<RENDER_PASS_STATE const> const &rpstate)
+        : framebuffer(fb), createInfo(pCreateInfo), rp_state(rpstate){};
 };
 
 struct shader_module;
+class ShaderValidationPool;
 struct DeviceExtensions;
 
 // Fwd declarations of layer_data and helpers to look-up/validate state from layer_data maps
@@ -822,13 +977,14 @@ const VkImageFormatProperties *GetImageFormatProperties(core_validation::layer_d
 const debug_report_data *GetReportData(const layer_data *);
 const VkPhysicalDeviceProperties *GetPhysicalDeviceProperties(layer_data *);
 const CHECK_DISABLED *GetDisables(layer_data *);
-std::unordered_map<VkImage, std::unique_ptr<IMAGE_STATE>> *GetImageMap(core_validation::layer_data *);
+ShaderValidationPool *GetShaderValidationPool(layer_data *);
+FlatHashMap<VkImage, std::unique_ptr<IMAGE_STATE>> *GetImageMap(core_validation::layer_data *);
 std::unordered_map<VkImage, std::vector<ImageSubresourcePair>> *GetImageSubresourceMap(layer_data *);
 std::unordered_map<ImageSubresourcePair, IMAGE_LAYOUT_NODE> *GetImageLayoutMap(layer_data *);
 std::unordered_map<ImageSubresourcePair, IMAGE_LAYOUT_NODE> const *GetImageLayoutMap(layer_data const *);
-std::unordered_map<VkBuffer, std::unique_ptr<BUFFER_STATE>> *GetBufferMap(layer_data *device_data);
-std::unordered_map<VkBufferView, std::unique_ptr<BUFFER_VIEW_STATE>> *GetBufferViewMap(layer_data *device_data);
-std::unordered_map<VkImageView, std::unique_ptr<IMAGE_VIEW_STATE>> *GetImageViewMap(layer_data *device_data);
+FlatHashMap<VkBuffer, std::unique_ptr<BUFFER_STATE>> *GetBufferMap(layer_data *device_data);
+FlatHashMap<VkBufferView, std::unique_ptr<BUFFER_VIEW_STATE>> *GetBufferViewMap(layer_data *device_data);
+FlatHashMap<VkImageView, std::unique_ptr<IMAGE_VIEW_STATE>> *GetImageViewMap(layer_data *device_data);
 const DeviceExtensions *GetDeviceExtensions(const layer_data *);
 }
 
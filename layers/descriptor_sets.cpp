@@ -25,6 +25,7 @@
 #include "vk_enum_string_helper.h"
 #include "vk_safe_struct.h"
 #include "buffer_validation.h"
+#include "vk_layer_state_stats.h"
 #include <sstream>
 #include <algorithm>
 
@@ -202,6 +203,15 @@ uint32_t cvdescriptorset::DescriptorSetLayout::GetNextValidBinding(const uint32_
     } while (GetDescriptorCountFromBinding(new_binding) == 0);
     return new_binding;
 }
+size_t cvdescriptorset::DescriptorSetLayout::GetStateBytes() const {
+    size_t bytes = sizeof(*this) + ContainerBytes(binding_to_index_map_) + ContainerBytes(binding_to_global_start_index_map_) +
+                   ContainerBytes(binding_to_global_end_index_map_) + ContainerBytes(binding_to_dynamic_array_idx_map_) +
+                   ContainerBytes(bindings_);
+    for (auto const &binding : bindings_) {
+        if (binding.pImmutableSamplers) bytes += binding.descriptorCount * sizeof(VkSampler);
+    }
+    return bytes;
+}
 // For given index, return ptr to ImmutableSampler array
 VkSampler const *cvdescriptorset::DescriptorSetLayout::GetImmutableSamplerPtrFromIndex(const uint32_t index) const {
     assert(index < bindings_.size());
@@ -592,6 +602,29 @@ uint32_t cvdescriptorset::DescriptorSet::GetStorageUpdates(const std::map<uint32
 void cvdescriptorset::DescriptorSet::InvalidateBoundCmdBuffers() {
     core_validation::invalidateCommandBuffers(device_data_, cb_bindings, {HandleToUint64(set_), kVulkanObjectTypeDescriptorSet});
 }
+size_t cvdescriptorset::DescriptorSet::GetStateBytes() const {
+    size_t bytes = sizeof(*this) + ContainerBytes(descriptors_) + ContainerBytes(cb_bindings);
+    for (auto const &descriptor : descriptors_) {
+        switch (descriptor->GetClass()) {
+            case PlainSampler:
+                bytes += sizeof(SamplerDescriptor);
+                break;
+            case ImageSampler:
+                bytes += sizeof(ImageSamplerDescriptor);
+                break;
+            case Image:
+                bytes += sizeof(ImageDescriptor);
+                break;
+            case TexelBuffer:
+                bytes += sizeof(TexelDescriptor);
+                break;
+            case GeneralBuffer:
+                bytes += sizeof(BufferDescriptor);
+                break;
+        }
+    }
+    return bytes;
+}
 // Perform write update in given update struct
 void cvdescriptorset::DescriptorSet::PerformWriteUpdate(const VkWriteDescriptorSet *update) {
     // Perform update on a per-binding basis as consecutive updates roll over to next binding
@@ -611,8 +644,6 @@ void cvdescriptorset::DescriptorSet::PerformWriteUpdate(const VkWriteDescriptorS
         binding_being_updated++;
     }
     if (update->descriptorCount) some_update_ = true;
-
-    InvalidateBoundCmdBuffers();
 }
 // Validate Copy update
 bool cvdescriptorset::DescriptorSet::ValidateCopyUpdate(const debug_report_data *report_data, const VkCopyDescriptorSet *update,
@@ -931,6 +962,49 @@ bool cvdescriptorset::ValidateImageUpdate(VkImageView image_view, VkImageLayout
     return true;
 }
 
+cvdescriptorset::WriteUpdateCache::WriteUpdateCache() {
+    memset(image_views_, 0, sizeof(image_views_));
+    memset(samplers_, 0, sizeof(samplers_));
+    memset(buffers_, 0, sizeof(buffers_));
+    memset(buffer_views_, 0, sizeof(buffer_views_));
+}
+
+bool cvdescriptorset::WriteUpdateCache::HasImageView(VkImageView image_view, VkImageLayout image_layout,
+                                                     VkDescriptorType type) const {
+    auto const &entry = image_views_[Slot(image_view)];
+    return entry.image_view == image_view && entry.image_layout == image_layout && entry.type == type;
+}
+
+void cvdescriptorset::WriteUpdateCache::AddImageView(VkImageView image_view, VkImageLayout image_layout, VkDescriptorType type) {
+    image_views_[Slot(image_view)] = {image_view, image_layout, type};
+}
+
+// Empty slots hold VK_NULL_HANDLE, which must not count as a sampler that passed validation
+bool cvdescriptorset::WriteUpdateCache::HasSampler(VkSampler sampler) const {
+    return sampler != VK_NULL_HANDLE && samplers_[Slot(sampler)] == sampler;
+}
+
+void cvdescriptorset::WriteUpdateCache::AddSampler(VkSampler sampler) { samplers_[Slot(sampler)] = sampler; }
+
+BUFFER_STATE const *cvdescriptorset::WriteUpdateCache::GetBuffer(VkBuffer buffer, VkDescriptorType type) const {
+    auto const &entry = buffers_[Slot(buffer)];
+    if (entry.buffer_state && entry.buffer_state->buffer == buffer && entry.type == type) return entry.buffer_state;
+    return nullptr;
+}
+
+void cvdescriptorset::WriteUpdateCache::AddBuffer(BUFFER_STATE const *buffer_state, VkDescriptorType type) {
+    buffers_[Slot(buffer_state->buffer)] = {buffer_state, type};
+}
+
+bool cvdescriptorset::WriteUpdateCache::HasBufferView(VkBufferView buffer_view, VkDescriptorType type) const {
+    auto const &entry = buffer_views_[Slot(buffer_view)];
+    return entry.buffer_view == buffer_view && entry.type == type;
+}
+
+void cvdescriptorset::WriteUpdateCache::AddBufferView(VkBufferView buffer_view, VkDescriptorType type) {
+    buffer_views_[Slot(buffer_view)] = {buffer_view, type};
+}
+
 void cvdescriptorset::SamplerDescriptor::WriteUpdate(const VkWriteDescriptorSet *update, const uint32_t index) {
     sampler_ = update->pImageInfo[index].sampler;
     updated = true;
@@ -1090,10 +1164,15 @@ bool cvdescriptorset::ValidateUpdateDescriptorSets(const debug_report_data *repo
                                                    uint32_t write_count, const VkWriteDescriptorSet *p_wds, uint32_t copy_count,
                                                    const VkCopyDescriptorSet *p_cds) {
     bool skip = false;
-    // Validate Write updates
+    WriteUpdateCache cache;
+    // Validate Write updates. Consecutive writes usually target the same set, so only look the set up when it changes
+    VkDescriptorSet dest_set = VK_NULL_HANDLE;
+    DescriptorSet *set_node = nullptr;
     for (uint32_t i = 0; i < write_count; i++) {
-        auto dest_set = p_wds[i].dstSet;
-        auto set_node = core_validation::GetSetNode(dev_data, dest_set);
+        if (i == 0 || p_wds[i].dstSet != dest_set) {
+            dest_set = p_wds[i].dstSet;
+            set_node = core_validation::GetSetNode(dev_data, dest_set);
+        }
         if (!set_node) {
             skip |=
                 log_msg(report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_DESCRIPTOR_SET_EXT,
@@ -1103,7 +1182,7 @@ bool cvdescriptorset::ValidateUpdateDescriptorSets(const debug_report_data *repo
         } else {
             UNIQUE_VALIDATION_ERROR_CODE error_code;
             std::string error_str;
-            if (!set_node->ValidateWriteUpdate(report_data, &p_wds[i], &error_code, &error_str)) {
+            if (!set_node->ValidateWriteUpdate(report_data, &p_wds[i], &cache, &error_code, &error_str)) {
                 skip |= log_msg(report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_DESCRIPTOR_SET_EXT,
                                 HandleToUint64(dest_set), __LINE__, error_code, "DS",
                                 "vkUpdateDescriptorsSets() failed write update validation for Descriptor Set 0x%" PRIx64
@@ -1142,15 +1221,27 @@ bool cvdescriptorset::ValidateUpdateDescriptorSets(const debug_report_data *repo
 void cvdescriptorset::PerformUpdateDescriptorSets(const layer_data *dev_data, uint32_t write_count,
                                                   const VkWriteDescriptorSet *p_wds, uint32_t copy_count,
                                                   const VkCopyDescriptorSet *p_cds) {
-    // Write updates first
+    // Write updates first. Each updated set invalidates its bound cmd buffers once, after all of its writes, rather than
+    //  once per write
+    std::vector<DescriptorSet *> updated_sets;
+    VkDescriptorSet dest_set = VK_NULL_HANDLE;
+    DescriptorSet *set_node = nullptr;
     uint32_t i = 0;
     for (i = 0; i < write_count; ++i) {
-        auto dest_set = p_wds[i].dstSet;
-        auto set_node = core_validation::GetSetNode(dev_data, dest_set);
+        if (i == 0 || p_wds[i].dstSet != dest_set) {
+            dest_set = p_wds[i].dstSet;
+            set_node = core_validation::GetSetNode(dev_data, dest_set);
+            if (set_node) updated_sets.push_back(set_node);
+        }
         if (set_node) {
             set_node->PerformWriteUpdate(&p_wds[i]);
         }
     }
+    std::sort(updated_sets.begin(), updated_sets.end());
+    updated_sets.erase(std::unique(updated_sets.begin(), updated_sets.end()), updated_sets.end());
+    for (auto updated_set : updated_sets) {
+        updated_set->InvalidateBoundCmdBuffers();
+    }
     // Now copy updates
     for (i = 0; i < copy_count; ++i) {
         auto dst_set = p_cds[i].dstSet;
@@ -1162,76 +1253,122 @@ void cvdescriptorset::PerformUpdateDescriptorSets(const layer_data *dev_data, ui
         }
     }
 }
-// This helper function carries out the state updates for descriptor updates peformed via update templates. It basically collects
-// data and leverages the PerformUpdateDescriptor helper functions to do this.
-void cvdescriptorset::PerformUpdateDescriptorSetsWithTemplateKHR(layer_data *device_data, VkDescriptorSet descriptorSet,
-                                                                 std::unique_ptr<TEMPLATE_STATE> const &template_state,
-                                                                 const void *pData) {
+// Decode the entries of an update template into write updates, resolving binding roll-over against the set layout once so
+//  that each vkUpdateDescriptorSetWithTemplateKHR() call only has to point the writes at its data. Descriptors of an entry
+//  that share a binding and are tightly packed in the data become a single write; any other descriptor gets its own.
+void cvdescriptorset::DecodeUpdateTemplate(const layer_data *device_data, TEMPLATE_STATE *template_state) {
     auto const &create_info = template_state->create_info;
-
-    // Create a vector of write structs
-    std::vector<VkWriteDescriptorSet> desc_writes;
+    template_state->decoded_writes.clear();
+    template_state->decoded_offsets.clear();
+    if (create_info.templateType != VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET_KHR) return;
     auto layout_obj = GetDescriptorSetLayout(device_data, create_info.descriptorSetLayout);
+    if (!layout_obj) return;
 
-    // Create a WriteDescriptorSet struct for each template update entry
     for (uint32_t i = 0; i < create_info.descriptorUpdateEntryCount; i++) {
-        auto binding_count = layout_obj->GetDescriptorCountFromBinding(create_info.pDescriptorUpdateEntries[i].dstBinding);
-        auto binding_being_updated = create_info.pDescriptorUpdateEntries[i].dstBinding;
-        auto dst_array_element = create_info.pDescriptorUpdateEntries[i].dstArrayElement;
+        auto const &entry = create_info.pDescriptorUpdateEntries[i];
+        auto binding_count = layout_obj->GetDescriptorCountFromBinding(entry.dstBinding);
+        auto binding_being_updated = entry.dstBinding;
+        auto dst_array_element = entry.dstArrayElement;
+
+        size_t element_size = 0;
+        switch (entry.descriptorType) {
+            case VK_DESCRIPTOR_TYPE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+            case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+                element_size = sizeof(VkDescriptorImageInfo);
+                break;
 
-        for (uint32_t j = 0; j < create_info.pDescriptorUpdateEntries[i].descriptorCount; j++) {
-            desc_writes.emplace_back();
-            auto &write_entry = desc_writes.back();
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+                element_size = sizeof(VkDescriptorBufferInfo);
+                break;
 
-            size_t offset = create_info.pDescriptorUpdateEntries[i].offset + j * create_info.pDescriptorUpdateEntries[i].stride;
-            char *update_entry = (char *)(pData) + offset;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+                element_size = sizeof(VkBufferView);
+                break;
+            default:
+                assert(0);
+                break;
+        }
+        bool packed = (entry.stride == element_size);
 
+        for (uint32_t j = 0; j < entry.descriptorCount; j++) {
             if (dst_array_element >= binding_count) {
                 dst_array_element = 0;
                 binding_being_updated = layout_obj->GetNextValidBinding(binding_being_updated);
+                binding_count = layout_obj->GetDescriptorCountFromBinding(binding_being_updated);
             }
-
-            write_entry.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            write_entry.pNext = NULL;
-            write_entry.dstSet = descriptorSet;
-            write_entry.dstBinding = binding_being_updated;
-            write_entry.dstArrayElement = dst_array_element;
-            write_entry.descriptorCount = 1;
-            write_entry.descriptorType = create_info.pDescriptorUpdateEntries[i].descriptorType;
-
-            switch (create_info.pDescriptorUpdateEntries[i].descriptorType) {
-                case VK_DESCRIPTOR_TYPE_SAMPLER:
-                case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
-                case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
-                case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
-                case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
-                    write_entry.pImageInfo = reinterpret_cast<VkDescriptorImageInfo *>(update_entry);
-                    break;
-
-                case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
-                case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
-                case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
-                case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
-                    write_entry.pBufferInfo = reinterpret_cast<VkDescriptorBufferInfo *>(update_entry);
-                    break;
-
-                case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
-                case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
-                    write_entry.pTexelBufferView = reinterpret_cast<VkBufferView *>(update_entry);
-                    break;
-                default:
-                    assert(0);
-                    break;
+            auto &writes = template_state->decoded_writes;
+            if (packed && j > 0 && dst_array_element > 0) {
+                // Extends the previous write, which covers the preceding descriptors of this binding
+                writes.back().descriptorCount++;
+            } else {
+                writes.emplace_back();
+                auto &write_entry = writes.back();
+                write_entry.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                write_entry.pNext = NULL;
+                write_entry.dstSet = VK_NULL_HANDLE;
+                write_entry.dstBinding = binding_being_updated;
+                write_entry.dstArrayElement = dst_array_element;
+                write_entry.descriptorCount = 1;
+                write_entry.descriptorType = entry.descriptorType;
+                write_entry.pImageInfo = NULL;
+                write_entry.pBufferInfo = NULL;
+                write_entry.pTexelBufferView = NULL;
+                template_state->decoded_offsets.push_back(entry.offset + j * entry.stride);
             }
             dst_array_element++;
         }
     }
+}
+// This helper function carries out the state updates for descriptor updates peformed via update templates. It points the
+// template's decoded writes at pData and leverages the PerformUpdateDescriptor helper functions to do this.
+void cvdescriptorset::PerformUpdateDescriptorSetsWithTemplateKHR(layer_data *device_data, VkDescriptorSet descriptorSet,
+                                                                 std::unique_ptr<TEMPLATE_STATE> const &template_state,
+                                                                 const void *pData) {
+    std::vector<VkWriteDescriptorSet> desc_writes(template_state->decoded_writes);
+    for (size_t i = 0; i < desc_writes.size(); i++) {
+        auto &write_entry = desc_writes[i];
+        char *update_entry = (char *)(pData) + template_state->decoded_offsets[i];
+        write_entry.dstSet = descriptorSet;
+
+        switch (write_entry.descriptorType) {
+            case VK_DESCRIPTOR_TYPE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+            case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+                write_entry.pImageInfo = reinterpret_cast<VkDescriptorImageInfo *>(update_entry);
+                break;
+
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+                write_entry.pBufferInfo = reinterpret_cast<VkDescriptorBufferInfo *>(update_entry);
+                break;
+
+            case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+                write_entry.pTexelBufferView = reinterpret_cast<VkBufferView *>(update_entry);
+                break;
+            default:
+                assert(0);
+                break;
+        }
+    }
     PerformUpdateDescriptorSets(device_data, static_cast<uint32_t>(desc_writes.size()), desc_writes.data(), 0, NULL);
 }
 // Validate the state for a given write update but don't actually perform the update
 //  If an error would occur for this update, return false and fill in details in error_msg string
 bool cvdescriptorset::DescriptorSet::ValidateWriteUpdate(const debug_report_data *report_data, const VkWriteDescriptorSet *update,
-                                                         UNIQUE_VALIDATION_ERROR_CODE *error_code, std::string *error_msg) {
+                                                         WriteUpdateCache *cache, UNIQUE_VALIDATION_ERROR_CODE *error_code,
+                                                         std::string *error_msg) {
     // Verify idle ds
     if (in_use.load()) {
         // TODO : Re-using Free Idle error code, need write update idle error code
@@ -1289,7 +1426,7 @@ bool cvdescriptorset::DescriptorSet::ValidateWriteUpdate(const debug_report_data
         return false;
     }
     // Update is within bounds and consistent so last step is to validate update contents
-    if (!VerifyWriteUpdateContents(update, start_idx, error_code, error_msg)) {
+    if (!VerifyWriteUpdateContents(update, start_idx, cache, error_code, error_msg)) {
         std::stringstream error_str;
         error_str << "Write update to descriptor in set " << set_ << " binding #" << update->dstBinding
                   << " failed with error message: " << error_msg->c_str();
@@ -1354,20 +1491,26 @@ bool cvdescriptorset::DescriptorSet::ValidateBufferUsage(BUFFER_STATE const *buf
 //  5. range and offset are within the device's limits
 // If there's an error, update the error_msg string with details and return false, else return true
 bool cvdescriptorset::DescriptorSet::ValidateBufferUpdate(VkDescriptorBufferInfo const *buffer_info, VkDescriptorType type,
-                                                          UNIQUE_VALIDATION_ERROR_CODE *error_code, std::string *error_msg) const {
-    // First make sure that buffer is valid
-    auto buffer_node = GetBufferState(device_data_, buffer_info->buffer);
-    // Any invalid buffer should already be caught by object_tracker
-    assert(buffer_node);
-    if (ValidateMemoryIsBoundToBuffer(device_data_, buffer_node, "vkUpdateDescriptorSets()", VALIDATION_ERROR_15c00294)) {
-        *error_code = VALIDATION_ERROR_15c00294;
-        *error_msg = "No memory bound to buffer.";
-        return false;
-    }
-    // Verify usage bits
-    if (!ValidateBufferUsage(buffer_node, type, error_code, error_msg)) {
-        // error_msg will have been updated by ValidateBufferUsage()
-        return false;
+                                                          WriteUpdateCache *cache, UNIQUE_VALIDATION_ERROR_CODE *error_code,
+                                                          std::string *error_msg) const {
+    // Memory binding and usage only depend on the buffer, so they're checked once per batch
+    auto buffer_node = cache->GetBuffer(buffer_info->buffer, type);
+    if (!buffer_node) {
+        // First make sure that buffer is valid
+        buffer_node = GetBufferState(device_data_, buffer_info->buffer);
+        // Any invalid buffer should already be caught by object_tracker
+        assert(buffer_node);
+        if (ValidateMemoryIsBoundToBuffer(device_data_, buffer_node, "vkUpdateDescriptorSets()", VALIDATION_ERROR_15c00294)) {
+            *error_code = VALIDATION_ERROR_15c00294;
+            *error_msg = "No memory bound to buffer.";
+            return false;
+        }
+        // Verify usage bits
+        if (!ValidateBufferUsage(buffer_node, type, error_code, error_msg)) {
+            // error_msg will have been updated by ValidateBufferUsage()
+            return false;
+        }
+        cache->AddBuffer(buffer_node, type);
     }
     // offset must be less than buffer size
     if (buffer_info->offset >= buffer_node->createInfo.size) {
@@ -1426,7 +1569,7 @@ bool cvdescriptorset::DescriptorSet::ValidateBufferUpdate(VkDescriptorBufferInfo
 
 // Verify that the contents of the update are ok, but don't perform actual update
 bool cvdescriptorset::DescriptorSet::VerifyWriteUpdateContents(const VkWriteDescriptorSet *update, const uint32_t index,
-                                                               UNIQUE_VALIDATION_ERROR_CODE *error_code,
+                                                               WriteUpdateCache *cache, UNIQUE_VALIDATION_ERROR_CODE *error_code,
                                                                std::string *error_msg) const {
     switch (update->descriptorType) {
         case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER: {
@@ -1434,6 +1577,7 @@ bool cvdescriptorset::DescriptorSet::VerifyWriteUpdateContents(const VkWriteDesc
                 // Validate image
                 auto image_view = update->pImageInfo[di].imageView;
                 auto image_layout = update->pImageInfo[di].imageLayout;
+                if (cache->HasImageView(image_view, image_layout, update->descriptorType)) continue;
                 if (!ValidateImageUpdate(image_view, image_layout, update->descriptorType, device_data_, error_code, error_msg)) {
                     std::stringstream error_str;
                     error_str << "Attempted write update to combined image sampler descriptor failed due to: "
@@ -1441,20 +1585,23 @@ bool cvdescriptorset::DescriptorSet::VerifyWriteUpdateContents(const VkWriteDesc
                     *error_msg = error_str.str();
                     return false;
                 }
+                cache->AddImageView(image_view, image_layout, update->descriptorType);
             }
             // Intentional fall-through to validate sampler
         }
         case VK_DESCRIPTOR_TYPE_SAMPLER: {
             for (uint32_t di = 0; di < update->descriptorCount; ++di) {
                 if (!descriptors_[index + di].get()->IsImmutableSampler()) {
-                    if (!ValidateSampler(update->pImageInfo[di].sampler, device_data_)) {
+                    auto sampler = update->pImageInfo[di].sampler;
+                    if (cache->HasSampler(sampler)) continue;
+                    if (!ValidateSampler(sampler, device_data_)) {
                         *error_code = VALIDATION_ERROR_15c0028a;
                         std::stringstream error_str;
-                        error_str << "Attempted write update to sampler descriptor with invalid sampler: "
-                                  << update->pImageInfo[di].sampler << ".";
+                        error_str << "Attempted write update to sampler descriptor with invalid sampler: " << sampler << ".";
                         *error_msg = error_str.str();
                         return false;
                     }
+                    cache->AddSampler(sampler);
                 } else {
                     // TODO : Warn here
                 }
@@ -1467,12 +1614,14 @@ bool cvdescriptorset::DescriptorSet::VerifyWriteUpdateContents(const VkWriteDesc
             for (uint32_t di = 0; di < update->descriptorCount; ++di) {
                 auto image_view = update->pImageInfo[di].imageView;
                 auto image_layout = update->pImageInfo[di].imageLayout;
+                if (cache->HasImageView(image_view, image_layout, update->descriptorType)) continue;
                 if (!ValidateImageUpdate(image_view, image_layout, update->descriptorType, device_data_, error_code, error_msg)) {
                     std::stringstream error_str;
                     error_str << "Attempted write update to image descriptor failed due to: " << error_msg->c_str();
                     *error_msg = error_str.str();
                     return false;
                 }
+                cache->AddImageView(image_view, image_layout, update->descriptorType);
             }
             break;
         }
@@ -1480,6 +1629,7 @@ bool cvdescriptorset::DescriptorSet::VerifyWriteUpdateContents(const VkWriteDesc
         case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER: {
             for (uint32_t di = 0; di < update->descriptorCount; ++di) {
                 auto buffer_view = update->pTexelBufferView[di];
+                if (cache->HasBufferView(buffer_view, update->descriptorType)) continue;
                 auto bv_state = GetBufferViewState(device_data_, buffer_view);
                 if (!bv_state) {
                     *error_code = VALIDATION_ERROR_15c00286;
@@ -1495,6 +1645,7 @@ bool cvdescriptorset::DescriptorSet::VerifyWriteUpdateContents(const VkWriteDesc
                     *error_msg = error_str.str();
                     return false;
                 }
+                cache->AddBufferView(buffer_view, update->descriptorType);
             }
             break;
         }
@@ -1503,7 +1654,7 @@ bool cvdescriptorset::DescriptorSet::VerifyWriteUpdateContents(const VkWriteDesc
         case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
         case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC: {
             for (uint32_t di = 0; di < update->descriptorCount; ++di) {
-                if (!ValidateBufferUpdate(update->pBufferInfo + di, update->descriptorType, error_code, error_msg)) {
+                if (!ValidateBufferUpdate(update->pBufferInfo + di, update->descriptorType, cache, error_code, error_msg)) {
                     std::stringstream error_str;
                     error_str << "Attempted write update to buffer descriptor failed due to: " << error_msg->c_str();
                     *error_msg = error_str.str();
@@ -1691,8 +1842,8 @@ bool cvdescriptorset::ValidateAllocateDescriptorSets(const core_validation::laye
 void cvdescriptorset::PerformAllocateDescriptorSets(const VkDescriptorSetAllocateInfo *p_alloc_info,
                                                     const VkDescriptorSet *descriptor_sets,
                                                     const AllocateDescriptorSetsData *ds_data,
-                                                    std::unordered_map<VkDescriptorPool, DESCRIPTOR_POOL_STATE *> *pool_map,
-                                                    std::unordered_map<VkDescriptorSet, cvdescriptorset::DescriptorSet *> *set_map,
+                                                    FlatHashMap<VkDescriptorPool, DESCRIPTOR_POOL_STATE *> *pool_map,
+                                                    FlatHashMap<VkDescriptorSet, cvdescriptorset::DescriptorSet *> *set_map,
                                                     const layer_data *dev_data) {
     auto pool_state = (*pool_map)[p_alloc_info->descriptorPool];
     // Account for sets and individual descriptors allocated from pool
@@ -143,6 +143,8 @@ class DescriptorSetLayout {
     // For a particular binding starting at offset and having update_count descriptors
     //  updated, verify that for any binding boundaries crossed, the update is consistent
     bool VerifyUpdateConsistency(uint32_t, uint32_t, uint32_t, const char *, const VkDescriptorSet, std::string *) const;
+    // Approximate host memory held by this layout, for the state stats
+    size_t GetStateBytes() const;
 
    private:
     VkDescriptorSetLayout layout_;
@@ -191,6 +193,55 @@ bool ValidateSampler(const VkSampler, const core_validation::layer_data *);
 bool ValidateImageUpdate(VkImageView, VkImageLayout, VkDescriptorType, const core_validation::layer_data *,
                          UNIQUE_VALIDATION_ERROR_CODE *, std::string *);
 
+/*
+ * WriteUpdateCache class
+ *
+ * Remembers which image view, sampler, buffer and buffer view uses have already passed validation within one batch of
+ *   write updates. Streaming engines write the same few objects into thousands of descriptors per call, so a hit here
+ *   skips the object lookups and checks that ValidateImageUpdate() and friends would otherwise repeat for every
+ *   descriptor. Each table is direct-mapped on the handle, so a collision simply evicts the older entry and the next
+ *   use of it is validated again. Object state can't change in the middle of a batch, so a cache must not outlive the
+ *   vkUpdateDescriptorSets() call it was built for.
+ */
+class WriteUpdateCache {
+   public:
+    WriteUpdateCache();
+    bool HasImageView(VkImageView, VkImageLayout, VkDescriptorType) const;
+    void AddImageView(VkImageView, VkImageLayout, VkDescriptorType);
+    bool HasSampler(VkSampler) const;
+    void AddSampler(VkSampler);
+    // Returns the state of a buffer whose memory binding and usage were already checked for this type, else nullptr
+    BUFFER_STATE const *GetBuffer(VkBuffer, VkDescriptorType) const;
+    void AddBuffer(BUFFER_STATE const *, VkDescriptorType);
+    bool HasBufferView(VkBufferView, VkDescriptorType) const;
+    void AddBufferView(VkBufferView, VkDescriptorType);
+
+   private:
+    static const uint32_t kEntryCount = 32;
+    template <typename HANDLE_T>
+    static uint32_t Slot(HANDLE_T handle) {
+        return static_cast<uint32_t>((HandleToUint64(handle) * 0x9E3779B97F4A7C15ull) >> 59);
+    }
+
+    struct ImageViewUse {
+        VkImageView image_view;
+        VkImageLayout image_layout;
+        VkDescriptorType type;
+    };
+    struct BufferUse {
+        BUFFER_STATE const *buffer_state;
+        VkDescriptorType type;
+    };
+    struct BufferViewUse {
+        VkBufferView buffer_view;
+        VkDescriptorType type;
+    };
+    ImageViewUse image_views_[kEntryCount];
+    VkSampler samplers_[kEntryCount];
+    BufferUse buffers_[kEntryCount];
+    BufferViewUse buffer_views_[kEntryCount];
+};
+
 class SamplerDescriptor : public Descriptor {
    public:
     SamplerDescriptor(const VkSampler *);
@@ -289,6 +340,8 @@ void PerformUpdateDescriptorSets(const core_validation::layer_data *, uint32_t,
 // Similar to PerformUpdateDescriptorSets, this function will do the same for updating via templates
 void PerformUpdateDescriptorSetsWithTemplateKHR(layer_data *, VkDescriptorSet, std::unique_ptr<TEMPLATE_STATE> const &,
                                                 const void *);
+// Decode the entries of a descriptor set update template into write updates against its set layout, once at creation
+void DecodeUpdateTemplate(const layer_data *, TEMPLATE_STATE *);
 // Update the common AllocateDescriptorSetsData struct which can then be shared between Validate* and Perform* funcs below
 void UpdateAllocateDescriptorSetsData(const layer_data *dev_data, const VkDescriptorSetAllocateInfo *,
                                       AllocateDescriptorSetsData *);
@@ -297,8 +350,8 @@ bool ValidateAllocateDescriptorSets(const core_validation::layer_data *, const V
                                     const AllocateDescriptorSetsData *);
 // Update state based on allocating new descriptorsets
 void PerformAllocateDescriptorSets(const VkDescriptorSetAllocateInfo *, const VkDescriptorSet *, const AllocateDescriptorSetsData *,
-                                   std::unordered_map<VkDescriptorPool, DESCRIPTOR_POOL_STATE *> *,
-                                   std::unordered_map<VkDescriptorSet, cvdescriptorset::DescriptorSet *> *,
+                                   FlatHashMap<VkDescriptorPool, DESCRIPTOR_POOL_STATE *> *,
+                                   FlatHashMap<VkDescriptorSet, cvdescriptorset::DescriptorSet *> *,
                                    const core_validation::layer_data *);
 
 /*
@@ -353,9 +406,10 @@ class DescriptorSet : public BASE_NODE {
 
     // Descriptor Update functions. These functions validate state and perform update separately
     // Validate contents of a WriteUpdate
-    bool ValidateWriteUpdate(const debug_report_data *, const VkWriteDescriptorSet *, UNIQUE_VALIDATION_ERROR_CODE *,
-                             std::string *);
+    bool ValidateWriteUpdate(const debug_report_data *, const VkWriteDescriptorSet *, WriteUpdateCache *,
+                             UNIQUE_VALIDATION_ERROR_CODE *, std::string *);
     // Perform a WriteUpdate whose contents were just validated using ValidateWriteUpdate
+    //  Bound cmd buffers are not invalidated here; call InvalidateBoundCmdBuffers() once the set's writes are done
     void PerformWriteUpdate(const VkWriteDescriptorSet *);
     // Validate contents of a CopyUpdate
     bool ValidateCopyUpdate(const debug_report_data *, const VkCopyDescriptorSet *, const DescriptorSet *,
@@ -383,17 +437,19 @@ class DescriptorSet : public BASE_NODE {
     };
     // Return true if any part of set has ever been updated
     bool IsUpdated() const { return some_update_; };
+    // Set all bound cmd buffers to INVALID state
+    void InvalidateBoundCmdBuffers();
+    // Approximate host memory held by this set and its descriptors, for the state stats
+    size_t GetStateBytes() const;
 
    private:
-    bool VerifyWriteUpdateContents(const VkWriteDescriptorSet *, const uint32_t, UNIQUE_VALIDATION_ERROR_CODE *,
+    bool VerifyWriteUpdateContents(const VkWriteDescriptorSet *, const uint32_t, WriteUpdateCache *, UNIQUE_VALIDATION_ERROR_CODE *,
                                    std::string *) const;
     bool VerifyCopyUpdateContents(const VkCopyDescriptorSet *, const DescriptorSet *, VkDescriptorType, uint32_t,
                                   UNIQUE_VALIDATION_ERROR_CODE *, std::string *) const;
     bool ValidateBufferUsage(BUFFER_STATE const *, VkDescriptorType, UNIQUE_VALIDATION_ERROR_CODE *, std::string *) const;
-    bool ValidateBufferUpdate(VkDescriptorBufferInfo const *, VkDescriptorType, UNIQUE_VALIDATION_ERROR_CODE *,
+    bool ValidateBufferUpdate(VkDescriptorBufferInfo const *, VkDescriptorType, WriteUpdateCache *, UNIQUE_VALIDATION_ERROR_CODE *,
                               std::string *) const;
-    // Private helper to set all bound cmd buffers to INVALID state
-    void InvalidateBoundCmdBuffers();
     bool some_update_;  // has any part of the set ever been updated?
     VkDescriptorSet set_;
     DESCRIPTOR_POOL_STATE *pool_state_;
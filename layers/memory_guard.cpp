@@ -0,0 +1,254 @@
+/* Copyright (c) 2015-2017 The Khronos Group Inc.
+ * Copyright (c) 2015-2017 Valve Corporation
+ * Copyright (c) 2015-2017 LunarG, Inc.
+ * Copyright (C) 2015-2017 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "memory_guard.h"
+
+#include <string.h>
+
+#if defined(__linux__)
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
+// Live mappings, scanned by the fault handler. A fixed table of atomics keeps the handler free of locks and allocation;
+// once it's full, further mappings fall back to the shadow copy.
+static const size_t kMaxGuardedMappings = 32;
+static std::atomic<GuardedMapping *> guarded_mappings[kMaxGuardedMappings];
+// Fault handlers that may be using a mapping they found in the table. A mapping is only unmapped and freed once it has
+// been taken out of the table and this has dropped to zero, so that a handler never touches one that's gone. Both sides
+// use sequentially consistent operations: either the handler's increment is seen by the destructor, or the handler's
+// load of the slot sees it emptied.
+static std::atomic<int> running_fault_handlers(0);
+static struct sigaction previous_segv_action;
+static std::once_flag install_segv_handler_once;
+
+static void GuardedMappingFaultHandler(int sig, siginfo_t *info, void *context) {
+    running_fault_handlers.fetch_add(1);
+    for (size_t i = 0; i < kMaxGuardedMappings; ++i) {
+        GuardedMapping *mapping = guarded_mappings[i].load();
+        if (mapping && mapping->HandleFault(info->si_addr)) {
+            running_fault_handlers.fetch_sub(1);
+            return;
+        }
+    }
+    // The previous handler may not return, so stop counting this one first
+    running_fault_handlers.fetch_sub(1);
+    // Not one of ours, so hand it to whoever had SIGSEGV before. This handler stays installed unless the process is about to
+    // be killed anyway, so that later faults in guarded mappings are still taken.
+    if (previous_segv_action.sa_flags & SA_SIGINFO) {
+        previous_segv_action.sa_sigaction(sig, info, context);
+    } else if (previous_segv_action.sa_handler == SIG_IGN && info->si_code <= 0) {
+        // Sent with kill() or similar, so ignore it as before. A real fault can't be ignored.
+    } else if (previous_segv_action.sa_handler == SIG_DFL || previous_segv_action.sa_handler == SIG_IGN) {
+        // Take the default action, killing the process. SIGSEGV is blocked while this runs, so the raised signal is
+        // delivered on return; a faulting access would also fault again.
+        signal(SIGSEGV, SIG_DFL);
+        raise(SIGSEGV);
+    } else {
+        previous_segv_action.sa_handler(sig);
+    }
+}
+
+static void InstallFaultHandler() {
+    struct sigaction action = {};
+    action.sa_sigaction = GuardedMappingFaultHandler;
+    action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGSEGV, &action, &previous_segv_action);
+}
+
+// Pages are tracked in blocks of at least kMinPagesPerBlock, so that writing a large range takes one fault per block rather
+// than per page. Blocks grow for large mappings to keep each to at most kMaxBlocks: every change of protection within a
+// mapping splits it into another kernel VMA, and a process only gets vm.max_map_count (65530 by default) of those.
+static const size_t kMinPagesPerBlock = 16;
+static const size_t kMaxBlocks = 1024;
+
+static inline bool TestBit(const std::unique_ptr<std::atomic<uint64_t>[]> &bits, size_t index) {
+    return (bits[index / 64].load(std::memory_order_acquire) >> (index % 64)) & 1;
+}
+
+static inline void SetBit(const std::unique_ptr<std::atomic<uint64_t>[]> &bits, size_t index) {
+    bits[index / 64].fetch_or(1ull << (index % 64), std::memory_order_acq_rel);
+}
+
+std::unique_ptr<GuardedMapping> GuardedMapping::Create(void *driver_data, size_t size, size_t start_offset,
+                                                       size_t map_alignment) {
+    const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    if (size == 0 || map_alignment > page_size || start_offset >= page_size) return nullptr;
+
+    const size_t page_count = (start_offset + size + page_size - 1) / page_size;
+    void *base = mmap(nullptr, (page_count + 2) * page_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) return nullptr;
+    std::unique_ptr<GuardedMapping> mapping(
+        new GuardedMapping(static_cast<char *>(base), page_size, page_count, driver_data, size, start_offset));
+
+    std::call_once(install_segv_handler_once, InstallFaultHandler);
+    for (size_t i = 0; i < kMaxGuardedMappings; ++i) {
+        GuardedMapping *expected = nullptr;
+        if (guarded_mappings[i].compare_exchange_strong(expected, mapping.get(), std::memory_order_acq_rel)) {
+            mapping->registry_slot_ = i;
+            return mapping;
+        }
+    }
+    return nullptr;
+}
+
+GuardedMapping::GuardedMapping(char *base, size_t page_size, size_t page_count, void *driver_data, size_t size,
+                               size_t start_offset)
+    : base_(base),
+      page_size_(page_size),
+      page_count_(page_count),
+      driver_data_(static_cast<char *>(driver_data)),
+      size_(size),
+      start_offset_(start_offset),
+      pages_per_block_(std::max(kMinPagesPerBlock, (page_count + kMaxBlocks - 1) / kMaxBlocks)),
+      block_count_((page_count + pages_per_block_ - 1) / pages_per_block_),
+      valid_(new std::atomic<uint64_t>[(block_count_ + 63) / 64]),
+      dirty_(new std::atomic<uint64_t>[(block_count_ + 63) / 64]),
+      underflow_(false),
+      overflow_(false),
+      registry_slot_(kMaxGuardedMappings) {
+    for (size_t i = 0; i < (block_count_ + 63) / 64; ++i) {
+        valid_[i].store(0, std::memory_order_relaxed);
+        dirty_[i].store(0, std::memory_order_relaxed);
+    }
+    fault_lock_.clear();
+}
+
+GuardedMapping::~GuardedMapping() {
+    if (registry_slot_ < kMaxGuardedMappings) {
+        guarded_mappings[registry_slot_].store(nullptr);
+        // A handler that found this mapping before it left the table may still be using it
+        while (running_fault_handlers.load() != 0) std::this_thread::yield();
+    }
+    munmap(base_, (page_count_ + 2) * page_size_);
+}
+
+char *GuardedMapping::Block(size_t block) const {
+    size_t page = block * pages_per_block_;
+    return base_ + (std::min(page, page_count_) + 1) * page_size_;
+}
+
+// Copy the driver's data for one block into the shadow, which must already be writable, and fill the part of the block
+// that lies outside the mapped range
+void GuardedMapping::FillBlock(size_t block) {
+    char *page_begin = Block(block);
+    char *page_end = Block(block + 1);
+    char *data_begin = static_cast<char *>(data());
+    char *data_end = data_begin + size_;
+    char *copy_begin = page_begin > data_begin ? page_begin : data_begin;
+    char *copy_end = page_end < data_end ? page_end : data_end;
+    memcpy(copy_begin, driver_data_ + (copy_begin - data_begin), copy_end - copy_begin);
+    if (copy_begin > page_begin) memset(page_begin, kFillValue, copy_begin - page_begin);
+    if (copy_end < page_end) memset(copy_end, kFillValue, page_end - copy_end);
+}
+
+bool GuardedMapping::HandleFault(const void *address) {
+    const char *addr = static_cast<const char *>(address);
+    if (addr < base_ || addr >= base_ + (page_count_ + 2) * page_size_) return false;
+    size_t page = (addr - base_) / page_size_;
+    if (page == 0 || page == page_count_ + 1) {
+        // Let the access through and report it at the next flush, as the shadow copy's pad bytes would
+        (page == 0 ? underflow_ : overflow_).store(true, std::memory_order_release);
+        mprotect(base_ + page * page_size_, page_size_, PROT_READ | PROT_WRITE);
+        return true;
+    }
+    size_t block = (page - 1) / pages_per_block_;
+    while (fault_lock_.test_and_set(std::memory_order_acquire)) {
+    }
+    if (mprotect(Block(block), Block(block + 1) - Block(block), PROT_READ | PROT_WRITE) != 0) {
+        // Out of VMAs, most likely. Returning would just fault again, so let the previous handler have it.
+        fault_lock_.clear(std::memory_order_release);
+        return false;
+    }
+    if (!TestBit(valid_, block)) {
+        FillBlock(block);
+        SetBit(valid_, block);
+    }
+    SetBit(dirty_, block);
+    fault_lock_.clear(std::memory_order_release);
+    return true;
+}
+
+bool GuardedMapping::SlackIsIntact(const char *begin, const char *end) const {
+    for (const char *p = begin; p < end; ++p) {
+        if (static_cast<uint8_t>(*p) != kFillValue) return false;
+    }
+    return true;
+}
+
+void GuardedMapping::Flush(bool *underflow, bool *overflow) {
+    char *data_begin = static_cast<char *>(data());
+    char *data_end = data_begin + size_;
+    for (size_t word = 0; word < (block_count_ + 63) / 64; ++word) {
+        // Take the dirty bits before write-protecting the blocks. A write that lands before the protection is copied
+        // below; one that lands after it faults and marks the page dirty for the next flush.
+        uint64_t bits = dirty_[word].exchange(0, std::memory_order_acq_rel);
+        while (bits) {
+            size_t first = 0;
+            while (!((bits >> first) & 1)) ++first;
+            size_t last = first;
+            while (last < 64 && ((bits >> last) & 1)) ++last;
+            bits &= (last < 64) ? ~((1ull << last) - 1) : 0;
+
+            char *run_begin = Block(word * 64 + first);
+            char *run_end = Block(word * 64 + last);
+            mprotect(run_begin, run_end - run_begin, PROT_READ);
+            char *copy_begin = run_begin > data_begin ? run_begin : data_begin;
+            char *copy_end = run_end < data_end ? run_end : data_end;
+            memcpy(driver_data_ + (copy_begin - data_begin), copy_begin, copy_end - copy_begin);
+        }
+    }
+
+    *underflow = underflow_.exchange(false, std::memory_order_acq_rel);
+    *overflow = overflow_.exchange(false, std::memory_order_acq_rel);
+    if (*underflow) mprotect(base_, page_size_, PROT_NONE);
+    if (*overflow) mprotect(Block(block_count_), page_size_, PROT_NONE);
+    // Writes just outside the mapped range but within its first or last page don't fault, so check the fill there. Putting
+    // the fill back may fault on a write-protected block, which just marks it dirty again.
+    if (TestBit(valid_, 0) && !SlackIsIntact(Block(0), data_begin)) {
+        *underflow = true;
+        memset(Block(0), kFillValue, data_begin - Block(0));
+    }
+    if (TestBit(valid_, block_count_ - 1) && !SlackIsIntact(data_end, Block(block_count_))) {
+        *overflow = true;
+        memset(data_end, kFillValue, Block(block_count_) - data_end);
+    }
+}
+
+void GuardedMapping::Invalidate() {
+    mprotect(Block(0), page_count_ * page_size_, PROT_NONE);
+    madvise(Block(0), page_count_ * page_size_, MADV_DONTNEED);
+    for (size_t i = 0; i < (block_count_ + 63) / 64; ++i) {
+        valid_[i].store(0, std::memory_order_release);
+        dirty_[i].store(0, std::memory_order_release);
+    }
+}
+
+#else  // !defined(__linux__)
+
+std::unique_ptr<GuardedMapping> GuardedMapping::Create(void *, size_t, size_t, size_t) { return nullptr; }
+GuardedMapping::~GuardedMapping() {}
+void GuardedMapping::Flush(bool *underflow, bool *overflow) { *underflow = *overflow = false; }
+void GuardedMapping::Invalidate() {}
+bool GuardedMapping::HandleFault(const void *) { return false; }
+
+#endif  // defined(__linux__)
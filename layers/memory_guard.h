@@ -0,0 +1,86 @@
+/* Copyright (c) 2015-2017 The Khronos Group Inc.
+ * Copyright (c) 2015-2017 Valve Corporation
+ * Copyright (c) 2015-2017 LunarG, Inc.
+ * Copyright (C) 2015-2017 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CORE_VALIDATION_MEMORY_GUARD_H_
+#define CORE_VALIDATION_MEMORY_GUARD_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// GuardedMapping is the page-protected alternative to the malloc'd shadow copy that core_validation hands out for mapped
+// non-coherent memory. The shadow is an anonymous mapping with an inaccessible guard page on either side, so a stray write
+// past either end of the mapped range faults instead of needing a scan of pad bytes. Data pages start out inaccessible too,
+// and are tracked in blocks of a few pages: the first touch of a block faults, copies it in from the driver's mapping and
+// marks it dirty. A flush copies only dirty blocks to the driver and write-protects them again, and untouched blocks never
+// take up memory.
+//
+// Faults are taken by a process-wide SIGSEGV handler that passes anything outside a guarded mapping on to the previous
+// handler. Only Linux is supported; Create() returns null elsewhere, and when page guards can't be set up, so that the
+// caller falls back to the shadow copy.
+class GuardedMapping {
+   public:
+    // Byte written to the parts of the first and last data pages outside the mapped range, checked at each flush
+    static const uint8_t kFillValue = 0xb;
+
+    // Shadows size bytes of the driver's mapping at driver_data. The pointer handed to the application is start_offset
+    // bytes into a page, which must keep it aligned to map_alignment.
+    static std::unique_ptr<GuardedMapping> Create(void *driver_data, size_t size, size_t start_offset, size_t map_alignment);
+    ~GuardedMapping();
+
+    // Pointer to hand to the application in place of the driver's mapping
+    void *data() const { return base_ + page_size_ + start_offset_; }
+    // Address space taken up by the mapping, guard pages included
+    size_t MappedBytes() const { return (page_count_ + 2) * page_size_; }
+
+    // Copies the blocks written since the last flush to the driver's mapping and write-protects them again. Sets underflow
+    // or overflow if anything was written outside the mapped range since the last flush.
+    void Flush(bool *underflow, bool *overflow);
+    // Drops the shadow's contents so that each block is copied in from the driver again on its next access
+    void Invalidate();
+
+    // Called from the SIGSEGV handler. Returns false if address isn't in this mapping.
+    bool HandleFault(const void *address);
+
+   private:
+    GuardedMapping(char *base, size_t page_size, size_t page_count, void *driver_data, size_t size, size_t start_offset);
+    // Start of a block's first page; the last block may be short, and Block(block_count_) is the trailing guard page
+    char *Block(size_t block) const;
+    void FillBlock(size_t block);
+    bool SlackIsIntact(const char *begin, const char *end) const;
+
+    char *base_;         // Start of the anonymous mapping, including the leading guard page
+    size_t page_size_;
+    size_t page_count_;  // Data pages, not counting the two guard pages
+    char *driver_data_;
+    size_t size_;
+    size_t start_offset_;
+    size_t pages_per_block_;
+    size_t block_count_;
+    // One bit per block: valid blocks hold a copy of the driver's data, dirty blocks may have been written since the last
+    // flush. Both are set from the fault handler, so they're atomics rather than std::vector<bool>.
+    std::unique_ptr<std::atomic<uint64_t>[]> valid_;
+    std::unique_ptr<std::atomic<uint64_t>[]> dirty_;
+    std::atomic<bool> underflow_;
+    std::atomic<bool> overflow_;
+    // Serializes first-touch faults so that two threads can't both copy a page in from the driver
+    std::atomic_flag fault_lock_;
+    size_t registry_slot_;
+};
+
+#endif  // CORE_VALIDATION_MEMORY_GUARD_H_
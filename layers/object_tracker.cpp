@@ -338,7 +338,7 @@ static bool ValidateObject(T1 dispatchable_object, T2 object, VulkanObjectType o
         if ((object_type != kVulkanObjectTypeImage) ||
             (device_data->swapchainImageMap.find(object_handle) == device_data->swapchainImageMap.end())) {
             // Object not found, look for it in other device object maps
-            for (auto other_device_data : layer_data_map) {
+            for (auto other_device_data : layer_data_map.entries()) {
                 if (other_device_data.second != device_data) {
                     if (other_device_data.second->object_map[object_type].find(object_handle) !=
                             other_device_data.second->object_map[object_type].end() ||
@@ -480,7 +480,13 @@ VKAPI_ATTR void VKAPI_CALL DestroyInstance(VkInstance instance, const VkAllocati
     delete pInstanceTable;
 }
 
+static void LogStateStats(VkDevice device, layer_data const *device_data);
+
 VKAPI_ATTR void VKAPI_CALL DestroyDevice(VkDevice device, const VkAllocationCallbacks *pAllocator) {
+    layer_data *device_data = GetLayerDataPtr(get_dispatch_key(device), layer_data_map);
+    device_data->state_stats_task.reset();
+    if (device_data->state_stats.log_on_destroy) LogStateStats(device, device_data);
+
     std::unique_lock<std::mutex> lock(global_lock);
     ValidateObject(device, device, kVulkanObjectTypeDevice, true, VALIDATION_ERROR_24a05601, VALIDATION_ERROR_UNDEFINED);
     DestroyObject(device, device, kVulkanObjectTypeDevice, pAllocator, VALIDATION_ERROR_24a002f6, VALIDATION_ERROR_24a002f8);
@@ -3249,6 +3255,34 @@ static const VkLayerProperties globalLayerProps = {"VK_LAYER_LUNARG_object_track
                                                    1,                     // implementationVersion
                                                    "LunarG Validation Layer"};
 
+// Tally the objects tracked for a device, by type. Must be called with global_lock held.
+static StateStats GatherStateStats(layer_data const *device_data) {
+    StateStats stats(globalLayerProps.layerName);
+    for (int object_type = kVulkanObjectTypeDevice; object_type < kVulkanObjectTypeMax; ++object_type) {
+        auto const &object_map = device_data->object_map[object_type];
+        stats.Add(object_string[object_type], object_map.size(),
+                  ContainerBytes(object_map) + object_map.size() * sizeof(OBJTRACK_NODE));
+    }
+    stats.Add("SwapchainImage", device_data->swapchainImageMap.size(),
+              ContainerBytes(device_data->swapchainImageMap) + device_data->swapchainImageMap.size() * sizeof(OBJTRACK_NODE));
+    stats.Add("QueueInfo", device_data->queue_info_map.size(),
+              ContainerBytes(device_data->queue_info_map) + device_data->queue_info_map.size() * sizeof(OT_QUEUE_INFO));
+    return stats;
+}
+
+static void LogStateStats(VkDevice device, layer_data const *device_data) {
+    std::lock_guard<std::mutex> lock(global_lock);
+    GatherStateStats(device_data).Log(device_data->report_data, device);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL GetLayerStateStatsLUNARG(VkDevice device, uint32_t *pStatCount, VkLayerStateStatLUNARG *pStats) {
+    layer_data *device_data = GetLayerDataPtr(get_dispatch_key(device), layer_data_map);
+    std::unique_lock<std::mutex> lock(global_lock);
+    StateStats stats = GatherStateStats(device_data);
+    lock.unlock();
+    return stats.Report(device, device_data->dispatch_table.GetDeviceProcAddr, pStatCount, pStats);
+}
+
 VKAPI_ATTR VkResult VKAPI_CALL EnumerateInstanceLayerProperties(uint32_t *pCount, VkLayerProperties *pProperties) {
     return util_GetLayerProperties(1, &globalLayerProps, pCount, pProperties);
 }
@@ -3316,6 +3350,13 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateDevice(VkPhysicalDevice physicalDevice, con
 
     CreateObject(*pDevice, *pDevice, kVulkanObjectTypeDevice, pAllocator);
 
+    device_data->state_stats = GetStateStatsSettings("lunarg_object_tracker");
+    if (device_data->state_stats.log_interval) {
+        VkDevice device = *pDevice;
+        device_data->state_stats_task.reset(new PeriodicTask(device_data->state_stats.log_interval,
+                                                             [device, device_data]() { LogStateStats(device, device_data); }));
+    }
+
     return result;
 }
 
@@ -5042,6 +5083,7 @@ VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceSurfaceFormats2KHR(VkPhysicalDev
 // Map of all APIs to be intercepted by this layer
 static const std::unordered_map<std::string, void*> name_to_funcptr_map = {
     {"vkGetDeviceProcAddr", (void*)GetDeviceProcAddr},
+    {VK_LUNARG_STATE_STATS_FUNCTION_NAME, (void*)GetLayerStateStatsLUNARG},
     {"vkDestroyDevice", (void*)DestroyDevice},
     {"vkGetDeviceQueue", (void*)GetDeviceQueue},
     {"vkQueueSubmit", (void*)QueueSubmit},
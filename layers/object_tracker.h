@@ -26,6 +26,7 @@
 #include "vk_layer_extension_utils.h"
 #include "vk_layer_table.h"
 #include "vk_layer_utils.h"
+#include "vk_layer_state_stats.h"
 #include "vulkan/vk_layer.h"
 
 namespace object_tracker {
@@ -99,6 +100,10 @@ struct layer_data {
     // Map of queue information structures, one per queue
     std::unordered_map<VkQueue, OT_QUEUE_INFO *> queue_info_map;
 
+    // lunarg_object_tracker.state_stats_* settings, and the periodic log they may ask for
+    StateStatsSettings state_stats;
+    std::unique_ptr<PeriodicTask> state_stats_task;
+
     VkLayerDispatchTable dispatch_table;
     // Default constructor
     layer_data()
@@ -111,12 +116,13 @@ struct layer_data {
           tmp_dbg_create_infos(nullptr),
           tmp_callbacks(nullptr),
           object_map{},
+          state_stats{},
           dispatch_table{} {
         object_map.resize(kVulkanObjectTypeMax + 1);
     }
 };
 
-static std::unordered_map<void *, layer_data *> layer_data_map;
+static LayerDataMap<layer_data> layer_data_map;
 static device_table_map ot_device_table_map;
 static instance_table_map ot_instance_table_map;
 static std::mutex global_lock;
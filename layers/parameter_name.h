@@ -19,15 +19,16 @@
 #define PARAMETER_NAME_H
 
 #include <cassert>
-#include <sstream>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
 #include <string>
-#include <vector>
 
 /**
  * Parameter name string supporting deferred formatting for array subscripts.
  *
  * Custom parameter name class with support for deferred formatting of names containing array subscripts.  The class stores
- * a format string and a vector of index values, and performs string formatting when an accessor function is called to
+ * a format string and a small fixed array of index values, and performs string formatting when an accessor function is called to
  * retrieve the name string.  This class was primarily designed to be used with validation functions that receive a parameter name
  * string and value as arguments, and print an error message that includes the parameter name when the value fails a validation
  * test.  Using standard strings with these validation functions requires that parameter names containing array subscripts be
@@ -36,19 +37,25 @@
  *         sprintf(name, "pCreateInfo[%d].sType", i);
  *         validate_stype(name, pCreateInfo[i].sType);
  *
- * With the ParameterName class, a format string and a vector of format values are stored by the ParameterName object that is
+ * With the ParameterName class, a format string and the index values are stored by the ParameterName object that is
  * provided to the validation function.  String formatting is then performed only when the validation function retrieves the
  * name string from the ParameterName object:
  *         validate_stype(ParameterName("pCreateInfo[%i].sType", IndexVector{ i }), pCreateInfo[i].sType);
+ *
+ * Constructing a ParameterName never allocates: the source string is not copied, so it must outlive the object (in practice
+ * it is always a string literal), and the index values are copied into a fixed-size array.
  */
 class ParameterName {
    public:
     /// Container for index values to be used with parameter name string formatting.
-    typedef std::vector<size_t> IndexVector;
+    typedef std::initializer_list<size_t> IndexVector;
+
+    /// Maximum number of index values; the generated code nests arrays at most three deep.
+    static const size_t kMaxIndices = 4;
 
     /// Format specifier for the parameter name string, to be replaced by an index value.  The parameter name string must contain
     /// one format specifier for each index value specified.
-    const std::string IndexFormatSpecifier = "%i";
+    static const char *IndexFormatSpecifier() { return "%i"; }
 
    public:
     /**
@@ -58,91 +65,69 @@ class ParameterName {
      *
      * @pre The source string must not contain the %i format specifier.
      */
-    ParameterName(const char *source) : source_(source) { assert(IsValid()); }
+    ParameterName(const char *source) : source_(source), arg_count_(0) { assert(IsValid()); }
 
     /**
-    * Construct a ParameterName object from a std::string object, without formatting.
-    *
-    * @param source Paramater name string without format specifiers.
-    *
-    * @pre The source string must not contain the %i format specifier.
-    */
-    ParameterName(const std::string &source) : source_(source) { assert(IsValid()); }
-
-    /**
-    * Construct a ParameterName object from a std::string object, without formatting.
-    *
-    * @param source Paramater name string without format specifiers.
-    *
-    * @pre The source string must not contain the %i format specifier.
-    */
-    ParameterName(const std::string &&source) : source_(std::move(source)) { assert(IsValid()); }
-
-    /**
-    * Construct a ParameterName object from a std::string object, with formatting.
-    *
-    * @param source Paramater name string with format specifiers.
-    * @param args Array index values to be used for formatting.
-    *
-    * @pre The number of %i format specifiers contained by the source string must match the number of elements contained
-    *      by the index vector.
-    */
-    ParameterName(const std::string &source, const IndexVector &args) : source_(source), args_(args) { assert(IsValid()); }
-
-    /**
-    * Construct a ParameterName object from a std::string object, with formatting.
+    * Construct a ParameterName object from a string literal, with formatting.
     *
     * @param source Paramater name string with format specifiers.
     * @param args Array index values to be used for formatting.
     *
     * @pre The number of %i format specifiers contained by the source string must match the number of elements contained
-    *      by the index vector.
+    *      by the index list, which may not exceed kMaxIndices.
     */
-    ParameterName(const std::string &&source, const IndexVector &&args) : source_(std::move(source)), args_(std::move(args)) {
+    ParameterName(const char *source, IndexVector args) : source_(source), arg_count_(0) {
+        assert(args.size() <= kMaxIndices);
+        for (size_t index : args) {
+            if (arg_count_ == kMaxIndices) break;
+            args_[arg_count_++] = index;
+        }
         assert(IsValid());
     }
 
     /// Retrive the formatted name string.
-    std::string get_name() const { return (args_.empty()) ? source_ : Format(); }
+    std::string get_name() const { return (arg_count_ == 0) ? std::string(source_) : Format(); }
 
    private:
-    /// Replace the %i format specifiers in the source string with the values from the index vector.
+    /// Replace the %i format specifiers in the source string with the index values.
     std::string Format() const {
-        std::string::size_type current = 0;
-        std::string::size_type last = 0;
-        std::stringstream format;
+        const size_t specifier_length = strlen(IndexFormatSpecifier());
+        const char *last = source_;
+        std::string format;
 
-        for (size_t index : args_) {
-            current = source_.find(IndexFormatSpecifier, last);
-            if (current == std::string::npos) {
+        for (size_t i = 0; i < arg_count_; ++i) {
+            const char *current = strstr(last, IndexFormatSpecifier());
+            if (current == nullptr) {
                 break;
             }
-            format << source_.substr(last, (current - last)) << index;
-            last = current + IndexFormatSpecifier.length();
+            format.append(last, current - last);
+            format += std::to_string(args_[i]);
+            last = current + specifier_length;
         }
 
-        format << source_.substr(last, std::string::npos);
+        format += last;
 
-        return format.str();
+        return format;
     }
 
-    /// Check that the number of %i format specifiers in the source string matches the number of elements in the index vector.
-    bool IsValid() {
+    /// Check that the number of %i format specifiers in the source string matches the number of index values.
+    bool IsValid() const {
         // Count the number of occurances of the format specifier
         uint32_t count = 0;
-        std::string::size_type pos = source_.find(IndexFormatSpecifier);
+        const char *pos = strstr(source_, IndexFormatSpecifier());
 
-        while (pos != std::string::npos) {
+        while (pos != nullptr) {
             ++count;
-            pos = source_.find(IndexFormatSpecifier, pos + 1);
+            pos = strstr(pos + 1, IndexFormatSpecifier());
         }
 
-        return (count == args_.size());
+        return (count == arg_count_);
     }
 
    private:
-    std::string source_;  ///< Format string.
-    IndexVector args_;    ///< Array index values for formatting.
+    const char *source_;           ///< Format string.
+    size_t args_[kMaxIndices];     ///< Array index values for formatting.
+    size_t arg_count_;             ///< Number of valid entries in args_.
 };
 
 #endif  // PARAMETER_NAME_H
@@ -510,7 +510,7 @@ static bool validate_string_array(debug_report_data *report_data, const char *ap
  * @param allowed_struct_names Names of allowed structs.
  * @param next Pointer to validate.
  * @param allowed_type_count Total number of allowed structure types.
- * @param allowed_types Array of strcuture types allowed for pNext.
+ * @param allowed_types Array of structure types allowed for pNext, sorted by value.
  * @param header_version Version of header defining the pNext validation rules.
  * @return Boolean value indicating that the call should be skipped.
  */
@@ -519,8 +519,6 @@ static bool validate_struct_pnext(debug_report_data *report_data, const char *ap
                                   const VkStructureType *allowed_types, uint32_t header_version,
                                   UNIQUE_VALIDATION_ERROR_CODE vuid) {
     bool skip_call = false;
-    std::unordered_set<const void *> cycle_check;
-    std::unordered_set<VkStructureType, std::hash<int>> unique_stype_check;
 
     const char disclaimer[] =
         "This warning is based on the Valid Usage documentation for version %d of the Vulkan header.  It "
@@ -528,8 +526,6 @@ static bool validate_struct_pnext(debug_report_data *report_data, const char *ap
         "to a later version of the Vulkan header, in which case your use of %s is perfectly valid but "
         "is not guaranteed to work correctly with validation enabled";
 
-    // TODO: The valid pNext structure types are not recursive. Each structure has its own list of valid sTypes for pNext.
-    // Codegen a map of vectors containing the allowable pNext types for each struct and use that here -- also simplifies parms.
     if (next != NULL) {
         if (allowed_type_count == 0) {
             std::string message = "%s: value of %s must be NULL. %s ";
@@ -538,35 +534,74 @@ static bool validate_struct_pnext(debug_report_data *report_data, const char *ap
                                  vuid, LayerName, message.c_str(), api_name, parameter_name.get_name().c_str(),
                                  validation_error_map[vuid], header_version, parameter_name.get_name().c_str());
         } else {
+            // allowed_types is a generated table sorted by value, with at most 64 entries. Allowed sTypes that have
+            // already appeared are tracked as bits indexed by their table position; other sTypes go in a small fixed-size
+            // array, and a chain with more distinct disallowed sTypes than that only has duplicates among the first ones
+            // reported.
+            const size_t kMaxTrackedStructs = 32;
             const VkStructureType *start = allowed_types;
             const VkStructureType *end = allowed_types + allowed_type_count;
-            const GenericHeader *current = reinterpret_cast<const GenericHeader *>(next);
-
-            cycle_check.insert(next);
+            uint64_t seen_allowed = 0;
+            VkStructureType seen_other[kMaxTrackedStructs];
+            size_t seen_other_count = 0;
+
+            // Find any cycle before validating anything, so that each node is checked once and the cycle is reported when
+            // the walk would come back to a node it has already seen. Floyd's algorithm finds where the cycle starts and
+            // its length without keeping track of visited nodes.
+            const GenericHeader *head = reinterpret_cast<const GenericHeader *>(next);
+            size_t distinct_count = SIZE_MAX;
+            const GenericHeader *tortoise = head;
+            const GenericHeader *hare = head;
+            while (hare != NULL && hare->pNext != NULL) {
+                tortoise = reinterpret_cast<const GenericHeader *>(tortoise->pNext);
+                hare = reinterpret_cast<const GenericHeader *>(reinterpret_cast<const GenericHeader *>(hare->pNext)->pNext);
+                if (tortoise == hare) {
+                    size_t cycle_start = 0;
+                    for (tortoise = head; tortoise != hare; ++cycle_start) {
+                        tortoise = reinterpret_cast<const GenericHeader *>(tortoise->pNext);
+                        hare = reinterpret_cast<const GenericHeader *>(hare->pNext);
+                    }
+                    size_t cycle_length = 1;
+                    for (hare = reinterpret_cast<const GenericHeader *>(tortoise->pNext); hare != tortoise; ++cycle_length) {
+                        hare = reinterpret_cast<const GenericHeader *>(hare->pNext);
+                    }
+                    distinct_count = cycle_start + cycle_length;
+                    break;
+                }
+            }
 
-            while (current != NULL) {
-                if (cycle_check.find(current->pNext) != cycle_check.end()) {
-                    std::string message = "%s: %s chain contains a cycle -- pNext pointer " PRIx64 " is repeated.";
+            const GenericHeader *current = head;
+            for (size_t position = 0; current != NULL; ++position) {
+                if (position == distinct_count) {
                     skip_call |= log_msg(report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_UNKNOWN_EXT, 0,
-                                         __LINE__, INVALID_STRUCT_PNEXT, LayerName, message.c_str(), api_name,
+                                         __LINE__, INVALID_STRUCT_PNEXT, LayerName,
+                                         "%s: %s chain contains a cycle -- pNext pointer 0x%" PRIx64 " is repeated.", api_name,
                                          parameter_name.get_name().c_str(), reinterpret_cast<uint64_t>(next));
                     break;
+                }
+
+                bool duplicate = false;
+                const VkStructureType *allowed = std::lower_bound(start, end, current->sType);
+                const bool is_allowed = (allowed != end) && (*allowed == current->sType);
+                if (is_allowed) {
+                    const uint64_t bit = uint64_t(1) << (allowed - start);
+                    duplicate = (seen_allowed & bit) != 0;
+                    seen_allowed |= bit;
                 } else {
-                    cycle_check.insert(current->pNext);
+                    duplicate = std::find(seen_other, seen_other + seen_other_count, current->sType) != seen_other + seen_other_count;
+                    if (!duplicate && seen_other_count < kMaxTrackedStructs) seen_other[seen_other_count++] = current->sType;
                 }
 
-                std::string type_name = string_VkStructureType(current->sType);
-                if (unique_stype_check.find(current->sType) != unique_stype_check.end()) {
-                    std::string message = "%s: %s chain contains duplicate structure types: %s appears multiple times.";
+                if (duplicate) {
                     skip_call |= log_msg(report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_UNKNOWN_EXT, 0,
-                                         __LINE__, INVALID_STRUCT_PNEXT, LayerName, message.c_str(), api_name,
-                                         parameter_name.get_name().c_str(), type_name.c_str());
-                } else {
-                    unique_stype_check.insert(current->sType);
+                                         __LINE__, INVALID_STRUCT_PNEXT, LayerName,
+                                         "%s: %s chain contains duplicate structure types: %s appears multiple times.", api_name,
+                                         parameter_name.get_name().c_str(), string_VkStructureType(current->sType));
                 }
 
-                if (std::find(start, end, current->sType) == end) {
-                    if (type_name == UnsupportedStructureTypeString) {
+                if (!is_allowed) {
+                    const char *type_name = string_VkStructureType(current->sType);
+                    if (UnsupportedStructureTypeString == type_name) {
                         std::string message =
                             "%s: %s chain includes a structure with unknown VkStructureType (%d); Allowed structures are [%s]. %s ";
                         message += disclaimer;
@@ -581,7 +616,7 @@ static bool validate_struct_pnext(debug_report_data *report_data, const char *ap
                         message += disclaimer;
                         skip_call |= log_msg(report_data, VK_DEBUG_REPORT_WARNING_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_UNKNOWN_EXT,
                                              0, __LINE__, vuid, LayerName, message.c_str(), api_name,
-                                             parameter_name.get_name().c_str(), type_name.c_str(), allowed_struct_names,
+                                             parameter_name.get_name().c_str(), type_name, allowed_struct_names,
                                              validation_error_map[vuid], header_version, parameter_name.get_name().c_str());
                     }
                 }
@@ -19,6 +19,7 @@
  */
 
 #include <cinttypes>
+#include <algorithm>
 #include <cassert>
 #include <vector>
 #include <unordered_map>
@@ -66,67 +67,193 @@ static shader_stage_attributes shader_stage_attribs[] = {
 };
 
 // SPIRV utility functions
-void shader_module::build_def_index() {
-    for (auto insn : *this) {
-        switch (insn.opcode()) {
-            // Types
-            case spv::OpTypeVoid:
-            case spv::OpTypeBool:
-            case spv::OpTypeInt:
-            case spv::OpTypeFloat:
-            case spv::OpTypeVector:
-            case spv::OpTypeMatrix:
-            case spv::OpTypeImage:
-            case spv::OpTypeSampler:
-            case spv::OpTypeSampledImage:
-            case spv::OpTypeArray:
-            case spv::OpTypeRuntimeArray:
-            case spv::OpTypeStruct:
-            case spv::OpTypeOpaque:
-            case spv::OpTypePointer:
-            case spv::OpTypeFunction:
-            case spv::OpTypeEvent:
-            case spv::OpTypeDeviceEvent:
-            case spv::OpTypeReserveId:
-            case spv::OpTypeQueue:
-            case spv::OpTypePipe:
-                def_index[insn.word(1)] = insn.offset();
-                break;
 
-                // Fixed constants
-            case spv::OpConstantTrue:
-            case spv::OpConstantFalse:
-            case spv::OpConstant:
-            case spv::OpConstantComposite:
-            case spv::OpConstantSampler:
-            case spv::OpConstantNull:
-                def_index[insn.word(2)] = insn.offset();
-                break;
+// The word holding the result id of the defs that def_index covers, or 0 for any other instruction
+static uint32_t def_index_id_word(uint32_t opcode) {
+    switch (opcode) {
+        // Types
+        case spv::OpTypeVoid:
+        case spv::OpTypeBool:
+        case spv::OpTypeInt:
+        case spv::OpTypeFloat:
+        case spv::OpTypeVector:
+        case spv::OpTypeMatrix:
+        case spv::OpTypeImage:
+        case spv::OpTypeSampler:
+        case spv::OpTypeSampledImage:
+        case spv::OpTypeArray:
+        case spv::OpTypeRuntimeArray:
+        case spv::OpTypeStruct:
+        case spv::OpTypeOpaque:
+        case spv::OpTypePointer:
+        case spv::OpTypeFunction:
+        case spv::OpTypeEvent:
+        case spv::OpTypeDeviceEvent:
+        case spv::OpTypeReserveId:
+        case spv::OpTypeQueue:
+        case spv::OpTypePipe:
+            return 1;
 
-                // Specialization constants
-            case spv::OpSpecConstantTrue:
-            case spv::OpSpecConstantFalse:
-            case spv::OpSpecConstant:
-            case spv::OpSpecConstantComposite:
-            case spv::OpSpecConstantOp:
-                def_index[insn.word(2)] = insn.offset();
-                break;
+        // Fixed constants
+        case spv::OpConstantTrue:
+        case spv::OpConstantFalse:
+        case spv::OpConstant:
+        case spv::OpConstantComposite:
+        case spv::OpConstantSampler:
+        case spv::OpConstantNull:
+            return 2;
 
-                // Variables
-            case spv::OpVariable:
-                def_index[insn.word(2)] = insn.offset();
-                break;
+        // Specialization constants
+        case spv::OpSpecConstantTrue:
+        case spv::OpSpecConstantFalse:
+        case spv::OpSpecConstant:
+        case spv::OpSpecConstantComposite:
+        case spv::OpSpecConstantOp:
+            return 2;
+
+        // Variables
+        case spv::OpVariable:
+            return 2;
+
+        // Functions
+        case spv::OpFunction:
+            return 2;
+
+        default:
+            // We don't care about any other defs for now.
+            return 0;
+    }
+}
+
+// Add the ids that an instruction in a function body may make accessible: pointers loaded from, stored to or accessed,
+// images sampled, read or written, functions called and their arguments, and operands to extended instructions
+static void collect_referenced_ids(uint32_t const *insn, std::vector<uint32_t> *refs) {
+    uint32_t len = insn[0] >> 16;
+    switch (insn[0] & 0x0ffffu) {
+        case spv::OpLoad:
+        case spv::OpAtomicLoad:
+        case spv::OpAtomicExchange:
+        case spv::OpAtomicCompareExchange:
+        case spv::OpAtomicCompareExchangeWeak:
+        case spv::OpAtomicIIncrement:
+        case spv::OpAtomicIDecrement:
+        case spv::OpAtomicIAdd:
+        case spv::OpAtomicISub:
+        case spv::OpAtomicSMin:
+        case spv::OpAtomicUMin:
+        case spv::OpAtomicSMax:
+        case spv::OpAtomicUMax:
+        case spv::OpAtomicAnd:
+        case spv::OpAtomicOr:
+        case spv::OpAtomicXor:
+            refs->push_back(insn[3]);  // ptr
+            break;
+        case spv::OpStore:
+        case spv::OpAtomicStore:
+            refs->push_back(insn[1]);  // ptr
+            break;
+        case spv::OpAccessChain:
+        case spv::OpInBoundsAccessChain:
+            refs->push_back(insn[3]);  // base ptr
+            break;
+        case spv::OpSampledImage:
+        case spv::OpImageSampleImplicitLod:
+        case spv::OpImageSampleExplicitLod:
+        case spv::OpImageSampleDrefImplicitLod:
+        case spv::OpImageSampleDrefExplicitLod:
+        case spv::OpImageSampleProjImplicitLod:
+        case spv::OpImageSampleProjExplicitLod:
+        case spv::OpImageSampleProjDrefImplicitLod:
+        case spv::OpImageSampleProjDrefExplicitLod:
+        case spv::OpImageFetch:
+        case spv::OpImageGather:
+        case spv::OpImageDrefGather:
+        case spv::OpImageRead:
+        case spv::OpImage:
+        case spv::OpImageQueryFormat:
+        case spv::OpImageQueryOrder:
+        case spv::OpImageQuerySizeLod:
+        case spv::OpImageQuerySize:
+        case spv::OpImageQueryLod:
+        case spv::OpImageQueryLevels:
+        case spv::OpImageQuerySamples:
+        case spv::OpImageSparseSampleImplicitLod:
+        case spv::OpImageSparseSampleExplicitLod:
+        case spv::OpImageSparseSampleDrefImplicitLod:
+        case spv::OpImageSparseSampleDrefExplicitLod:
+        case spv::OpImageSparseSampleProjImplicitLod:
+        case spv::OpImageSparseSampleProjExplicitLod:
+        case spv::OpImageSparseSampleProjDrefImplicitLod:
+        case spv::OpImageSparseSampleProjDrefExplicitLod:
+        case spv::OpImageSparseFetch:
+        case spv::OpImageSparseGather:
+        case spv::OpImageSparseDrefGather:
+        case spv::OpImageTexelPointer:
+            refs->push_back(insn[3]);  // Image or sampled image
+            break;
+        case spv::OpImageWrite:
+            refs->push_back(insn[1]);  // Image -- different operand order to above
+            break;
+        case spv::OpFunctionCall:
+            refs->insert(refs->end(), insn + 3, insn + len);  // fn itself, and all args
+            break;
+        case spv::OpExtInst:
+            if (len > 5) refs->insert(refs->end(), insn + 5, insn + len);  // Operands to ext inst
+            break;
+    }
+}
+
+shader_module::shader_module(VkShaderModuleCreateInfo const *pCreateInfo, bool keep_function_bodies) : has_valid_spirv(true) {
+    uint32_t const *code = pCreateInfo->pCode;
+    size_t size = pCreateInfo->codeSize / sizeof(uint32_t);
+    if (keep_function_bodies) {
+        words.assign(code, code + size);
+    } else {
+        words.assign(code, code + std::min<size_t>(size, 5));  // Header
+    }
 
-                // Functions
+    std::vector<uint32_t> *refs = nullptr;  // Those of the function whose body we're in
+    for (size_t offset = 5; offset < size;) {
+        uint32_t const *insn = code + offset;
+        uint32_t opcode = insn[0] & 0x0ffffu;
+        uint32_t len = insn[0] >> 16;
+        assert(len > 0);
+
+        bool in_body = false;
+        switch (opcode) {
             case spv::OpFunction:
-                def_index[insn.word(2)] = insn.offset();
+                refs = &function_refs[insn[2]];
+                break;
+            case spv::OpFunctionParameter:
+                break;
+            case spv::OpFunctionEnd:
+                if (refs) {
+                    std::sort(refs->begin(), refs->end());
+                    refs->erase(std::unique(refs->begin(), refs->end()), refs->end());
+                    refs->shrink_to_fit();
+                }
+                refs = nullptr;
                 break;
-
             default:
-                // We don't care about any other defs for now.
+                if (refs) {
+                    collect_referenced_ids(insn, refs);
+                    in_body = true;
+                }
                 break;
         }
+
+        if (keep_function_bodies || !in_body) {
+            uint32_t word_offset = static_cast<uint32_t>(offset);
+            if (!keep_function_bodies) {
+                word_offset = static_cast<uint32_t>(words.size());
+                words.insert(words.end(), insn, insn + len);
+            }
+            uint32_t id_word = def_index_id_word(opcode);
+            if (id_word) def_index[insn[id_word]] = word_offset;
+        }
+        offset += len;
     }
+    if (!keep_function_bodies) words.shrink_to_fit();
 }
 
 static spirv_inst_iter find_entrypoint(shader_module const *src, char const *name, VkShaderStageFlagBits stageBits) {
@@ -844,7 +971,7 @@ static std::unordered_set<uint32_t> mark_accessible_ids(shader_module const *src
 
         auto insn = src->get_def(id);
         if (insn == src->end()) {
-            // ID is something we didn't collect in build_def_index. that's OK -- we'll stumble across all kinds of things here
+            // ID is something we didn't collect in def_index. that's OK -- we'll stumble across all kinds of things here
             // that we may not care about.
             continue;
         }
@@ -854,89 +981,10 @@ static std::unordered_set<uint32_t> mark_accessible_ids(shader_module const *src
             continue;  // If we already saw this id, we don't want to walk it again.
         }
 
-        switch (insn.opcode()) {
-            case spv::OpFunction:
-                // Scan whole body of the function, enlisting anything interesting
-                while (++insn, insn.opcode() != spv::OpFunctionEnd) {
-                    switch (insn.opcode()) {
-                        case spv::OpLoad:
-                        case spv::OpAtomicLoad:
-                        case spv::OpAtomicExchange:
-                        case spv::OpAtomicCompareExchange:
-                        case spv::OpAtomicCompareExchangeWeak:
-                        case spv::OpAtomicIIncrement:
-                        case spv::OpAtomicIDecrement:
-                        case spv::OpAtomicIAdd:
-                        case spv::OpAtomicISub:
-                        case spv::OpAtomicSMin:
-                        case spv::OpAtomicUMin:
-                        case spv::OpAtomicSMax:
-                        case spv::OpAtomicUMax:
-                        case spv::OpAtomicAnd:
-                        case spv::OpAtomicOr:
-                        case spv::OpAtomicXor:
-                            worklist.insert(insn.word(3));  // ptr
-                            break;
-                        case spv::OpStore:
-                        case spv::OpAtomicStore:
-                            worklist.insert(insn.word(1));  // ptr
-                            break;
-                        case spv::OpAccessChain:
-                        case spv::OpInBoundsAccessChain:
-                            worklist.insert(insn.word(3));  // base ptr
-                            break;
-                        case spv::OpSampledImage:
-                        case spv::OpImageSampleImplicitLod:
-                        case spv::OpImageSampleExplicitLod:
-                        case spv::OpImageSampleDrefImplicitLod:
-                        case spv::OpImageSampleDrefExplicitLod:
-                        case spv::OpImageSampleProjImplicitLod:
-                        case spv::OpImageSampleProjExplicitLod:
-                        case spv::OpImageSampleProjDrefImplicitLod:
-                        case spv::OpImageSampleProjDrefExplicitLod:
-                        case spv::OpImageFetch:
-                        case spv::OpImageGather:
-                        case spv::OpImageDrefGather:
-                        case spv::OpImageRead:
-                        case spv::OpImage:
-                        case spv::OpImageQueryFormat:
-                        case spv::OpImageQueryOrder:
-                        case spv::OpImageQuerySizeLod:
-                        case spv::OpImageQuerySize:
-                        case spv::OpImageQueryLod:
-                        case spv::OpImageQueryLevels:
-                        case spv::OpImageQuerySamples:
-                        case spv::OpImageSparseSampleImplicitLod:
-                        case spv::OpImageSparseSampleExplicitLod:
-                        case spv::OpImageSparseSampleDrefImplicitLod:
-                        case spv::OpImageSparseSampleDrefExplicitLod:
-                        case spv::OpImageSparseSampleProjImplicitLod:
-                        case spv::OpImageSparseSampleProjExplicitLod:
-                        case spv::OpImageSparseSampleProjDrefImplicitLod:
-                        case spv::OpImageSparseSampleProjDrefExplicitLod:
-                        case spv::OpImageSparseFetch:
-                        case spv::OpImageSparseGather:
-                        case spv::OpImageSparseDrefGather:
-                        case spv::OpImageTexelPointer:
-                            worklist.insert(insn.word(3));  // Image or sampled image
-                            break;
-                        case spv::OpImageWrite:
-                            worklist.insert(insn.word(1));  // Image -- different operand order to above
-                            break;
-                        case spv::OpFunctionCall:
-                            for (uint32_t i = 3; i < insn.len(); i++) {
-                                worklist.insert(insn.word(i));  // fn itself, and all args
-                            }
-                            break;
-
-                        case spv::OpExtInst:
-                            for (uint32_t i = 5; i < insn.len(); i++) {
-                                worklist.insert(insn.word(i));  // Operands to ext inst
-                            }
-                            break;
-                    }
-                }
-                break;
+        if (insn.opcode() == spv::OpFunction) {
+            // Enlist anything interesting that the function's body refers to
+            auto refs = src->function_refs.find(id);
+            if (refs != src->function_refs.end()) worklist.insert(refs->second.begin(), refs->second.end());
         }
     }
 
@@ -1280,7 +1328,10 @@ static bool validate_pipeline_shader_stage(
     auto module = *out_module = GetShaderModuleState(dev_data, pStage->module);
     auto report_data = GetReportData(dev_data);
 
-    if (!module->has_valid_spirv) return false;
+    // The first pipeline to use a deferred module reports its SPIR-V errors. Create*Pipelines has already waited for it
+    // with global_lock released, so this doesn't block.
+    skip |= WaitForShaderModule(dev_data, pStage->module, module);
+    if (!module->has_valid_spirv) return skip;
 
     // Find the entrypoint
     auto entrypoint = *out_entrypoint = find_entrypoint(module, pStage->pName, pStage->stage);
@@ -1302,7 +1353,7 @@ static bool validate_pipeline_shader_stage(
     auto descriptor_uses = collect_interface_by_descriptor_slot(report_data, module, accessible_ids);
 
     skip |= validate_specialization_offsets(report_data, pStage);
-    skip |= validate_push_constant_usage(report_data, &pipeline->pipeline_layout.push_constant_ranges, module, accessible_ids, pStage->stage);
+    skip |= validate_push_constant_usage(report_data, &pipeline->pipeline_layout->push_constant_ranges, module, accessible_ids, pStage->stage);
 
     // Validate descriptor use
     for (auto use : descriptor_uses) {
@@ -1311,7 +1362,7 @@ static bool validate_pipeline_shader_stage(
         reqs = descriptor_req(reqs | descriptor_type_to_reqs(module, use.second.type_id));
 
         // Verify given pipelineLayout has requested setLayout with requested binding
-        const auto &binding = get_descriptor_binding(&pipeline->pipeline_layout, use.first);
+        const auto &binding = get_descriptor_binding(pipeline->pipeline_layout.get(), use.first);
         unsigned required_descriptor_count;
 
         if (!binding) {
@@ -1348,7 +1399,7 @@ static bool validate_pipeline_shader_stage(
     if (pStage->stage == VK_SHADER_STAGE_FRAGMENT_BIT) {
         auto input_attachment_uses = collect_interface_by_input_attachment_index(module, accessible_ids);
 
-        auto rpci = pipeline->render_pass_ci.ptr();
+        auto rpci = pipeline->rp_state->createInfo.ptr();
         auto subpass = pipeline->graphicsPipelineCI.subpass;
 
         for (auto use : input_attachment_uses) {
@@ -1495,14 +1546,14 @@ bool validate_and_capture_pipeline_shader_state(layer_data *dev_data, PIPELINE_S
 
     if (shaders[fragment_stage] && shaders[fragment_stage]->has_valid_spirv) {
         skip |= validate_fs_outputs_against_render_pass(report_data, shaders[fragment_stage], entrypoints[fragment_stage],
-                                                        pPipeline->render_pass_ci.ptr(), pCreateInfo->subpass);
+                                                        pPipeline->rp_state->createInfo.ptr(), pCreateInfo->subpass);
     }
 
     return skip;
 }
 
 bool validate_compute_pipeline(layer_data *dev_data, PIPELINE_STATE *pPipeline) {
-    auto pCreateInfo = pPipeline->computePipelineCI.ptr();
+    auto pCreateInfo = pPipeline->computePipelineCI->ptr();
 
     shader_module const *module;
     spirv_inst_iter entrypoint;
@@ -1510,6 +1561,25 @@ bool validate_compute_pipeline(layer_data *dev_data, PIPELINE_STATE *pPipeline)
     return validate_pipeline_shader_stage(dev_data, &pCreateInfo->stage, pPipeline, &module, &entrypoint);
 }
 
+// Runs the SPIRV-Tools validator over a module, returning the message to report if it isn't valid
+static spv_result_t ValidateSpirv(spv_context ctx, VkShaderModuleCreateInfo const *pCreateInfo, bool have_glsl_shader,
+                                  VkDebugReportFlagsEXT *report_flags, std::string *report) {
+    spv_const_binary_t binary{pCreateInfo->pCode, pCreateInfo->codeSize / sizeof(uint32_t)};
+    spv_diagnostic diag = nullptr;
+
+    spv_result_t spv_valid = spvValidate(ctx, &binary, &diag);
+    *report_flags = 0;
+    if (spv_valid != SPV_SUCCESS) {
+        if (!have_glsl_shader || (pCreateInfo->pCode[0] == spv::MagicNumber)) {
+            *report_flags = spv_valid == SPV_WARNING ? VK_DEBUG_REPORT_WARNING_BIT_EXT : VK_DEBUG_REPORT_ERROR_BIT_EXT;
+            *report = std::string("SPIR-V module not valid: ") + (diag && diag->error ? diag->error : "(no error text)");
+        }
+    }
+
+    spvDiagnosticDestroy(diag);
+    return spv_valid;
+}
+
 bool PreCallValidateCreateShaderModule(layer_data *dev_data, VkShaderModuleCreateInfo const *pCreateInfo, bool *spirv_valid) {
     bool skip = false;
     spv_result_t spv_valid = SPV_SUCCESS;
@@ -1526,26 +1596,108 @@ bool PreCallValidateCreateShaderModule(layer_data *dev_data, VkShaderModuleCreat
                         __LINE__, VALIDATION_ERROR_12a00ac0, "SC",
                         "SPIR-V module not valid: Codesize must be a multiple of 4 but is " PRINTF_SIZE_T_SPECIFIER ". %s",
                         pCreateInfo->codeSize, validation_error_map[VALIDATION_ERROR_12a00ac0]);
+    } else if (GetShaderValidationPool(dev_data)) {
+        // Left to the pool once the module has been created; see DeferShaderModuleValidation()
     } else {
         // Use SPIRV-Tools validator to try and catch any issues with the module itself
         spv_context ctx = spvContextCreate(SPV_ENV_VULKAN_1_0);
-        spv_const_binary_t binary{ pCreateInfo->pCode, pCreateInfo->codeSize / sizeof(uint32_t) };
-        spv_diagnostic diag = nullptr;
-
-        spv_valid = spvValidate(ctx, &binary, &diag);
-        if (spv_valid != SPV_SUCCESS) {
-            if (!have_glsl_shader || (pCreateInfo->pCode[0] == spv::MagicNumber)) {
-                skip |= log_msg(report_data,
-                                spv_valid == SPV_WARNING ? VK_DEBUG_REPORT_WARNING_BIT_EXT : VK_DEBUG_REPORT_ERROR_BIT_EXT,
-                                VK_DEBUG_REPORT_OBJECT_TYPE_UNKNOWN_EXT, 0, __LINE__, SHADER_CHECKER_INCONSISTENT_SPIRV, "SC",
-                                "SPIR-V module not valid: %s", diag && diag->error ? diag->error : "(no error text)");
-            }
+        VkDebugReportFlagsEXT report_flags;
+        std::string report;
+
+        spv_valid = ValidateSpirv(ctx, pCreateInfo, have_glsl_shader, &report_flags, &report);
+        if (report_flags) {
+            skip |= log_msg(report_data, report_flags, VK_DEBUG_REPORT_OBJECT_TYPE_UNKNOWN_EXT, 0, __LINE__,
+                            SHADER_CHECKER_INCONSISTENT_SPIRV, "SC", "%s", report.c_str());
         }
 
-        spvDiagnosticDestroy(diag);
         spvContextDestroy(ctx);
     }
 
     *spirv_valid = (spv_valid == SPV_SUCCESS);
     return skip;
 }
+
+ShaderValidationPool::ShaderValidationPool(uint32_t thread_count) : stop_(false) {
+    for (uint32_t i = 0; i < thread_count; i++) {
+        threads_.emplace_back(&ShaderValidationPool::Run, this);
+    }
+}
+
+ShaderValidationPool::~ShaderValidationPool() {
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        stop_ = true;
+    }
+    queue_cv_.notify_all();
+    for (auto &thread : threads_) {
+        thread.join();
+    }
+}
+
+std::shared_future<void> ShaderValidationPool::Enqueue(std::function<void(spv_context)> task) {
+    std::packaged_task<void(spv_context)> packaged_task(std::move(task));
+    std::shared_future<void> done = packaged_task.get_future().share();
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        queue_.push_back(std::move(packaged_task));
+    }
+    queue_cv_.notify_one();
+    return done;
+}
+
+void ShaderValidationPool::Run() {
+    spv_context ctx = spvContextCreate(SPV_ENV_VULKAN_1_0);
+    std::unique_lock<std::mutex> lock(lock_);
+    while (true) {
+        queue_cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) break;  // Stopping, with nothing left to run
+        auto task = std::move(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+        task(ctx);
+        lock.lock();
+    }
+    lock.unlock();
+    spvContextDestroy(ctx);
+}
+
+shader_module *DeferShaderModuleValidation(layer_data *dev_data, ShaderValidationPool *pool,
+                                           VkShaderModuleCreateInfo const *pCreateInfo, bool keep_function_bodies) {
+    auto module = new shader_module();
+    module->deferred.reset(new deferred_shader_validation());
+    module->deferred->code.assign(pCreateInfo->pCode, pCreateInfo->pCode + pCreateInfo->codeSize / sizeof(uint32_t));
+    auto have_glsl_shader = GetEnabledExtensions(dev_data)->vk_nv_glsl_shader;
+
+    module->deferred->done = pool->Enqueue([module, have_glsl_shader, keep_function_bodies](spv_context ctx) {
+        auto deferred = module->deferred.get();
+        VkShaderModuleCreateInfo create_info = {};
+        create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        create_info.codeSize = deferred->code.size() * sizeof(uint32_t);
+        create_info.pCode = deferred->code.data();
+
+        if (ValidateSpirv(ctx, &create_info, have_glsl_shader, &deferred->report_flags, &deferred->report) == SPV_SUCCESS) {
+            shader_module parsed(&create_info, keep_function_bodies);
+            module->words.swap(parsed.words);
+            module->def_index.swap(parsed.def_index);
+            module->function_refs.swap(parsed.function_refs);
+            module->has_valid_spirv = true;
+        }
+        std::vector<uint32_t>().swap(deferred->code);
+    });
+    return module;
+}
+
+bool WaitForShaderModule(layer_data *dev_data, VkShaderModule handle, shader_module const *module) {
+    auto deferred = module->deferred.get();
+    if (!deferred) return false;
+
+    deferred->done.wait();
+    std::call_once(deferred->reported, [dev_data, handle, deferred]() {
+        if (deferred->report_flags) {
+            deferred->skip = log_msg(GetReportData(dev_data), deferred->report_flags, VK_DEBUG_REPORT_OBJECT_TYPE_SHADER_MODULE_EXT,
+                                     HandleToUint64(handle), __LINE__, SHADER_CHECKER_INCONSISTENT_SPIRV, "SC", "%s",
+                                     deferred->report.c_str());
+        }
+    });
+    return deferred->skip;
+}
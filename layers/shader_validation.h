@@ -20,6 +20,16 @@
 #ifndef VULKAN_SHADER_VALIDATION_H
 #define VULKAN_SHADER_VALIDATION_H
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "spirv-tools/libspirv.h"
+
 // A forward iterator over spirv instructions. Provides easy access to len, opcode, and content words
 // without the caller needing to care too much about the physical SPIRV module layout.
 struct spirv_inst_iter {
@@ -65,20 +75,40 @@ struct spirv_inst_iter {
     spirv_inst_iter const &operator*() const { return *this; }
 };
 
+// SPIR-V validation of a module that was left to the ShaderValidationPool, and what it found
+struct deferred_shader_validation {
+    // A copy of pCode, until the pool is done with it
+    std::vector<uint32_t> code;
+    // Ready once the module has been validated and, if valid, read into the shader_module
+    std::shared_future<void> done;
+    // The message to report against the module, if report_flags isn't 0
+    VkDebugReportFlagsEXT report_flags;
+    std::string report;
+    // Reported once, at the first pipeline that uses the module or when it is destroyed
+    std::once_flag reported;
+    bool skip;
+
+    deferred_shader_validation() : report_flags(0), skip(false) {}
+};
+
 struct shader_module {
-    // The spirv image itself
+    // The spirv image itself. When function bodies aren't kept, each function is left as its OpFunction, OpFunctionParameters
+    // and OpFunctionEnd; everything outside functions is always kept.
     std::vector<uint32_t> words;
     // A mapping of <id> to the first word of its def. this is useful because walking type
     // trees, constant expressions, etc requires jumping all over the instruction stream.
     std::unordered_map<unsigned, unsigned> def_index;
+    // For each function, the ids its body loads, stores, accesses, samples, calls or passes to extended instructions --
+    // all that mark_accessible_ids() needs of the body.
+    std::unordered_map<unsigned, std::vector<uint32_t>> function_refs;
     bool has_valid_spirv;
+    // Set when the module is validated on the ShaderValidationPool. None of the above may be read until it is done; see
+    // WaitForShaderModule().
+    std::unique_ptr<deferred_shader_validation> deferred;
 
-    shader_module(VkShaderModuleCreateInfo const *pCreateInfo)
-        : words((uint32_t *)pCreateInfo->pCode, (uint32_t *)pCreateInfo->pCode + pCreateInfo->codeSize / sizeof(uint32_t)),
-          def_index(),
-          has_valid_spirv(true) {
-        build_def_index();
-    }
+    // Reads the module in a single pass. Without keep_function_bodies only the reflection data is kept, not a copy of
+    // the whole module.
+    shader_module(VkShaderModuleCreateInfo const *pCreateInfo, bool keep_function_bodies);
 
     shader_module() : has_valid_spirv(false) {}
 
@@ -96,10 +126,33 @@ struct shader_module {
         }
         return at(it->second);
     }
+};
 
-    void build_def_index();
+// Worker threads for lunarg_core_validation.deferred_shader_validation_threads. Each has a SPIR-V validator context of its
+// own. The destructor runs everything still queued before it returns.
+class ShaderValidationPool {
+   public:
+    explicit ShaderValidationPool(uint32_t thread_count);
+    ~ShaderValidationPool();
+
+    std::shared_future<void> Enqueue(std::function<void(spv_context)> task);
+
+   private:
+    void Run();
+
+    std::mutex lock_;
+    std::condition_variable queue_cv_;
+    std::deque<std::packaged_task<void(spv_context)>> queue_;
+    bool stop_;
+    std::vector<std::thread> threads_;
 };
 
+// Returns the state for a module whose validation and parsing is left to the pool. The create info needn't outlive the call.
+shader_module *DeferShaderModuleValidation(layer_data *dev_data, ShaderValidationPool *pool,
+                                           VkShaderModuleCreateInfo const *pCreateInfo, bool keep_function_bodies);
+// Waits for a module's deferred validation, if any, and reports what it found the first time it's called for the module
+bool WaitForShaderModule(layer_data *dev_data, VkShaderModule handle, shader_module const *module);
+
 bool validate_and_capture_pipeline_shader_state(layer_data *dev_data, PIPELINE_STATE *pPipeline);
 bool validate_compute_pipeline(layer_data *dev_data, PIPELINE_STATE *pPipeline);
 typedef std::pair<unsigned, unsigned> descriptor_slot_t;
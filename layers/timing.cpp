@@ -0,0 +1,446 @@
+/* Copyright (c) 2015-2017 The Khronos Group Inc.
+ * Copyright (c) 2015-2017 Valve Corporation
+ * Copyright (c) 2015-2017 LunarG, Inc.
+ * Copyright (C) 2015-2017 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: Tobin Ehlis <tobine@google.com>
+ */
+
+// The timing layer records, for every intercepted command, the number of calls and a latency histogram of the time
+// spent below this layer in the chain. Samples are kept per thread and merged only when a report is written, at
+// vkDestroyDevice or when the process receives SIGUSR1 (if enabled). Placing the layer at different positions in
+// the chain attributes time to the layers below it versus the driver.
+
+#include <inttypes.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "vk_loader_platform.h"
+#include "vulkan/vk_layer.h"
+#include "vk_layer_config.h"
+#include "vk_layer_extension_utils.h"
+#include "vk_layer_utils.h"
+#include "vk_layer_table.h"
+#include "timing.h"
+#include "vk_dispatch_table_helper.h"
+#include "vk_layer_data.h"
+
+#include "timing_wrappers.h"
+
+namespace timing {
+
+static uint32_t loader_layer_if_version = CURRENT_LOADER_LAYER_INTERFACE_VERSION;
+
+THREAD_LOCAL_DECL ThreadStats *tls_thread_stats = nullptr;
+std::atomic<bool> dump_requested(false);
+
+static std::atomic<ThreadStats *> thread_stats_list(nullptr);
+static std::atomic<uint32_t> thread_stats_count(0);
+
+struct TimingSettings {
+    bool csv;
+    bool per_thread;
+    std::string filename;
+};
+
+static std::mutex settings_lock;
+static bool settings_initialized = false;
+static TimingSettings settings;
+// Serializes report writers; recording threads never take it
+static std::mutex dump_lock;
+
+ThreadStats *RegisterThreadStats() {
+    ThreadStats *thread_stats = new ThreadStats();
+    thread_stats->thread_index = thread_stats_count.fetch_add(1);
+    thread_stats->thread_id = std::hash<std::thread::id>()(std::this_thread::get_id());
+    ThreadStats *head = thread_stats_list.load(std::memory_order_relaxed);
+    do {
+        thread_stats->next = head;
+    } while (!thread_stats_list.compare_exchange_weak(head, thread_stats, std::memory_order_release, std::memory_order_relaxed));
+    tls_thread_stats = thread_stats;
+    return thread_stats;
+}
+
+// Plain copy of FunctionStats used while merging
+struct StatsSnapshot {
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t histogram[kHistogramBuckets];
+};
+
+static void MergeStats(StatsSnapshot &dst, const FunctionStats &src) {
+    dst.calls += src.calls.load(std::memory_order_relaxed);
+    dst.total_ns += src.total_ns.load(std::memory_order_relaxed);
+    uint64_t max_ns = src.max_ns.load(std::memory_order_relaxed);
+    if (max_ns > dst.max_ns) dst.max_ns = max_ns;
+    for (uint32_t i = 0; i < kHistogramBuckets; ++i) {
+        dst.histogram[i] += src.histogram[i].load(std::memory_order_relaxed);
+    }
+}
+
+static void SnapshotThread(const ThreadStats *thread_stats, std::vector<StatsSnapshot> &snapshot) {
+    snapshot.assign(TIMED_FUNCTION_COUNT, StatsSnapshot());
+    for (uint32_t i = 0; i < TIMED_FUNCTION_COUNT; ++i) MergeStats(snapshot[i], thread_stats->functions[i]);
+}
+
+static void WriteJsonFunctions(FILE *out, const std::vector<StatsSnapshot> &stats, const char *indent) {
+    bool first = true;
+    for (uint32_t i = 0; i < TIMED_FUNCTION_COUNT; ++i) {
+        const StatsSnapshot &entry = stats[i];
+        if (!entry.calls) continue;
+        fprintf(out, "%s\n%s{\"name\": \"%s\", \"calls\": %" PRIu64 ", \"total_ns\": %" PRIu64 ", \"max_ns\": %" PRIu64
+                     ", \"histogram\": [",
+                first ? "" : ",", indent, timed_function_names[i], entry.calls, entry.total_ns, entry.max_ns);
+        for (uint32_t b = 0; b < kHistogramBuckets; ++b) {
+            fprintf(out, "%s%" PRIu64, b ? ", " : "", entry.histogram[b]);
+        }
+        fprintf(out, "]}");
+        first = false;
+    }
+}
+
+static void WriteCsvRows(FILE *out, const char *thread_label, const std::vector<StatsSnapshot> &stats) {
+    for (uint32_t i = 0; i < TIMED_FUNCTION_COUNT; ++i) {
+        const StatsSnapshot &entry = stats[i];
+        if (!entry.calls) continue;
+        fprintf(out, "%s,%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64, thread_label, timed_function_names[i], entry.calls, entry.total_ns,
+                entry.max_ns);
+        for (uint32_t b = 0; b < kHistogramBuckets; ++b) {
+            fprintf(out, ",%" PRIu64, entry.histogram[b]);
+        }
+        fprintf(out, "\n");
+    }
+}
+
+// Merge every thread's counters and write the report. The counters keep running while this reads them, so the
+// report is a consistent-enough snapshot rather than an exact cut.
+static void DumpReport() {
+    std::lock_guard<std::mutex> lock(dump_lock);
+
+    std::vector<const ThreadStats *> threads;
+    for (const ThreadStats *thread_stats = thread_stats_list.load(std::memory_order_acquire); thread_stats;
+         thread_stats = thread_stats->next) {
+        threads.push_back(thread_stats);
+    }
+
+    std::vector<StatsSnapshot> merged(TIMED_FUNCTION_COUNT, StatsSnapshot());
+    for (auto thread_stats : threads) {
+        for (uint32_t i = 0; i < TIMED_FUNCTION_COUNT; ++i) MergeStats(merged[i], thread_stats->functions[i]);
+    }
+
+    FILE *out = getLayerLogOutput(settings.filename.c_str(), "google_timing");
+    std::vector<StatsSnapshot> per_thread;
+    if (settings.csv) {
+        fprintf(out, "thread,function,calls,total_ns,max_ns");
+        for (uint32_t b = 0; b < kHistogramBuckets; ++b) fprintf(out, ",hist%u", b);
+        fprintf(out, "\n");
+        WriteCsvRows(out, "all", merged);
+        if (settings.per_thread) {
+            for (auto it = threads.rbegin(); it != threads.rend(); ++it) {
+                SnapshotThread(*it, per_thread);
+                WriteCsvRows(out, std::to_string((*it)->thread_index).c_str(), per_thread);
+            }
+        }
+    } else {
+        fprintf(out, "{\n  \"layer\": \"VK_LAYER_GOOGLE_timing\",\n");
+        fprintf(out, "  \"histogram_buckets\": \"log2 ns: bucket i counts calls taking [2^i, 2^(i+1)) ns\",\n");
+        fprintf(out, "  \"functions\": [");
+        WriteJsonFunctions(out, merged, "    ");
+        fprintf(out, "\n  ]");
+        if (settings.per_thread) {
+            fprintf(out, ",\n  \"threads\": [");
+            for (auto it = threads.rbegin(); it != threads.rend(); ++it) {
+                SnapshotThread(*it, per_thread);
+                fprintf(out, "%s\n    {\"thread\": %u, \"thread_id\": %" PRIu64 ", \"functions\": [", it == threads.rbegin() ? "" : ",",
+                        (*it)->thread_index, (*it)->thread_id);
+                WriteJsonFunctions(out, per_thread, "      ");
+                fprintf(out, "\n    ]}");
+            }
+            fprintf(out, "\n  ]");
+        }
+        fprintf(out, "\n}\n");
+    }
+
+    if (out == stdout) {
+        fflush(out);
+    } else {
+        fclose(out);
+    }
+}
+
+void ProcessPendingDump() {
+    if (dump_requested.exchange(false)) DumpReport();
+}
+
+#if !defined(_WIN32)
+static struct sigaction previous_dump_action;
+
+// Only flags the request; the report is written by the next thread to finish a timed call. Whatever handler the
+// application had installed still runs.
+static void DumpSignalHandler(int sig, siginfo_t *info, void *context) {
+    dump_requested.store(true, std::memory_order_relaxed);
+    if (previous_dump_action.sa_flags & SA_SIGINFO) {
+        previous_dump_action.sa_sigaction(sig, info, context);
+    } else if (previous_dump_action.sa_handler != SIG_DFL && previous_dump_action.sa_handler != SIG_IGN) {
+        previous_dump_action.sa_handler(sig);
+    }
+}
+#endif
+
+static void InitTiming() {
+    std::lock_guard<std::mutex> lock(settings_lock);
+    if (settings_initialized) return;
+    settings_initialized = true;
+
+    settings.csv = !strcmp(getLayerOption("google_timing.output_format"), "csv");
+    settings.per_thread = strcmp(getLayerOption("google_timing.per_thread"), "false") != 0;
+    settings.filename = getLayerOption("google_timing.output_filename");
+    if (settings.filename.empty()) settings.filename = settings.csv ? "vk_timing.csv" : "vk_timing.json";
+
+#if !defined(_WIN32)
+    if (!strcmp(getLayerOption("google_timing.dump_on_signal"), "true")) {
+        struct sigaction action = {};
+        action.sa_sigaction = DumpSignalHandler;
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGUSR1, &action, &previous_dump_action);
+    }
+#endif
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL CreateInstance(const VkInstanceCreateInfo *pCreateInfo, const VkAllocationCallbacks *pAllocator,
+                                              VkInstance *pInstance) {
+    VkLayerInstanceCreateInfo *chain_info = get_chain_info(pCreateInfo, VK_LAYER_LINK_INFO);
+
+    assert(chain_info->u.pLayerInfo);
+    PFN_vkGetInstanceProcAddr fpGetInstanceProcAddr = chain_info->u.pLayerInfo->pfnNextGetInstanceProcAddr;
+    PFN_vkCreateInstance fpCreateInstance = (PFN_vkCreateInstance)fpGetInstanceProcAddr(NULL, "vkCreateInstance");
+    if (fpCreateInstance == NULL) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    // Advance the link info for the next element on the chain
+    chain_info->u.pLayerInfo = chain_info->u.pLayerInfo->pNext;
+
+    InitTiming();
+
+    VkResult result;
+    {
+        TimedCall timed_call(TIMED_vkCreateInstance);
+        result = fpCreateInstance(pCreateInfo, pAllocator, pInstance);
+    }
+    if (result != VK_SUCCESS) return result;
+
+    layer_data *my_data = GetLayerDataPtr(get_dispatch_key(*pInstance), layer_data_map);
+    my_data->instance = *pInstance;
+    my_data->instance_dispatch_table = new VkLayerInstanceDispatchTable;
+    layer_init_instance_dispatch_table(*pInstance, my_data->instance_dispatch_table, fpGetInstanceProcAddr);
+    return result;
+}
+
+VKAPI_ATTR void VKAPI_CALL DestroyInstance(VkInstance instance, const VkAllocationCallbacks *pAllocator) {
+    dispatch_key key = get_dispatch_key(instance);
+    layer_data *my_data = GetLayerDataPtr(key, layer_data_map);
+    {
+        TimedCall timed_call(TIMED_vkDestroyInstance);
+        my_data->instance_dispatch_table->DestroyInstance(instance, pAllocator);
+    }
+    delete my_data->instance_dispatch_table;
+    FreeLayerDataPtr(key, layer_data_map);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL CreateDevice(VkPhysicalDevice gpu, const VkDeviceCreateInfo *pCreateInfo,
+                                            const VkAllocationCallbacks *pAllocator, VkDevice *pDevice) {
+    layer_data *my_instance_data = GetLayerDataPtr(get_dispatch_key(gpu), layer_data_map);
+    VkLayerDeviceCreateInfo *chain_info = get_chain_info(pCreateInfo, VK_LAYER_LINK_INFO);
+
+    assert(chain_info->u.pLayerInfo);
+    PFN_vkGetInstanceProcAddr fpGetInstanceProcAddr = chain_info->u.pLayerInfo->pfnNextGetInstanceProcAddr;
+    PFN_vkGetDeviceProcAddr fpGetDeviceProcAddr = chain_info->u.pLayerInfo->pfnNextGetDeviceProcAddr;
+    PFN_vkCreateDevice fpCreateDevice = (PFN_vkCreateDevice)fpGetInstanceProcAddr(my_instance_data->instance, "vkCreateDevice");
+    if (fpCreateDevice == NULL) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    // Advance the link info for the next element on the chain
+    chain_info->u.pLayerInfo = chain_info->u.pLayerInfo->pNext;
+
+    VkResult result;
+    {
+        TimedCall timed_call(TIMED_vkCreateDevice);
+        result = fpCreateDevice(gpu, pCreateInfo, pAllocator, pDevice);
+    }
+    if (result != VK_SUCCESS) {
+        return result;
+    }
+
+    layer_data *my_device_data = GetLayerDataPtr(get_dispatch_key(*pDevice), layer_data_map);
+    my_device_data->device_dispatch_table = new VkLayerDispatchTable;
+    layer_init_device_dispatch_table(*pDevice, my_device_data->device_dispatch_table, fpGetDeviceProcAddr);
+    return result;
+}
+
+VKAPI_ATTR void VKAPI_CALL DestroyDevice(VkDevice device, const VkAllocationCallbacks *pAllocator) {
+    dispatch_key key = get_dispatch_key(device);
+    layer_data *dev_data = GetLayerDataPtr(key, layer_data_map);
+    {
+        TimedCall timed_call(TIMED_vkDestroyDevice);
+        dev_data->device_dispatch_table->DestroyDevice(device, pAllocator);
+    }
+    delete dev_data->device_dispatch_table;
+    FreeLayerDataPtr(key, layer_data_map);
+
+    DumpReport();
+}
+
+static const VkLayerProperties layerProps = {
+    "VK_LAYER_GOOGLE_timing",
+    VK_LAYER_API_VERSION,  // specVersion
+    1, "Google per-entry-point timing layer",
+};
+
+VKAPI_ATTR VkResult VKAPI_CALL EnumerateInstanceLayerProperties(uint32_t *pCount, VkLayerProperties *pProperties) {
+    return util_GetLayerProperties(1, &layerProps, pCount, pProperties);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL EnumerateDeviceLayerProperties(VkPhysicalDevice physicalDevice, uint32_t *pCount,
+                                                              VkLayerProperties *pProperties) {
+    return util_GetLayerProperties(1, &layerProps, pCount, pProperties);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL EnumerateInstanceExtensionProperties(const char *pLayerName, uint32_t *pCount,
+                                                                    VkExtensionProperties *pProperties) {
+    // Timing layer does not have any instance extensions
+    if (pLayerName && !strcmp(pLayerName, layerProps.layerName)) return util_GetExtensionProperties(0, nullptr, pCount, pProperties);
+
+    return VK_ERROR_LAYER_NOT_PRESENT;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL EnumerateDeviceExtensionProperties(VkPhysicalDevice physicalDevice, const char *pLayerName,
+                                                                  uint32_t *pCount, VkExtensionProperties *pProperties) {
+    // Timing layer does not have any device extensions
+    if (pLayerName && !strcmp(pLayerName, layerProps.layerName)) return util_GetExtensionProperties(0, nullptr, pCount, pProperties);
+
+    assert(physicalDevice);
+
+    layer_data *my_data = GetLayerDataPtr(get_dispatch_key(physicalDevice), layer_data_map);
+    return my_data->instance_dispatch_table->EnumerateDeviceExtensionProperties(physicalDevice, NULL, pCount, pProperties);
+}
+
+// Need to prototype this call because it's internal and does not show up in vk.xml
+VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL GetPhysicalDeviceProcAddr(VkInstance instance, const char *funcName);
+
+VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL GetDeviceProcAddr(VkDevice device, const char *funcName) {
+    const auto item = name_to_funcptr_map.find(funcName);
+    if (item != name_to_funcptr_map.end()) {
+        return reinterpret_cast<PFN_vkVoidFunction>(item->second);
+    }
+
+    layer_data *device_data = GetLayerDataPtr(get_dispatch_key(device), layer_data_map);
+    auto &table = device_data->device_dispatch_table;
+    if (!table->GetDeviceProcAddr) return nullptr;
+    return table->GetDeviceProcAddr(device, funcName);
+}
+
+VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL GetInstanceProcAddr(VkInstance instance, const char *funcName) {
+    const auto item = name_to_funcptr_map.find(funcName);
+    if (item != name_to_funcptr_map.end()) {
+        return reinterpret_cast<PFN_vkVoidFunction>(item->second);
+    }
+
+    auto instance_data = GetLayerDataPtr(get_dispatch_key(instance), layer_data_map);
+    auto &table = instance_data->instance_dispatch_table;
+    if (!table->GetInstanceProcAddr) return nullptr;
+    return table->GetInstanceProcAddr(instance, funcName);
+}
+
+VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL GetPhysicalDeviceProcAddr(VkInstance instance, const char *funcName) {
+    assert(instance);
+
+    layer_data *my_data = GetLayerDataPtr(get_dispatch_key(instance), layer_data_map);
+    VkLayerInstanceDispatchTable *pTable = my_data->instance_dispatch_table;
+
+    if (pTable->GetPhysicalDeviceProcAddr == NULL) return NULL;
+    return pTable->GetPhysicalDeviceProcAddr(instance, funcName);
+}
+
+}  // namespace timing
+
+// loader-layer interface v0, just wrappers since there is only a layer
+
+VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateInstanceExtensionProperties(const char *pLayerName, uint32_t *pCount,
+                                                                                      VkExtensionProperties *pProperties) {
+    return timing::EnumerateInstanceExtensionProperties(pLayerName, pCount, pProperties);
+}
+
+VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateInstanceLayerProperties(uint32_t *pCount,
+                                                                                  VkLayerProperties *pProperties) {
+    return timing::EnumerateInstanceLayerProperties(pCount, pProperties);
+}
+
+VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateDeviceLayerProperties(VkPhysicalDevice physicalDevice, uint32_t *pCount,
+                                                                                VkLayerProperties *pProperties) {
+    // the layer command handles VK_NULL_HANDLE just fine internally
+    assert(physicalDevice == VK_NULL_HANDLE);
+    return timing::EnumerateDeviceLayerProperties(VK_NULL_HANDLE, pCount, pProperties);
+}
+
+VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateDeviceExtensionProperties(VkPhysicalDevice physicalDevice,
+                                                                                    const char *pLayerName, uint32_t *pCount,
+                                                                                    VkExtensionProperties *pProperties) {
+    // the layer command handles VK_NULL_HANDLE just fine internally
+    assert(physicalDevice == VK_NULL_HANDLE);
+    return timing::EnumerateDeviceExtensionProperties(VK_NULL_HANDLE, pLayerName, pCount, pProperties);
+}
+
+VK_LAYER_EXPORT VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetDeviceProcAddr(VkDevice dev, const char *funcName) {
+    return timing::GetDeviceProcAddr(dev, funcName);
+}
+
+VK_LAYER_EXPORT VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetInstanceProcAddr(VkInstance instance, const char *funcName) {
+    return timing::GetInstanceProcAddr(instance, funcName);
+}
+
+VK_LAYER_EXPORT VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vk_layerGetPhysicalDeviceProcAddr(VkInstance instance,
+                                                                                           const char *funcName) {
+    return timing::GetPhysicalDeviceProcAddr(instance, funcName);
+}
+
+VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkNegotiateLoaderLayerInterfaceVersion(VkNegotiateLayerInterface *pVersionStruct) {
+    assert(pVersionStruct != NULL);
+    assert(pVersionStruct->sType == LAYER_NEGOTIATE_INTERFACE_STRUCT);
+
+    // Fill in the function pointers if our version is at least capable of having the structure contain them.
+    if (pVersionStruct->loaderLayerInterfaceVersion >= 2) {
+        pVersionStruct->pfnGetInstanceProcAddr = vkGetInstanceProcAddr;
+        pVersionStruct->pfnGetDeviceProcAddr = vkGetDeviceProcAddr;
+        pVersionStruct->pfnGetPhysicalDeviceProcAddr = vk_layerGetPhysicalDeviceProcAddr;
+    }
+
+    if (pVersionStruct->loaderLayerInterfaceVersion < CURRENT_LOADER_LAYER_INTERFACE_VERSION) {
+        timing::loader_layer_if_version = pVersionStruct->loaderLayerInterfaceVersion;
+    } else if (pVersionStruct->loaderLayerInterfaceVersion > CURRENT_LOADER_LAYER_INTERFACE_VERSION) {
+        pVersionStruct->loaderLayerInterfaceVersion = CURRENT_LOADER_LAYER_INTERFACE_VERSION;
+    }
+
+    return VK_SUCCESS;
+}
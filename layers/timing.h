@@ -0,0 +1,110 @@
+/* Copyright (c) 2015-2017 The Khronos Group Inc.
+ * Copyright (c) 2015-2017 Valve Corporation
+ * Copyright (c) 2015-2017 LunarG, Inc.
+ * Copyright (C) 2015-2017 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: Tobin Ehlis <tobine@google.com>
+ */
+
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
+#include "vk_loader_platform.h"
+#include "vk_layer_config.h"
+#include "vk_layer_table.h"
+#include "timing_layer.h"
+
+namespace timing {
+
+struct layer_data {
+    VkInstance instance;
+    VkLayerDispatchTable *device_dispatch_table;
+    VkLayerInstanceDispatchTable *instance_dispatch_table;
+};
+
+static LayerDataMap<layer_data> layer_data_map;
+
+// Latency histogram bucket i counts calls that took [2^i, 2^(i+1)) ns. Bucket 0 also holds sub-ns calls and
+// the last bucket is open-ended (~2s and up).
+static const uint32_t kHistogramBuckets = 32;
+
+// Counters for one command on one thread. Only the owning thread writes them, so updates are plain relaxed
+// load/store pairs rather than read-modify-write; the atomics exist so a dump can read them from another thread
+// at any time without locking the writer out.
+struct FunctionStats {
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> total_ns;
+    std::atomic<uint64_t> max_ns;
+    std::atomic<uint64_t> histogram[kHistogramBuckets];
+};
+
+// One block per thread that has made a Vulkan call through this layer. Blocks are pushed onto a global
+// lock-free list on first use and are never freed, so samples from threads that have exited are still reported.
+struct ThreadStats {
+    uint32_t thread_index;
+    uint64_t thread_id;
+    ThreadStats *next;
+    FunctionStats functions[TIMED_FUNCTION_COUNT];
+};
+
+ThreadStats *RegisterThreadStats();
+void ProcessPendingDump();
+
+extern THREAD_LOCAL_DECL ThreadStats *tls_thread_stats;
+extern std::atomic<bool> dump_requested;
+
+static inline uint32_t HistogramBucket(uint64_t ns) {
+    if (ns < 2) return 0;
+#if defined(__GNUC__)
+    uint32_t bucket = 63 - __builtin_clzll(ns);
+#else
+    uint32_t bucket = 0;
+    while (ns >>= 1) bucket++;
+#endif
+    return bucket < kHistogramBuckets ? bucket : kHistogramBuckets - 1;
+}
+
+static inline void Accumulate(std::atomic<uint64_t> &counter, uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+// Times the enclosing scope and records it against a command on the calling thread
+class TimedCall {
+   public:
+    explicit TimedCall(TimedFunction function) : function_(function), start_(std::chrono::steady_clock::now()) {}
+
+    ~TimedCall() {
+        uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+        ThreadStats *thread_stats = tls_thread_stats;
+        if (!thread_stats) thread_stats = RegisterThreadStats();
+        FunctionStats &stats = thread_stats->functions[function_];
+        Accumulate(stats.calls, 1);
+        Accumulate(stats.total_ns, ns);
+        if (ns > stats.max_ns.load(std::memory_order_relaxed)) stats.max_ns.store(ns, std::memory_order_relaxed);
+        Accumulate(stats.histogram[HistogramBucket(ns)], 1);
+        if (dump_requested.load(std::memory_order_relaxed)) ProcessPendingDump();
+    }
+
+   private:
+    TimedFunction function_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace timing
+
+#endif  // TIMING_H
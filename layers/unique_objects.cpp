@@ -163,6 +163,28 @@ VKAPI_ATTR void VKAPI_CALL DestroyInstance(VkInstance instance, const VkAllocati
     FreeLayerDataPtr(key, instance_layer_data_map);
 }
 
+// Tally the handles wrapped for a device. Must be called with global_lock held.
+static StateStats GatherStateStats(layer_data const *dev_data) {
+    StateStats stats("VK_LAYER_GOOGLE_unique_objects");
+    stats.Add("handles", dev_data->unique_id_mapping.size(), ContainerBytes(dev_data->unique_id_mapping));
+    stats.Add("descriptor update templates", dev_data->desc_template_map.size(),
+              ContainerBytes(dev_data->desc_template_map) + dev_data->desc_template_map.size() * sizeof(TEMPLATE_STATE));
+    return stats;
+}
+
+static void LogStateStats(VkDevice device, layer_data const *dev_data) {
+    std::lock_guard<std::mutex> lock(global_lock);
+    GatherStateStats(dev_data).Log(dev_data->report_data, device);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL GetLayerStateStatsLUNARG(VkDevice device, uint32_t *pStatCount, VkLayerStateStatLUNARG *pStats) {
+    layer_data *dev_data = GetLayerDataPtr(get_dispatch_key(device), layer_data_map);
+    std::unique_lock<std::mutex> lock(global_lock);
+    StateStats stats = GatherStateStats(dev_data);
+    lock.unlock();
+    return stats.Report(device, dev_data->dispatch_table.GetDeviceProcAddr, pStatCount, pStats);
+}
+
 VKAPI_ATTR VkResult VKAPI_CALL CreateDevice(VkPhysicalDevice gpu, const VkDeviceCreateInfo *pCreateInfo,
                                             const VkAllocationCallbacks *pAllocator, VkDevice *pDevice) {
     instance_layer_data *my_instance_data = GetLayerDataPtr(get_dispatch_key(gpu), instance_layer_data_map);
@@ -195,6 +217,13 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateDevice(VkPhysicalDevice gpu, const VkDevice
     // Set gpu for this device in order to get at any objects mapped at instance level
     my_device_data->instance_data = my_instance_data;
 
+    my_device_data->state_stats = GetStateStatsSettings("google_unique_objects");
+    if (my_device_data->state_stats.log_interval) {
+        VkDevice device = *pDevice;
+        my_device_data->state_stats_task.reset(new PeriodicTask(
+            my_device_data->state_stats.log_interval, [device, my_device_data]() { LogStateStats(device, my_device_data); }));
+    }
+
     return result;
 }
 
@@ -202,6 +231,9 @@ VKAPI_ATTR void VKAPI_CALL DestroyDevice(VkDevice device, const VkAllocationCall
     dispatch_key key = get_dispatch_key(device);
     layer_data *dev_data = GetLayerDataPtr(key, layer_data_map);
 
+    dev_data->state_stats_task.reset();
+    if (dev_data->state_stats.log_on_destroy) LogStateStats(device, dev_data);
+
     layer_debug_report_destroy_device(device);
     dev_data->dispatch_table.DestroyDevice(device, pAllocator);
 
@@ -250,6 +282,10 @@ VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL GetDeviceProcAddr(VkDevice device, cons
     if (item != name_to_funcptr_map.end()) {
         return reinterpret_cast<PFN_vkVoidFunction>(item->second);
     }
+    // Not in vk.xml, so not in the generated map
+    if (!strcmp(funcName, VK_LUNARG_STATE_STATS_FUNCTION_NAME)) {
+        return reinterpret_cast<PFN_vkVoidFunction>(GetLayerStateStatsLUNARG);
+    }
 
     layer_data *device_data = GetLayerDataPtr(get_dispatch_key(device), layer_data_map);
     const auto &table = device_data->dispatch_table;
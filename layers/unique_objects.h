@@ -24,6 +24,7 @@
 #include "vk_layer_data.h"
 #include "vk_safe_struct.h"
 #include "vk_layer_utils.h"
+#include "vk_layer_state_stats.h"
 #include "mutex"
 
 #pragma once
@@ -69,11 +70,15 @@ struct layer_data {
     std::unordered_map<uint64_t, uint64_t> unique_id_mapping;  // Map uniqueID to actual object handle
     VkPhysicalDevice gpu;
 
+    // google_unique_objects.state_stats_* settings, and the periodic log they may ask for
+    StateStatsSettings state_stats = {};
+    std::unique_ptr<PeriodicTask> state_stats_task;
+
     layer_data() : wsi_enabled(false), gpu(VK_NULL_HANDLE){};
 };
 
-static std::unordered_map<void *, instance_layer_data *> instance_layer_data_map;
-static std::unordered_map<void *, layer_data *> layer_data_map;
+static LayerDataMap<instance_layer_data> instance_layer_data_map;
+static LayerDataMap<layer_data> layer_data_map;
 
 static std::mutex global_lock;  // Protect map accesses and unique_id increments
 
@@ -22,876 +22,335 @@
 #include <string.h>
 #include <string>
 #include <vector>
-#include <map>
 #include "vulkan/vulkan.h"
 #include "vk_format_utils.h"
 
+// Boolean properties of a format, one bit each in VULKAN_FORMAT_INFO::traits
+enum VULKAN_FORMAT_TRAIT {
+    TRAIT_DEPTH = 0x00000001,          // Depth-only
+    TRAIT_STENCIL = 0x00000002,        // Stencil-only
+    TRAIT_DEPTH_STENCIL = 0x00000004,  // Combined depth and stencil
+    TRAIT_ETC2_EAC = 0x00000008,
+    TRAIT_ASTC_LDR = 0x00000010,
+    TRAIT_BC = 0x00000020,
+    TRAIT_PVRTC = 0x00000040,
+    TRAIT_NORM = 0x00000080,
+    TRAIT_UNORM = 0x00000100,
+    TRAIT_SNORM = 0x00000200,
+    TRAIT_UINT = 0x00000400,
+    TRAIT_SINT = 0x00000800,
+    TRAIT_FLOAT = 0x00001000,
+    TRAIT_SRGB = 0x00002000,
+    TRAIT_USCALED = 0x00004000,
+    TRAIT_SSCALED = 0x00008000,
+};
+
+static const uint32_t TRAIT_COMPRESSED = TRAIT_ETC2_EAC | TRAIT_ASTC_LDR | TRAIT_BC | TRAIT_PVRTC;
+static const uint32_t TRAIT_DEPTH_OR_STENCIL = TRAIT_DEPTH | TRAIT_STENCIL | TRAIT_DEPTH_STENCIL;
+
 struct VULKAN_FORMAT_INFO {
-    size_t size;
-    uint32_t channel_count;
+    VkFormat format;  // Always the format used to index the table
+    uint8_t size;
+    uint8_t channel_count;
     VkFormatCompatibilityClass format_class;
+    uint8_t block_width;
+    uint8_t block_height;
+    uint32_t traits;
 };
 
-// Disable auto-formatting for this large table
+// Disable auto-formatting for these large tables
 // clang-format off
 
-// Set up data structure with number of bytes and number of channels for each Vulkan format
-const std::map<VkFormat, VULKAN_FORMAT_INFO> vk_format_table = {
-    {VK_FORMAT_UNDEFINED,                   {0, 0, VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT }},
-    {VK_FORMAT_R4G4_UNORM_PACK8,            {1, 2, VK_FORMAT_COMPATIBILITY_CLASS_8_BIT}},
-    {VK_FORMAT_R4G4B4A4_UNORM_PACK16,       {2, 4, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_B4G4R4A4_UNORM_PACK16,       {2, 4, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_R5G6B5_UNORM_PACK16,         {2, 3, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_B5G6R5_UNORM_PACK16,         {2, 3, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_R5G5B5A1_UNORM_PACK16,       {2, 4, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_B5G5R5A1_UNORM_PACK16,       {2, 4, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_A1R5G5B5_UNORM_PACK16,       {2, 4, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_R8_UNORM,                    {1, 1, VK_FORMAT_COMPATIBILITY_CLASS_8_BIT}},
-    {VK_FORMAT_R8_SNORM,                    {1, 1, VK_FORMAT_COMPATIBILITY_CLASS_8_BIT}},
-    {VK_FORMAT_R8_USCALED,                  {1, 1, VK_FORMAT_COMPATIBILITY_CLASS_8_BIT}},
-    {VK_FORMAT_R8_SSCALED,                  {1, 1, VK_FORMAT_COMPATIBILITY_CLASS_8_BIT}},
-    {VK_FORMAT_R8_UINT,                     {1, 1, VK_FORMAT_COMPATIBILITY_CLASS_8_BIT}},
-    {VK_FORMAT_R8_SINT,                     {1, 1, VK_FORMAT_COMPATIBILITY_CLASS_8_BIT}},
-    {VK_FORMAT_R8_SRGB,                     {1, 1, VK_FORMAT_COMPATIBILITY_CLASS_8_BIT}},
-    {VK_FORMAT_R8G8_UNORM,                  {2, 2, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_R8G8_SNORM,                  {2, 2, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_R8G8_USCALED,                {2, 2, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_R8G8_SSCALED,                {2, 2, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_R8G8_UINT,                   {2, 2, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_R8G8_SINT,                   {2, 2, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_R8G8_SRGB,                   {2, 2, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_R8G8B8_UNORM,                {3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT}},
-    {VK_FORMAT_R8G8B8_SNORM,                {3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT}},
-    {VK_FORMAT_R8G8B8_USCALED,              {3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT}},
-    {VK_FORMAT_R8G8B8_SSCALED,              {3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT}},
-    {VK_FORMAT_R8G8B8_UINT,                 {3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT}},
-    {VK_FORMAT_R8G8B8_SINT,                 {3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT}},
-    {VK_FORMAT_R8G8B8_SRGB,                 {3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT}},
-    {VK_FORMAT_B8G8R8_UNORM,                {3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT}},
-    {VK_FORMAT_B8G8R8_SNORM,                {3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT}},
-    {VK_FORMAT_B8G8R8_USCALED,              {3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT}},
-    {VK_FORMAT_B8G8R8_SSCALED,              {3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT}},
-    {VK_FORMAT_B8G8R8_UINT,                 {3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT}},
-    {VK_FORMAT_B8G8R8_SINT,                 {3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT}},
-    {VK_FORMAT_B8G8R8_SRGB,                 {3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT}},
-    {VK_FORMAT_R8G8B8A8_UNORM,              {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_R8G8B8A8_SNORM,              {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_R8G8B8A8_USCALED,            {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_R8G8B8A8_SSCALED,            {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_R8G8B8A8_UINT,               {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_R8G8B8A8_SINT,               {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_R8G8B8A8_SRGB,               {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_B8G8R8A8_UNORM,              {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_B8G8R8A8_SNORM,              {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_B8G8R8A8_USCALED,            {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_B8G8R8A8_SSCALED,            {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_B8G8R8A8_UINT,               {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_B8G8R8A8_SINT,               {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_B8G8R8A8_SRGB,               {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_A8B8G8R8_UNORM_PACK32,       {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_A8B8G8R8_SNORM_PACK32,       {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_A8B8G8R8_USCALED_PACK32,     {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_A8B8G8R8_SSCALED_PACK32,     {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_A8B8G8R8_UINT_PACK32,        {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_A8B8G8R8_SINT_PACK32,        {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_A8B8G8R8_SRGB_PACK32,        {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_A2R10G10B10_UNORM_PACK32,    {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_A2R10G10B10_SNORM_PACK32,    {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_A2R10G10B10_USCALED_PACK32,  {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_A2R10G10B10_SSCALED_PACK32,  {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_A2R10G10B10_UINT_PACK32,     {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_A2R10G10B10_SINT_PACK32,     {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_A2B10G10R10_UNORM_PACK32,    {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_A2B10G10R10_SNORM_PACK32,    {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_A2B10G10R10_USCALED_PACK32,  {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_A2B10G10R10_SSCALED_PACK32,  {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_A2B10G10R10_UINT_PACK32,     {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_A2B10G10R10_SINT_PACK32,     {4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_R16_UNORM,                   {2, 1, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_R16_SNORM,                   {2, 1, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_R16_USCALED,                 {2, 1, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_R16_SSCALED,                 {2, 1, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_R16_UINT,                    {2, 1, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_R16_SINT,                    {2, 1, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_R16_SFLOAT,                  {2, 1, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT}},
-    {VK_FORMAT_R16G16_UNORM,                {4, 2, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_R16G16_SNORM,                {4, 2, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_R16G16_USCALED,              {4, 2, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_R16G16_SSCALED,              {4, 2, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_R16G16_UINT,                 {4, 2, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_R16G16_SINT,                 {4, 2, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_R16G16_SFLOAT,               {4, 2, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_R16G16B16_UNORM,             {6, 3, VK_FORMAT_COMPATIBILITY_CLASS_48_BIT}},
-    {VK_FORMAT_R16G16B16_SNORM,             {6, 3, VK_FORMAT_COMPATIBILITY_CLASS_48_BIT}},
-    {VK_FORMAT_R16G16B16_USCALED,           {6, 3, VK_FORMAT_COMPATIBILITY_CLASS_48_BIT}},
-    {VK_FORMAT_R16G16B16_SSCALED,           {6, 3, VK_FORMAT_COMPATIBILITY_CLASS_48_BIT}},
-    {VK_FORMAT_R16G16B16_UINT,              {6, 3, VK_FORMAT_COMPATIBILITY_CLASS_48_BIT}},
-    {VK_FORMAT_R16G16B16_SINT,              {6, 3, VK_FORMAT_COMPATIBILITY_CLASS_48_BIT}},
-    {VK_FORMAT_R16G16B16_SFLOAT,            {6, 3, VK_FORMAT_COMPATIBILITY_CLASS_48_BIT}},
-    {VK_FORMAT_R16G16B16A16_UNORM,          {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT}},
-    {VK_FORMAT_R16G16B16A16_SNORM,          {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT}},
-    {VK_FORMAT_R16G16B16A16_USCALED,        {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT}},
-    {VK_FORMAT_R16G16B16A16_SSCALED,        {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT}},
-    {VK_FORMAT_R16G16B16A16_UINT,           {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT}},
-    {VK_FORMAT_R16G16B16A16_SINT,           {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT}},
-    {VK_FORMAT_R16G16B16A16_SFLOAT,         {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT}},
-    {VK_FORMAT_R32_UINT,                    {4, 1, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_R32_SINT,                    {4, 1, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_R32_SFLOAT,                  {4, 1, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_R32G32_UINT,                 {8, 2, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT}},
-    {VK_FORMAT_R32G32_SINT,                 {8, 2, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT}},
-    {VK_FORMAT_R32G32_SFLOAT,               {8, 2, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT}},
-    {VK_FORMAT_R32G32B32_UINT,              {12, 3, VK_FORMAT_COMPATIBILITY_CLASS_96_BIT}},
-    {VK_FORMAT_R32G32B32_SINT,              {12, 3, VK_FORMAT_COMPATIBILITY_CLASS_96_BIT}},
-    {VK_FORMAT_R32G32B32_SFLOAT,            {12, 3, VK_FORMAT_COMPATIBILITY_CLASS_96_BIT}},
-    {VK_FORMAT_R32G32B32A32_UINT,           {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_128_BIT}},
-    {VK_FORMAT_R32G32B32A32_SINT,           {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_128_BIT}},
-    {VK_FORMAT_R32G32B32A32_SFLOAT,         {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_128_BIT}},
-    {VK_FORMAT_R64_UINT,                    {8, 1, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT}},
-    {VK_FORMAT_R64_SINT,                    {8, 1, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT}},
-    {VK_FORMAT_R64_SFLOAT,                  {8, 1, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT}},
-    {VK_FORMAT_R64G64_UINT,                 {16, 2, VK_FORMAT_COMPATIBILITY_CLASS_128_BIT}},
-    {VK_FORMAT_R64G64_SINT,                 {16, 2, VK_FORMAT_COMPATIBILITY_CLASS_128_BIT}},
-    {VK_FORMAT_R64G64_SFLOAT,               {16, 2, VK_FORMAT_COMPATIBILITY_CLASS_128_BIT}},
-    {VK_FORMAT_R64G64B64_UINT,              {24, 3, VK_FORMAT_COMPATIBILITY_CLASS_192_BIT}},
-    {VK_FORMAT_R64G64B64_SINT,              {24, 3, VK_FORMAT_COMPATIBILITY_CLASS_192_BIT}},
-    {VK_FORMAT_R64G64B64_SFLOAT,            {24, 3, VK_FORMAT_COMPATIBILITY_CLASS_192_BIT}},
-    {VK_FORMAT_R64G64B64A64_UINT,           {32, 4, VK_FORMAT_COMPATIBILITY_CLASS_256_BIT}},
-    {VK_FORMAT_R64G64B64A64_SINT,           {32, 4, VK_FORMAT_COMPATIBILITY_CLASS_256_BIT}},
-    {VK_FORMAT_R64G64B64A64_SFLOAT,         {32, 4, VK_FORMAT_COMPATIBILITY_CLASS_256_BIT}},
-    {VK_FORMAT_B10G11R11_UFLOAT_PACK32,     {4, 3, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_E5B9G9R9_UFLOAT_PACK32,      {4, 3, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT}},
-    {VK_FORMAT_D16_UNORM,                   {2, 1, VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT}},
-    {VK_FORMAT_X8_D24_UNORM_PACK32,         {4, 1, VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT}},
-    {VK_FORMAT_D32_SFLOAT,                  {4, 1, VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT}},
-    {VK_FORMAT_S8_UINT,                     {1, 1, VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT}},
-    {VK_FORMAT_D16_UNORM_S8_UINT,           {3, 2, VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT}},
-    {VK_FORMAT_D24_UNORM_S8_UINT,           {4, 2, VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT}},
-    {VK_FORMAT_D32_SFLOAT_S8_UINT,          {8, 2, VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT}},
-    {VK_FORMAT_BC1_RGB_UNORM_BLOCK,         {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC1_RGB_BIT}},
-    {VK_FORMAT_BC1_RGB_SRGB_BLOCK,          {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC1_RGB_BIT}},
-    {VK_FORMAT_BC1_RGBA_UNORM_BLOCK,        {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC1_RGBA_BIT}},
-    {VK_FORMAT_BC1_RGBA_SRGB_BLOCK,         {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC1_RGBA_BIT}},
-    {VK_FORMAT_BC2_UNORM_BLOCK,             {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC2_BIT}},
-    {VK_FORMAT_BC2_SRGB_BLOCK,              {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC2_BIT}},
-    {VK_FORMAT_BC3_UNORM_BLOCK,             {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC3_BIT}},
-    {VK_FORMAT_BC3_SRGB_BLOCK,              {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC3_BIT}},
-    {VK_FORMAT_BC4_UNORM_BLOCK,             {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC4_BIT}},
-    {VK_FORMAT_BC4_SNORM_BLOCK,             {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC4_BIT}},
-    {VK_FORMAT_BC5_UNORM_BLOCK,             {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC5_BIT}},
-    {VK_FORMAT_BC5_SNORM_BLOCK,             {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC5_BIT}},
-    {VK_FORMAT_BC6H_UFLOAT_BLOCK,           {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC6H_BIT}},
-    {VK_FORMAT_BC6H_SFLOAT_BLOCK,           {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC6H_BIT}},
-    {VK_FORMAT_BC7_UNORM_BLOCK,             {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC7_BIT}},
-    {VK_FORMAT_BC7_SRGB_BLOCK,              {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC7_BIT}},
-    {VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK,     {8, 3, VK_FORMAT_COMPATIBILITY_CLASS_ETC2_RGB_BIT}},
-    {VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK,      {8, 3, VK_FORMAT_COMPATIBILITY_CLASS_ETC2_RGB_BIT}},
-    {VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK,   {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_ETC2_RGBA_BIT}},
-    {VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK,    {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_ETC2_RGBA_BIT}},
-    {VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK,   {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ETC2_EAC_RGBA_BIT}},
-    {VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK,    {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_ETC2_EAC_RGBA_BIT}},
-    {VK_FORMAT_EAC_R11_UNORM_BLOCK,         {8, 1, VK_FORMAT_COMPATIBILITY_CLASS_EAC_R_BIT}},
-    {VK_FORMAT_EAC_R11_SNORM_BLOCK,         {8, 1, VK_FORMAT_COMPATIBILITY_CLASS_EAC_R_BIT}},
-    {VK_FORMAT_EAC_R11G11_UNORM_BLOCK,      {16, 2, VK_FORMAT_COMPATIBILITY_CLASS_EAC_RG_BIT}},
-    {VK_FORMAT_EAC_R11G11_SNORM_BLOCK,      {16, 2, VK_FORMAT_COMPATIBILITY_CLASS_EAC_RG_BIT}},
-    {VK_FORMAT_ASTC_4x4_UNORM_BLOCK,        {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_4X4_BIT}},
-    {VK_FORMAT_ASTC_4x4_SRGB_BLOCK,         {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_4X4_BIT}},
-    {VK_FORMAT_ASTC_5x4_UNORM_BLOCK,        {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_5X4_BIT}},
-    {VK_FORMAT_ASTC_5x4_SRGB_BLOCK,         {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_5X4_BIT}},
-    {VK_FORMAT_ASTC_5x5_UNORM_BLOCK,        {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_5X5_BIT}},
-    {VK_FORMAT_ASTC_5x5_SRGB_BLOCK,         {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_5X5_BIT}},
-    {VK_FORMAT_ASTC_6x5_UNORM_BLOCK,        {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_6X5_BIT}},
-    {VK_FORMAT_ASTC_6x5_SRGB_BLOCK,         {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_6X5_BIT}},
-    {VK_FORMAT_ASTC_6x6_UNORM_BLOCK,        {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_6X6_BIT}},
-    {VK_FORMAT_ASTC_6x6_SRGB_BLOCK,         {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_6X6_BIT}},
-    {VK_FORMAT_ASTC_8x5_UNORM_BLOCK,        {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_8X5_BIT}},
-    {VK_FORMAT_ASTC_8x5_SRGB_BLOCK,         {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_8X5_BIT}},
-    {VK_FORMAT_ASTC_8x6_UNORM_BLOCK,        {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_8X6_BIT}},
-    {VK_FORMAT_ASTC_8x6_SRGB_BLOCK,         {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_8X6_BIT}},
-    {VK_FORMAT_ASTC_8x8_UNORM_BLOCK,        {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_8X8_BIT}},
-    {VK_FORMAT_ASTC_8x8_SRGB_BLOCK,         {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_8X8_BIT}},
-    {VK_FORMAT_ASTC_10x5_UNORM_BLOCK,       {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_10X5_BIT}},
-    {VK_FORMAT_ASTC_10x5_SRGB_BLOCK,        {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_10X5_BIT}},
-    {VK_FORMAT_ASTC_10x6_UNORM_BLOCK,       {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_10X6_BIT}},
-    {VK_FORMAT_ASTC_10x6_SRGB_BLOCK,        {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_10X6_BIT}},
-    {VK_FORMAT_ASTC_10x8_UNORM_BLOCK,       {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_10X8_BIT}},
-    {VK_FORMAT_ASTC_10x8_SRGB_BLOCK,        {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_10X8_BIT}},
-    {VK_FORMAT_ASTC_10x10_UNORM_BLOCK,      {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_10X10_BIT}},
-    {VK_FORMAT_ASTC_10x10_SRGB_BLOCK,       {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_10X10_BIT}},
-    {VK_FORMAT_ASTC_12x10_UNORM_BLOCK,      {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_12X10_BIT}},
-    {VK_FORMAT_ASTC_12x10_SRGB_BLOCK,       {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_12X10_BIT}},
-    {VK_FORMAT_ASTC_12x12_UNORM_BLOCK,      {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_12X12_BIT}},
-    {VK_FORMAT_ASTC_12x12_SRGB_BLOCK,       {16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_12X12_BIT}},
-    {VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG, {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_PVRTC1_2BPP_BIT}},
-    {VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG, {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_PVRTC1_4BPP_BIT}},
-    {VK_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG, {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_PVRTC2_2BPP_BIT}},
-    {VK_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG, {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_PVRTC2_4BPP_BIT}},
-    {VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG,  {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_PVRTC1_2BPP_BIT}},
-    {VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG,  {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_PVRTC1_4BPP_BIT}},
-    {VK_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG,  {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_PVRTC2_2BPP_BIT}},
-    {VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG,  {8, 4, VK_FORMAT_COMPATIBILITY_CLASS_PVRTC2_4BPP_BIT}}
+// Number of bytes, number of channels, compatibility class, texel block extent and traits for each core format, in
+// VkFormat order so that a format indexes its own entry
+static const VULKAN_FORMAT_INFO vk_format_table[VK_FORMAT_RANGE_SIZE] = {
+    {VK_FORMAT_UNDEFINED,                    0, 0, VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT,           1,  1, 0},
+    {VK_FORMAT_R4G4_UNORM_PACK8,             1, 2, VK_FORMAT_COMPATIBILITY_CLASS_8_BIT,              1,  1, TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_R4G4B4A4_UNORM_PACK16,        2, 4, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_B4G4R4A4_UNORM_PACK16,        2, 4, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, 0},
+    {VK_FORMAT_R5G6B5_UNORM_PACK16,          2, 3, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_B5G6R5_UNORM_PACK16,          2, 3, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_R5G5B5A1_UNORM_PACK16,        2, 4, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_B5G5R5A1_UNORM_PACK16,        2, 4, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, 0},
+    {VK_FORMAT_A1R5G5B5_UNORM_PACK16,        2, 4, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_R8_UNORM,                     1, 1, VK_FORMAT_COMPATIBILITY_CLASS_8_BIT,              1,  1, TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_R8_SNORM,                     1, 1, VK_FORMAT_COMPATIBILITY_CLASS_8_BIT,              1,  1, TRAIT_NORM | TRAIT_SNORM},
+    {VK_FORMAT_R8_USCALED,                   1, 1, VK_FORMAT_COMPATIBILITY_CLASS_8_BIT,              1,  1, TRAIT_USCALED},
+    {VK_FORMAT_R8_SSCALED,                   1, 1, VK_FORMAT_COMPATIBILITY_CLASS_8_BIT,              1,  1, TRAIT_SSCALED},
+    {VK_FORMAT_R8_UINT,                      1, 1, VK_FORMAT_COMPATIBILITY_CLASS_8_BIT,              1,  1, TRAIT_UINT},
+    {VK_FORMAT_R8_SINT,                      1, 1, VK_FORMAT_COMPATIBILITY_CLASS_8_BIT,              1,  1, TRAIT_SINT},
+    {VK_FORMAT_R8_SRGB,                      1, 1, VK_FORMAT_COMPATIBILITY_CLASS_8_BIT,              1,  1, TRAIT_SRGB},
+    {VK_FORMAT_R8G8_UNORM,                   2, 2, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_R8G8_SNORM,                   2, 2, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, TRAIT_NORM | TRAIT_SNORM},
+    {VK_FORMAT_R8G8_USCALED,                 2, 2, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, TRAIT_USCALED},
+    {VK_FORMAT_R8G8_SSCALED,                 2, 2, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, TRAIT_SSCALED},
+    {VK_FORMAT_R8G8_UINT,                    2, 2, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, TRAIT_UINT},
+    {VK_FORMAT_R8G8_SINT,                    2, 2, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, TRAIT_SINT},
+    {VK_FORMAT_R8G8_SRGB,                    2, 2, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, TRAIT_SRGB},
+    {VK_FORMAT_R8G8B8_UNORM,                 3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT,             1,  1, TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_R8G8B8_SNORM,                 3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT,             1,  1, TRAIT_NORM | TRAIT_SNORM},
+    {VK_FORMAT_R8G8B8_USCALED,               3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT,             1,  1, TRAIT_USCALED},
+    {VK_FORMAT_R8G8B8_SSCALED,               3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT,             1,  1, TRAIT_SSCALED},
+    {VK_FORMAT_R8G8B8_UINT,                  3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT,             1,  1, TRAIT_UINT},
+    {VK_FORMAT_R8G8B8_SINT,                  3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT,             1,  1, TRAIT_SINT},
+    {VK_FORMAT_R8G8B8_SRGB,                  3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT,             1,  1, TRAIT_SRGB},
+    {VK_FORMAT_B8G8R8_UNORM,                 3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT,             1,  1, TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_B8G8R8_SNORM,                 3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT,             1,  1, TRAIT_NORM | TRAIT_SNORM},
+    {VK_FORMAT_B8G8R8_USCALED,               3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT,             1,  1, TRAIT_USCALED},
+    {VK_FORMAT_B8G8R8_SSCALED,               3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT,             1,  1, TRAIT_SSCALED},
+    {VK_FORMAT_B8G8R8_UINT,                  3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT,             1,  1, TRAIT_UINT},
+    {VK_FORMAT_B8G8R8_SINT,                  3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT,             1,  1, TRAIT_SINT},
+    {VK_FORMAT_B8G8R8_SRGB,                  3, 3, VK_FORMAT_COMPATIBILITY_CLASS_24_BIT,             1,  1, TRAIT_SRGB},
+    {VK_FORMAT_R8G8B8A8_UNORM,               4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_R8G8B8A8_SNORM,               4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_NORM | TRAIT_SNORM},
+    {VK_FORMAT_R8G8B8A8_USCALED,             4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_USCALED},
+    {VK_FORMAT_R8G8B8A8_SSCALED,             4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_SSCALED},
+    {VK_FORMAT_R8G8B8A8_UINT,                4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_UINT},
+    {VK_FORMAT_R8G8B8A8_SINT,                4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_SINT},
+    {VK_FORMAT_R8G8B8A8_SRGB,                4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_SRGB},
+    {VK_FORMAT_B8G8R8A8_UNORM,               4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_B8G8R8A8_SNORM,               4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_NORM | TRAIT_SNORM},
+    {VK_FORMAT_B8G8R8A8_USCALED,             4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_USCALED},
+    {VK_FORMAT_B8G8R8A8_SSCALED,             4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_SSCALED},
+    {VK_FORMAT_B8G8R8A8_UINT,                4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_UINT},
+    {VK_FORMAT_B8G8R8A8_SINT,                4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_SINT},
+    {VK_FORMAT_B8G8R8A8_SRGB,                4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_SRGB},
+    {VK_FORMAT_A8B8G8R8_UNORM_PACK32,        4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_A8B8G8R8_SNORM_PACK32,        4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_NORM | TRAIT_SNORM},
+    {VK_FORMAT_A8B8G8R8_USCALED_PACK32,      4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_USCALED},
+    {VK_FORMAT_A8B8G8R8_SSCALED_PACK32,      4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_SSCALED},
+    {VK_FORMAT_A8B8G8R8_UINT_PACK32,         4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_UINT},
+    {VK_FORMAT_A8B8G8R8_SINT_PACK32,         4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_SINT},
+    {VK_FORMAT_A8B8G8R8_SRGB_PACK32,         4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_SRGB},
+    {VK_FORMAT_A2R10G10B10_UNORM_PACK32,     4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_A2R10G10B10_SNORM_PACK32,     4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_NORM | TRAIT_SNORM},
+    {VK_FORMAT_A2R10G10B10_USCALED_PACK32,   4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_USCALED},
+    {VK_FORMAT_A2R10G10B10_SSCALED_PACK32,   4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_SSCALED},
+    {VK_FORMAT_A2R10G10B10_UINT_PACK32,      4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_UINT},
+    {VK_FORMAT_A2R10G10B10_SINT_PACK32,      4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_SINT},
+    {VK_FORMAT_A2B10G10R10_UNORM_PACK32,     4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_A2B10G10R10_SNORM_PACK32,     4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_NORM | TRAIT_SNORM},
+    {VK_FORMAT_A2B10G10R10_USCALED_PACK32,   4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_USCALED},
+    {VK_FORMAT_A2B10G10R10_SSCALED_PACK32,   4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_SSCALED},
+    {VK_FORMAT_A2B10G10R10_UINT_PACK32,      4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_UINT},
+    {VK_FORMAT_A2B10G10R10_SINT_PACK32,      4, 4, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_SINT},
+    {VK_FORMAT_R16_UNORM,                    2, 1, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_R16_SNORM,                    2, 1, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, TRAIT_NORM | TRAIT_SNORM},
+    {VK_FORMAT_R16_USCALED,                  2, 1, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, TRAIT_USCALED},
+    {VK_FORMAT_R16_SSCALED,                  2, 1, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, TRAIT_SSCALED},
+    {VK_FORMAT_R16_UINT,                     2, 1, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, TRAIT_UINT},
+    {VK_FORMAT_R16_SINT,                     2, 1, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, TRAIT_SINT},
+    {VK_FORMAT_R16_SFLOAT,                   2, 1, VK_FORMAT_COMPATIBILITY_CLASS_16_BIT,             1,  1, TRAIT_FLOAT},
+    {VK_FORMAT_R16G16_UNORM,                 4, 2, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_R16G16_SNORM,                 4, 2, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_NORM | TRAIT_SNORM},
+    {VK_FORMAT_R16G16_USCALED,               4, 2, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_USCALED},
+    {VK_FORMAT_R16G16_SSCALED,               4, 2, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_SSCALED},
+    {VK_FORMAT_R16G16_UINT,                  4, 2, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_UINT},
+    {VK_FORMAT_R16G16_SINT,                  4, 2, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_SINT},
+    {VK_FORMAT_R16G16_SFLOAT,                4, 2, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_FLOAT},
+    {VK_FORMAT_R16G16B16_UNORM,              6, 3, VK_FORMAT_COMPATIBILITY_CLASS_48_BIT,             1,  1, TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_R16G16B16_SNORM,              6, 3, VK_FORMAT_COMPATIBILITY_CLASS_48_BIT,             1,  1, TRAIT_NORM | TRAIT_SNORM},
+    {VK_FORMAT_R16G16B16_USCALED,            6, 3, VK_FORMAT_COMPATIBILITY_CLASS_48_BIT,             1,  1, TRAIT_USCALED},
+    {VK_FORMAT_R16G16B16_SSCALED,            6, 3, VK_FORMAT_COMPATIBILITY_CLASS_48_BIT,             1,  1, TRAIT_SSCALED},
+    {VK_FORMAT_R16G16B16_UINT,               6, 3, VK_FORMAT_COMPATIBILITY_CLASS_48_BIT,             1,  1, TRAIT_UINT},
+    {VK_FORMAT_R16G16B16_SINT,               6, 3, VK_FORMAT_COMPATIBILITY_CLASS_48_BIT,             1,  1, TRAIT_SINT},
+    {VK_FORMAT_R16G16B16_SFLOAT,             6, 3, VK_FORMAT_COMPATIBILITY_CLASS_48_BIT,             1,  1, TRAIT_FLOAT},
+    {VK_FORMAT_R16G16B16A16_UNORM,           8, 4, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT,             1,  1, TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_R16G16B16A16_SNORM,           8, 4, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT,             1,  1, TRAIT_NORM | TRAIT_SNORM},
+    {VK_FORMAT_R16G16B16A16_USCALED,         8, 4, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT,             1,  1, TRAIT_USCALED},
+    {VK_FORMAT_R16G16B16A16_SSCALED,         8, 4, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT,             1,  1, TRAIT_SSCALED},
+    {VK_FORMAT_R16G16B16A16_UINT,            8, 4, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT,             1,  1, TRAIT_UINT},
+    {VK_FORMAT_R16G16B16A16_SINT,            8, 4, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT,             1,  1, TRAIT_SINT},
+    {VK_FORMAT_R16G16B16A16_SFLOAT,          8, 4, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT,             1,  1, TRAIT_FLOAT},
+    {VK_FORMAT_R32_UINT,                     4, 1, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_UINT},
+    {VK_FORMAT_R32_SINT,                     4, 1, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_SINT},
+    {VK_FORMAT_R32_SFLOAT,                   4, 1, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_FLOAT},
+    {VK_FORMAT_R32G32_UINT,                  8, 2, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT,             1,  1, TRAIT_UINT},
+    {VK_FORMAT_R32G32_SINT,                  8, 2, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT,             1,  1, TRAIT_SINT},
+    {VK_FORMAT_R32G32_SFLOAT,                8, 2, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT,             1,  1, TRAIT_FLOAT},
+    {VK_FORMAT_R32G32B32_UINT,              12, 3, VK_FORMAT_COMPATIBILITY_CLASS_96_BIT,             1,  1, TRAIT_UINT},
+    {VK_FORMAT_R32G32B32_SINT,              12, 3, VK_FORMAT_COMPATIBILITY_CLASS_96_BIT,             1,  1, TRAIT_SINT},
+    {VK_FORMAT_R32G32B32_SFLOAT,            12, 3, VK_FORMAT_COMPATIBILITY_CLASS_96_BIT,             1,  1, TRAIT_FLOAT},
+    {VK_FORMAT_R32G32B32A32_UINT,           16, 4, VK_FORMAT_COMPATIBILITY_CLASS_128_BIT,            1,  1, TRAIT_UINT},
+    {VK_FORMAT_R32G32B32A32_SINT,           16, 4, VK_FORMAT_COMPATIBILITY_CLASS_128_BIT,            1,  1, TRAIT_SINT},
+    {VK_FORMAT_R32G32B32A32_SFLOAT,         16, 4, VK_FORMAT_COMPATIBILITY_CLASS_128_BIT,            1,  1, TRAIT_FLOAT},
+    {VK_FORMAT_R64_UINT,                     8, 1, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT,             1,  1, TRAIT_UINT},
+    {VK_FORMAT_R64_SINT,                     8, 1, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT,             1,  1, TRAIT_SINT},
+    {VK_FORMAT_R64_SFLOAT,                   8, 1, VK_FORMAT_COMPATIBILITY_CLASS_64_BIT,             1,  1, TRAIT_FLOAT},
+    {VK_FORMAT_R64G64_UINT,                 16, 2, VK_FORMAT_COMPATIBILITY_CLASS_128_BIT,            1,  1, TRAIT_UINT},
+    {VK_FORMAT_R64G64_SINT,                 16, 2, VK_FORMAT_COMPATIBILITY_CLASS_128_BIT,            1,  1, TRAIT_SINT},
+    {VK_FORMAT_R64G64_SFLOAT,               16, 2, VK_FORMAT_COMPATIBILITY_CLASS_128_BIT,            1,  1, TRAIT_FLOAT},
+    {VK_FORMAT_R64G64B64_UINT,              24, 3, VK_FORMAT_COMPATIBILITY_CLASS_192_BIT,            1,  1, TRAIT_UINT},
+    {VK_FORMAT_R64G64B64_SINT,              24, 3, VK_FORMAT_COMPATIBILITY_CLASS_192_BIT,            1,  1, TRAIT_SINT},
+    {VK_FORMAT_R64G64B64_SFLOAT,            24, 3, VK_FORMAT_COMPATIBILITY_CLASS_192_BIT,            1,  1, TRAIT_FLOAT},
+    {VK_FORMAT_R64G64B64A64_UINT,           32, 4, VK_FORMAT_COMPATIBILITY_CLASS_256_BIT,            1,  1, TRAIT_UINT},
+    {VK_FORMAT_R64G64B64A64_SINT,           32, 4, VK_FORMAT_COMPATIBILITY_CLASS_256_BIT,            1,  1, TRAIT_SINT},
+    {VK_FORMAT_R64G64B64A64_SFLOAT,         32, 4, VK_FORMAT_COMPATIBILITY_CLASS_256_BIT,            1,  1, TRAIT_FLOAT},
+    {VK_FORMAT_B10G11R11_UFLOAT_PACK32,      4, 3, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_FLOAT},
+    {VK_FORMAT_E5B9G9R9_UFLOAT_PACK32,       4, 3, VK_FORMAT_COMPATIBILITY_CLASS_32_BIT,             1,  1, TRAIT_FLOAT},
+    {VK_FORMAT_D16_UNORM,                    2, 1, VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT,           1,  1, TRAIT_DEPTH},
+    {VK_FORMAT_X8_D24_UNORM_PACK32,          4, 1, VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT,           1,  1, TRAIT_DEPTH},
+    {VK_FORMAT_D32_SFLOAT,                   4, 1, VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT,           1,  1, TRAIT_DEPTH},
+    {VK_FORMAT_S8_UINT,                      1, 1, VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT,           1,  1, TRAIT_STENCIL | TRAIT_UINT},
+    {VK_FORMAT_D16_UNORM_S8_UINT,            3, 2, VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT,           1,  1, TRAIT_DEPTH_STENCIL},
+    {VK_FORMAT_D24_UNORM_S8_UINT,            4, 2, VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT,           1,  1, TRAIT_DEPTH_STENCIL},
+    {VK_FORMAT_D32_SFLOAT_S8_UINT,           8, 2, VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT,           1,  1, TRAIT_DEPTH_STENCIL},
+    {VK_FORMAT_BC1_RGB_UNORM_BLOCK,          8, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC1_RGB_BIT,        4,  4, TRAIT_BC | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_BC1_RGB_SRGB_BLOCK,           8, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC1_RGB_BIT,        4,  4, TRAIT_BC | TRAIT_SRGB},
+    {VK_FORMAT_BC1_RGBA_UNORM_BLOCK,         8, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC1_RGBA_BIT,       4,  4, TRAIT_BC},
+    {VK_FORMAT_BC1_RGBA_SRGB_BLOCK,          8, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC1_RGBA_BIT,       4,  4, TRAIT_BC},
+    {VK_FORMAT_BC2_UNORM_BLOCK,             16, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC2_BIT,            4,  4, TRAIT_BC | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_BC2_SRGB_BLOCK,              16, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC2_BIT,            4,  4, TRAIT_BC | TRAIT_SRGB},
+    {VK_FORMAT_BC3_UNORM_BLOCK,             16, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC3_BIT,            4,  4, TRAIT_BC | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_BC3_SRGB_BLOCK,              16, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC3_BIT,            4,  4, TRAIT_BC | TRAIT_SRGB},
+    {VK_FORMAT_BC4_UNORM_BLOCK,              8, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC4_BIT,            4,  4, TRAIT_BC | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_BC4_SNORM_BLOCK,              8, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC4_BIT,            4,  4, TRAIT_BC | TRAIT_NORM | TRAIT_SNORM},
+    {VK_FORMAT_BC5_UNORM_BLOCK,             16, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC5_BIT,            4,  4, TRAIT_BC | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_BC5_SNORM_BLOCK,             16, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC5_BIT,            4,  4, TRAIT_BC | TRAIT_NORM | TRAIT_SNORM},
+    {VK_FORMAT_BC6H_UFLOAT_BLOCK,           16, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC6H_BIT,           4,  4, TRAIT_BC | TRAIT_FLOAT},
+    {VK_FORMAT_BC6H_SFLOAT_BLOCK,           16, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC6H_BIT,           4,  4, TRAIT_BC | TRAIT_FLOAT},
+    {VK_FORMAT_BC7_UNORM_BLOCK,             16, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC7_BIT,            4,  4, TRAIT_BC | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_BC7_SRGB_BLOCK,              16, 4, VK_FORMAT_COMPATIBILITY_CLASS_BC7_BIT,            4,  4, TRAIT_BC | TRAIT_SRGB},
+    {VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK,      8, 3, VK_FORMAT_COMPATIBILITY_CLASS_ETC2_RGB_BIT,       4,  4, TRAIT_ETC2_EAC | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK,       8, 3, VK_FORMAT_COMPATIBILITY_CLASS_ETC2_RGB_BIT,       4,  4, TRAIT_ETC2_EAC | TRAIT_SRGB},
+    {VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK,    8, 4, VK_FORMAT_COMPATIBILITY_CLASS_ETC2_RGBA_BIT,      4,  4, TRAIT_ETC2_EAC | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK,     8, 4, VK_FORMAT_COMPATIBILITY_CLASS_ETC2_RGBA_BIT,      4,  4, TRAIT_ETC2_EAC | TRAIT_SRGB},
+    {VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK,   16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ETC2_EAC_RGBA_BIT,  4,  4, TRAIT_ETC2_EAC | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK,     8, 4, VK_FORMAT_COMPATIBILITY_CLASS_ETC2_EAC_RGBA_BIT,  4,  4, TRAIT_ETC2_EAC | TRAIT_SRGB},
+    {VK_FORMAT_EAC_R11_UNORM_BLOCK,          8, 1, VK_FORMAT_COMPATIBILITY_CLASS_EAC_R_BIT,          4,  4, TRAIT_ETC2_EAC | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_EAC_R11_SNORM_BLOCK,          8, 1, VK_FORMAT_COMPATIBILITY_CLASS_EAC_R_BIT,          4,  4, TRAIT_ETC2_EAC | TRAIT_NORM | TRAIT_SNORM},
+    {VK_FORMAT_EAC_R11G11_UNORM_BLOCK,      16, 2, VK_FORMAT_COMPATIBILITY_CLASS_EAC_RG_BIT,         4,  4, TRAIT_ETC2_EAC | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_EAC_R11G11_SNORM_BLOCK,      16, 2, VK_FORMAT_COMPATIBILITY_CLASS_EAC_RG_BIT,         4,  4, TRAIT_ETC2_EAC | TRAIT_NORM | TRAIT_SNORM},
+    {VK_FORMAT_ASTC_4x4_UNORM_BLOCK,        16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_4X4_BIT,       4,  4, TRAIT_ASTC_LDR | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_ASTC_4x4_SRGB_BLOCK,         16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_4X4_BIT,       4,  4, TRAIT_ASTC_LDR | TRAIT_SRGB},
+    {VK_FORMAT_ASTC_5x4_UNORM_BLOCK,        16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_5X4_BIT,       5,  4, TRAIT_ASTC_LDR | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_ASTC_5x4_SRGB_BLOCK,         16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_5X4_BIT,       5,  4, TRAIT_ASTC_LDR | TRAIT_SRGB},
+    {VK_FORMAT_ASTC_5x5_UNORM_BLOCK,        16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_5X5_BIT,       5,  5, TRAIT_ASTC_LDR | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_ASTC_5x5_SRGB_BLOCK,         16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_5X5_BIT,       5,  5, TRAIT_ASTC_LDR | TRAIT_SRGB},
+    {VK_FORMAT_ASTC_6x5_UNORM_BLOCK,        16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_6X5_BIT,       6,  5, TRAIT_ASTC_LDR | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_ASTC_6x5_SRGB_BLOCK,         16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_6X5_BIT,       6,  5, TRAIT_ASTC_LDR | TRAIT_SRGB},
+    {VK_FORMAT_ASTC_6x6_UNORM_BLOCK,        16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_6X6_BIT,       6,  6, TRAIT_ASTC_LDR | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_ASTC_6x6_SRGB_BLOCK,         16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_6X6_BIT,       6,  6, TRAIT_ASTC_LDR | TRAIT_SRGB},
+    {VK_FORMAT_ASTC_8x5_UNORM_BLOCK,        16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_8X5_BIT,       8,  5, TRAIT_ASTC_LDR | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_ASTC_8x5_SRGB_BLOCK,         16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_8X5_BIT,       8,  5, TRAIT_ASTC_LDR | TRAIT_SRGB},
+    {VK_FORMAT_ASTC_8x6_UNORM_BLOCK,        16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_8X6_BIT,       8,  6, TRAIT_ASTC_LDR | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_ASTC_8x6_SRGB_BLOCK,         16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_8X6_BIT,       8,  6, TRAIT_ASTC_LDR | TRAIT_SRGB},
+    {VK_FORMAT_ASTC_8x8_UNORM_BLOCK,        16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_8X8_BIT,       8,  8, TRAIT_ASTC_LDR | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_ASTC_8x8_SRGB_BLOCK,         16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_8X8_BIT,       8,  8, TRAIT_ASTC_LDR | TRAIT_SRGB},
+    {VK_FORMAT_ASTC_10x5_UNORM_BLOCK,       16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_10X5_BIT,     10,  5, TRAIT_ASTC_LDR | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_ASTC_10x5_SRGB_BLOCK,        16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_10X5_BIT,     10,  5, TRAIT_ASTC_LDR | TRAIT_SRGB},
+    {VK_FORMAT_ASTC_10x6_UNORM_BLOCK,       16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_10X6_BIT,     10,  6, TRAIT_ASTC_LDR | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_ASTC_10x6_SRGB_BLOCK,        16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_10X6_BIT,     10,  6, TRAIT_ASTC_LDR | TRAIT_SRGB},
+    {VK_FORMAT_ASTC_10x8_UNORM_BLOCK,       16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_10X8_BIT,     10,  8, TRAIT_ASTC_LDR | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_ASTC_10x8_SRGB_BLOCK,        16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_10X8_BIT,     10,  8, TRAIT_ASTC_LDR | TRAIT_SRGB},
+    {VK_FORMAT_ASTC_10x10_UNORM_BLOCK,      16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_10X10_BIT,    10, 10, TRAIT_ASTC_LDR | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_ASTC_10x10_SRGB_BLOCK,       16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_10X10_BIT,    10, 10, TRAIT_ASTC_LDR | TRAIT_SRGB},
+    {VK_FORMAT_ASTC_12x10_UNORM_BLOCK,      16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_12X10_BIT,    12, 10, TRAIT_ASTC_LDR | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_ASTC_12x10_SRGB_BLOCK,       16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_12X10_BIT,    12, 10, TRAIT_ASTC_LDR | TRAIT_SRGB},
+    {VK_FORMAT_ASTC_12x12_UNORM_BLOCK,      16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_12X12_BIT,    12, 12, TRAIT_ASTC_LDR | TRAIT_NORM | TRAIT_UNORM},
+    {VK_FORMAT_ASTC_12x12_SRGB_BLOCK,       16, 4, VK_FORMAT_COMPATIBILITY_CLASS_ASTC_12X12_BIT,    12, 12, TRAIT_ASTC_LDR | TRAIT_SRGB}
+};
+
+// The same for the VK_IMG_format_pvrtc formats, indexed from VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG
+static const VULKAN_FORMAT_INFO vk_format_table_pvrtc[] = {
+    {VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG,  8, 4, VK_FORMAT_COMPATIBILITY_CLASS_PVRTC1_2BPP_BIT,    8,  4, TRAIT_PVRTC},
+    {VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG,  8, 4, VK_FORMAT_COMPATIBILITY_CLASS_PVRTC1_4BPP_BIT,    4,  4, TRAIT_PVRTC},
+    {VK_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG,  8, 4, VK_FORMAT_COMPATIBILITY_CLASS_PVRTC2_2BPP_BIT,    8,  4, TRAIT_PVRTC},
+    {VK_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG,  8, 4, VK_FORMAT_COMPATIBILITY_CLASS_PVRTC2_4BPP_BIT,    4,  4, TRAIT_PVRTC},
+    {VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG,   8, 4, VK_FORMAT_COMPATIBILITY_CLASS_PVRTC1_2BPP_BIT,    8,  4, TRAIT_PVRTC},
+    {VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG,   8, 4, VK_FORMAT_COMPATIBILITY_CLASS_PVRTC1_4BPP_BIT,    4,  4, TRAIT_PVRTC},
+    {VK_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG,   8, 4, VK_FORMAT_COMPATIBILITY_CLASS_PVRTC2_2BPP_BIT,    8,  4, TRAIT_PVRTC},
+    {VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG,   8, 4, VK_FORMAT_COMPATIBILITY_CLASS_PVRTC2_4BPP_BIT,    4,  4, TRAIT_PVRTC}
 };
 
 // Renable formatting
 // clang-format on
 
-// Return true if format is an ETC2 or EAC compressed texture format
-VK_LAYER_EXPORT bool FormatIsCompressed_ETC2_EAC(VkFormat format) {
-    bool found = false;
-
-    switch (format) {
-        case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
-        case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
-        case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
-        case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
-        case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
-        case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
-        case VK_FORMAT_EAC_R11_UNORM_BLOCK:
-        case VK_FORMAT_EAC_R11_SNORM_BLOCK:
-        case VK_FORMAT_EAC_R11G11_UNORM_BLOCK:
-        case VK_FORMAT_EAC_R11G11_SNORM_BLOCK:
-            found = true;
-            break;
-        default:
-            break;
+// Return the table entry for a format. Unknown formats get the VK_FORMAT_UNDEFINED entry, which has no traits.
+static inline const VULKAN_FORMAT_INFO &GetFormatInfo(VkFormat format) {
+    if (format >= VK_FORMAT_BEGIN_RANGE && format <= VK_FORMAT_END_RANGE) {
+        return vk_format_table[format];
     }
-    return found;
+    if (format >= VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG && format <= VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG) {
+        return vk_format_table_pvrtc[format - VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG];
+    }
+    return vk_format_table[VK_FORMAT_UNDEFINED];
 }
 
+static inline bool FormatHasTraits(VkFormat format, uint32_t traits) { return (GetFormatInfo(format).traits & traits) != 0; }
+
+// Return true if format is an ETC2 or EAC compressed texture format
+VK_LAYER_EXPORT bool FormatIsCompressed_ETC2_EAC(VkFormat format) { return FormatHasTraits(format, TRAIT_ETC2_EAC); }
+
 // Return true if format is an ASTC compressed texture format
-VK_LAYER_EXPORT bool FormatIsCompressed_ASTC_LDR(VkFormat format) {
-    bool found = false;
-
-    switch (format) {
-        case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_5x4_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_5x4_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_5x5_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_5x5_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_6x5_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_6x5_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_6x6_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_6x6_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_8x5_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_8x5_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_8x6_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_8x6_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_8x8_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_8x8_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_10x5_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_10x5_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_10x6_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_10x6_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_10x8_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_10x8_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_10x10_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_10x10_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_12x10_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_12x10_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_12x12_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_12x12_SRGB_BLOCK:
-            found = true;
-            break;
-        default:
-            break;
-    }
-    return found;
-}
+VK_LAYER_EXPORT bool FormatIsCompressed_ASTC_LDR(VkFormat format) { return FormatHasTraits(format, TRAIT_ASTC_LDR); }
 
 // Return true if format is a BC compressed texture format
-VK_LAYER_EXPORT bool FormatIsCompressed_BC(VkFormat format) {
-    bool found = false;
-
-    switch (format) {
-        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
-        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
-        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
-        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
-        case VK_FORMAT_BC2_UNORM_BLOCK:
-        case VK_FORMAT_BC2_SRGB_BLOCK:
-        case VK_FORMAT_BC3_UNORM_BLOCK:
-        case VK_FORMAT_BC3_SRGB_BLOCK:
-        case VK_FORMAT_BC4_UNORM_BLOCK:
-        case VK_FORMAT_BC4_SNORM_BLOCK:
-        case VK_FORMAT_BC5_UNORM_BLOCK:
-        case VK_FORMAT_BC5_SNORM_BLOCK:
-        case VK_FORMAT_BC6H_UFLOAT_BLOCK:
-        case VK_FORMAT_BC6H_SFLOAT_BLOCK:
-        case VK_FORMAT_BC7_UNORM_BLOCK:
-        case VK_FORMAT_BC7_SRGB_BLOCK:
-            found = true;
-            break;
-        default:
-            break;
-    }
-    return found;
-}
+VK_LAYER_EXPORT bool FormatIsCompressed_BC(VkFormat format) { return FormatHasTraits(format, TRAIT_BC); }
 
 // Return true if format is a PVRTC compressed texture format
-VK_LAYER_EXPORT bool FormatIsCompressed_PVRTC(VkFormat format) {
-    bool found = false;
-
-    switch (format) {
-        case VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG:
-        case VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG:
-        case VK_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG:
-        case VK_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG:
-        case VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG:
-        case VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG:
-        case VK_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG:
-        case VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG:
-            found = true;
-            break;
-        default:
-            break;
-    }
-    return found;
-}
+VK_LAYER_EXPORT bool FormatIsCompressed_PVRTC(VkFormat format) { return FormatHasTraits(format, TRAIT_PVRTC); }
 
 // Return true if format is compressed
-VK_LAYER_EXPORT bool FormatIsCompressed(VkFormat format) {
-    return (FormatIsCompressed_ASTC_LDR(format) || 
-            FormatIsCompressed_BC(format) || 
-            FormatIsCompressed_ETC2_EAC(format) ||
-            FormatIsCompressed_PVRTC(format));
-}
+VK_LAYER_EXPORT bool FormatIsCompressed(VkFormat format) { return FormatHasTraits(format, TRAIT_COMPRESSED); }
 
 // Return true if format is a depth or stencil format
-VK_LAYER_EXPORT bool FormatIsDepthOrStencil(VkFormat format) {
-    return (FormatIsDepthAndStencil(format) || FormatIsDepthOnly(format) || FormatIsStencilOnly(format));
-}
+VK_LAYER_EXPORT bool FormatIsDepthOrStencil(VkFormat format) { return FormatHasTraits(format, TRAIT_DEPTH_OR_STENCIL); }
 
 // Return true if format contains depth and stencil information
-VK_LAYER_EXPORT bool FormatIsDepthAndStencil(VkFormat format) {
-    bool is_ds = false;
-
-    switch (format) {
-        case VK_FORMAT_D16_UNORM_S8_UINT:
-        case VK_FORMAT_D24_UNORM_S8_UINT:
-        case VK_FORMAT_D32_SFLOAT_S8_UINT:
-            is_ds = true;
-            break;
-        default:
-            break;
-    }
-    return is_ds;
-}
+VK_LAYER_EXPORT bool FormatIsDepthAndStencil(VkFormat format) { return FormatHasTraits(format, TRAIT_DEPTH_STENCIL); }
 
 // Return true if format is a stencil-only format
-VK_LAYER_EXPORT bool FormatIsStencilOnly(VkFormat format) { return (format == VK_FORMAT_S8_UINT); }
+VK_LAYER_EXPORT bool FormatIsStencilOnly(VkFormat format) { return FormatHasTraits(format, TRAIT_STENCIL); }
 
 // Return true if format is a depth-only format
-VK_LAYER_EXPORT bool FormatIsDepthOnly(VkFormat format) {
-    bool is_depth = false;
-
-    switch (format) {
-        case VK_FORMAT_D16_UNORM:
-        case VK_FORMAT_X8_D24_UNORM_PACK32:
-        case VK_FORMAT_D32_SFLOAT:
-            is_depth = true;
-            break;
-        default:
-            break;
-    }
-
-    return is_depth;
-}
+VK_LAYER_EXPORT bool FormatIsDepthOnly(VkFormat format) { return FormatHasTraits(format, TRAIT_DEPTH); }
 
 // Return true if format is of type NORM
-VK_LAYER_EXPORT bool FormatIsNorm(VkFormat format) {
-    bool is_norm = false;
-
-    switch (format) {
-        case VK_FORMAT_R4G4_UNORM_PACK8:
-        case VK_FORMAT_R4G4B4A4_UNORM_PACK16:
-        case VK_FORMAT_R5G6B5_UNORM_PACK16:
-        case VK_FORMAT_R5G5B5A1_UNORM_PACK16:
-        case VK_FORMAT_A1R5G5B5_UNORM_PACK16:
-        case VK_FORMAT_R8_UNORM:
-        case VK_FORMAT_R8_SNORM:
-        case VK_FORMAT_R8G8_UNORM:
-        case VK_FORMAT_R8G8_SNORM:
-        case VK_FORMAT_R8G8B8_UNORM:
-        case VK_FORMAT_R8G8B8_SNORM:
-        case VK_FORMAT_R8G8B8A8_UNORM:
-        case VK_FORMAT_R8G8B8A8_SNORM:
-        case VK_FORMAT_A8B8G8R8_UNORM_PACK32:
-        case VK_FORMAT_A8B8G8R8_SNORM_PACK32:
-        case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
-        case VK_FORMAT_A2B10G10R10_SNORM_PACK32:
-        case VK_FORMAT_R16_UNORM:
-        case VK_FORMAT_R16_SNORM:
-        case VK_FORMAT_R16G16_UNORM:
-        case VK_FORMAT_R16G16_SNORM:
-        case VK_FORMAT_R16G16B16_UNORM:
-        case VK_FORMAT_R16G16B16_SNORM:
-        case VK_FORMAT_R16G16B16A16_UNORM:
-        case VK_FORMAT_R16G16B16A16_SNORM:
-        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
-        case VK_FORMAT_BC2_UNORM_BLOCK:
-        case VK_FORMAT_BC3_UNORM_BLOCK:
-        case VK_FORMAT_BC4_UNORM_BLOCK:
-        case VK_FORMAT_BC4_SNORM_BLOCK:
-        case VK_FORMAT_BC5_UNORM_BLOCK:
-        case VK_FORMAT_BC5_SNORM_BLOCK:
-        case VK_FORMAT_BC7_UNORM_BLOCK:
-        case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
-        case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
-        case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
-        case VK_FORMAT_EAC_R11_UNORM_BLOCK:
-        case VK_FORMAT_EAC_R11_SNORM_BLOCK:
-        case VK_FORMAT_EAC_R11G11_UNORM_BLOCK:
-        case VK_FORMAT_EAC_R11G11_SNORM_BLOCK:
-        case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_5x4_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_5x5_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_6x5_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_6x6_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_8x5_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_8x6_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_8x8_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_10x5_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_10x6_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_10x8_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_10x10_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_12x10_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_12x12_UNORM_BLOCK:
-        case VK_FORMAT_B5G6R5_UNORM_PACK16:
-        case VK_FORMAT_B8G8R8_UNORM:
-        case VK_FORMAT_B8G8R8_SNORM:
-        case VK_FORMAT_B8G8R8A8_UNORM:
-        case VK_FORMAT_B8G8R8A8_SNORM:
-        case VK_FORMAT_A2R10G10B10_UNORM_PACK32:
-        case VK_FORMAT_A2R10G10B10_SNORM_PACK32:
-            is_norm = true;
-            break;
-        default:
-            break;
-    }
-
-    return is_norm;
-};
+VK_LAYER_EXPORT bool FormatIsNorm(VkFormat format) { return FormatHasTraits(format, TRAIT_NORM); }
 
 // Return true if format is of type UNORM
-VK_LAYER_EXPORT bool FormatIsUNorm(VkFormat format) {
-    bool is_unorm = false;
-
-    switch (format) {
-        case VK_FORMAT_R4G4_UNORM_PACK8:
-        case VK_FORMAT_R4G4B4A4_UNORM_PACK16:
-        case VK_FORMAT_R5G6B5_UNORM_PACK16:
-        case VK_FORMAT_R5G5B5A1_UNORM_PACK16:
-        case VK_FORMAT_A1R5G5B5_UNORM_PACK16:
-        case VK_FORMAT_R8_UNORM:
-        case VK_FORMAT_R8G8_UNORM:
-        case VK_FORMAT_R8G8B8_UNORM:
-        case VK_FORMAT_R8G8B8A8_UNORM:
-        case VK_FORMAT_A8B8G8R8_UNORM_PACK32:
-        case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
-        case VK_FORMAT_R16_UNORM:
-        case VK_FORMAT_R16G16_UNORM:
-        case VK_FORMAT_R16G16B16_UNORM:
-        case VK_FORMAT_R16G16B16A16_UNORM:
-        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
-        case VK_FORMAT_BC2_UNORM_BLOCK:
-        case VK_FORMAT_BC3_UNORM_BLOCK:
-        case VK_FORMAT_BC4_UNORM_BLOCK:
-        case VK_FORMAT_BC5_UNORM_BLOCK:
-        case VK_FORMAT_BC7_UNORM_BLOCK:
-        case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
-        case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
-        case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
-        case VK_FORMAT_EAC_R11_UNORM_BLOCK:
-        case VK_FORMAT_EAC_R11G11_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_5x4_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_5x5_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_6x5_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_6x6_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_8x5_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_8x6_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_8x8_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_10x5_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_10x6_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_10x8_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_10x10_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_12x10_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_12x12_UNORM_BLOCK:
-        case VK_FORMAT_B5G6R5_UNORM_PACK16:
-        case VK_FORMAT_B8G8R8_UNORM:
-        case VK_FORMAT_B8G8R8A8_UNORM:
-        case VK_FORMAT_A2R10G10B10_UNORM_PACK32:
-            is_unorm = true;
-            break;
-        default:
-            break;
-    }
-
-    return is_unorm;
-};
+VK_LAYER_EXPORT bool FormatIsUNorm(VkFormat format) { return FormatHasTraits(format, TRAIT_UNORM); }
 
 // Return true if format is of type SNORM
-VK_LAYER_EXPORT bool FormatIsSNorm(VkFormat format) {
-    bool is_snorm = false;
-
-    switch (format) {
-        case VK_FORMAT_R8_SNORM:
-        case VK_FORMAT_R8G8_SNORM:
-        case VK_FORMAT_R8G8B8_SNORM:
-        case VK_FORMAT_R8G8B8A8_SNORM:
-        case VK_FORMAT_A8B8G8R8_SNORM_PACK32:
-        case VK_FORMAT_A2B10G10R10_SNORM_PACK32:
-        case VK_FORMAT_R16_SNORM:
-        case VK_FORMAT_R16G16_SNORM:
-        case VK_FORMAT_R16G16B16_SNORM:
-        case VK_FORMAT_R16G16B16A16_SNORM:
-        case VK_FORMAT_BC4_SNORM_BLOCK:
-        case VK_FORMAT_BC5_SNORM_BLOCK:
-        case VK_FORMAT_EAC_R11_SNORM_BLOCK:
-        case VK_FORMAT_EAC_R11G11_SNORM_BLOCK:
-        case VK_FORMAT_B8G8R8_SNORM:
-        case VK_FORMAT_B8G8R8A8_SNORM:
-        case VK_FORMAT_A2R10G10B10_SNORM_PACK32:
-            is_snorm = true;
-            break;
-        default:
-            break;
-    }
-
-    return is_snorm;
-};
+VK_LAYER_EXPORT bool FormatIsSNorm(VkFormat format) { return FormatHasTraits(format, TRAIT_SNORM); }
 
 // Return true if format is an integer format
-VK_LAYER_EXPORT bool FormatIsInt(VkFormat format) { return (FormatIsSInt(format) || FormatIsUInt(format)); }
+VK_LAYER_EXPORT bool FormatIsInt(VkFormat format) { return FormatHasTraits(format, TRAIT_UINT | TRAIT_SINT); }
 
 // Return true if format is an unsigned integer format
-VK_LAYER_EXPORT bool FormatIsUInt(VkFormat format) {
-    bool is_uint = false;
-
-    switch (format) {
-        case VK_FORMAT_R8_UINT:
-        case VK_FORMAT_S8_UINT:
-        case VK_FORMAT_R8G8_UINT:
-        case VK_FORMAT_R8G8B8_UINT:
-        case VK_FORMAT_R8G8B8A8_UINT:
-        case VK_FORMAT_A8B8G8R8_UINT_PACK32:
-        case VK_FORMAT_A2B10G10R10_UINT_PACK32:
-        case VK_FORMAT_R16_UINT:
-        case VK_FORMAT_R16G16_UINT:
-        case VK_FORMAT_R16G16B16_UINT:
-        case VK_FORMAT_R16G16B16A16_UINT:
-        case VK_FORMAT_R32_UINT:
-        case VK_FORMAT_R32G32_UINT:
-        case VK_FORMAT_R32G32B32_UINT:
-        case VK_FORMAT_R32G32B32A32_UINT:
-        case VK_FORMAT_R64_UINT:
-        case VK_FORMAT_R64G64_UINT:
-        case VK_FORMAT_R64G64B64_UINT:
-        case VK_FORMAT_R64G64B64A64_UINT:
-        case VK_FORMAT_B8G8R8_UINT:
-        case VK_FORMAT_B8G8R8A8_UINT:
-        case VK_FORMAT_A2R10G10B10_UINT_PACK32:
-            is_uint = true;
-            break;
-        default:
-            break;
-    }
-
-    return is_uint;
-}
+VK_LAYER_EXPORT bool FormatIsUInt(VkFormat format) { return FormatHasTraits(format, TRAIT_UINT); }
 
 // Return true if format is a signed integer format
-VK_LAYER_EXPORT bool FormatIsSInt(VkFormat format) {
-    bool is_sint = false;
-
-    switch (format) {
-        case VK_FORMAT_R8_SINT:
-        case VK_FORMAT_R8G8_SINT:
-        case VK_FORMAT_R8G8B8_SINT:
-        case VK_FORMAT_R8G8B8A8_SINT:
-        case VK_FORMAT_A8B8G8R8_SINT_PACK32:
-        case VK_FORMAT_A2B10G10R10_SINT_PACK32:
-        case VK_FORMAT_R16_SINT:
-        case VK_FORMAT_R16G16_SINT:
-        case VK_FORMAT_R16G16B16_SINT:
-        case VK_FORMAT_R16G16B16A16_SINT:
-        case VK_FORMAT_R32_SINT:
-        case VK_FORMAT_R32G32_SINT:
-        case VK_FORMAT_R32G32B32_SINT:
-        case VK_FORMAT_R32G32B32A32_SINT:
-        case VK_FORMAT_R64_SINT:
-        case VK_FORMAT_R64G64_SINT:
-        case VK_FORMAT_R64G64B64_SINT:
-        case VK_FORMAT_R64G64B64A64_SINT:
-        case VK_FORMAT_B8G8R8_SINT:
-        case VK_FORMAT_B8G8R8A8_SINT:
-        case VK_FORMAT_A2R10G10B10_SINT_PACK32:
-            is_sint = true;
-            break;
-        default:
-            break;
-    }
-
-    return is_sint;
-}
+VK_LAYER_EXPORT bool FormatIsSInt(VkFormat format) { return FormatHasTraits(format, TRAIT_SINT); }
 
 // Return true if format is a floating-point format
-VK_LAYER_EXPORT bool FormatIsFloat(VkFormat format) {
-    bool is_float = false;
-
-    switch (format) {
-        case VK_FORMAT_R16_SFLOAT:
-        case VK_FORMAT_R16G16_SFLOAT:
-        case VK_FORMAT_R16G16B16_SFLOAT:
-        case VK_FORMAT_R16G16B16A16_SFLOAT:
-        case VK_FORMAT_R32_SFLOAT:
-        case VK_FORMAT_R32G32_SFLOAT:
-        case VK_FORMAT_R32G32B32_SFLOAT:
-        case VK_FORMAT_R32G32B32A32_SFLOAT:
-        case VK_FORMAT_R64_SFLOAT:
-        case VK_FORMAT_R64G64_SFLOAT:
-        case VK_FORMAT_R64G64B64_SFLOAT:
-        case VK_FORMAT_R64G64B64A64_SFLOAT:
-        case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
-        case VK_FORMAT_E5B9G9R9_UFLOAT_PACK32:
-        case VK_FORMAT_BC6H_UFLOAT_BLOCK:
-        case VK_FORMAT_BC6H_SFLOAT_BLOCK:
-            is_float = true;
-            break;
-        default:
-            break;
-    }
-
-    return is_float;
-}
+VK_LAYER_EXPORT bool FormatIsFloat(VkFormat format) { return FormatHasTraits(format, TRAIT_FLOAT); }
 
 // Return true if format is in the SRGB colorspace
-VK_LAYER_EXPORT bool FormatIsSRGB(VkFormat format) {
-    bool is_srgb = false;
-
-    switch (format) {
-        case VK_FORMAT_R8_SRGB:
-        case VK_FORMAT_R8G8_SRGB:
-        case VK_FORMAT_R8G8B8_SRGB:
-        case VK_FORMAT_R8G8B8A8_SRGB:
-        case VK_FORMAT_A8B8G8R8_SRGB_PACK32:
-        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
-        case VK_FORMAT_BC2_SRGB_BLOCK:
-        case VK_FORMAT_BC3_SRGB_BLOCK:
-        case VK_FORMAT_BC7_SRGB_BLOCK:
-        case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
-        case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
-        case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_5x4_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_5x5_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_6x5_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_6x6_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_8x5_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_8x6_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_8x8_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_10x5_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_10x6_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_10x8_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_10x10_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_12x10_SRGB_BLOCK:
-        case VK_FORMAT_ASTC_12x12_SRGB_BLOCK:
-        case VK_FORMAT_B8G8R8_SRGB:
-        case VK_FORMAT_B8G8R8A8_SRGB:
-            is_srgb = true;
-            break;
-        default:
-            break;
-    }
-
-    return is_srgb;
-}
+VK_LAYER_EXPORT bool FormatIsSRGB(VkFormat format) { return FormatHasTraits(format, TRAIT_SRGB); }
 
 // Return true if format is a USCALED format
-VK_LAYER_EXPORT bool FormatIsUScaled(VkFormat format) {
-    bool is_uscaled = false;
-
-    switch (format) {
-        case VK_FORMAT_R8_USCALED:
-        case VK_FORMAT_R8G8_USCALED:
-        case VK_FORMAT_R8G8B8_USCALED:
-        case VK_FORMAT_B8G8R8_USCALED:
-        case VK_FORMAT_R8G8B8A8_USCALED:
-        case VK_FORMAT_B8G8R8A8_USCALED:
-        case VK_FORMAT_A8B8G8R8_USCALED_PACK32:
-        case VK_FORMAT_A2R10G10B10_USCALED_PACK32:
-        case VK_FORMAT_A2B10G10R10_USCALED_PACK32:
-        case VK_FORMAT_R16_USCALED:
-        case VK_FORMAT_R16G16_USCALED:
-        case VK_FORMAT_R16G16B16_USCALED:
-        case VK_FORMAT_R16G16B16A16_USCALED:
-            is_uscaled = true;
-            break;
-        default:
-            break;
-    }
-
-    return is_uscaled;
-}
+VK_LAYER_EXPORT bool FormatIsUScaled(VkFormat format) { return FormatHasTraits(format, TRAIT_USCALED); }
 
 // Return true if format is a SSCALED format
-VK_LAYER_EXPORT bool FormatIsSScaled(VkFormat format) {
-    bool is_sscaled = false;
-
-    switch (format) {
-        case VK_FORMAT_R8_SSCALED:
-        case VK_FORMAT_R8G8_SSCALED:
-        case VK_FORMAT_R8G8B8_SSCALED:
-        case VK_FORMAT_B8G8R8_SSCALED:
-        case VK_FORMAT_R8G8B8A8_SSCALED:
-        case VK_FORMAT_B8G8R8A8_SSCALED:
-        case VK_FORMAT_A8B8G8R8_SSCALED_PACK32:
-        case VK_FORMAT_A2R10G10B10_SSCALED_PACK32:
-        case VK_FORMAT_A2B10G10R10_SSCALED_PACK32:
-        case VK_FORMAT_R16_SSCALED:
-        case VK_FORMAT_R16G16_SSCALED:
-        case VK_FORMAT_R16G16B16_SSCALED:
-        case VK_FORMAT_R16G16B16A16_SSCALED:
-            is_sscaled = true;
-            break;
-        default:
-            break;
-    }
-
-    return is_sscaled;
-}
+VK_LAYER_EXPORT bool FormatIsSScaled(VkFormat format) { return FormatHasTraits(format, TRAIT_SSCALED); }
 
 // Return compressed texel block sizes for block compressed formats
 VK_LAYER_EXPORT VkExtent3D FormatCompressedTexelBlockExtent(VkFormat format) {
-    VkExtent3D block_size = {1, 1, 1};
-    switch (format) {
-        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
-        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
-        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
-        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
-        case VK_FORMAT_BC2_UNORM_BLOCK:
-        case VK_FORMAT_BC2_SRGB_BLOCK:
-        case VK_FORMAT_BC3_UNORM_BLOCK:
-        case VK_FORMAT_BC3_SRGB_BLOCK:
-        case VK_FORMAT_BC4_UNORM_BLOCK:
-        case VK_FORMAT_BC4_SNORM_BLOCK:
-        case VK_FORMAT_BC5_UNORM_BLOCK:
-        case VK_FORMAT_BC5_SNORM_BLOCK:
-        case VK_FORMAT_BC6H_UFLOAT_BLOCK:
-        case VK_FORMAT_BC6H_SFLOAT_BLOCK:
-        case VK_FORMAT_BC7_UNORM_BLOCK:
-        case VK_FORMAT_BC7_SRGB_BLOCK:
-        case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
-        case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
-        case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
-        case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
-        case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
-        case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
-        case VK_FORMAT_EAC_R11_UNORM_BLOCK:
-        case VK_FORMAT_EAC_R11_SNORM_BLOCK:
-        case VK_FORMAT_EAC_R11G11_UNORM_BLOCK:
-        case VK_FORMAT_EAC_R11G11_SNORM_BLOCK:
-        case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
-            block_size = {4, 4, 1};
-            break;
-        case VK_FORMAT_ASTC_5x4_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_5x4_SRGB_BLOCK:
-            block_size = {5, 4, 1};
-            break;
-        case VK_FORMAT_ASTC_5x5_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_5x5_SRGB_BLOCK:
-            block_size = {5, 5, 1};
-            break;
-        case VK_FORMAT_ASTC_6x5_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_6x5_SRGB_BLOCK:
-            block_size = {6, 5, 1};
-            break;
-        case VK_FORMAT_ASTC_6x6_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_6x6_SRGB_BLOCK:
-            block_size = {6, 6, 1};
-            break;
-        case VK_FORMAT_ASTC_8x5_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_8x5_SRGB_BLOCK:
-            block_size = {8, 5, 1};
-            break;
-        case VK_FORMAT_ASTC_8x6_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_8x6_SRGB_BLOCK:
-            block_size = {8, 6, 1};
-            break;
-        case VK_FORMAT_ASTC_8x8_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_8x8_SRGB_BLOCK:
-            block_size = {8, 8, 1};
-            break;
-        case VK_FORMAT_ASTC_10x5_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_10x5_SRGB_BLOCK:
-            block_size = {10, 5, 1};
-            break;
-        case VK_FORMAT_ASTC_10x6_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_10x6_SRGB_BLOCK:
-            block_size = {10, 6, 1};
-            break;
-        case VK_FORMAT_ASTC_10x8_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_10x8_SRGB_BLOCK:
-            block_size = {10, 8, 1};
-            break;
-        case VK_FORMAT_ASTC_10x10_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_10x10_SRGB_BLOCK:
-            block_size = {10, 10, 1};
-            break;
-        case VK_FORMAT_ASTC_12x10_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_12x10_SRGB_BLOCK:
-            block_size = {12, 10, 1};
-            break;
-        case VK_FORMAT_ASTC_12x12_UNORM_BLOCK:
-        case VK_FORMAT_ASTC_12x12_SRGB_BLOCK:
-            block_size = {12, 12, 1};
-            break;
-        case VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG:
-        case VK_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG:
-        case VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG:
-        case VK_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG:
-            block_size = {8, 4, 1};
-            break;
-        case VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG:
-        case VK_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG:
-        case VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG:
-        case VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG:
-            block_size = {4, 4, 1};
-            break;
-        default:
-            break;
-    }
+    const VULKAN_FORMAT_INFO &info = GetFormatInfo(format);
+    VkExtent3D block_size = {info.block_width, info.block_height, 1};
     return block_size;
 }
 
 // Return format class of the specified format
-VK_LAYER_EXPORT VkFormatCompatibilityClass FormatCompatibilityClass(VkFormat format) {
-    auto item = vk_format_table.find(format);
-    if (item != vk_format_table.end()) {
-        return item->second.format_class;
-    }
-    return VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT;
-}
+VK_LAYER_EXPORT VkFormatCompatibilityClass FormatCompatibilityClass(VkFormat format) { return GetFormatInfo(format).format_class; }
 
 // Return size, in bytes, of a pixel of the specified format
-VK_LAYER_EXPORT size_t FormatSize(VkFormat format) {
-    auto item = vk_format_table.find(format);
-    if (item != vk_format_table.end()) {
-        return item->second.size;
-    }
-    return 0;
-}
+VK_LAYER_EXPORT size_t FormatSize(VkFormat format) { return GetFormatInfo(format).size; }
 
 // Return the number of channels for a given format
-unsigned int FormatChannelCount(VkFormat format) {
-    auto item = vk_format_table.find(format);
-    if (item != vk_format_table.end()) {
-        return item->second.channel_count;
-    }
-    return 0;
-}
+unsigned int FormatChannelCount(VkFormat format) { return GetFormatInfo(format).channel_count; }
 
 // Perform a zero-tolerant modulo operation
 VK_LAYER_EXPORT VkDeviceSize SafeModulo(VkDeviceSize dividend, VkDeviceSize divisor) {
@@ -20,10 +20,116 @@
 #ifndef LAYER_DATA_H
 #define LAYER_DATA_H
 
+#include <atomic>
 #include <cassert>
+#include <mutex>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 #include "vk_layer_table.h"
 
+// Table of per-instance or per-device layer data, keyed by dispatch key. Every intercepted call starts with a lookup here,
+// so the first few entries live in a small array of slots that is searched without a lock: an application rarely has more
+// than a couple of instances or devices, and the common case is a single pointer compare against slot 0. Further entries
+// spill into a mutex-guarded unordered_map.
+//
+// Entries are only added and removed while creating and destroying the instance or device they belong to. A slot's value
+// is written before its key is published with release semantics, and a lookup loads the key with acquire semantics, so a
+// thread that finds a key also sees its data. Vulkan forbids using an object while it is being destroyed, so clearing a
+// slot cannot race with a lookup of the same key.
+template <typename DATA_T>
+class LayerDataMap {
+   public:
+    LayerDataMap() : used_slots_(0) {
+        for (size_t i = 0; i < kSlotCount; ++i) {
+            keys_[i].store(nullptr, std::memory_order_relaxed);
+            values_[i] = nullptr;
+        }
+    }
+
+    DATA_T *Find(void *key) {
+        if (keys_[0].load(std::memory_order_acquire) == key) return values_[0];
+        return FindSlow(key);
+    }
+
+    // Returns the data for key, creating it if there is none yet
+    DATA_T *FindOrCreate(void *key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        DATA_T *data = FindLocked(key);
+        if (data) return data;
+        data = new DATA_T;
+        for (size_t i = 0; i < kSlotCount; ++i) {
+            if (!keys_[i].load(std::memory_order_relaxed)) {
+                values_[i] = data;
+                keys_[i].store(key, std::memory_order_release);
+                if (i >= used_slots_.load(std::memory_order_relaxed)) used_slots_.store(i + 1, std::memory_order_release);
+                return data;
+            }
+        }
+        overflow_[key] = data;
+        return data;
+    }
+
+    // Removes key and returns its data, which the caller then owns
+    DATA_T *Erase(void *key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < kSlotCount; ++i) {
+            if (keys_[i].load(std::memory_order_relaxed) == key) {
+                keys_[i].store(nullptr, std::memory_order_release);
+                DATA_T *data = values_[i];
+                values_[i] = nullptr;
+                return data;
+            }
+        }
+        auto got = overflow_.find(key);
+        if (got == overflow_.end()) return nullptr;
+        DATA_T *data = got->second;
+        overflow_.erase(got);
+        return data;
+    }
+
+    // Copy of every (key, data) pair, for the rare callers that need to visit all entries
+    std::vector<std::pair<void *, DATA_T *>> entries() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<std::pair<void *, DATA_T *>> result;
+        for (size_t i = 0; i < kSlotCount; ++i) {
+            void *key = keys_[i].load(std::memory_order_relaxed);
+            if (key) result.emplace_back(key, values_[i]);
+        }
+        result.insert(result.end(), overflow_.begin(), overflow_.end());
+        return result;
+    }
+
+   private:
+    static const size_t kSlotCount = 8;
+
+    DATA_T *FindSlow(void *key) {
+        size_t used_slots = used_slots_.load(std::memory_order_acquire);
+        for (size_t i = 1; i < used_slots; ++i) {
+            if (keys_[i].load(std::memory_order_acquire) == key) return values_[i];
+        }
+        if (used_slots < kSlotCount) return nullptr;
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto got = overflow_.find(key);
+        return got == overflow_.end() ? nullptr : got->second;
+    }
+
+    DATA_T *FindLocked(void *key) {
+        for (size_t i = 0; i < kSlotCount; ++i) {
+            if (keys_[i].load(std::memory_order_relaxed) == key) return values_[i];
+        }
+        auto got = overflow_.find(key);
+        return got == overflow_.end() ? nullptr : got->second;
+    }
+
+    std::atomic<void *> keys_[kSlotCount];
+    DATA_T *values_[kSlotCount];
+    // One past the highest slot ever used; slots are reused but never given back
+    std::atomic<size_t> used_slots_;
+    std::mutex mutex_;
+    std::unordered_map<void *, DATA_T *> overflow_;
+};
+
 // For the given data key, look up the layer_data instance from given layer_data_map
 template <typename DATA_T>
 DATA_T *GetLayerDataPtr(void *data_key, std::unordered_map<void *, DATA_T *> &layer_data_map) {
@@ -52,4 +158,18 @@ void FreeLayerDataPtr(void *data_key, std::unordered_map<void *, DATA_T *> &laye
     layer_data_map.erase(got);
 }
 
+template <typename DATA_T>
+DATA_T *GetLayerDataPtr(void *data_key, LayerDataMap<DATA_T> &layer_data_map) {
+    DATA_T *data = layer_data_map.Find(data_key);
+    if (data) return data;
+    return layer_data_map.FindOrCreate(data_key);
+}
+
+template <typename DATA_T>
+void FreeLayerDataPtr(void *data_key, LayerDataMap<DATA_T> &layer_data_map) {
+    DATA_T *data = layer_data_map.Erase(data_key);
+    assert(data);
+    delete data;
+}
+
 #endif  // LAYER_DATA_H
@@ -0,0 +1,241 @@
+/* Copyright (c) 2015-2017 The Khronos Group Inc.
+ * Copyright (c) 2015-2017 Valve Corporation
+ * Copyright (c) 2015-2017 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: Tobin Ehlis <tobine@google.com>
+ */
+
+#ifndef VK_LAYER_FLAT_MAP_H
+#define VK_LAYER_FLAT_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// FlatHashMap is an open-addressing (linear probing) hash map for the handle-keyed state tables in the layers. Entries
+// live in one contiguous array, so a lookup is a hash plus a short scan instead of a bucket chain walk. It mirrors the
+// subset of the std::unordered_map interface that the layers use, with these differences:
+//  - Inserting may move entries, so references to values are only stable until the next insertion. Store pointers
+//    (unique_ptr, shared_ptr or raw) to state objects that must stay put.
+//  - Erasing leaves a tombstone rather than moving other entries, so iterators and references to other entries stay
+//    valid across erase, and erase-while-iterating works as with std::unordered_map.
+//  - T must be default-constructible; empty slots hold a default-constructed value.
+template <typename Key, typename T, typename Hash = std::hash<Key>>
+class FlatHashMap {
+   public:
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef std::pair<Key, T> value_type;
+    typedef size_t size_type;
+
+    template <typename Map, typename Value>
+    class iterator_base {
+       public:
+        iterator_base() : map_(nullptr), index_(0) {}
+        iterator_base(Map *map, size_t index) : map_(map), index_(index) { SkipEmpty(); }
+        // Allows iterator -> const_iterator
+        template <typename OtherMap, typename OtherValue>
+        iterator_base(const iterator_base<OtherMap, OtherValue> &other) : map_(other.map_), index_(other.index_) {}
+
+        Value &operator*() const { return map_->slots_[index_]; }
+        Value *operator->() const { return &map_->slots_[index_]; }
+        iterator_base &operator++() {
+            ++index_;
+            SkipEmpty();
+            return *this;
+        }
+        iterator_base operator++(int) {
+            iterator_base prev = *this;
+            ++*this;
+            return prev;
+        }
+        template <typename OtherMap, typename OtherValue>
+        bool operator==(const iterator_base<OtherMap, OtherValue> &other) const {
+            return index_ == other.index_;
+        }
+        template <typename OtherMap, typename OtherValue>
+        bool operator!=(const iterator_base<OtherMap, OtherValue> &other) const {
+            return index_ != other.index_;
+        }
+
+       private:
+        void SkipEmpty() {
+            if (!map_) return;
+            while (index_ < map_->ctrl_.size() && map_->ctrl_[index_] != kFull) ++index_;
+        }
+
+        Map *map_;
+        size_t index_;
+
+        friend class FlatHashMap;
+        template <typename, typename>
+        friend class iterator_base;
+    };
+    typedef iterator_base<FlatHashMap, value_type> iterator;
+    typedef iterator_base<const FlatHashMap, const value_type> const_iterator;
+
+    FlatHashMap() : size_(0), used_(0), shift_(64) {}
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, ctrl_.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, ctrl_.size()); }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    // Slots in the table, full or not
+    size_t capacity() const { return ctrl_.size(); }
+
+    iterator find(const Key &key) { return iterator(this, FindIndex(key)); }
+    const_iterator find(const Key &key) const { return const_iterator(this, FindIndex(key)); }
+    size_t count(const Key &key) const { return FindIndex(key) != ctrl_.size() ? 1 : 0; }
+
+    T &operator[](const Key &key) { return slots_[InsertKey(key).first].second; }
+
+    template <typename Pair>
+    std::pair<iterator, bool> insert(Pair &&value) {
+        auto result = InsertKey(value.first);
+        if (result.second) slots_[result.first].second = std::forward<Pair>(value).second;
+        return std::make_pair(iterator(this, result.first), result.second);
+    }
+
+    template <typename Value>
+    std::pair<iterator, bool> emplace(const Key &key, Value &&value) {
+        auto result = InsertKey(key);
+        if (result.second) slots_[result.first].second = std::forward<Value>(value);
+        return std::make_pair(iterator(this, result.first), result.second);
+    }
+
+    size_t erase(const Key &key) {
+        size_t index = FindIndex(key);
+        if (index == ctrl_.size()) return 0;
+        EraseIndex(index);
+        return 1;
+    }
+
+    template <typename Map, typename Value>
+    iterator erase(const iterator_base<Map, Value> &pos) {
+        EraseIndex(pos.index_);
+        return iterator(this, pos.index_ + 1);
+    }
+
+    void clear() {
+        std::vector<value_type>().swap(slots_);
+        std::vector<uint8_t>().swap(ctrl_);
+        size_ = 0;
+        used_ = 0;
+        shift_ = 64;
+    }
+
+    void reserve(size_t count) {
+        if (count * 4 > ctrl_.size() * 3) Rehash(count);
+    }
+
+   private:
+    enum : uint8_t { kEmpty = 0, kFull = 1, kDeleted = 2 };
+    static const size_t kMinCapacity = 16;
+
+    // Fibonacci hashing: the multiply spreads handle values whose low bits are all zero (aligned pointers) across the
+    // table, and the top bits select the slot.
+    size_t Slot(const Key &key) const {
+        return static_cast<size_t>((static_cast<uint64_t>(Hash()(key)) * 0x9E3779B97F4A7C15ull) >> shift_);
+    }
+
+    size_t FindIndex(const Key &key) const {
+        if (size_ == 0) return ctrl_.size();
+        const size_t mask = ctrl_.size() - 1;
+        for (size_t i = Slot(key);; i = (i + 1) & mask) {
+            if (ctrl_[i] == kEmpty) return ctrl_.size();
+            if (ctrl_[i] == kFull && slots_[i].first == key) return i;
+        }
+    }
+
+    // Returns the slot index for key and whether it was newly inserted
+    std::pair<size_t, bool> InsertKey(const Key &key) {
+        // Keep the load (including tombstones) at or below 3/4 so probe sequences stay short and always end. Grow once the
+        // live entries fill half the table; below that, tombstones take up at least a quarter of it and rebuilding at the
+        // same size drops them. Either way the next rehash is a quarter of the table's inserts away, so insert/erase churn
+        // at a steady size stays amortized O(1) instead of rebuilding every few operations.
+        if ((used_ + 1) * 4 > ctrl_.size() * 3) Rehash(size_ * 2 >= ctrl_.size() ? ctrl_.size() : ctrl_.size() * 3 / 4);
+        const size_t mask = ctrl_.size() - 1;
+        size_t tombstone = ctrl_.size();
+        for (size_t i = Slot(key);; i = (i + 1) & mask) {
+            if (ctrl_[i] == kFull) {
+                if (slots_[i].first == key) return std::make_pair(i, false);
+            } else if (ctrl_[i] == kDeleted) {
+                if (tombstone == ctrl_.size()) tombstone = i;
+            } else {
+                size_t target = i;
+                if (tombstone != ctrl_.size()) {
+                    target = tombstone;
+                } else {
+                    used_++;
+                }
+                ctrl_[target] = kFull;
+                slots_[target].first = key;
+                size_++;
+                return std::make_pair(target, true);
+            }
+        }
+    }
+
+    void EraseIndex(size_t index) {
+        slots_[index] = value_type();
+        size_--;
+        // A slot followed by an empty one ends every probe sequence through it, so it can become empty again
+        if (ctrl_[(index + 1) & (ctrl_.size() - 1)] == kEmpty) {
+            ctrl_[index] = kEmpty;
+            used_--;
+        } else {
+            ctrl_[index] = kDeleted;
+        }
+    }
+
+    // Rebuild the table with room for at least count entries, dropping tombstones
+    void Rehash(size_t count) {
+        size_t capacity = kMinCapacity;
+        unsigned bits = 4;
+        while (capacity * 3 < count * 4) {
+            capacity *= 2;
+            bits++;
+        }
+        std::vector<value_type> old_slots(capacity);
+        std::vector<uint8_t> old_ctrl(capacity, static_cast<uint8_t>(kEmpty));
+        // Swap in the new, empty table; old_slots/old_ctrl now hold the previous contents
+        old_slots.swap(slots_);
+        old_ctrl.swap(ctrl_);
+        shift_ = 64 - bits;
+        used_ = size_;
+
+        const size_t mask = capacity - 1;
+        for (size_t j = 0; j < old_ctrl.size(); ++j) {
+            if (old_ctrl[j] != kFull) continue;
+            size_t i = Slot(old_slots[j].first);
+            while (ctrl_[i] == kFull) i = (i + 1) & mask;
+            ctrl_[i] = kFull;
+            slots_[i] = std::move(old_slots[j]);
+        }
+    }
+
+    std::vector<value_type> slots_;
+    std::vector<uint8_t> ctrl_;
+    size_t size_;   // Full slots
+    size_t used_;   // Full and deleted slots
+    unsigned shift_;
+};
+
+#endif  // VK_LAYER_FLAT_MAP_H
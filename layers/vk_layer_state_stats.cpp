@@ -0,0 +1,111 @@
+/* Copyright (c) 2015-2017 The Khronos Group Inc.
+ * Copyright (c) 2015-2017 Valve Corporation
+ * Copyright (c) 2015-2017 LunarG, Inc.
+ * Copyright (C) 2015-2017 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include "vk_layer_config.h"
+#include "vk_layer_state_stats.h"
+
+void StateStats::Add(const char *category, uint64_t object_count, uint64_t byte_count) {
+    VkLayerStateStatLUNARG stat = {};
+    strncpy(stat.layerName, layer_name_, VK_MAX_EXTENSION_NAME_SIZE - 1);
+    strncpy(stat.category, category, VK_MAX_STATE_STATS_CATEGORY_SIZE - 1);
+    stat.objectCount = object_count;
+    stat.byteCount = byte_count;
+    stats_.push_back(stat);
+}
+
+VkResult StateStats::Report(VkDevice device, PFN_vkGetDeviceProcAddr next_get_device_proc_addr, uint32_t *pStatCount,
+                            VkLayerStateStatLUNARG *pStats) const {
+    auto next_get_stats = next_get_device_proc_addr
+                              ? reinterpret_cast<PFN_vkGetLayerStateStatsLUNARG>(
+                                    next_get_device_proc_addr(device, VK_LUNARG_STATE_STATS_FUNCTION_NAME))
+                              : nullptr;
+    uint32_t own_count = static_cast<uint32_t>(stats_.size());
+
+    if (!pStats) {
+        uint32_t next_count = 0;
+        if (next_get_stats) next_get_stats(device, &next_count, nullptr);
+        *pStatCount = own_count + next_count;
+        return VK_SUCCESS;
+    }
+
+    uint32_t written = std::min(*pStatCount, own_count);
+    std::copy(stats_.begin(), stats_.begin() + written, pStats);
+    VkResult result = written < own_count ? VK_INCOMPLETE : VK_SUCCESS;
+    if (next_get_stats) {
+        uint32_t next_count = *pStatCount - written;
+        if (next_count) {
+            result = next_get_stats(device, &next_count, pStats + written);
+            written += next_count;
+        } else if (result == VK_SUCCESS) {
+            // No room left, but the layers below may still have stats to add
+            next_get_stats(device, &next_count, nullptr);
+            if (next_count) result = VK_INCOMPLETE;
+        }
+    }
+    *pStatCount = written;
+    return result;
+}
+
+void StateStats::Log(const debug_report_data *report_data, VkDevice device) const {
+    uint64_t total_objects = 0;
+    uint64_t total_bytes = 0;
+    for (const auto &stat : stats_) {
+        log_msg(report_data, VK_DEBUG_REPORT_INFORMATION_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_DEVICE_EXT, HandleToUint64(device),
+                __LINE__, 0, layer_name_, "State stats: %s: %" PRIu64 " objects, %" PRIu64 " bytes.", stat.category,
+                stat.objectCount, stat.byteCount);
+        total_objects += stat.objectCount;
+        total_bytes += stat.byteCount;
+    }
+    log_msg(report_data, VK_DEBUG_REPORT_INFORMATION_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_DEVICE_EXT, HandleToUint64(device),
+            __LINE__, 0, layer_name_, "State stats: total: %" PRIu64 " objects, %" PRIu64 " bytes.", total_objects, total_bytes);
+}
+
+StateStatsSettings GetStateStatsSettings(const char *layer_identifier) {
+    StateStatsSettings settings = {};
+    std::string prefix(layer_identifier);
+    settings.log_on_destroy = !strcmp(getLayerOption((prefix + ".state_stats_on_destroy").c_str()), "true");
+    settings.log_interval = static_cast<uint32_t>(strtoul(getLayerOption((prefix + ".state_stats_interval").c_str()), nullptr, 10));
+    return settings;
+}
+
+PeriodicTask::PeriodicTask(uint32_t interval_seconds, std::function<void()> task)
+    : interval_(interval_seconds), task_(std::move(task)), stop_(false), thread_(&PeriodicTask::Run, this) {}
+
+PeriodicTask::~PeriodicTask() {
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        stop_ = true;
+    }
+    stop_cv_.notify_one();
+    thread_.join();
+}
+
+void PeriodicTask::Run() {
+    std::unique_lock<std::mutex> lock(lock_);
+    while (!stop_cv_.wait_for(lock, interval_, [this] { return stop_; })) {
+        lock.unlock();
+        task_();
+        lock.lock();
+    }
+}
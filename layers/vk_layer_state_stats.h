@@ -0,0 +1,129 @@
+/* Copyright (c) 2015-2017 The Khronos Group Inc.
+ * Copyright (c) 2015-2017 Valve Corporation
+ * Copyright (c) 2015-2017 LunarG, Inc.
+ * Copyright (C) 2015-2017 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LAYER_STATE_STATS_H
+#define LAYER_STATE_STATS_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "vulkan/vulkan.h"
+#include "vk_layer_flat_map.h"
+#include "vk_layer_logging.h"
+#include "vk_lunarg_state_stats_layer.h"
+
+// Approximate heap use of the standard containers. Node-based containers are counted as one allocation per element
+// holding the element and its links, plus the bucket array for the hashed ones. What the elements themselves point to
+// isn't included.
+template <typename T, typename A>
+size_t ContainerBytes(const std::vector<T, A> &v) {
+    return v.capacity() * sizeof(T);
+}
+template <typename A>
+size_t ContainerBytes(const std::vector<bool, A> &v) {
+    return v.capacity() / 8;
+}
+template <typename T, typename A>
+size_t ContainerBytes(const std::deque<T, A> &d) {
+    return d.size() * sizeof(T);
+}
+template <typename T, typename A>
+size_t ContainerBytes(const std::list<T, A> &l) {
+    return l.size() * (sizeof(T) + 2 * sizeof(void *));
+}
+template <typename K, typename C, typename A>
+size_t ContainerBytes(const std::set<K, C, A> &s) {
+    return s.size() * (sizeof(K) + 4 * sizeof(void *));
+}
+template <typename K, typename T, typename C, typename A>
+size_t ContainerBytes(const std::map<K, T, C, A> &m) {
+    return m.size() * (sizeof(typename std::map<K, T, C, A>::value_type) + 4 * sizeof(void *));
+}
+template <typename K, typename H, typename E, typename A>
+size_t ContainerBytes(const std::unordered_set<K, H, E, A> &s) {
+    return s.size() * (sizeof(K) + 2 * sizeof(void *)) + s.bucket_count() * sizeof(void *);
+}
+template <typename K, typename T, typename H, typename E, typename A>
+size_t ContainerBytes(const std::unordered_map<K, T, H, E, A> &m) {
+    return m.size() * (sizeof(typename std::unordered_map<K, T, H, E, A>::value_type) + 2 * sizeof(void *)) +
+           m.bucket_count() * sizeof(void *);
+}
+template <typename K, typename T, typename H>
+size_t ContainerBytes(const FlatHashMap<K, T, H> &m) {
+    return m.capacity() * (sizeof(typename FlatHashMap<K, T, H>::value_type) + sizeof(uint8_t));
+}
+
+// One layer's tracked state for a device, tallied by category when the stats are read
+class VK_LAYER_EXPORT StateStats {
+   public:
+    explicit StateStats(const char *layer_name) : layer_name_(layer_name) {}
+
+    // Every category is added on every read, even when empty, so that the count of entries doesn't change between calls
+    void Add(const char *category, uint64_t object_count, uint64_t byte_count);
+
+    // Implements vkGetLayerStateStatsLUNARG: these stats come first, then those of the layers below, found through
+    // next_get_device_proc_addr
+    VkResult Report(VkDevice device, PFN_vkGetDeviceProcAddr next_get_device_proc_addr, uint32_t *pStatCount,
+                    VkLayerStateStatLUNARG *pStats) const;
+
+    // Logs one information message per category, and one with the totals
+    void Log(const debug_report_data *report_data, VkDevice device) const;
+
+   private:
+    const char *layer_name_;
+    std::vector<VkLayerStateStatLUNARG> stats_;
+};
+
+// <layer_identifier>.state_stats_on_destroy and .state_stats_interval from vk_layer_settings.txt
+struct StateStatsSettings {
+    bool log_on_destroy;
+    uint32_t log_interval;  // In seconds; 0 to not log periodically
+};
+
+VK_LAYER_EXPORT StateStatsSettings GetStateStatsSettings(const char *layer_identifier);
+
+// Runs a task on a thread of its own every interval until destroyed. The destructor waits for a run in progress, so it
+// must not be called with a lock that the task takes. The layers' periodic state stats logs take global_lock and read the
+// device's state, so DestroyDevice destroys its task first, before taking global_lock or tearing any of that down.
+class VK_LAYER_EXPORT PeriodicTask {
+   public:
+    PeriodicTask(uint32_t interval_seconds, std::function<void()> task);
+    ~PeriodicTask();
+
+   private:
+    void Run();
+
+    std::chrono::seconds interval_;
+    std::function<void()> task_;
+    std::mutex lock_;
+    std::condition_variable stop_cv_;
+    bool stop_;
+    std::thread thread_;
+};
+
+#endif  // LAYER_STATE_STATS_H
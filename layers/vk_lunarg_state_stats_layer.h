@@ -0,0 +1,53 @@
+/* Copyright (c) 2015-2017 The Khronos Group Inc.
+ * Copyright (c) 2015-2017 Valve Corporation
+ * Copyright (c) 2015-2017 LunarG, Inc.
+ * Copyright (C) 2015-2017 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VK_LUNARG_STATE_STATS_LAYER_H_
+#define VK_LUNARG_STATE_STATS_LAYER_H_
+
+#include "vulkan/vulkan.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Layer state stats
+//
+// VK_LAYER_LUNARG_core_validation, VK_LAYER_LUNARG_object_tracker and VK_LAYER_GOOGLE_unique_objects return
+// vkGetLayerStateStatsLUNARG from vkGetDeviceProcAddr. It reports how much state each of them holds for a device: one
+// entry per layer and category of tracked state, with the number of objects in it and roughly how many bytes of host
+// memory they take up. Each layer fills in its own entries and passes the rest of the array down the chain, so a single
+// call covers every enabled layer that supports it. The usual two-call idiom applies; VK_INCOMPLETE is returned when
+// pStats is too small to hold every entry.
+
+#define VK_LUNARG_STATE_STATS_FUNCTION_NAME "vkGetLayerStateStatsLUNARG"
+#define VK_MAX_STATE_STATS_CATEGORY_SIZE 64
+
+typedef struct VkLayerStateStatLUNARG {
+    char layerName[VK_MAX_EXTENSION_NAME_SIZE];
+    char category[VK_MAX_STATE_STATS_CATEGORY_SIZE];
+    uint64_t objectCount;
+    uint64_t byteCount;  // approximate
+} VkLayerStateStatLUNARG;
+
+typedef VkResult(VKAPI_PTR *PFN_vkGetLayerStateStatsLUNARG)(VkDevice device, uint32_t *pStatCount, VkLayerStateStatLUNARG *pStats);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // VK_LUNARG_STATE_STATS_LAYER_H_
@@ -23,6 +23,9 @@
 #include <assert.h>
 #include <string.h>
 
+#include <bitset>
+#include <cfloat>
+#include <climits>
 #include <cmath>
 #include <cinttypes>
 #include <cstdio>
@@ -32,7 +35,6 @@
 #include <type_traits>
 #include <utility>
 
-#include <cJSON.h>
 #include <vulkan/vk_sdk_platform.h>
 
 namespace {
@@ -362,117 +364,440 @@ template <typename T>
 using EnableForEnum =
     typename std::enable_if<std::is_enum<T>::value, void>::type;
 
+template <typename Visitor, typename T>
+inline void VisitForWrite(Visitor* visitor, const T& t) {
+  Iterate(visitor, const_cast<T*>(&t));
+}
+
+template <typename Visitor, typename T>
+inline bool VisitForRead(Visitor* visitor, T* t) {
+  return Iterate(visitor, t);
+}
+
+// JSON writer. Output is appended straight to a string, in the same layout
+// cJSON_Print produced, so profiles written before and after compare equal.
+
+inline void AppendIndent(std::string* out, int depth) {
+  out->append(depth, '\t');
+}
+
+// Same formatting rules as cJSON's print_number.
+inline void WriteJsonNumber(std::string* out, double d) {
+  if (d == 0) {
+    out->push_back('0');
+    return;
+  }
+  if (d <= INT_MAX && d >= INT_MIN &&
+      std::fabs(static_cast<double>(static_cast<int>(d)) - d) <= DBL_EPSILON) {
+    // Most values are integers; format them without going through snprintf.
+    int value = static_cast<int>(d);
+    char digits[16];
+    char* end = digits + sizeof(digits);
+    char* begin = end;
+    uint32_t magnitude = value < 0 ? 0u - static_cast<uint32_t>(value)
+                                   : static_cast<uint32_t>(value);
+    do {
+      *--begin = static_cast<char>('0' + magnitude % 10);
+      magnitude /= 10;
+    } while (magnitude);
+    if (value < 0)
+      *--begin = '-';
+    out->append(begin, end);
+    return;
+  }
+  char string[64];
+  if (std::fabs(std::floor(d) - d) <= DBL_EPSILON &&
+           std::fabs(d) < 1.0e60)
+    snprintf(string, sizeof(string), "%.0f", d);
+  else if (std::fabs(d) < 1.0e-6 || std::fabs(d) > 1.0e9)
+    snprintf(string, sizeof(string), "%e", d);
+  else
+    snprintf(string, sizeof(string), "%f", d);
+  out->append(string);
+}
+
+inline void WriteJsonString(std::string* out, const char* value,
+                            size_t length) {
+  out->push_back('"');
+  for (size_t i = 0; i < length; ++i) {
+    unsigned char c = static_cast<unsigned char>(value[i]);
+    switch (c) {
+      case '"': out->append("\\\""); break;
+      case '\\': out->append("\\\\"); break;
+      case '\b': out->append("\\b"); break;
+      case '\f': out->append("\\f"); break;
+      case '\n': out->append("\\n"); break;
+      case '\r': out->append("\\r"); break;
+      case '\t': out->append("\\t"); break;
+      default:
+        if (c < 0x20) {
+          char escape[8];
+          snprintf(escape, sizeof(escape), "\\u%04x", c);
+          out->append(escape);
+        } else {
+          out->push_back(static_cast<char>(c));
+        }
+        break;
+    }
+  }
+  out->push_back('"');
+}
+
 template <typename T, typename = EnableForStruct<T>, typename = void>
-cJSON* ToJsonValue(const T& value);
+void WriteJsonValue(std::string* out, int depth, const T& value);
 
 template <typename T, typename = EnableForArithmetic<T>>
-inline cJSON* ToJsonValue(const T& value) {
-  return cJSON_CreateNumber(static_cast<double>(value));
+inline void WriteJsonValue(std::string* out, int depth, const T& value) {
+  WriteJsonNumber(out, static_cast<double>(value));
 }
 
-inline cJSON* ToJsonValue(const uint64_t& value) {
+inline void WriteJsonValue(std::string* out, int depth,
+                           const uint64_t& value) {
   char string[19] = {0};  // "0x" + 16 digits + terminal \0
   snprintf(string, sizeof(string), "0x%016" PRIx64, value);
-  return cJSON_CreateString(string);
+  out->push_back('"');
+  out->append(string);
+  out->push_back('"');
 }
 
 template <typename T, typename = EnableForEnum<T>, typename = void,
           typename = void>
-inline cJSON* ToJsonValue(const T& value) {
-  return cJSON_CreateNumber(static_cast<double>(value));
+inline void WriteJsonValue(std::string* out, int depth, const T& value) {
+  WriteJsonNumber(out, static_cast<double>(value));
 }
 
 template <typename T>
-inline cJSON* ArrayToJsonValue(uint32_t count, const T* values) {
-  cJSON* array = cJSON_CreateArray();
-  for (unsigned int i = 0; i < count; ++i)
-    cJSON_AddItemToArray(array, ToJsonValue(values[i]));
-  return array;
+inline void WriteJsonArray(std::string* out, int depth, uint32_t count,
+                           const T* values) {
+  out->push_back('[');
+  for (uint32_t i = 0; i < count; ++i) {
+    if (i)
+      out->append(", ");
+    WriteJsonValue(out, depth + 1, values[i]);
+  }
+  out->push_back(']');
 }
 
 template <typename T, unsigned int N>
-inline cJSON* ToJsonValue(const T (&value)[N]) {
-  return ArrayToJsonValue(N, value);
+inline void WriteJsonValue(std::string* out, int depth, const T (&value)[N]) {
+  WriteJsonArray(out, depth, N, value);
 }
 
 template <size_t N>
-inline cJSON* ToJsonValue(const char (&value)[N]) {
-  assert(strlen(value) < N);
-  return cJSON_CreateString(value);
+inline void WriteJsonValue(std::string* out, int depth,
+                           const char (&value)[N]) {
+  size_t length = 0;
+  while (length < N && value[length])
+    ++length;
+  assert(length < N);
+  WriteJsonString(out, value, length);
 }
 
 template <typename T>
-inline cJSON* ToJsonValue(const std::vector<T>& value) {
+inline void WriteJsonValue(std::string* out, int depth,
+                           const std::vector<T>& value) {
   assert(value.size() <= std::numeric_limits<uint32_t>::max());
-  return ArrayToJsonValue(static_cast<uint32_t>(value.size()), value.data());
+  WriteJsonArray(out, depth, static_cast<uint32_t>(value.size()),
+                 value.data());
 }
 
 template <typename F, typename S>
-inline cJSON* ToJsonValue(const std::pair<F, S>& value) {
-  cJSON* array = cJSON_CreateArray();
-  cJSON_AddItemToArray(array, ToJsonValue(value.first));
-  cJSON_AddItemToArray(array, ToJsonValue(value.second));
-  return array;
+inline void WriteJsonValue(std::string* out, int depth,
+                           const std::pair<F, S>& value) {
+  out->push_back('[');
+  WriteJsonValue(out, depth + 1, value.first);
+  out->append(", ");
+  WriteJsonValue(out, depth + 1, value.second);
+  out->push_back(']');
 }
 
 template <typename F, typename S>
-inline cJSON* ToJsonValue(const std::map<F, S>& value) {
-  cJSON* array = cJSON_CreateArray();
-  for (auto& kv : value)
-    cJSON_AddItemToArray(array, ToJsonValue(kv));
-  return array;
+inline void WriteJsonValue(std::string* out, int depth,
+                           const std::map<F, S>& value) {
+  out->push_back('[');
+  bool first = true;
+  for (auto& kv : value) {
+    if (!first)
+      out->append(", ");
+    first = false;
+    WriteJsonValue(out, depth + 1, kv);
+  }
+  out->push_back(']');
 }
 
 class JsonWriterVisitor {
  public:
-  JsonWriterVisitor() : object_(cJSON_CreateObject()) {}
-
-  ~JsonWriterVisitor() {
-    if (object_)
-      cJSON_Delete(object_);
-  }
+  JsonWriterVisitor(std::string* out, int depth)
+      : out_(out), depth_(depth), first_(true) {}
 
   template <typename T> bool Visit(const char* key, const T* value) {
-    cJSON_AddItemToObjectCS(object_, key, ToJsonValue(*value));
+    BeginMember(key);
+    WriteJsonValue(out_, depth_ + 1, *value);
     return true;
   }
 
   template <typename T, uint32_t N>
   bool VisitArray(const char* key, uint32_t count, const T (*value)[N]) {
     assert(count <= N);
-    cJSON_AddItemToObjectCS(object_, key, ArrayToJsonValue(count, *value));
+    BeginMember(key);
+    WriteJsonArray(out_, depth_ + 1, count, *value);
     return true;
   }
 
-  cJSON* get_object() const { return object_; }
-  cJSON* take_object() {
-    cJSON* object = object_;
-    object_ = nullptr;
-    return object;
+  void End() {
+    out_->push_back('\n');
+    AppendIndent(out_, depth_);
+    out_->push_back('}');
   }
 
  private:
-  cJSON* object_;
-};
+  void BeginMember(const char* key) {
+    out_->append(first_ ? "\n" : ",\n");
+    first_ = false;
+    AppendIndent(out_, depth_ + 1);
+    out_->push_back('"');
+    out_->append(key);
+    out_->append("\":\t");
+  }
 
-template <typename Visitor, typename T>
-inline void VisitForWrite(Visitor* visitor, const T& t) {
-  Iterate(visitor, const_cast<T*>(&t));
-}
+  std::string* out_;
+  int depth_;
+  bool first_;
+};
 
 template <typename T, typename /*= EnableForStruct<T>*/, typename /*= void*/>
-cJSON* ToJsonValue(const T& value) {
-  JsonWriterVisitor visitor;
+void WriteJsonValue(std::string* out, int depth, const T& value) {
+  out->push_back('{');
+  JsonWriterVisitor visitor(out, depth);
   VisitForWrite(&visitor, value);
-  return visitor.take_object();
+  visitor.End();
 }
 
+// JSON reader. Values are parsed from the text directly into the destination
+// structs, with Iterate supplying the member names, so no DOM is built.
+// Members may appear in any order and unknown members are skipped, as they
+// were when profiles were read through cJSON.
+class JsonReader {
+ public:
+  explicit JsonReader(const char* text) : pos_(text), syntax_error_(nullptr) {}
+
+  // Skips whitespace, then consumes |c| if it is the next character.
+  bool Consume(char c) {
+    SkipWhitespace();
+    if (*pos_ != c)
+      return false;
+    ++pos_;
+    return true;
+  }
+
+  bool Expect(char c) { return Consume(c) || SyntaxError(); }
+
+  // Reads an object member name and the ':' after it into key().
+  bool ReadKey() { return ReadString(&key_) && Expect(':'); }
+  const std::string& key() const { return key_; }
+
+  bool ReadString(std::string* value) {
+    if (!Expect('"'))
+      return false;
+    value->clear();
+    for (;;) {
+      const char* start = pos_;
+      while (*pos_ && *pos_ != '"' && *pos_ != '\\')
+        ++pos_;
+      value->append(start, pos_);
+      if (!*pos_)
+        return SyntaxError();
+      if (*pos_++ == '"')
+        return true;
+      char escape = *pos_++;
+      switch (escape) {
+        case 'b': value->push_back('\b'); break;
+        case 'f': value->push_back('\f'); break;
+        case 'n': value->push_back('\n'); break;
+        case 'r': value->push_back('\r'); break;
+        case 't': value->push_back('\t'); break;
+        case 'u':
+          if (!ReadEscapedCodePoint(value))
+            return SyntaxError();
+          break;
+        case '\0':
+          --pos_;
+          return SyntaxError();
+        default: value->push_back(escape); break;
+      }
+    }
+  }
+
+  // Reads a string into a scratch buffer that is reused between calls.
+  bool ReadString() { return ReadString(&string_); }
+  const std::string& string() const { return string_; }
+
+  // Same arithmetic as cJSON's parse_number, so values read back exactly as
+  // they did before.
+  bool ReadNumber(double* value) {
+    SkipWhitespace();
+    const char* num = pos_;
+    double n = 0, sign = 1, scale = 0;
+    int subscale = 0, signsubscale = 1;
+    if (*num == '-')
+      sign = -1, num++;
+    if (!IsDigit(*num))
+      return false;
+    if (*num == '0')
+      num++;
+    else
+      do
+        n = (n * 10.0) + (*num++ - '0');
+      while (IsDigit(*num));
+    if (*num == '.' && IsDigit(num[1])) {
+      num++;
+      do
+        n = (n * 10.0) + (*num++ - '0'), scale--;
+      while (IsDigit(*num));
+    }
+    if (*num == 'e' || *num == 'E') {
+      num++;
+      if (*num == '+')
+        num++;
+      else if (*num == '-')
+        signsubscale = -1, num++;
+      while (IsDigit(*num))
+        subscale = (subscale * 10) + (*num++ - '0');
+    }
+    int exponent = static_cast<int>(scale) + subscale * signsubscale;
+    *value = exponent ? sign * n * pow(10.0, exponent) : sign * n;
+    pos_ = num;
+    return true;
+  }
+
+  // Skips over a value of any type, for members no Iterate function names.
+  bool SkipValue() {
+    SkipWhitespace();
+    switch (*pos_) {
+      case '"':
+        return ReadString();
+      case '{':
+        ++pos_;
+        if (Consume('}'))
+          return true;
+        do {
+          if (!ReadKey() || !SkipValue())
+            return false;
+        } while (Consume(','));
+        return Expect('}');
+      case '[':
+        ++pos_;
+        if (Consume(']'))
+          return true;
+        do {
+          if (!SkipValue())
+            return false;
+        } while (Consume(','));
+        return Expect(']');
+      case 't':
+        return SkipLiteral("true");
+      case 'f':
+        return SkipLiteral("false");
+      case 'n':
+        return SkipLiteral("null");
+      default: {
+        double value;
+        return ReadNumber(&value) || SyntaxError();
+      }
+    }
+  }
+
+  // Where the text stopped being valid JSON, or null if it has not.
+  const char* syntax_error() const { return syntax_error_; }
+
+ private:
+  static bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+  void SkipWhitespace() {
+    while (*pos_ && static_cast<unsigned char>(*pos_) <= 32)
+      ++pos_;
+  }
+
+  bool SyntaxError() {
+    if (!syntax_error_)
+      syntax_error_ = pos_;
+    return false;
+  }
+
+  bool SkipLiteral(const char* literal) {
+    size_t length = strlen(literal);
+    if (strncmp(pos_, literal, length))
+      return SyntaxError();
+    pos_ += length;
+    return true;
+  }
+
+  bool ReadHex4(uint32_t* value) {
+    *value = 0;
+    for (int i = 0; i < 4; ++i, ++pos_) {
+      char c = *pos_;
+      *value <<= 4;
+      if (c >= '0' && c <= '9')
+        *value |= c - '0';
+      else if (c >= 'a' && c <= 'f')
+        *value |= c - 'a' + 10;
+      else if (c >= 'A' && c <= 'F')
+        *value |= c - 'A' + 10;
+      else
+        return false;
+    }
+    return true;
+  }
+
+  // Appends the UTF-8 encoding of a \uXXXX escape (or surrogate pair). Like
+  // cJSON, invalid code points and \u0000 are dropped.
+  bool ReadEscapedCodePoint(std::string* value) {
+    uint32_t code = 0;
+    if (!ReadHex4(&code))
+      return false;
+    if ((code >= 0xDC00 && code <= 0xDFFF) || code == 0)
+      return true;
+    if (code >= 0xD800 && code <= 0xDBFF) {
+      uint32_t low = 0;
+      if (pos_[0] != '\\' || pos_[1] != 'u')
+        return true;
+      pos_ += 2;
+      if (!ReadHex4(&low))
+        return false;
+      if (low < 0xDC00 || low > 0xDFFF)
+        return true;
+      code = 0x10000 + (((code & 0x3FF) << 10) | (low & 0x3FF));
+    }
+    if (code < 0x80) {
+      value->push_back(static_cast<char>(code));
+    } else if (code < 0x800) {
+      value->push_back(static_cast<char>(0xC0 | (code >> 6)));
+      value->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+      value->push_back(static_cast<char>(0xE0 | (code >> 12)));
+      value->push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+      value->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else {
+      value->push_back(static_cast<char>(0xF0 | (code >> 18)));
+      value->push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+      value->push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+      value->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+    return true;
+  }
+
+  const char* pos_;
+  const char* syntax_error_;
+  std::string key_;
+  std::string string_;
+};
+
 template <typename T, typename = EnableForStruct<T>>
-bool AsValue(cJSON* json_value, T* t);
+bool ReadJsonValue(JsonReader* reader, T* t);
 
-inline bool AsValue(cJSON* json_value, int32_t* value) {
-  double d = json_value->valuedouble;
-  if (json_value->type != cJSON_Number || !IsIntegral(d) ||
+inline bool ReadJsonValue(JsonReader* reader, int32_t* value) {
+  double d = 0;
+  if (!reader->ReadNumber(&d) || !IsIntegral(d) ||
       d < static_cast<double>(std::numeric_limits<int32_t>::min()) ||
       d > static_cast<double>(std::numeric_limits<int32_t>::max()))
     return false;
@@ -480,73 +805,83 @@ inline bool AsValue(cJSON* json_value, int32_t* value) {
   return true;
 }
 
-inline bool AsValue(cJSON* json_value, uint64_t* value) {
-  if (json_value->type != cJSON_String)
+inline bool ReadJsonValue(JsonReader* reader, uint64_t* value) {
+  if (!reader->ReadString())
     return false;
-  int result = std::sscanf(json_value->valuestring, "0x%016" PRIx64, value);
+  int result =
+      std::sscanf(reader->string().c_str(), "0x%016" PRIx64, value);
   return result == 1;
 }
 
-inline bool AsValue(cJSON* json_value, uint32_t* value) {
-  double d = json_value->valuedouble;
-  if (json_value->type != cJSON_Number || !IsIntegral(d) ||
-      d < 0.0 || d > static_cast<double>(std::numeric_limits<uint32_t>::max()))
+inline bool ReadJsonValue(JsonReader* reader, uint32_t* value) {
+  double d = 0;
+  if (!reader->ReadNumber(&d) || !IsIntegral(d) || d < 0.0 ||
+      d > static_cast<double>(std::numeric_limits<uint32_t>::max()))
     return false;
   *value = static_cast<uint32_t>(d);
   return true;
 }
 
-inline bool AsValue(cJSON* json_value, uint8_t* value) {
+inline bool ReadJsonValue(JsonReader* reader, uint8_t* value) {
   uint32_t value32 = 0;
-  AsValue(json_value, &value32);
-  if (value32 > std::numeric_limits<uint8_t>::max())
+  if (!ReadJsonValue(reader, &value32) ||
+      value32 > std::numeric_limits<uint8_t>::max())
     return false;
   *value = static_cast<uint8_t>(value32);
   return true;
 }
 
-inline bool AsValue(cJSON* json_value, float* value) {
-  if (json_value->type != cJSON_Number)
+inline bool ReadJsonValue(JsonReader* reader, float* value) {
+  double d = 0;
+  if (!reader->ReadNumber(&d))
     return false;
-  *value = static_cast<float>(json_value->valuedouble);
+  *value = static_cast<float>(d);
   return true;
 }
 
+// Reads up to |capacity| array elements and returns how many there were.
 template <typename T>
-inline bool AsArray(cJSON* json_value, uint32_t count, T* values) {
-  if (json_value->type != cJSON_Array ||
-      cJSON_GetArraySize(json_value) != count)
+inline bool ReadJsonArray(JsonReader* reader, uint32_t capacity, T* values,
+                          uint32_t* count) {
+  if (!reader->Consume('['))
     return false;
-  for (uint32_t i = 0; i < count; ++i) {
-    if (!AsValue(cJSON_GetArrayItem(json_value, i), values + i))
+  uint32_t n = 0;
+  if (!reader->Consume(']')) {
+    do {
+      if (n == capacity || !ReadJsonValue(reader, values + n))
+        return false;
+      ++n;
+    } while (reader->Consume(','));
+    if (!reader->Expect(']'))
       return false;
   }
+  *count = n;
   return true;
 }
 
 template <typename T, unsigned int N>
-inline bool AsValue(cJSON* json_value, T (*value)[N]) {
-  return AsArray(json_value, N, *value);
+inline bool ReadJsonValue(JsonReader* reader, T (*value)[N]) {
+  uint32_t count = 0;
+  return ReadJsonArray(reader, N, *value, &count) && count == N;
 }
 
 template <size_t N>
-inline bool AsValue(cJSON* json_value, char (*value)[N]) {
-  if (json_value->type != cJSON_String)
+inline bool ReadJsonValue(JsonReader* reader, char (*value)[N]) {
+  if (!reader->ReadString())
     return false;
-  size_t len = strlen(json_value->valuestring);
+  size_t len = strlen(reader->string().c_str());
   if (len >= N)
     return false;
-  memcpy(*value, json_value->valuestring, len);
-  memset(*value + len, 0, N-len);
+  memcpy(*value, reader->string().data(), len);
+  memset(*value + len, 0, N - len);
   return true;
 }
 
 template <typename T, typename = EnableForEnum<T>, typename = void>
-inline bool AsValue(cJSON* json_value, T* t) {
-  // TODO(piman): to/from strings instead?
+inline bool ReadJsonValue(JsonReader* reader, T* t) {
   uint32_t value = 0;
-  if (!AsValue(json_value, &value))
-      return false;
+  if (!ReadJsonValue(reader, &value))
+    return false;
   if (value < EnumTraits<T>::min() || value > EnumTraits<T>::max())
     return false;
   *t = static_cast<T>(value);
@@ -554,122 +889,689 @@ inline bool AsValue(cJSON* json_value, T* t) {
 }
 
 template <typename T>
-inline bool AsValue(cJSON* json_value, std::vector<T>* value) {
-  if (json_value->type != cJSON_Array)
+inline bool ReadJsonValue(JsonReader* reader, std::vector<T>* value) {
+  if (!reader->Consume('['))
     return false;
-  int size = cJSON_GetArraySize(json_value);
-  value->resize(size);
-  return AsArray(json_value, size, value->data());
+  value->clear();
+  if (!reader->Consume(']')) {
+    do {
+      value->emplace_back();
+      if (!ReadJsonValue(reader, &value->back()))
+        return false;
+    } while (reader->Consume(','));
+    if (!reader->Expect(']'))
+      return false;
+  }
+  return true;
 }
 
 template <typename F, typename S>
-inline bool AsValue(cJSON* json_value, std::pair<F, S>* value) {
-  if (json_value->type != cJSON_Array || cJSON_GetArraySize(json_value) != 2)
-    return false;
-  return AsValue(cJSON_GetArrayItem(json_value, 0), &value->first) &&
-         AsValue(cJSON_GetArrayItem(json_value, 1), &value->second);
+inline bool ReadJsonValue(JsonReader* reader, std::pair<F, S>* value) {
+  return reader->Consume('[') && ReadJsonValue(reader, &value->first) &&
+         reader->Consume(',') && ReadJsonValue(reader, &value->second) &&
+         reader->Expect(']');
 }
 
 template <typename F, typename S>
-inline bool AsValue(cJSON* json_value, std::map<F, S>* value) {
-  if (json_value->type != cJSON_Array)
+inline bool ReadJsonValue(JsonReader* reader, std::map<F, S>* value) {
+  if (!reader->Consume('['))
     return false;
-  int size = cJSON_GetArraySize(json_value);
-  for (int i = 0; i < size; ++i) {
-    std::pair<F, S> elem;
-    if (!AsValue(cJSON_GetArrayItem(json_value, i), &elem))
-      return false;
-    if (!value->insert(elem).second)
+  if (!reader->Consume(']')) {
+    do {
+      std::pair<F, S> elem;
+      if (!ReadJsonValue(reader, &elem))
+        return false;
+      // Written maps are sorted, so the end is almost always the right hint.
+      size_t size = value->size();
+      value->emplace_hint(value->end(), elem);
+      if (value->size() == size)
+        return false;
+    } while (reader->Consume(','));
+    if (!reader->Expect(']'))
       return false;
   }
   return true;
 }
 
+// Reads one object member into whichever field Iterate names it after. Visit
+// returns false once the member has been handled, which stops the walk over
+// the remaining fields. Input is usually in the order it was written in, so
+// the first walk only compares the name of the field after the last one
+// matched; Rescan falls back to comparing every name. After the closing
+// brace, Finish walks the fields again to check that none were missing.
+class JsonReaderVisitor {
+ public:
+  JsonReaderVisitor(JsonReader* reader, std::string* errors)
+      : reader_(reader),
+        errors_(errors),
+        key_(nullptr),
+        index_(0),
+        expected_(0),
+        probing_(false),
+        matched_(false),
+        finishing_(false),
+        ok_(true),
+        array_count_(0) {}
+
+  void BeginMember(const char* key) {
+    key_ = key;
+    index_ = 0;
+    matched_ = false;
+    probing_ = true;
+  }
+
+  void Rescan() {
+    index_ = 0;
+    probing_ = false;
+  }
+
+  template <typename T>
+  bool Finish(T* t) {
+    finishing_ = true;
+    index_ = 0;
+    VisitForRead(this, t);
+    return ok_;
+  }
+
+  template <typename T> bool Visit(const char* key, T* value) {
+    if (finishing_)
+      return CheckPresent(key);
+    if (!Match(key))
+      return true;
+    if (!ReadJsonValue(reader_, value))
+      Fail("Wrong type for ", key, ".");
+    return false;
+  }
+
+  template <typename T, uint32_t N>
+  bool VisitArray(const char* key, uint32_t count, T (*value)[N]) {
+    if (finishing_) {
+      if (!CheckPresent(key))
+        return false;
+      // The count may only have been read after the array itself.
+      for (uint32_t i = 0; i < array_count_; ++i) {
+        if (arrays_[i].index == index_ - 1 && arrays_[i].length != count)
+          return Fail("Wrong type for ", key, ".");
+      }
+      return true;
+    }
+    if (!Match(key))
+      return true;
+    uint32_t length = 0;
+    if (count > N || array_count_ == kMaxArrays ||
+        !ReadJsonArray(reader_, N, *value, &length))
+      return Fail("Wrong type for ", key, ".");
+    arrays_[array_count_].index = index_ - 1;
+    arrays_[array_count_].length = length;
+    ++array_count_;
+    return false;
+  }
+
+  bool matched() const { return matched_; }
+  bool ok() const { return ok_; }
+
+ private:
+  static const uint32_t kMaxFields = 128;
+  static const uint32_t kMaxArrays = 4;
+
+  bool Match(const char* key) {
+    uint32_t index = index_++;
+    assert(index < kMaxFields);
+    if ((probing_ && index != expected_) || strcmp(key, key_))
+      return false;
+    matched_ = true;
+    expected_ = index + 1;
+    seen_.set(index);
+    return true;
+  }
+
+  bool CheckPresent(const char* key) {
+    if (seen_.test(index_++))
+      return true;
+    return Fail("", key, " missing.");
+  }
+
+  bool Fail(const char* prefix, const char* key, const char* suffix) {
+    ok_ = false;
+    if (errors_)
+      *errors_ = std::string(prefix) + key + suffix;
+    return false;
+  }
+
+  JsonReader* reader_;
+  std::string* errors_;
+  const char* key_;
+  uint32_t index_;
+  uint32_t expected_;
+  bool probing_;
+  bool matched_;
+  bool finishing_;
+  bool ok_;
+  std::bitset<kMaxFields> seen_;
+  struct {
+    uint32_t index;
+    uint32_t length;
+  } arrays_[kMaxArrays];
+  uint32_t array_count_;
+};
+
+// |errors| only receives messages about the object's own members, matching
+// what the cJSON reader reported.
 template <typename T>
-bool ReadValue(cJSON* object, const char* key, T* value,
-               std::string* errors) {
-  cJSON* json_value = cJSON_GetObjectItem(object, key);
-  if (!json_value) {
-    if (errors)
-      *errors = std::string(key) + " missing.";
+bool ReadJsonObject(JsonReader* reader, T* t, std::string* errors) {
+  if (!reader->Consume('{'))
     return false;
+  JsonReaderVisitor visitor(reader, errors);
+  if (!reader->Consume('}')) {
+    do {
+      if (!reader->ReadKey())
+        return false;
+      visitor.BeginMember(reader->key().c_str());
+      VisitForRead(&visitor, t);
+      if (!visitor.matched() && visitor.ok()) {
+        visitor.Rescan();
+        VisitForRead(&visitor, t);
+      }
+      if (!visitor.ok())
+        return false;
+      if (!visitor.matched() && !reader->SkipValue())
+        return false;
+    } while (reader->Consume(','));
+    if (!reader->Expect('}'))
+      return false;
   }
-  if (AsValue(json_value, value))
+  return visitor.Finish(t);
+}
+
+template <typename T, typename /*= EnableForStruct<T>*/>
+bool ReadJsonValue(JsonReader* reader, T* t) {
+  return ReadJsonObject(reader, t, nullptr);
+}
+
+template <typename T> std::string VkTypeToJson(const T& t) {
+  std::string result;
+  WriteJsonValue(&result, 0, t);
+  return result;
+}
+
+template <typename T> bool VkTypeFromJson(const std::string& json,
+                                          T* t,
+                                          std::string* errors) {
+  *t = T();
+  JsonReader reader(json.c_str());
+  if (ReadJsonObject(&reader, t, errors))
     return true;
-  if (errors)
-    *errors = std::string("Wrong type for ") + std::string(key) + ".";
+  if (errors && reader.syntax_error())
+    errors->assign(reader.syntax_error());
   return false;
 }
 
-template <typename Visitor, typename T>
-inline bool VisitForRead(Visitor* visitor, T* t) {
-  return Iterate(visitor, t);
+// Binary encoding. Fields are written in Iterate order without their names:
+// integers as LEB128 varints (zigzag for signed), floats as their 4 byte
+// little-endian bit pattern, strings and arrays with a length prefix. A blob
+// starts with a magic number and a hash of the schema (every field name and
+// type), so one written by a build with a different set of fields is rejected
+// rather than misread.
+
+const uint8_t kBinaryMagic[4] = {'V', 'K', 'J', 'B'};
+const uint32_t kBinaryFormatVersion = 1;
+
+inline void WriteBinaryVarint(std::vector<uint8_t>* out, uint64_t value) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<uint8_t>(value));
 }
 
-class JsonReaderVisitor {
+inline void WriteBinaryFixed32(std::vector<uint8_t>* out, uint32_t value) {
+  for (int i = 0; i < 4; ++i)
+    out->push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+template <typename T, typename = EnableForStruct<T>>
+void WriteBinaryValue(std::vector<uint8_t>* out, const T& value);
+
+inline void WriteBinaryValue(std::vector<uint8_t>* out,
+                             const uint8_t& value) {
+  out->push_back(value);
+}
+
+inline void WriteBinaryValue(std::vector<uint8_t>* out,
+                             const uint32_t& value) {
+  WriteBinaryVarint(out, value);
+}
+
+inline void WriteBinaryValue(std::vector<uint8_t>* out,
+                             const int32_t& value) {
+  uint32_t zigzag = (static_cast<uint32_t>(value) << 1) ^
+                    static_cast<uint32_t>(value >> 31);
+  WriteBinaryVarint(out, zigzag);
+}
+
+inline void WriteBinaryValue(std::vector<uint8_t>* out,
+                             const uint64_t& value) {
+  WriteBinaryVarint(out, value);
+}
+
+inline void WriteBinaryValue(std::vector<uint8_t>* out, const float& value) {
+  uint32_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+  WriteBinaryFixed32(out, bits);
+}
+
+template <typename T, typename = EnableForEnum<T>, typename = void>
+inline void WriteBinaryValue(std::vector<uint8_t>* out, const T& value) {
+  WriteBinaryVarint(out, static_cast<uint32_t>(value));
+}
+
+template <typename T>
+inline void WriteBinaryArray(std::vector<uint8_t>* out, uint32_t count,
+                             const T* values) {
+  for (uint32_t i = 0; i < count; ++i)
+    WriteBinaryValue(out, values[i]);
+}
+
+template <typename T, unsigned int N>
+inline void WriteBinaryValue(std::vector<uint8_t>* out, const T (&value)[N]) {
+  WriteBinaryArray(out, N, value);
+}
+
+template <size_t N>
+inline void WriteBinaryValue(std::vector<uint8_t>* out,
+                             const char (&value)[N]) {
+  size_t length = 0;
+  while (length < N && value[length])
+    ++length;
+  assert(length < N);
+  WriteBinaryVarint(out, length);
+  out->insert(out->end(), value, value + length);
+}
+
+template <typename T>
+inline void WriteBinaryValue(std::vector<uint8_t>* out,
+                             const std::vector<T>& value) {
+  WriteBinaryVarint(out, value.size());
+  WriteBinaryArray(out, static_cast<uint32_t>(value.size()), value.data());
+}
+
+template <typename F, typename S>
+inline void WriteBinaryValue(std::vector<uint8_t>* out,
+                             const std::pair<F, S>& value) {
+  WriteBinaryValue(out, value.first);
+  WriteBinaryValue(out, value.second);
+}
+
+template <typename F, typename S>
+inline void WriteBinaryValue(std::vector<uint8_t>* out,
+                             const std::map<F, S>& value) {
+  WriteBinaryVarint(out, value.size());
+  for (auto& kv : value)
+    WriteBinaryValue(out, kv);
+}
+
+class BinaryWriterVisitor {
  public:
-  JsonReaderVisitor(cJSON* object, std::string* errors)
-      : object_(object), errors_(errors) {}
+  explicit BinaryWriterVisitor(std::vector<uint8_t>* out) : out_(out) {}
 
-  template <typename T> bool Visit(const char* key, T* value) const {
-    return ReadValue(object_, key, value, errors_);
+  template <typename T> bool Visit(const char* key, const T* value) {
+    WriteBinaryValue(out_, *value);
+    return true;
   }
 
   template <typename T, uint32_t N>
-  bool VisitArray(const char* key, uint32_t count, T (*value)[N]) {
-    if (count > N)
+  bool VisitArray(const char* key, uint32_t count, const T (*value)[N]) {
+    assert(count <= N);
+    WriteBinaryVarint(out_, count);
+    WriteBinaryArray(out_, count, *value);
+    return true;
+  }
+
+ private:
+  std::vector<uint8_t>* out_;
+};
+
+template <typename T, typename /*= EnableForStruct<T>*/>
+void WriteBinaryValue(std::vector<uint8_t>* out, const T& value) {
+  BinaryWriterVisitor visitor(out);
+  VisitForWrite(&visitor, value);
+}
+
+class BinaryReader {
+ public:
+  BinaryReader(const uint8_t* begin, const uint8_t* end)
+      : pos_(begin), end_(end) {}
+
+  bool ReadByte(uint8_t* value) {
+    if (pos_ == end_)
       return false;
-    cJSON* json_value = cJSON_GetObjectItem(object_, key);
-    if (!json_value) {
-      if (errors_)
-        *errors_ = std::string(key) + " missing.";
+    *value = *pos_++;
+    return true;
+  }
+
+  bool ReadBytes(size_t count, const uint8_t** bytes) {
+    if (count > remaining())
       return false;
+    *bytes = pos_;
+    pos_ += count;
+    return true;
+  }
+
+  bool ReadVarint(uint64_t* value) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t byte = 0;
+      if (!ReadByte(&byte))
+        return false;
+      *value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+        return true;
     }
-    if (AsArray(json_value, count, *value))
-      return true;
-    if (errors_)
-      *errors_ = std::string("Wrong type for ") + std::string(key) + ".";
     return false;
   }
 
+  bool ReadVarint32(uint32_t* value) {
+    uint64_t value64 = 0;
+    if (!ReadVarint(&value64) ||
+        value64 > std::numeric_limits<uint32_t>::max())
+      return false;
+    *value = static_cast<uint32_t>(value64);
+    return true;
+  }
+
+  bool ReadFixed32(uint32_t* value) {
+    const uint8_t* bytes = nullptr;
+    if (!ReadBytes(4, &bytes))
+      return false;
+    *value = static_cast<uint32_t>(bytes[0]) |
+             static_cast<uint32_t>(bytes[1]) << 8 |
+             static_cast<uint32_t>(bytes[2]) << 16 |
+             static_cast<uint32_t>(bytes[3]) << 24;
+    return true;
+  }
+
+  // Every encoded element takes at least one byte, so a count larger than
+  // this is corrupt and must not be used to size an allocation.
+  size_t remaining() const { return static_cast<size_t>(end_ - pos_); }
 
  private:
-  cJSON* object_;
-  std::string* errors_;
+  const uint8_t* pos_;
+  const uint8_t* end_;
 };
 
-template <typename T, typename /*= EnableForStruct<T>*/>
-bool AsValue(cJSON* json_value, T* t) {
-  if (json_value->type != cJSON_Object)
+template <typename T, typename = EnableForStruct<T>>
+bool ReadBinaryValue(BinaryReader* reader, T* t);
+
+inline bool ReadBinaryValue(BinaryReader* reader, uint8_t* value) {
+  return reader->ReadByte(value);
+}
+
+inline bool ReadBinaryValue(BinaryReader* reader, uint32_t* value) {
+  return reader->ReadVarint32(value);
+}
+
+inline bool ReadBinaryValue(BinaryReader* reader, int32_t* value) {
+  uint32_t zigzag = 0;
+  if (!reader->ReadVarint32(&zigzag))
     return false;
-  JsonReaderVisitor visitor(json_value, nullptr);
+  *value = static_cast<int32_t>((zigzag >> 1) ^ (0u - (zigzag & 1)));
+  return true;
+}
+
+inline bool ReadBinaryValue(BinaryReader* reader, uint64_t* value) {
+  return reader->ReadVarint(value);
+}
+
+inline bool ReadBinaryValue(BinaryReader* reader, float* value) {
+  uint32_t bits = 0;
+  if (!reader->ReadFixed32(&bits))
+    return false;
+  memcpy(value, &bits, sizeof(bits));
+  return true;
+}
+
+template <typename T, typename = EnableForEnum<T>, typename = void>
+inline bool ReadBinaryValue(BinaryReader* reader, T* t) {
+  uint32_t value = 0;
+  if (!reader->ReadVarint32(&value) || value < EnumTraits<T>::min() ||
+      value > EnumTraits<T>::max())
+    return false;
+  *t = static_cast<T>(value);
+  return true;
+}
+
+template <typename T>
+inline bool ReadBinaryArray(BinaryReader* reader, uint32_t count, T* values) {
+  for (uint32_t i = 0; i < count; ++i) {
+    if (!ReadBinaryValue(reader, values + i))
+      return false;
+  }
+  return true;
+}
+
+template <typename T, unsigned int N>
+inline bool ReadBinaryValue(BinaryReader* reader, T (*value)[N]) {
+  return ReadBinaryArray(reader, N, *value);
+}
+
+template <size_t N>
+inline bool ReadBinaryValue(BinaryReader* reader, char (*value)[N]) {
+  uint32_t length = 0;
+  const uint8_t* bytes = nullptr;
+  if (!reader->ReadVarint32(&length) || length >= N ||
+      !reader->ReadBytes(length, &bytes))
+    return false;
+  memcpy(*value, bytes, length);
+  memset(*value + length, 0, N - length);
+  return true;
+}
+
+template <typename T>
+inline bool ReadBinaryValue(BinaryReader* reader, std::vector<T>* value) {
+  uint32_t count = 0;
+  if (!reader->ReadVarint32(&count) || count > reader->remaining())
+    return false;
+  value->resize(count);
+  return ReadBinaryArray(reader, count, value->data());
+}
+
+template <typename F, typename S>
+inline bool ReadBinaryValue(BinaryReader* reader, std::pair<F, S>* value) {
+  return ReadBinaryValue(reader, &value->first) &&
+         ReadBinaryValue(reader, &value->second);
+}
+
+template <typename F, typename S>
+inline bool ReadBinaryValue(BinaryReader* reader, std::map<F, S>* value) {
+  uint32_t count = 0;
+  if (!reader->ReadVarint32(&count) || count > reader->remaining())
+    return false;
+  for (uint32_t i = 0; i < count; ++i) {
+    std::pair<F, S> elem;
+    if (!ReadBinaryValue(reader, &elem))
+      return false;
+    // Maps are written in key order, so anything else is corrupt.
+    if (!value->empty() && !(value->rbegin()->first < elem.first))
+      return false;
+    value->emplace_hint(value->end(), elem);
+  }
+  return true;
+}
+
+class BinaryReaderVisitor {
+ public:
+  explicit BinaryReaderVisitor(BinaryReader* reader) : reader_(reader) {}
+
+  template <typename T> bool Visit(const char* key, T* value) {
+    return ReadBinaryValue(reader_, value);
+  }
+
+  template <typename T, uint32_t N>
+  bool VisitArray(const char* key, uint32_t count, T (*value)[N]) {
+    uint32_t length = 0;
+    return reader_->ReadVarint32(&length) && length == count && count <= N &&
+           ReadBinaryArray(reader_, count, *value);
+  }
+
+ private:
+  BinaryReader* reader_;
+};
+
+template <typename T, typename /*= EnableForStruct<T>*/>
+bool ReadBinaryValue(BinaryReader* reader, T* t) {
+  BinaryReaderVisitor visitor(reader);
   return VisitForRead(&visitor, t);
 }
 
+// FNV-1a over the field names and type tags of T, in Iterate order.
+inline void HashSchema(uint32_t* hash, const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    *hash ^= bytes[i];
+    *hash *= 16777619u;
+  }
+}
 
-template <typename T> std::string VkTypeToJson(const T& t) {
-  JsonWriterVisitor visitor;
-  VisitForWrite(&visitor, t);
+inline void HashSchema(uint32_t* hash, const char* text) {
+  HashSchema(hash, text, strlen(text) + 1);
+}
 
-  char* output = cJSON_Print(visitor.get_object());
-  std::string result(output);
-  free(output);
-  return result;
+template <typename T, typename = EnableForStruct<T>>
+void HashSchemaType(uint32_t* hash, T* t);
+
+inline void HashSchemaType(uint32_t* hash, uint8_t*) {
+  HashSchema(hash, "u8");
 }
 
-template <typename T> bool VkTypeFromJson(const std::string& json,
-                                          T* t,
-                                          std::string* errors) {
+inline void HashSchemaType(uint32_t* hash, uint32_t*) {
+  HashSchema(hash, "u32");
+}
+
+inline void HashSchemaType(uint32_t* hash, int32_t*) {
+  HashSchema(hash, "i32");
+}
+
+inline void HashSchemaType(uint32_t* hash, uint64_t*) {
+  HashSchema(hash, "u64");
+}
+
+inline void HashSchemaType(uint32_t* hash, float*) {
+  HashSchema(hash, "f32");
+}
+
+template <typename T, typename = EnableForEnum<T>, typename = void>
+inline void HashSchemaType(uint32_t* hash, T*) {
+  HashSchema(hash, "enum");
+}
+
+template <typename T, unsigned int N>
+inline void HashSchemaType(uint32_t* hash, T (*value)[N]) {
+  uint32_t count = N;
+  HashSchema(hash, "array");
+  HashSchema(hash, &count, sizeof(count));
+  HashSchemaType(hash, &(*value)[0]);
+}
+
+template <size_t N>
+inline void HashSchemaType(uint32_t* hash, char (*)[N]) {
+  uint32_t size = N;
+  HashSchema(hash, "string");
+  HashSchema(hash, &size, sizeof(size));
+}
+
+template <typename T>
+inline void HashSchemaType(uint32_t* hash, std::vector<T>*) {
+  T elem = T();
+  HashSchema(hash, "vector");
+  HashSchemaType(hash, &elem);
+}
+
+template <typename F, typename S>
+inline void HashSchemaType(uint32_t* hash, std::pair<F, S>* value) {
+  HashSchema(hash, "pair");
+  HashSchemaType(hash, &value->first);
+  HashSchemaType(hash, &value->second);
+}
+
+template <typename F, typename S>
+inline void HashSchemaType(uint32_t* hash, std::map<F, S>*) {
+  std::pair<F, S> elem;
+  HashSchema(hash, "map");
+  HashSchemaType(hash, &elem);
+}
+
+class BinarySchemaVisitor {
+ public:
+  explicit BinarySchemaVisitor(uint32_t* hash) : hash_(hash) {}
+
+  template <typename T> bool Visit(const char* key, T* value) {
+    HashSchema(hash_, key);
+    HashSchemaType(hash_, value);
+    return true;
+  }
+
+  template <typename T, uint32_t N>
+  bool VisitArray(const char* key, uint32_t count, T (*value)[N]) {
+    HashSchema(hash_, key);
+    HashSchema(hash_, "counted");
+    HashSchemaType(hash_, value);
+    return true;
+  }
+
+ private:
+  uint32_t* hash_;
+};
+
+template <typename T, typename /*= EnableForStruct<T>*/>
+void HashSchemaType(uint32_t* hash, T* t) {
+  BinarySchemaVisitor visitor(hash);
+  HashSchema(hash, "{");
+  Iterate(&visitor, t);
+  HashSchema(hash, "}");
+}
+
+template <typename T> uint32_t BinarySchemaHash() {
+  uint32_t hash = 2166136261u;
+  HashSchema(&hash, &kBinaryFormatVersion, sizeof(kBinaryFormatVersion));
+  T t;
+  HashSchemaType(&hash, &t);
+  return hash;
+}
+
+template <typename T> std::vector<uint8_t> VkTypeToBinary(const T& t) {
+  static const uint32_t schema_hash = BinarySchemaHash<T>();
+  std::vector<uint8_t> out(kBinaryMagic, kBinaryMagic + sizeof(kBinaryMagic));
+  WriteBinaryFixed32(&out, schema_hash);
+  WriteBinaryValue(&out, t);
+  return out;
+}
+
+template <typename T> bool VkTypeFromBinary(const std::vector<uint8_t>& binary,
+                                            T* t,
+                                            std::string* errors) {
+  static const uint32_t schema_hash = BinarySchemaHash<T>();
   *t = T();
-  cJSON* object = cJSON_Parse(json.c_str());
-  if (!object) {
+  BinaryReader reader(binary.data(), binary.data() + binary.size());
+  const uint8_t* magic = nullptr;
+  uint32_t hash = 0;
+  if (!reader.ReadBytes(sizeof(kBinaryMagic), &magic) ||
+      memcmp(magic, kBinaryMagic, sizeof(kBinaryMagic)) ||
+      !reader.ReadFixed32(&hash)) {
     if (errors)
-      errors->assign(cJSON_GetErrorPtr());
+      *errors = "Not a vkjson binary profile.";
     return false;
   }
-  bool result = AsValue(object, t);
-  cJSON_Delete(object);
-  return result;
+  if (hash != schema_hash) {
+    if (errors)
+      *errors = "Binary profile was written with a different schema.";
+    return false;
+  }
+  if (!ReadBinaryValue(&reader, t) || reader.remaining()) {
+    if (errors)
+      *errors = "Binary profile is truncated or corrupt.";
+    return false;
+  }
+  return true;
 }
 
 }  // anonymous namespace
@@ -684,6 +1586,16 @@ bool VkJsonInstanceFromJson(const std::string& json,
   return VkTypeFromJson(json, instance, errors);
 }
 
+std::vector<uint8_t> VkJsonInstanceToBinary(const VkJsonInstance& instance) {
+  return VkTypeToBinary(instance);
+}
+
+bool VkJsonInstanceFromBinary(const std::vector<uint8_t>& binary,
+                              VkJsonInstance* instance,
+                              std::string* errors) {
+  return VkTypeFromBinary(binary, instance, errors);
+}
+
 std::string VkJsonDeviceToJson(const VkJsonDevice& device) {
   return VkTypeToJson(device);
 }
@@ -694,6 +1606,16 @@ bool VkJsonDeviceFromJson(const std::string& json,
   return VkTypeFromJson(json, device, errors);
 };
 
+std::vector<uint8_t> VkJsonDeviceToBinary(const VkJsonDevice& device) {
+  return VkTypeToBinary(device);
+}
+
+bool VkJsonDeviceFromBinary(const std::vector<uint8_t>& binary,
+                            VkJsonDevice* device,
+                            std::string* errors) {
+  return VkTypeFromBinary(binary, device, errors);
+}
+
 std::string VkJsonImageFormatPropertiesToJson(
     const VkImageFormatProperties& properties) {
   return VkTypeToJson(properties);
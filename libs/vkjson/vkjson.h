@@ -22,6 +22,7 @@
 #define VKJSON_H_
 
 #include <vulkan/vulkan.h>
+#include <stdint.h>
 #include <string.h>
 
 #include <map>
@@ -59,17 +60,58 @@ struct VkJsonInstance {
   std::vector<VkJsonDevice> devices;
 };
 
+struct VkJsonDeviceTiming {
+  double milliseconds;
+  // True if features and formats were copied from the previous profile.
+  bool reused;
+};
+
+struct VkJsonTiming {
+  VkJsonTiming() : instance_milliseconds(0), total_milliseconds(0) {}
+  // Layer and extension enumeration and instance creation
+  double instance_milliseconds;
+  double total_milliseconds;
+  std::vector<VkJsonDeviceTiming> devices;
+};
+
 VkJsonInstance VkJsonGetInstance();
+// Captures each physical device on its own thread. Features and formats only
+// change with the device and driver, so for a device that matches one in
+// |previous| (same IDs, driver version, API version and pipeline cache UUID)
+// they are copied instead of queried again. |previous| and |timing| may be
+// null.
+VkJsonInstance VkJsonGetInstance(const VkJsonInstance* previous,
+                                 VkJsonTiming* timing);
+// As above, on at most |thread_count| threads including the calling one. 1
+// captures the devices one after another on the calling thread, and 0 uses a
+// thread per device.
+VkJsonInstance VkJsonGetInstance(const VkJsonInstance* previous,
+                                 VkJsonTiming* timing,
+                                 uint32_t thread_count);
 std::string VkJsonInstanceToJson(const VkJsonInstance& instance);
 bool VkJsonInstanceFromJson(const std::string& json,
                             VkJsonInstance* instance,
                             std::string* errors);
 
+// Compact binary form of the same data, for storing and comparing large
+// numbers of profiles. It is only readable by builds with the same set of
+// fields; anything else is rejected with an error.
+std::vector<uint8_t> VkJsonInstanceToBinary(const VkJsonInstance& instance);
+bool VkJsonInstanceFromBinary(const std::vector<uint8_t>& binary,
+                              VkJsonInstance* instance,
+                              std::string* errors);
+
 VkJsonDevice VkJsonGetDevice(VkPhysicalDevice device);
+VkJsonDevice VkJsonGetDevice(VkPhysicalDevice device,
+                             const VkJsonDevice* previous);
 std::string VkJsonDeviceToJson(const VkJsonDevice& device);
 bool VkJsonDeviceFromJson(const std::string& json,
                           VkJsonDevice* device,
                           std::string* errors);
+std::vector<uint8_t> VkJsonDeviceToBinary(const VkJsonDevice& device);
+bool VkJsonDeviceFromBinary(const std::vector<uint8_t>& binary,
+                            VkJsonDevice* device,
+                            std::string* errors);
 
 std::string VkJsonImageFormatPropertiesToJson(
     const VkImageFormatProperties& properties);
@@ -0,0 +1,211 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2016 The Khronos Group Inc.
+// Copyright (c) 2015-2016 Valve Corporation
+// Copyright (c) 2015-2016 LunarG, Inc.
+// Copyright (c) 2015-2016 Google, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+// Measures how fast profiles are written and read back, as JSON and in the
+// binary encoding.
+//
+//   vkjson_benchmark [--iterations N] [profile.json]
+//
+// Without a profile a synthetic instance is used: two devices, every core
+// format populated, and a few dozen extensions, which is about the size of a
+// profile captured from a desktop driver. A profile written by vkjson_info
+// --instance can be given instead.
+
+#include "vkjson.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+VkJsonDevice SyntheticDevice(uint32_t index) {
+  VkJsonDevice device;
+  snprintf(device.properties.deviceName, sizeof(device.properties.deviceName),
+           "Synthetic device %u", index);
+  device.properties.apiVersion = VK_MAKE_VERSION(1, 0, 61);
+  device.properties.driverVersion = 0x12345678 + index;
+  device.properties.vendorID = 0x1234;
+  device.properties.deviceID = 0x100 + index;
+  device.properties.deviceType = VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU;
+  device.properties.limits.maxImageDimension2D = 16384;
+  device.properties.limits.maxSamplerLodBias = 15.5f;
+  device.properties.limits.bufferImageGranularity = 0x400;
+  device.properties.limits.maxViewportDimensions[0] = 16384;
+  device.properties.limits.maxViewportDimensions[1] = 16384;
+  device.properties.limits.pointSizeRange[1] = 2047.9375f;
+  device.properties.limits.minMemoryMapAlignment = 64;
+  for (VkBool32* feature = &device.features.robustBufferAccess;
+       feature <= &device.features.inheritedQueries; ++feature)
+    *feature = VK_TRUE;
+
+  device.memory.memoryTypeCount = 4;
+  for (uint32_t i = 0; i < 4; ++i) {
+    device.memory.memoryTypes[i].heapIndex = i / 2;
+    device.memory.memoryTypes[i].propertyFlags =
+        i < 2 ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+              : VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+  }
+  device.memory.memoryHeapCount = 2;
+  device.memory.memoryHeaps[0].size = 8ull << 30;
+  device.memory.memoryHeaps[0].flags = VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+  device.memory.memoryHeaps[1].size = 16ull << 30;
+
+  VkQueueFamilyProperties queues[] = {
+      {VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT,
+       16, 64, {1, 1, 1}},
+      {VK_QUEUE_TRANSFER_BIT, 2, 64, {1, 1, 1}},
+      {VK_QUEUE_COMPUTE_BIT, 8, 64, {1, 1, 1}}};
+  device.queues.assign(queues, queues + 3);
+
+  for (uint32_t i = 0; i < 40; ++i) {
+    VkExtensionProperties extension = {};
+    snprintf(extension.extensionName, sizeof(extension.extensionName),
+             "VK_VENDOR_synthetic_extension_%u", i);
+    extension.specVersion = i + 1;
+    device.extensions.push_back(extension);
+  }
+
+  for (int format = VK_FORMAT_BEGIN_RANGE + 1; format <= VK_FORMAT_END_RANGE;
+       ++format) {
+    VkFormatProperties props = {
+        VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |
+            VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT |
+            VK_FORMAT_FEATURE_TRANSFER_SRC_BIT_KHR,
+        VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |
+            VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT,
+        format % 3 ? VkFormatFeatureFlags(VK_FORMAT_FEATURE_VERTEX_BUFFER_BIT)
+                   : 0u};
+    device.formats.insert(std::make_pair(static_cast<VkFormat>(format), props));
+  }
+  return device;
+}
+
+VkJsonInstance SyntheticInstance() {
+  VkJsonInstance instance;
+  for (uint32_t i = 0; i < 16; ++i) {
+    VkExtensionProperties extension = {};
+    snprintf(extension.extensionName, sizeof(extension.extensionName),
+             "VK_KHR_synthetic_instance_extension_%u", i);
+    extension.specVersion = 1;
+    instance.extensions.push_back(extension);
+  }
+  VkJsonLayer layer = {};
+  snprintf(layer.properties.layerName, sizeof(layer.properties.layerName),
+           "VK_LAYER_LUNARG_standard_validation");
+  layer.properties.specVersion = VK_MAKE_VERSION(1, 0, 61);
+  layer.properties.implementationVersion = 1;
+  instance.layers.push_back(layer);
+  instance.devices.push_back(SyntheticDevice(0));
+  instance.devices.push_back(SyntheticDevice(1));
+  return instance;
+}
+
+double Seconds() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void Report(const char* what, double seconds, int iterations, size_t bytes) {
+  double per_iteration = seconds / iterations;
+  printf("%-13s %8u bytes  %9.1f us  %8.1f MB/s\n", what,
+         static_cast<unsigned>(bytes), per_iteration * 1e6,
+         bytes / per_iteration / 1e6);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  int iterations = 200;
+  const char* profile = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+      iterations = atoi(argv[++i]);
+    } else if (argv[i][0] != '-' && !profile) {
+      profile = argv[i];
+    } else {
+      std::cerr << "Usage: " << argv[0] << " [--iterations N] [profile.json]"
+                << std::endl;
+      return 1;
+    }
+  }
+  if (iterations <= 0)
+    iterations = 1;
+
+  VkJsonInstance instance;
+  std::string errors;
+  if (profile) {
+    std::ifstream file(profile);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    if (!file || !VkJsonInstanceFromJson(contents.str(), &instance, &errors)) {
+      std::cerr << profile << ": " << (errors.empty() ? "can't read" : errors)
+                << std::endl;
+      return 1;
+    }
+  } else {
+    instance = SyntheticInstance();
+  }
+
+  const std::string json = VkJsonInstanceToJson(instance);
+  const std::vector<uint8_t> binary = VkJsonInstanceToBinary(instance);
+  size_t checksum = 0;
+
+  double start = Seconds();
+  for (int i = 0; i < iterations; ++i)
+    checksum += VkJsonInstanceToJson(instance).size();
+  Report("JSON write", Seconds() - start, iterations, json.size());
+
+  start = Seconds();
+  for (int i = 0; i < iterations; ++i) {
+    VkJsonInstance copy;
+    if (!VkJsonInstanceFromJson(json, &copy, &errors)) {
+      std::cerr << "JSON read failed: " << errors << std::endl;
+      return 1;
+    }
+    checksum += copy.devices.size();
+  }
+  Report("JSON read", Seconds() - start, iterations, json.size());
+
+  start = Seconds();
+  for (int i = 0; i < iterations; ++i)
+    checksum += VkJsonInstanceToBinary(instance).size();
+  Report("binary write", Seconds() - start, iterations, binary.size());
+
+  start = Seconds();
+  for (int i = 0; i < iterations; ++i) {
+    VkJsonInstance copy;
+    if (!VkJsonInstanceFromBinary(binary, &copy, &errors)) {
+      std::cerr << "Binary read failed: " << errors << std::endl;
+      return 1;
+    }
+    checksum += copy.devices.size();
+  }
+  Report("binary read", Seconds() - start, iterations, binary.size());
+
+  return checksum ? 0 : 1;
+}
@@ -32,9 +32,12 @@ const uint32_t unsignedNegOne = (uint32_t)(-1);
 
 struct Options {
   bool instance = false;
+  bool timing = false;
+  uint32_t thread_count = 0;
   uint32_t device_index = unsignedNegOne;
   std::string device_name;
   std::string output_file;
+  std::string refresh_file;
 };
 
 bool ParseOptions(int argc, char* argv[], Options* options) {
@@ -44,6 +47,8 @@ bool ParseOptions(int argc, char* argv[], Options* options) {
       options->instance = true;
     } else if (arg == "--first" || arg == "-f") {
       options->device_index = 0;
+    } else if (arg == "--timing" || arg == "-t") {
+      options->timing = true;
     } else {
       ++i;
       if (i >= argc) {
@@ -62,6 +67,13 @@ bool ParseOptions(int argc, char* argv[], Options* options) {
         options->device_name = arg2;
       } else if (arg == "--output" || arg == "-o") {
         options->output_file = arg2;
+      } else if (arg == "--refresh" || arg == "-r") {
+        options->refresh_file = arg2;
+      } else if (arg == "--threads" || arg == "-j") {
+        if (sscanf(arg2.c_str(), "%u", &options->thread_count) != 1) {
+          std::cerr << "Unable to parse thread count: " << arg2 << std::endl;
+          return false;
+        }
       } else {
         std::cerr << "Unknown argument: " << arg << std::endl;
         return false;
@@ -152,12 +164,59 @@ bool Dump(const VkJsonInstance& instance, const Options& options) {
   return true;
 }
 
+// Loads a profile written by an earlier run, either of a whole instance or of
+// a single device.
+bool LoadPrevious(const std::string& file_name, VkJsonInstance* previous) {
+  FILE* file = fopen(file_name.c_str(), "rb");
+  if (!file) {
+    std::cerr << "Unable to open file " << file_name << "." << std::endl;
+    return false;
+  }
+  std::string json;
+  char buffer[4096];
+  size_t size;
+  while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    json.append(buffer, size);
+  fclose(file);
+
+  std::string errors;
+  if (VkJsonInstanceFromJson(json, previous, &errors))
+    return true;
+  previous->devices.resize(1);
+  if (VkJsonDeviceFromJson(json, &previous->devices[0], &errors))
+    return true;
+  std::cerr << "Unable to read profile " << file_name << ": " << errors
+            << std::endl;
+  return false;
+}
+
+void PrintTiming(const VkJsonTiming& timing) {
+  std::cerr << "Captured " << timing.devices.size() << " devices in "
+            << timing.total_milliseconds << " ms (instance "
+            << timing.instance_milliseconds << " ms)" << std::endl;
+  for (size_t i = 0; i < timing.devices.size(); ++i) {
+    std::cerr << "  device " << i << ": " << timing.devices[i].milliseconds
+              << " ms" << (timing.devices[i].reused ? ", reused" : "")
+              << std::endl;
+  }
+}
+
 int main(int argc, char* argv[]) {
   Options options;
   if (!ParseOptions(argc, argv, &options))
     return 1;
 
-  VkJsonInstance instance = VkJsonGetInstance();
+  VkJsonInstance previous;
+  if (!options.refresh_file.empty() &&
+      !LoadPrevious(options.refresh_file, &previous))
+    return 1;
+
+  VkJsonTiming timing;
+  VkJsonInstance instance = VkJsonGetInstance(
+      options.refresh_file.empty() ? nullptr : &previous, &timing,
+      options.thread_count);
+  if (options.timing)
+    PrintTiming(timing);
   if (options.instance || options.device_index != unsignedNegOne ||
       !options.device_name.empty()) {
     Dump(instance, options);
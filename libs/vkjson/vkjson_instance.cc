@@ -21,6 +21,8 @@
 #define VK_PROTOTYPES
 #include "vkjson.h"
 
+#include <chrono>
+#include <thread>
 #include <utility>
 
 namespace {
@@ -39,12 +41,35 @@ bool EnumerateExtensions(const char* layer_name,
   return true;
 }
 
-}  // anonymous namespace
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
 
-VkJsonDevice VkJsonGetDevice(VkPhysicalDevice physical_device) {
+bool IsSameDeviceAndDriver(const VkPhysicalDeviceProperties& a,
+                           const VkPhysicalDeviceProperties& b) {
+  return a.vendorID == b.vendorID && a.deviceID == b.deviceID &&
+         a.driverVersion == b.driverVersion && a.apiVersion == b.apiVersion &&
+         !strcmp(a.deviceName, b.deviceName) &&
+         !memcmp(a.pipelineCacheUUID, b.pipelineCacheUUID, VK_UUID_SIZE);
+}
+
+// Captures one physical device, copying features and formats from the first
+// of the |previous_count| profiles in |previous| that is the same device and
+// driver.
+VkJsonDevice CaptureDevice(VkPhysicalDevice physical_device,
+                           const VkJsonDevice* previous,
+                           size_t previous_count,
+                           VkJsonDeviceTiming* timing) {
+  auto start = std::chrono::steady_clock::now();
   VkJsonDevice device;
   vkGetPhysicalDeviceProperties(physical_device, &device.properties);
-  vkGetPhysicalDeviceFeatures(physical_device, &device.features);
+  const VkJsonDevice* match = nullptr;
+  for (size_t i = 0; i < previous_count && !match; ++i) {
+    if (IsSameDeviceAndDriver(previous[i].properties, device.properties))
+      match = &previous[i];
+  }
   vkGetPhysicalDeviceMemoryProperties(physical_device, &device.memory);
 
   uint32_t queue_family_count = 0;
@@ -75,22 +100,77 @@ VkJsonDevice VkJsonGetDevice(VkPhysicalDevice physical_device) {
                                      device.layers.data());
   }
 
-  VkFormatProperties format_properties = {};
-  for (VkFormat format = VK_FORMAT_R4G4_UNORM_PACK8;
-       format <= VK_FORMAT_END_RANGE;
-       format = static_cast<VkFormat>(format + 1)) {
-    vkGetPhysicalDeviceFormatProperties(physical_device, format,
-                                        &format_properties);
-    if (format_properties.linearTilingFeatures ||
-        format_properties.optimalTilingFeatures ||
-        format_properties.bufferFeatures) {
-      device.formats.insert(std::make_pair(format, format_properties));
+  if (match) {
+    device.features = match->features;
+    device.formats = match->formats;
+  } else {
+    vkGetPhysicalDeviceFeatures(physical_device, &device.features);
+    VkFormatProperties format_properties = {};
+    for (VkFormat format = VK_FORMAT_R4G4_UNORM_PACK8;
+         format <= VK_FORMAT_END_RANGE;
+         format = static_cast<VkFormat>(format + 1)) {
+      vkGetPhysicalDeviceFormatProperties(physical_device, format,
+                                          &format_properties);
+      if (format_properties.linearTilingFeatures ||
+          format_properties.optimalTilingFeatures ||
+          format_properties.bufferFeatures) {
+        device.formats.emplace_hint(device.formats.end(), format,
+                                    format_properties);
+      }
     }
   }
+
+  if (timing) {
+    timing->milliseconds = MillisecondsSince(start);
+    timing->reused = match != nullptr;
+  }
   return device;
 }
 
+// Joins its threads when it goes out of scope, so that none is left running
+// if capturing on the calling thread, or starting another thread, throws.
+class JoiningThreads {
+ public:
+  ~JoiningThreads() {
+    for (auto& thread : threads_) {
+      if (thread.joinable())
+        thread.join();
+    }
+  }
+
+  template <typename Function>
+  void Start(Function function) {
+    threads_.emplace_back(function);
+  }
+
+ private:
+  std::vector<std::thread> threads_;
+};
+
+}  // anonymous namespace
+
+VkJsonDevice VkJsonGetDevice(VkPhysicalDevice physical_device) {
+  return VkJsonGetDevice(physical_device, nullptr);
+}
+
+VkJsonDevice VkJsonGetDevice(VkPhysicalDevice physical_device,
+                             const VkJsonDevice* previous) {
+  return CaptureDevice(physical_device, previous, previous ? 1 : 0, nullptr);
+}
+
 VkJsonInstance VkJsonGetInstance() {
+  return VkJsonGetInstance(nullptr, nullptr);
+}
+
+VkJsonInstance VkJsonGetInstance(const VkJsonInstance* previous,
+                                 VkJsonTiming* timing) {
+  return VkJsonGetInstance(previous, timing, 0);
+}
+
+VkJsonInstance VkJsonGetInstance(const VkJsonInstance* previous,
+                                 VkJsonTiming* timing,
+                                 uint32_t thread_count) {
+  auto start = std::chrono::steady_clock::now();
   VkJsonInstance instance;
   VkResult result;
   uint32_t count;
@@ -150,10 +230,36 @@ VkJsonInstance VkJsonGetInstance() {
     return VkJsonInstance();
   }
 
-  instance.devices.reserve(devices.size());
-  for (auto device : devices)
-    instance.devices.emplace_back(VkJsonGetDevice(device));
+  VkJsonTiming local_timing;
+  if (!timing)
+    timing = &local_timing;
+  timing->instance_milliseconds = MillisecondsSince(start);
+  timing->devices.assign(devices.size(), VkJsonDeviceTiming());
+
+  // Physical device queries need no external synchronization, and most of
+  // the time goes to per-format driver calls, so capture the devices in
+  // parallel. Thread t captures every thread_count'th device starting at t;
+  // the calling thread is thread 0.
+  const VkJsonDevice* previous_devices =
+      previous ? previous->devices.data() : nullptr;
+  size_t previous_count = previous ? previous->devices.size() : 0;
+  instance.devices.resize(devices.size());
+  if (thread_count == 0 || thread_count > devices.size())
+    thread_count = static_cast<uint32_t>(devices.size());
+  auto capture = [&](size_t first) {
+    for (size_t i = first; i < devices.size(); i += thread_count) {
+      instance.devices[i] = CaptureDevice(devices[i], previous_devices,
+                                          previous_count, &timing->devices[i]);
+    }
+  };
+  {
+    JoiningThreads threads;
+    for (uint32_t t = 1; t < thread_count; ++t)
+      threads.Start([&, t] { capture(t); });
+    capture(0);
+  }
 
   vkDestroyInstance(vkinstance, nullptr);
+  timing->total_milliseconds = MillisecondsSince(start);
   return instance;
 }
@@ -0,0 +1,128 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2017 The Khronos Group Inc.
+// Copyright (c) 2015-2017 Valve Corporation
+// Copyright (c) 2015-2017 LunarG, Inc.
+// Copyright (c) 2015-2017 Google, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+// Captures profiles through the loader from the stand-in ICD in
+// vkjson_test_icd.cc, so no GPU is needed.
+
+#include "vkjson.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <iostream>
+
+#define EXPECT(X) if (!(X)) \
+  ReportFailure(__FILE__, __LINE__, #X);
+
+#define ASSERT(X) if (!(X)) { \
+  ReportFailure(__FILE__, __LINE__, #X); \
+  return 2; \
+}
+
+int g_failures;
+
+void ReportFailure(const char* file, int line, const char* assertion) {
+  std::cout << file << ":" << line << ": \"" << assertion << "\" failed."
+            << std::endl;
+  ++g_failures;
+}
+
+bool SameFormats(const std::map<VkFormat, VkFormatProperties>& a,
+                 const std::map<VkFormat, VkFormatProperties>& b) {
+  if (a.size() != b.size())
+    return false;
+  for (auto ia = a.begin(), ib = b.begin(); ia != a.end(); ++ia, ++ib) {
+    if (ia->first != ib->first ||
+        memcmp(&ia->second, &ib->second, sizeof(ia->second)))
+      return false;
+  }
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+  setenv("VK_ICD_FILENAMES", VKJSON_TEST_ICD_MANIFEST, 1);
+  setenv("VKJSON_TEST_ICD_DEVICE_COUNT", "3", 1);
+  setenv("VKJSON_TEST_ICD_DRIVER_VERSION", "1", 1);
+
+  VkJsonTiming timing;
+  VkJsonInstance instance = VkJsonGetInstance(nullptr, &timing);
+  ASSERT(instance.devices.size() == 3);
+  ASSERT(timing.devices.size() == 3);
+  EXPECT(timing.total_milliseconds >= timing.instance_milliseconds);
+  for (uint32_t i = 0; i < 3; ++i) {
+    const VkJsonDevice& device = instance.devices[i];
+    EXPECT(device.properties.deviceID == 0x100 + i);
+    EXPECT(device.properties.limits.maxImageDimension2D == 4096u << i);
+    EXPECT(device.features.geometryShader == (i & 1));
+    EXPECT(device.memory.memoryHeaps[0].size == (256ull << 20) * (i + 1));
+    EXPECT(device.queues.size() == 1);
+    EXPECT(!device.formats.empty());
+    // Each device has its own set of unsupported formats.
+    EXPECT(!device.formats.count(static_cast<VkFormat>(4 - i)));
+    EXPECT(!timing.devices[i].reused);
+  }
+
+  // Capturing on worker threads gives the same result as capturing the
+  // devices one after another, as does sharing fewer threads between them.
+  std::string json = VkJsonInstanceToJson(instance);
+  VkJsonTiming serial_timing;
+  VkJsonInstance serial = VkJsonGetInstance(nullptr, &serial_timing, 1);
+  EXPECT(serial_timing.devices.size() == 3);
+  EXPECT(VkJsonInstanceToJson(serial) == json);
+  EXPECT(VkJsonInstanceToJson(VkJsonGetInstance(nullptr, nullptr, 2)) == json);
+
+  // An unchanged driver lets a refresh copy features and formats from the
+  // previous profile. Mark them so that the copy can be told apart.
+  VkJsonInstance previous = instance;
+  VkFormatProperties marker = {VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT, 0, 0};
+  for (auto& device : previous.devices) {
+    device.formats[VK_FORMAT_ASTC_12x12_SRGB_BLOCK] = marker;
+    device.features.sparseBinding = VK_TRUE;
+  }
+  previous.devices.erase(previous.devices.begin() + 1);
+  VkJsonInstance refreshed = VkJsonGetInstance(&previous, &timing);
+  ASSERT(refreshed.devices.size() == 3);
+  EXPECT(timing.devices[0].reused);
+  EXPECT(!timing.devices[1].reused);
+  EXPECT(timing.devices[2].reused);
+  EXPECT(SameFormats(refreshed.devices[0].formats, previous.devices[0].formats));
+  EXPECT(refreshed.devices[0].features.sparseBinding);
+  EXPECT(SameFormats(refreshed.devices[1].formats, instance.devices[1].formats));
+  EXPECT(!refreshed.devices[1].features.sparseBinding);
+  EXPECT(SameFormats(refreshed.devices[2].formats, previous.devices[1].formats));
+
+  // A driver update invalidates the previous profile.
+  setenv("VKJSON_TEST_ICD_DRIVER_VERSION", "2", 1);
+  refreshed = VkJsonGetInstance(&previous, &timing);
+  ASSERT(refreshed.devices.size() == 3);
+  for (uint32_t i = 0; i < 3; ++i) {
+    EXPECT(!timing.devices[i].reused);
+    EXPECT(refreshed.devices[i].properties.driverVersion == 2);
+    EXPECT(SameFormats(refreshed.devices[i].formats, instance.devices[i].formats));
+  }
+
+  if (g_failures) {
+    std::cout << g_failures << " failures." << std::endl;
+    return 1;
+  } else {
+    std::cout << "Success." << std::endl;
+    return 0;
+  }
+}
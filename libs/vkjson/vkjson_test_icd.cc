@@ -0,0 +1,280 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2015-2017 The Khronos Group Inc.
+// Copyright (c) 2015-2017 Valve Corporation
+// Copyright (c) 2015-2017 LunarG, Inc.
+// Copyright (c) 2015-2017 Google, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+// Stand-in ICD for testing device capture without a GPU. It reports a fixed
+// set of fake physical devices whose properties are derived from their index.
+// The environment can change what it reports:
+//   VKJSON_TEST_ICD_DEVICE_COUNT    number of physical devices (default 3)
+//   VKJSON_TEST_ICD_DRIVER_VERSION  driverVersion of every device (default 1)
+//   VKJSON_TEST_ICD_FORMAT_DELAY_US time each format query takes, to stand in
+//                                   for a slow driver (default 0)
+
+#include <vulkan/vulkan.h>
+#include <vulkan/vk_icd.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#define TEST_ICD_EXPORT extern "C" __declspec(dllexport)
+#else
+#define TEST_ICD_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+namespace {
+
+struct PhysicalDevice {
+  VK_LOADER_DATA loader_data;
+  uint32_t index;
+};
+
+struct Instance {
+  VK_LOADER_DATA loader_data;
+  std::vector<PhysicalDevice*> physical_devices;
+};
+
+uint32_t GetEnvironmentValue(const char* name, uint32_t default_value) {
+  const char* value = getenv(name);
+  return value ? static_cast<uint32_t>(strtoul(value, nullptr, 0))
+               : default_value;
+}
+
+PhysicalDevice* AsPhysicalDevice(VkPhysicalDevice physical_device) {
+  return reinterpret_cast<PhysicalDevice*>(physical_device);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+CreateInstance(const VkInstanceCreateInfo* pCreateInfo,
+               const VkAllocationCallbacks* pAllocator, VkInstance* pInstance) {
+  Instance* instance = new Instance();
+  set_loader_magic_value(instance);
+  uint32_t count = GetEnvironmentValue("VKJSON_TEST_ICD_DEVICE_COUNT", 3);
+  for (uint32_t i = 0; i < count; ++i) {
+    PhysicalDevice* physical_device = new PhysicalDevice();
+    set_loader_magic_value(physical_device);
+    physical_device->index = i;
+    instance->physical_devices.push_back(physical_device);
+  }
+  *pInstance = reinterpret_cast<VkInstance>(instance);
+  return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL
+DestroyInstance(VkInstance vk_instance,
+                const VkAllocationCallbacks* pAllocator) {
+  Instance* instance = reinterpret_cast<Instance*>(vk_instance);
+  if (!instance)
+    return;
+  for (PhysicalDevice* physical_device : instance->physical_devices)
+    delete physical_device;
+  delete instance;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+EnumerateInstanceExtensionProperties(const char* pLayerName,
+                                     uint32_t* pPropertyCount,
+                                     VkExtensionProperties* pProperties) {
+  *pPropertyCount = 0;
+  return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+EnumeratePhysicalDevices(VkInstance vk_instance,
+                         uint32_t* pPhysicalDeviceCount,
+                         VkPhysicalDevice* pPhysicalDevices) {
+  Instance* instance = reinterpret_cast<Instance*>(vk_instance);
+  uint32_t count = static_cast<uint32_t>(instance->physical_devices.size());
+  if (!pPhysicalDevices) {
+    *pPhysicalDeviceCount = count;
+    return VK_SUCCESS;
+  }
+  uint32_t written = *pPhysicalDeviceCount < count ? *pPhysicalDeviceCount
+                                                   : count;
+  for (uint32_t i = 0; i < written; ++i) {
+    pPhysicalDevices[i] =
+        reinterpret_cast<VkPhysicalDevice>(instance->physical_devices[i]);
+  }
+  *pPhysicalDeviceCount = written;
+  return written < count ? VK_INCOMPLETE : VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL
+GetPhysicalDeviceProperties(VkPhysicalDevice physical_device,
+                            VkPhysicalDeviceProperties* pProperties) {
+  uint32_t index = AsPhysicalDevice(physical_device)->index;
+  memset(pProperties, 0, sizeof(*pProperties));
+  pProperties->apiVersion = VK_API_VERSION_1_0;
+  pProperties->driverVersion =
+      GetEnvironmentValue("VKJSON_TEST_ICD_DRIVER_VERSION", 1);
+  pProperties->vendorID = 0x10000;
+  pProperties->deviceID = 0x100 + index;
+  pProperties->deviceType = VK_PHYSICAL_DEVICE_TYPE_CPU;
+  snprintf(pProperties->deviceName, sizeof(pProperties->deviceName),
+           "vkjson test device %u", index);
+  pProperties->pipelineCacheUUID[0] = static_cast<uint8_t>(index);
+  pProperties->limits.maxImageDimension2D = 4096 << index;
+  pProperties->limits.maxMemoryAllocationCount = 4096;
+  pProperties->limits.maxSamplerLodBias = 2.5f;
+  pProperties->limits.minTexelOffset = -8;
+  pProperties->limits.pointSizeRange[0] = 1.0f;
+  pProperties->limits.pointSizeRange[1] = 64.0f;
+  pProperties->limits.minMemoryMapAlignment = 64;
+}
+
+VKAPI_ATTR void VKAPI_CALL
+GetPhysicalDeviceFeatures(VkPhysicalDevice physical_device,
+                          VkPhysicalDeviceFeatures* pFeatures) {
+  uint32_t index = AsPhysicalDevice(physical_device)->index;
+  memset(pFeatures, 0, sizeof(*pFeatures));
+  pFeatures->robustBufferAccess = VK_TRUE;
+  pFeatures->geometryShader = index & 1;
+}
+
+VKAPI_ATTR void VKAPI_CALL
+GetPhysicalDeviceMemoryProperties(
+    VkPhysicalDevice physical_device,
+    VkPhysicalDeviceMemoryProperties* pMemoryProperties) {
+  uint32_t index = AsPhysicalDevice(physical_device)->index;
+  memset(pMemoryProperties, 0, sizeof(*pMemoryProperties));
+  pMemoryProperties->memoryTypeCount = 1;
+  pMemoryProperties->memoryTypes[0].propertyFlags =
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+  pMemoryProperties->memoryHeapCount = 1;
+  pMemoryProperties->memoryHeaps[0].size = (256ull << 20) * (index + 1);
+}
+
+VKAPI_ATTR void VKAPI_CALL
+GetPhysicalDeviceQueueFamilyProperties(
+    VkPhysicalDevice physical_device, uint32_t* pQueueFamilyPropertyCount,
+    VkQueueFamilyProperties* pQueueFamilyProperties) {
+  if (!pQueueFamilyProperties) {
+    *pQueueFamilyPropertyCount = 1;
+    return;
+  }
+  if (*pQueueFamilyPropertyCount < 1)
+    return;
+  VkQueueFamilyProperties properties = {
+      VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT, 1, 64, {1, 1, 1}};
+  pQueueFamilyProperties[0] = properties;
+  *pQueueFamilyPropertyCount = 1;
+}
+
+VKAPI_ATTR void VKAPI_CALL
+GetPhysicalDeviceFormatProperties(VkPhysicalDevice physical_device,
+                                  VkFormat format,
+                                  VkFormatProperties* pFormatProperties) {
+  uint32_t delay = GetEnvironmentValue("VKJSON_TEST_ICD_FORMAT_DELAY_US", 0);
+  if (delay)
+    std::this_thread::sleep_for(std::chrono::microseconds(delay));
+  uint32_t index = AsPhysicalDevice(physical_device)->index;
+  memset(pFormatProperties, 0, sizeof(*pFormatProperties));
+  // Leave some formats unsupported, and a different set on each device
+  if ((format + index) % 4 == 0)
+    return;
+  pFormatProperties->optimalTilingFeatures =
+      VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_BLIT_SRC_BIT;
+  if (format % 2)
+    pFormatProperties->linearTilingFeatures =
+        VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+  if (format % 3)
+    pFormatProperties->bufferFeatures = VK_FORMAT_FEATURE_VERTEX_BUFFER_BIT;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceImageFormatProperties(
+    VkPhysicalDevice physical_device, VkFormat format, VkImageType type,
+    VkImageTiling tiling, VkImageUsageFlags usage, VkImageCreateFlags flags,
+    VkImageFormatProperties* pImageFormatProperties) {
+  return VK_ERROR_FORMAT_NOT_SUPPORTED;
+}
+
+VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceSparseImageFormatProperties(
+    VkPhysicalDevice physical_device, VkFormat format, VkImageType type,
+    VkSampleCountFlagBits samples, VkImageUsageFlags usage,
+    VkImageTiling tiling, uint32_t* pPropertyCount,
+    VkSparseImageFormatProperties* pProperties) {
+  *pPropertyCount = 0;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+EnumerateDeviceExtensionProperties(VkPhysicalDevice physical_device,
+                                   const char* pLayerName,
+                                   uint32_t* pPropertyCount,
+                                   VkExtensionProperties* pProperties) {
+  *pPropertyCount = 0;
+  return VK_SUCCESS;
+}
+
+// Capture never creates a device.
+VKAPI_ATTR VkResult VKAPI_CALL
+CreateDevice(VkPhysicalDevice physical_device,
+             const VkDeviceCreateInfo* pCreateInfo,
+             const VkAllocationCallbacks* pAllocator, VkDevice* pDevice) {
+  return VK_ERROR_INITIALIZATION_FAILED;
+}
+
+VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL GetDeviceProcAddr(VkDevice device,
+                                                           const char* pName) {
+  return nullptr;
+}
+
+}  // anonymous namespace
+
+TEST_ICD_EXPORT VKAPI_ATTR VkResult VKAPI_CALL
+vk_icdNegotiateLoaderICDInterfaceVersion(uint32_t* pSupportedVersion) {
+  if (*pSupportedVersion > 2)
+    *pSupportedVersion = 2;
+  return VK_SUCCESS;
+}
+
+TEST_ICD_EXPORT VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL
+vk_icdGetInstanceProcAddr(VkInstance instance, const char* pName) {
+  struct {
+    const char* name;
+    PFN_vkVoidFunction function;
+  } static const kFunctions[] = {
+#define TEST_ICD_FUNCTION(name) \
+  { "vk" #name, reinterpret_cast<PFN_vkVoidFunction>(name) }
+      TEST_ICD_FUNCTION(CreateInstance),
+      TEST_ICD_FUNCTION(DestroyInstance),
+      TEST_ICD_FUNCTION(EnumerateInstanceExtensionProperties),
+      TEST_ICD_FUNCTION(EnumeratePhysicalDevices),
+      TEST_ICD_FUNCTION(GetPhysicalDeviceProperties),
+      TEST_ICD_FUNCTION(GetPhysicalDeviceFeatures),
+      TEST_ICD_FUNCTION(GetPhysicalDeviceMemoryProperties),
+      TEST_ICD_FUNCTION(GetPhysicalDeviceQueueFamilyProperties),
+      TEST_ICD_FUNCTION(GetPhysicalDeviceFormatProperties),
+      TEST_ICD_FUNCTION(GetPhysicalDeviceImageFormatProperties),
+      TEST_ICD_FUNCTION(GetPhysicalDeviceSparseImageFormatProperties),
+      TEST_ICD_FUNCTION(EnumerateDeviceExtensionProperties),
+      TEST_ICD_FUNCTION(CreateDevice),
+      TEST_ICD_FUNCTION(GetDeviceProcAddr),
+#undef TEST_ICD_FUNCTION
+  };
+  for (const auto& function : kFunctions) {
+    if (!strcmp(pName, function.name))
+      return function.function;
+  }
+  return nullptr;
+}
@@ -91,6 +91,96 @@ int main(int argc, char* argv[]) {
 
   EXPECT(!memcmp(&props, &props2, sizeof(props)));
 
+  // The writer keeps the layout cJSON_Print used to produce.
+  props.maxExtent.width = 4096;
+  props.maxResourceSize = 0x100000000ull;
+  json = VkJsonImageFormatPropertiesToJson(props);
+  EXPECT(json ==
+         "{\n"
+         "\t\"maxExtent\":\t{\n"
+         "\t\t\"width\":\t4096,\n"
+         "\t\t\"height\":\t0,\n"
+         "\t\t\"depth\":\t0\n"
+         "\t},\n"
+         "\t\"maxMipLevels\":\t0,\n"
+         "\t\"maxArrayLayers\":\t0,\n"
+         "\t\"sampleCounts\":\t0,\n"
+         "\t\"maxResourceSize\":\t\"0x0000000100000000\"\n"
+         "}");
+
+  // Members may come in any order, and unknown ones are skipped.
+  json =
+      "{\"maxResourceSize\": \"0x0000000100000000\", \"sampleCounts\": 1,"
+      " \"unknown\": [{\"a\": null}, true, \"\\\"\"], \"maxArrayLayers\": 2,"
+      " \"maxMipLevels\": 3, \"maxExtent\": {\"depth\": 1, \"height\": 2,"
+      " \"width\": 4096}}";
+  result = VkJsonImageFormatPropertiesFromJson(json, &props2, &errors);
+  EXPECT(result);
+  EXPECT(props2.maxExtent.width == 4096 && props2.maxExtent.height == 2 &&
+         props2.maxExtent.depth == 1 && props2.maxMipLevels == 3 &&
+         props2.maxArrayLayers == 2 && props2.sampleCounts == 1 &&
+         props2.maxResourceSize == 0x100000000ull);
+
+  json = "{\"maxResourceSize\": \"0x0\", \"sampleCounts\": 1,"
+         " \"maxArrayLayers\": 2, \"maxMipLevels\": 3}";
+  result = VkJsonImageFormatPropertiesFromJson(json, &props2, &errors);
+  EXPECT(!result);
+  EXPECT(errors == "maxExtent missing.");
+  json = "{\"maxExtent\": {\"width\": 1, \"height\": 2, \"depth\": -1}}";
+  result = VkJsonImageFormatPropertiesFromJson(json, &props2, &errors);
+  EXPECT(!result);
+  EXPECT(errors == "Wrong type for maxExtent.");
+
+  // The binary encoding reads back exactly what the JSON path does.
+  device.properties.limits.pointSizeGranularity = 0.125f;
+  device.properties.limits.minTexelOffset = -8;
+  device.properties.limits.minMemoryMapAlignment = 64;
+  device.memory.memoryTypeCount = 1;
+  device.memory.memoryTypes[0].propertyFlags =
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+  device.memory.memoryHeapCount = 1;
+  device.memory.memoryHeaps[0].size = 0x100000000ull;
+  VkQueueFamilyProperties queue = {VK_QUEUE_GRAPHICS_BIT, 16, 64, {1, 1, 1}};
+  device.queues.push_back(queue);
+  VkExtensionProperties extension = {"VK_KHR_swapchain", 68};
+  device.extensions.push_back(extension);
+  instance.extensions.push_back(extension);
+  json = VkJsonInstanceToJson(instance);
+  result = VkJsonInstanceFromJson(json, &instance2, &errors);
+  EXPECT(result);
+
+  std::vector<uint8_t> binary = VkJsonInstanceToBinary(instance2);
+  EXPECT(binary.size() < json.size() / 4);
+  VkJsonInstance instance3;
+  result = VkJsonInstanceFromBinary(binary, &instance3, &errors);
+  EXPECT(result);
+  if (!result)
+    std::cout << "Error: " << errors << std::endl;
+  EXPECT(VkJsonInstanceToJson(instance3) == json);
+  ASSERT(instance3.devices.size() == 1);
+  EXPECT(!memcmp(&instance2.devices[0].properties,
+                 &instance3.devices[0].properties,
+                 sizeof(VkPhysicalDeviceProperties)));
+  EXPECT(!memcmp(&instance2.devices[0].memory, &instance3.devices[0].memory,
+                 sizeof(VkPhysicalDeviceMemoryProperties)));
+  EXPECT(instance3.devices[0].formats.size() == 2);
+
+  VkJsonDevice device3;
+  result = VkJsonDeviceFromBinary(VkJsonDeviceToBinary(device), &device3,
+                                  &errors);
+  EXPECT(result);
+  EXPECT(VkJsonDeviceToJson(device3) == VkJsonDeviceToJson(device));
+
+  // Blobs that are truncated, of the wrong type or not binary profiles at all
+  // are rejected.
+  std::vector<uint8_t> truncated(binary.begin(), binary.end() - 1);
+  EXPECT(!VkJsonInstanceFromBinary(truncated, &instance3, &errors));
+  EXPECT(!VkJsonDeviceFromBinary(binary, &device3, &errors));
+  EXPECT(errors == "Binary profile was written with a different schema.");
+  std::vector<uint8_t> text(json.begin(), json.end());
+  EXPECT(!VkJsonInstanceFromBinary(text, &instance3, &errors));
+  EXPECT(errors == "Not a vkjson binary profile.");
+
   if (g_failures) {
     std::cout << g_failures << " failures." << std::endl;
     return 1;
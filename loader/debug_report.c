@@ -95,6 +95,15 @@ debug_report_CreateDebugReportCallbackEXT(VkInstance instance, const VkDebugRepo
     return result;
 }
 
+// Return the combined message flags of every callback registered on the instance
+VkFlags util_DebugReportFlags(const struct loader_instance *inst) {
+    VkFlags flags = 0;
+    for (VkLayerDbgFunctionNode *pTrav = inst->DbgFunctionHead; pTrav; pTrav = pTrav->pNext) {
+        flags |= pTrav->msgFlags;
+    }
+    return flags;
+}
+
 // Utility function to handle reporting
 VkBool32 util_DebugReportMessage(const struct loader_instance *inst, VkFlags msgFlags, VkDebugReportObjectTypeEXT objectType,
                                  uint64_t srcObject, size_t location, int32_t msgCode, const char *pLayerPrefix, const char *pMsg) {
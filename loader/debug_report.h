@@ -134,5 +134,7 @@ VkResult util_CreateDebugReportCallbacks(struct loader_instance *inst, const VkA
 void util_DestroyDebugReportCallbacks(struct loader_instance *inst, const VkAllocationCallbacks *pAllocator, uint32_t num_callbacks,
                                       VkDebugReportCallbackEXT *callbacks);
 
+VkFlags util_DebugReportFlags(const struct loader_instance *inst);
+
 VkBool32 util_DebugReportMessage(const struct loader_instance *inst, VkFlags msgFlags, VkDebugReportObjectTypeEXT objectType,
                                  uint64_t srcObject, size_t location, int32_t msgCode, const char *pLayerPrefix, const char *pMsg);
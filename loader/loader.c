@@ -25,12 +25,14 @@
  */
 
 #define _GNU_SOURCE
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <string.h>
 #include <stddef.h>
+#include <time.h>
 
 #include <sys/types.h>
 #if defined(_WIN32)
@@ -80,11 +82,16 @@ enum loader_debug {
 uint32_t g_loader_debug = 0;
 uint32_t g_loader_log_msgs = 0;
 
+// Output of the VK_LOADER_TRACE startup trace, or NULL when it is off
+static FILE *g_loader_trace_file = NULL;
+
 // thread safety lock for accessing global data structures such as "loader"
 // all entrypoints on the instance chain need to be locked except GPA
 // additionally CreateDevice and DestroyDevice needs to be locked
 loader_platform_thread_mutex loader_lock;
 loader_platform_thread_mutex loader_json_lock;
+// serializes writes to the VK_LOADER_TRACE file
+static loader_platform_thread_mutex loader_trace_lock;
 
 LOADER_PLATFORM_THREAD_ONCE_DECLARATION(once_init);
 
@@ -294,6 +301,12 @@ void loader_log(const struct loader_instance *inst, VkFlags msg_type, int32_t ms
     va_list ap;
     int ret;
 
+    // Most messages go nowhere, so find out who is listening before paying for any formatting
+    VkFlags report_flags = inst ? (msg_type & util_DebugReportFlags(inst)) : 0;
+    if (!report_flags && !(msg_type & g_loader_log_msgs)) {
+        return;
+    }
+
     va_start(ap, format);
     ret = vsnprintf(msg, sizeof(msg), format, ap);
     if ((ret >= (int)sizeof(msg)) || ret < 0) {
@@ -301,7 +314,7 @@ void loader_log(const struct loader_instance *inst, VkFlags msg_type, int32_t ms
     }
     va_end(ap);
 
-    if (inst) {
+    if (report_flags) {
         util_DebugReportMessage(inst, msg_type, VK_DEBUG_REPORT_OBJECT_TYPE_INSTANCE_EXT, (uint64_t)(uintptr_t)inst, 0, msg_code,
                                 "loader", msg);
     }
@@ -314,7 +327,6 @@ void loader_log(const struct loader_instance *inst, VkFlags msg_type, int32_t ms
     cmd_line_size -= 1;
     size_t original_size = cmd_line_size;
 
-    va_start(ap, format);
     if ((msg_type & LOADER_INFO_BIT) != 0) {
         strncat(cmd_line_msg, "INFO", cmd_line_size);
         cmd_line_size -= 4;
@@ -377,6 +389,64 @@ void loader_log(const struct loader_instance *inst, VkFlags msg_type, int32_t ms
     fputc('\n', stderr);
 }
 
+// Monotonic time in microseconds
+static uint64_t loader_trace_now(void) {
+#if defined(_WIN32)
+    LARGE_INTEGER now, frequency;
+    QueryPerformanceCounter(&now);
+    QueryPerformanceFrequency(&frequency);
+    return (uint64_t)(now.QuadPart / frequency.QuadPart) * 1000000 +
+           (uint64_t)(now.QuadPart % frequency.QuadPart) * 1000000 / frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+#endif
+}
+
+uint64_t loader_trace_begin(void) { return g_loader_trace_file ? loader_trace_now() : 0; }
+
+// Write a string as a JSON string literal
+static void loader_trace_write_string(FILE *file, const char *str) {
+    fputc('"', file);
+    for (; *str; ++str) {
+        if (*str == '"' || *str == '\\') {
+            fputc('\\', file);
+            fputc(*str, file);
+        } else if ((unsigned char)*str < 0x20) {
+            fprintf(file, "\\u%04x", (unsigned char)*str);
+        } else {
+            fputc(*str, file);
+        }
+    }
+    fputc('"', file);
+}
+
+// Record one complete ("X") event. The file is the JSON array form of the Chrome trace format, which is loaded by
+// chrome://tracing and similar viewers; the closing bracket is optional there, so events are flushed as they happen
+// and the file stays usable if the application exits or crashes without tearing the loader down.
+void loader_trace_end(const char *phase, const char *detail, uint64_t start) {
+    FILE *file = g_loader_trace_file;
+    if (!file || !start) {
+        return;
+    }
+    uint64_t end = loader_trace_now();
+
+    loader_platform_thread_lock_mutex(&loader_trace_lock);
+    fputs("{\"cat\":\"loader\",\"ph\":\"X\",\"pid\":1,\"name\":", file);
+    loader_trace_write_string(file, phase);
+    fprintf(file, ",\"tid\":%" PRIu64 ",\"ts\":%" PRIu64 ",\"dur\":%" PRIu64, (uint64_t)(uintptr_t)loader_platform_get_thread_id(),
+            start, end - start);
+    if (detail) {
+        fputs(",\"args\":{\"detail\":", file);
+        loader_trace_write_string(file, detail);
+        fputc('}', file);
+    }
+    fputs("},\n", file);
+    fflush(file);
+    loader_platform_thread_unlock_mutex(&loader_trace_lock);
+}
+
 VKAPI_ATTR VkResult VKAPI_CALL vkSetInstanceDispatch(VkInstance instance, void *object) {
     struct loader_instance *inst = loader_get_instance(instance);
     if (!inst) {
@@ -600,6 +670,70 @@ bool has_vk_dev_ext_property(const VkExtensionProperties *ext_prop, const struct
     return false;
 }
 
+// Set of extension names, for merging and validating extension lists without comparing each name against every entry of a
+// list. With several ICDs and layers each exposing dozens of extensions, those linear searches add up to a quadratic cost.
+// The set is open-addressed and only holds pointers, so the names it's given must stay put for as long as it's in use.
+struct loader_ext_name_set {
+    uint32_t mask;  // Table size less one; the size is a power of two
+    const char **names;
+};
+
+// Searches comparing fewer names than this stick to a linear scan, which is cheaper than allocating and filling a set
+#define LOADER_EXT_NAME_SET_MIN_COMPARES 256
+
+static uint32_t loader_hash_ext_name(const char *name) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Allocate an empty set with room for capacity names. Returns false on allocation failure, in which case the caller should
+// fall back to a linear search.
+static bool loader_init_ext_name_set(const struct loader_instance *inst, struct loader_ext_name_set *set, uint32_t capacity) {
+    uint32_t size = 16;
+    while (size < capacity * 2) {
+        size *= 2;
+    }
+    set->names = loader_instance_heap_alloc(inst, sizeof(const char *) * size, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+    if (set->names == NULL) {
+        return false;
+    }
+    memset(set->names, 0, sizeof(const char *) * size);
+    set->mask = size - 1;
+    return true;
+}
+
+static void loader_destroy_ext_name_set(const struct loader_instance *inst, struct loader_ext_name_set *set) {
+    loader_instance_heap_free(inst, (void *)set->names);
+    set->names = NULL;
+}
+
+// Add name to the set. Returns false if it was already there.
+static bool loader_ext_name_set_insert(struct loader_ext_name_set *set, const char *name) {
+    for (uint32_t i = loader_hash_ext_name(name) & set->mask;; i = (i + 1) & set->mask) {
+        if (set->names[i] == NULL) {
+            set->names[i] = name;
+            return true;
+        }
+        if (strcmp(set->names[i], name) == 0) {
+            return false;
+        }
+    }
+}
+
+static bool loader_ext_name_set_contains(const struct loader_ext_name_set *set, const char *name) {
+    for (uint32_t i = loader_hash_ext_name(name) & set->mask; set->names[i] != NULL; i = (i + 1) & set->mask) {
+        if (strcmp(set->names[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 // Search the given layer list for a layer matching the given layer name
 static struct loader_layer_properties *loader_get_layer_property(const char *name, const struct loader_layer_list *layer_list) {
     for (uint32_t i = 0; i < layer_list->count; i++) {
@@ -673,7 +807,7 @@ void loader_delete_layer_properties(const struct loader_instance *inst, struct l
 static VkResult loader_add_instance_extensions(const struct loader_instance *inst,
                                                const PFN_vkEnumerateInstanceExtensionProperties fp_get_props, const char *lib_name,
                                                struct loader_extension_list *ext_list) {
-    uint32_t i, count = 0;
+    uint32_t i, count = 0, supported_count;
     VkExtensionProperties *ext_props;
     VkResult res = VK_SUCCESS;
 
@@ -711,6 +845,8 @@ static VkResult loader_add_instance_extensions(const struct loader_instance *ins
         goto out;
     }
 
+    // Compact the supported extensions to the front of ext_props, and add them in one go
+    supported_count = 0;
     for (i = 0; i < count; i++) {
         char spec_version[64];
 
@@ -721,17 +857,19 @@ static VkResult loader_add_instance_extensions(const struct loader_instance *ins
             loader_log(inst, VK_DEBUG_REPORT_DEBUG_BIT_EXT, 0, "Instance Extension: %s (%s) version %s", ext_props[i].extensionName,
                        lib_name, spec_version);
 
-            res = loader_add_to_ext_list(inst, ext_list, 1, &ext_props[i]);
-            if (res != VK_SUCCESS) {
-                loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
-                           "loader_add_instance_extensions: Failed to add %s "
-                           "to Instance extension list",
-                           lib_name);
-                goto out;
-            }
+            ext_props[supported_count++] = ext_props[i];
         }
     }
 
+    res = loader_add_to_ext_list(inst, ext_list, supported_count, ext_props);
+    if (res != VK_SUCCESS) {
+        loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
+                   "loader_add_instance_extensions: Failed to add %s "
+                   "to Instance extension list",
+                   lib_name);
+        goto out;
+    }
+
 out:
     return res;
 }
@@ -755,11 +893,9 @@ static VkResult loader_init_device_extensions(const struct loader_instance *inst
                        VK_VERSION_MINOR(ext_props[i].specVersion), VK_VERSION_PATCH(ext_props[i].specVersion));
         loader_log(inst, VK_DEBUG_REPORT_DEBUG_BIT_EXT, 0, "Device Extension: %s (%s) version %s", ext_props[i].extensionName,
                    phys_dev_term->this_icd_term->scanned_icd->lib_name, spec_version);
-        res = loader_add_to_ext_list(inst, ext_list, 1, &ext_props[i]);
-        if (res != VK_SUCCESS) return res;
     }
 
-    return VK_SUCCESS;
+    return loader_add_to_ext_list(inst, ext_list, count, ext_props);
 }
 
 VkResult loader_add_device_extensions(const struct loader_instance *inst,
@@ -789,10 +925,10 @@ VkResult loader_add_device_extensions(const struct loader_instance *inst,
                            VK_VERSION_MINOR(ext_props[i].specVersion), VK_VERSION_PATCH(ext_props[i].specVersion));
             loader_log(inst, VK_DEBUG_REPORT_DEBUG_BIT_EXT, 0, "Device Extension: %s (%s) version %s", ext_props[i].extensionName,
                        lib_name, spec_version);
-            res = loader_add_to_ext_list(inst, ext_list, 1, &ext_props[i]);
-            if (res != VK_SUCCESS) {
-                return res;
-            }
+        }
+        res = loader_add_to_ext_list(inst, ext_list, count, ext_props);
+        if (res != VK_SUCCESS) {
+            return res;
         }
     } else {
         loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
@@ -832,7 +968,8 @@ void loader_destroy_generic_list(const struct loader_instance *inst, struct load
 VkResult loader_add_to_ext_list(const struct loader_instance *inst, struct loader_extension_list *ext_list,
                                 uint32_t prop_list_count, const VkExtensionProperties *props) {
     uint32_t i;
-    const VkExtensionProperties *cur_ext;
+    struct loader_ext_name_set ext_names = {0};
+    bool use_name_set;
 
     if (ext_list->list == NULL || ext_list->capacity == 0) {
         VkResult res = loader_init_generic_list(inst, (struct loader_generic_list *)ext_list, sizeof(VkExtensionProperties));
@@ -841,34 +978,44 @@ VkResult loader_add_to_ext_list(const struct loader_instance *inst, struct loade
         }
     }
 
-    for (i = 0; i < prop_list_count; i++) {
-        cur_ext = &props[i];
-
-        // look for duplicates
-        if (has_vk_extension_property(cur_ext, ext_list)) {
-            continue;
+    // Make room for all of props up front, so that the list doesn't move while the name set points into it
+    size_t new_capacity = ext_list->capacity;
+    while ((ext_list->count + prop_list_count) * sizeof(VkExtensionProperties) >= new_capacity) {
+        new_capacity *= 2;
+    }
+    if (new_capacity != ext_list->capacity) {
+        void *new_ptr = loader_instance_heap_realloc(inst, ext_list->list, ext_list->capacity, new_capacity,
+                                                     VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+        if (new_ptr == NULL) {
+            loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
+                       "loader_add_to_ext_list: Failed to reallocate "
+                       "space for extension list");
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
         }
+        ext_list->list = new_ptr;
+        ext_list->capacity = new_capacity;
+    }
 
-        // add to list at end
-        // check for enough capacity
-        if (ext_list->count * sizeof(VkExtensionProperties) >= ext_list->capacity) {
-            void *new_ptr = loader_instance_heap_realloc(inst, ext_list->list, ext_list->capacity, ext_list->capacity * 2,
-                                                         VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
-            if (new_ptr == NULL) {
-                loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
-                           "loader_add_to_ext_list: Failed to reallocate "
-                           "space for extension list");
-                return VK_ERROR_OUT_OF_HOST_MEMORY;
-            }
-            ext_list->list = new_ptr;
-
-            // double capacity
-            ext_list->capacity *= 2;
+    use_name_set = prop_list_count > 1 &&
+                   (uint64_t)(ext_list->count + prop_list_count) * prop_list_count >= LOADER_EXT_NAME_SET_MIN_COMPARES &&
+                   loader_init_ext_name_set(inst, &ext_names, ext_list->count + prop_list_count);
+    if (use_name_set) {
+        for (i = 0; i < ext_list->count; i++) {
+            loader_ext_name_set_insert(&ext_names, ext_list->list[i].extensionName);
         }
+    }
 
-        memcpy(&ext_list->list[ext_list->count], cur_ext, sizeof(VkExtensionProperties));
-        ext_list->count++;
+    for (i = 0; i < prop_list_count; i++) {
+        // Copy into the first free slot, and only keep it if it isn't a duplicate
+        VkExtensionProperties *cur_ext = &ext_list->list[ext_list->count];
+        memcpy(cur_ext, &props[i], sizeof(VkExtensionProperties));
+        if (use_name_set ? loader_ext_name_set_insert(&ext_names, cur_ext->extensionName)
+                         : !has_vk_extension_property(cur_ext, ext_list)) {
+            ext_list->count++;
+        }
     }
+
+    loader_destroy_ext_name_set(inst, &ext_names);
     return VK_SUCCESS;
 }
 
@@ -1226,6 +1373,7 @@ VkResult loader_get_icd_loader_instance_extensions(const struct loader_instance
     VkResult res = VK_SUCCESS;
     char *env_value;
     bool filter_extensions = true;
+    struct loader_ext_name_set known_exts = {0};
 
     loader_log(inst, VK_DEBUG_REPORT_DEBUG_BIT_EXT, 0, "Build ICD instance extension list");
 
@@ -1236,6 +1384,22 @@ VkResult loader_get_icd_loader_instance_extensions(const struct loader_instance
     }
     loader_free_getenv(env_value, inst);
 
+    if (filter_extensions) {
+        uint32_t known_count = 0;
+        while (LOADER_INSTANCE_EXTENSIONS[known_count] != NULL) {
+            known_count++;
+        }
+        if (!loader_init_ext_name_set(inst, &known_exts, known_count)) {
+            loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
+                       "loader_get_icd_loader_instance_extensions: Failed to allocate space for known extension names");
+            res = VK_ERROR_OUT_OF_HOST_MEMORY;
+            goto out;
+        }
+        for (uint32_t k = 0; k < known_count; k++) {
+            loader_ext_name_set_insert(&known_exts, LOADER_INSTANCE_EXTENSIONS[k]);
+        }
+    }
+
     // traverse scanned icd list adding non-duplicate extensions to the list
     for (uint32_t i = 0; i < icd_tramp_list->count; i++) {
         res = loader_init_generic_list(inst, (struct loader_generic_list *)&icd_exts, sizeof(VkExtensionProperties));
@@ -1246,26 +1410,14 @@ VkResult loader_get_icd_loader_instance_extensions(const struct loader_instance
                                              icd_tramp_list->scanned_list[i].lib_name, &icd_exts);
         if (VK_SUCCESS == res) {
             if (filter_extensions) {
-                // Remove any extensions not recognized by the loader
-                for (int32_t j = 0; j < (int32_t)icd_exts.count; j++) {
-                    // See if the extension is in the list of supported extensions
-                    bool found = false;
-                    for (uint32_t k = 0; LOADER_INSTANCE_EXTENSIONS[k] != NULL; k++) {
-                        if (strcmp(icd_exts.list[j].extensionName, LOADER_INSTANCE_EXTENSIONS[k]) == 0) {
-                            found = true;
-                            break;
-                        }
-                    }
-
-                    // If it isn't in the list, remove it
-                    if (!found) {
-                        for (uint32_t k = j + 1; k < icd_exts.count; k++) {
-                            icd_exts.list[k - 1] = icd_exts.list[k];
-                        }
-                        --icd_exts.count;
-                        --j;
+                // Remove any extensions not recognized by the loader, keeping the rest in order
+                uint32_t known_count = 0;
+                for (uint32_t j = 0; j < icd_exts.count; j++) {
+                    if (loader_ext_name_set_contains(&known_exts, icd_exts.list[j].extensionName)) {
+                        icd_exts.list[known_count++] = icd_exts.list[j];
                     }
                 }
+                icd_exts.count = known_count;
             }
 
             res = loader_add_to_ext_list(inst, inst_exts, icd_exts.count, icd_exts.list);
@@ -1280,6 +1432,7 @@ VkResult loader_get_icd_loader_instance_extensions(const struct loader_instance
     debug_report_add_instance_extensions(inst, inst_exts);
 
 out:
+    loader_destroy_ext_name_set(inst, &known_exts);
     return res;
 }
 
@@ -1490,7 +1643,9 @@ static VkResult loader_scanned_icd_add(const struct loader_instance *inst, struc
 
     // TODO implement smarter opening/closing of libraries. For now this
     // function leaves libraries open and the scanned_icd_clear closes them
+    uint64_t trace_start = loader_trace_begin();
     handle = loader_platform_open_library(filename);
+    loader_trace_end("ICD dlopen", filename, trace_start);
     if (NULL == handle) {
         loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0, loader_platform_open_library_error(filename));
         goto out;
@@ -1499,7 +1654,10 @@ static VkResult loader_scanned_icd_add(const struct loader_instance *inst, struc
     // Get and settle on an ICD interface version
     fp_negotiate_icd_version = loader_platform_get_proc_address(handle, "vk_icdNegotiateLoaderICDInterfaceVersion");
 
-    if (!loader_get_icd_interface_version(fp_negotiate_icd_version, &interface_vers)) {
+    trace_start = loader_trace_begin();
+    bool negotiated = loader_get_icd_interface_version(fp_negotiate_icd_version, &interface_vers);
+    loader_trace_end("ICD interface negotiation", filename, trace_start);
+    if (!negotiated) {
         loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
                    "loader_scanned_icd_add: ICD %s doesn't support interface"
                    " version compatible with loader, skip this ICD.",
@@ -1657,12 +1815,26 @@ static void loader_debug_init(void) {
     }
 
     loader_free_getenv(orig, NULL);
+
+    // Startup trace output
+    char *trace_path = loader_getenv("VK_LOADER_TRACE", NULL);
+    if (trace_path && *trace_path) {
+        g_loader_trace_file = fopen(trace_path, "w");
+        if (g_loader_trace_file) {
+            fputs("[\n", g_loader_trace_file);
+        } else {
+            loader_log(NULL, VK_DEBUG_REPORT_WARNING_BIT_EXT, 0, "loader_debug_init: Failed to open VK_LOADER_TRACE file %s",
+                       trace_path);
+        }
+    }
+    loader_free_getenv(trace_path, NULL);
 }
 
 void loader_initialize(void) {
     // initialize mutexs
     loader_platform_thread_create_mutex(&loader_lock);
     loader_platform_thread_create_mutex(&loader_json_lock);
+    loader_platform_thread_create_mutex(&loader_trace_lock);
 
     // initialize logging
     loader_debug_init();
@@ -1748,6 +1920,7 @@ static VkResult loader_get_json(const struct loader_instance *inst, const char *
     char *json_buf;
     size_t len;
     VkResult res = VK_SUCCESS;
+    uint64_t trace_start = loader_trace_begin();
 
     if (NULL == json) {
         loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0, "loader_get_json: Received invalid JSON file");
@@ -1799,6 +1972,7 @@ out:
         fclose(file);
     }
 
+    loader_trace_end("JSON parse", filename, trace_start);
     return res;
 }
 
@@ -2005,19 +2179,19 @@ static bool verify_meta_layer_comp_layers(const struct loader_instance *inst, st
                 loader_log(inst, VK_DEBUG_REPORT_DEBUG_BIT_EXT, 0, "Meta-layer %s component layer %s adding instance extension %s",
                            prop->info.layerName, prop->component_layer_names[comp_layer],
                            comp_prop->instance_extension_list.list[ext].extensionName);
-                if (!has_vk_extension_property(&comp_prop->instance_extension_list.list[ext], &prop->instance_extension_list)) {
-                    loader_add_to_ext_list(inst, &prop->instance_extension_list, 1, &comp_prop->instance_extension_list.list[ext]);
-                }
+            }
+            if (comp_prop->instance_extension_list.count > 0) {
+                loader_add_to_ext_list(inst, &prop->instance_extension_list, comp_prop->instance_extension_list.count,
+                                       comp_prop->instance_extension_list.list);
             }
 
             for (uint32_t ext = 0; ext < comp_prop->device_extension_list.count; ext++) {
                 loader_log(inst, VK_DEBUG_REPORT_DEBUG_BIT_EXT, 0, "Meta-layer %s component layer %s adding device extension %s",
                            prop->info.layerName, prop->component_layer_names[comp_layer],
                            comp_prop->device_extension_list.list[ext].props.extensionName);
-                if (!has_vk_dev_ext_property(&comp_prop->device_extension_list.list[ext].props, &prop->device_extension_list)) {
-                    loader_add_to_dev_ext_list(inst, &prop->device_extension_list,
-                                               &comp_prop->device_extension_list.list[ext].props, 0, NULL);
-                }
+                // Duplicates are skipped by loader_add_to_dev_ext_list
+                loader_add_to_dev_ext_list(inst, &prop->device_extension_list, &comp_prop->device_extension_list.list[ext].props, 0,
+                                           NULL);
             }
         }
     }
@@ -2628,6 +2802,7 @@ static VkResult loader_get_manifest_files(const struct loader_instance *inst, co
     bool list_is_dirs = false;
     struct dirent *dent;
     VkResult res = VK_SUCCESS;
+    uint64_t trace_start = loader_trace_begin();
 
     out_files->count = 0;
     out_files->filename_list = NULL;
@@ -3002,6 +3177,7 @@ out:
     if (NULL != reg && reg != orig_loc) {
         loader_instance_heap_free(inst, reg);
     }
+    loader_trace_end(is_layer ? "layer manifest discovery" : "ICD manifest discovery", location, trace_start);
     return res;
 }
 
@@ -3962,7 +4138,10 @@ struct loader_instance *loader_get_instance(const VkInstance instance) {
 
 static loader_platform_dl_handle loader_open_layer_lib(const struct loader_instance *inst, const char *chain_type,
                                                        struct loader_layer_properties *prop) {
-    if ((prop->lib_handle = loader_platform_open_library(prop->lib_name)) == NULL) {
+    uint64_t trace_start = loader_trace_begin();
+    prop->lib_handle = loader_platform_open_library(prop->lib_name);
+    loader_trace_end("layer dlopen", prop->lib_name, trace_start);
+    if (prop->lib_handle == NULL) {
         loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0, loader_platform_open_library_error(prop->lib_name));
     } else {
         loader_log(inst, VK_DEBUG_REPORT_DEBUG_BIT_EXT, 0, "Loading layer library %s", prop->lib_name);
@@ -4173,7 +4352,10 @@ VkResult loader_create_instance_chain(const VkInstanceCreateInfo *pCreateInfo, c
 
                     VkNegotiateLayerInterface interface_struct;
 
-                    if (loader_get_layer_interface_version(negotiate_interface, &interface_struct)) {
+                    uint64_t trace_start = loader_trace_begin();
+                    bool negotiated = loader_get_layer_interface_version(negotiate_interface, &interface_struct);
+                    loader_trace_end("layer interface negotiation", layer_prop->info.layerName, trace_start);
+                    if (negotiated) {
                         // Go ahead and set the properties version to the
                         // correct value.
                         layer_prop->interface_version = interface_struct.loaderLayerInterfaceVersion;
@@ -4368,7 +4550,10 @@ VkResult loader_create_device_chain(const struct loader_physical_device_tramp *p
 
                     VkNegotiateLayerInterface interface_struct;
 
-                    if (loader_get_layer_interface_version(negotiate_interface, &interface_struct)) {
+                    uint64_t trace_start = loader_trace_begin();
+                    bool negotiated = loader_get_layer_interface_version(negotiate_interface, &interface_struct);
+                    loader_trace_end("layer interface negotiation", layer_prop->info.layerName, trace_start);
+                    if (negotiated) {
                         // Go ahead and set the properties version to the correct value.
                         layer_prop->interface_version = interface_struct.loaderLayerInterfaceVersion;
 
@@ -4487,6 +4672,20 @@ VkResult loader_validate_layers(const struct loader_instance *inst, const uint32
     return VK_SUCCESS;
 }
 
+// Build a set of the names in icd_exts for validating name_count enabled extension names against, if there are enough of
+// both for it to be worth it. Returns false if the caller should search icd_exts directly.
+static bool loader_init_icd_ext_name_set(const struct loader_instance *inst, const struct loader_extension_list *icd_exts,
+                                         uint32_t name_count, struct loader_ext_name_set *icd_ext_names) {
+    if ((uint64_t)name_count * icd_exts->count < LOADER_EXT_NAME_SET_MIN_COMPARES ||
+        !loader_init_ext_name_set(inst, icd_ext_names, icd_exts->count)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < icd_exts->count; i++) {
+        loader_ext_name_set_insert(icd_ext_names, icd_exts->list[i].extensionName);
+    }
+    return true;
+}
+
 VkResult loader_validate_instance_extensions(const struct loader_instance *inst, const struct loader_extension_list *icd_exts,
                                              const struct loader_layer_list *instance_layers,
                                              const VkInstanceCreateInfo *pCreateInfo) {
@@ -4494,6 +4693,18 @@ VkResult loader_validate_instance_extensions(const struct loader_instance *inst,
     struct loader_layer_properties *layer_prop;
     char *env_value;
     bool check_if_known = true;
+    struct loader_ext_name_set icd_ext_names = {0};
+    bool use_name_set;
+    VkResult res = VK_SUCCESS;
+
+    // Check if a user wants to disable the instance extension filtering behavior
+    env_value = loader_getenv("VK_LOADER_DISABLE_INST_EXT_FILTER", inst);
+    if (NULL != env_value && atoi(env_value) != 0) {
+        check_if_known = false;
+    }
+    loader_free_getenv(env_value, inst);
+
+    use_name_set = loader_init_icd_ext_name_set(inst, icd_exts, pCreateInfo->enabledExtensionCount, &icd_ext_names);
 
     for (uint32_t i = 0; i < pCreateInfo->enabledExtensionCount; i++) {
         VkStringErrorFlags result = vk_string_validate(MaxLoaderStringLength, pCreateInfo->ppEnabledExtensionNames[i]);
@@ -4501,15 +4712,9 @@ VkResult loader_validate_instance_extensions(const struct loader_instance *inst,
             loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
                        "loader_validate_instance_extensions: Instance ppEnabledExtensionNames contains "
                        "string that is too long or is badly formed");
-            return VK_ERROR_EXTENSION_NOT_PRESENT;
-        }
-
-        // Check if a user wants to disable the instance extension filtering behavior
-        env_value = loader_getenv("VK_LOADER_DISABLE_INST_EXT_FILTER", inst);
-        if (NULL != env_value && atoi(env_value) != 0) {
-            check_if_known = false;
+            res = VK_ERROR_EXTENSION_NOT_PRESENT;
+            goto out;
         }
-        loader_free_getenv(env_value, inst);
 
         if (check_if_known) {
             // See if the extension is in the list of supported extensions
@@ -4526,13 +4731,13 @@ VkResult loader_validate_instance_extensions(const struct loader_instance *inst,
                 loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
                            "loader_validate_instance_extensions: Extension %s not found in list of known instance extensions.",
                            pCreateInfo->ppEnabledExtensionNames[i]);
-                return VK_ERROR_EXTENSION_NOT_PRESENT;
+                res = VK_ERROR_EXTENSION_NOT_PRESENT;
+                goto out;
             }
         }
 
-        extension_prop = get_extension_property(pCreateInfo->ppEnabledExtensionNames[i], icd_exts);
-
-        if (extension_prop) {
+        if (use_name_set ? loader_ext_name_set_contains(&icd_ext_names, pCreateInfo->ppEnabledExtensionNames[i])
+                         : get_extension_property(pCreateInfo->ppEnabledExtensionNames[i], icd_exts) != NULL) {
             continue;
         }
 
@@ -4559,10 +4764,14 @@ VkResult loader_validate_instance_extensions(const struct loader_instance *inst,
                        "loader_validate_instance_extensions: Instance extension %s not supported by available ICDs or enabled "
                        "layers.",
                        pCreateInfo->ppEnabledExtensionNames[i]);
-            return VK_ERROR_EXTENSION_NOT_PRESENT;
+            res = VK_ERROR_EXTENSION_NOT_PRESENT;
+            goto out;
         }
     }
-    return VK_SUCCESS;
+
+out:
+    loader_destroy_ext_name_set(inst, &icd_ext_names);
+    return res;
 }
 
 VkResult loader_validate_device_extensions(struct loader_physical_device_tramp *phys_dev,
@@ -4570,6 +4779,12 @@ VkResult loader_validate_device_extensions(struct loader_physical_device_tramp *
                                            const struct loader_extension_list *icd_exts, const VkDeviceCreateInfo *pCreateInfo) {
     VkExtensionProperties *extension_prop;
     struct loader_layer_properties *layer_prop;
+    struct loader_ext_name_set icd_ext_names = {0};
+    bool use_name_set;
+    VkResult res = VK_SUCCESS;
+
+    use_name_set =
+        loader_init_icd_ext_name_set(phys_dev->this_instance, icd_exts, pCreateInfo->enabledExtensionCount, &icd_ext_names);
 
     for (uint32_t i = 0; i < pCreateInfo->enabledExtensionCount; i++) {
         VkStringErrorFlags result = vk_string_validate(MaxLoaderStringLength, pCreateInfo->ppEnabledExtensionNames[i]);
@@ -4577,16 +4792,18 @@ VkResult loader_validate_device_extensions(struct loader_physical_device_tramp *
             loader_log(phys_dev->this_instance, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
                        "loader_validate_device_extensions: Device ppEnabledExtensionNames contains "
                        "string that is too long or is badly formed");
-            return VK_ERROR_EXTENSION_NOT_PRESENT;
+            res = VK_ERROR_EXTENSION_NOT_PRESENT;
+            goto out;
         }
 
         const char *extension_name = pCreateInfo->ppEnabledExtensionNames[i];
-        extension_prop = get_extension_property(extension_name, icd_exts);
-
-        if (extension_prop) {
+        if (use_name_set ? loader_ext_name_set_contains(&icd_ext_names, extension_name)
+                         : get_extension_property(extension_name, icd_exts) != NULL) {
             continue;
         }
 
+        extension_prop = NULL;
+
         // Not in global list, search activated layer extension lists
         for (uint32_t j = 0; j < activated_device_layers->count; j++) {
             layer_prop = &activated_device_layers->list[j];
@@ -4604,10 +4821,14 @@ VkResult loader_validate_device_extensions(struct loader_physical_device_tramp *
                        "loader_validate_device_extensions: Device extension %s not supported by selected physical device "
                        "or enabled layers.",
                        pCreateInfo->ppEnabledExtensionNames[i]);
-            return VK_ERROR_EXTENSION_NOT_PRESENT;
+            res = VK_ERROR_EXTENSION_NOT_PRESENT;
+            goto out;
         }
     }
-    return VK_SUCCESS;
+
+out:
+    loader_destroy_ext_name_set(phys_dev->this_instance, &icd_ext_names);
+    return res;
 }
 
 // Terminator functions for the Instance chain
@@ -5438,14 +5659,27 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_EnumerateDeviceExtensionProperties(VkP
         loader_add_implicit_layers(icd_term->this_instance, &implicit_layer_list, NULL,
                                    &icd_term->this_instance->instance_layer_list);
 
+        // Gather the implicit layers' device extensions so that they can be merged in one go
+        uint32_t layer_ext_count = 0;
         for (uint32_t i = 0; i < implicit_layer_list.count; i++) {
-            for (uint32_t j = 0; j < implicit_layer_list.list[i].device_extension_list.count; j++) {
-                res = loader_add_to_ext_list(icd_term->this_instance, &all_exts, 1,
-                                             &implicit_layer_list.list[i].device_extension_list.list[j].props);
-                if (res != VK_SUCCESS) {
-                    goto out;
+            layer_ext_count += implicit_layer_list.list[i].device_extension_list.count;
+        }
+        if (layer_ext_count > 0) {
+            VkExtensionProperties *layer_exts = loader_stack_alloc(layer_ext_count * sizeof(VkExtensionProperties));
+            if (layer_exts == NULL) {
+                res = VK_ERROR_OUT_OF_HOST_MEMORY;
+                goto out;
+            }
+            layer_ext_count = 0;
+            for (uint32_t i = 0; i < implicit_layer_list.count; i++) {
+                for (uint32_t j = 0; j < implicit_layer_list.list[i].device_extension_list.count; j++) {
+                    layer_exts[layer_ext_count++] = implicit_layer_list.list[i].device_extension_list.list[j].props;
                 }
             }
+            res = loader_add_to_ext_list(icd_term->this_instance, &all_exts, layer_ext_count, layer_exts);
+            if (res != VK_SUCCESS) {
+                goto out;
+            }
         }
         uint32_t capacity = *pPropertyCount;
         VkExtensionProperties *props = pProperties;
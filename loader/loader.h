@@ -398,6 +398,11 @@ void *loader_device_heap_realloc(const struct loader_device *device, void *pMemo
 
 void loader_log(const struct loader_instance *inst, VkFlags msg_type, int32_t msg_code, const char *format, ...);
 
+// Startup tracing, enabled by pointing VK_LOADER_TRACE at an output file. loader_trace_begin returns a start time
+// (0 when tracing is off) to pass to loader_trace_end, which records the phase as a Chrome trace event.
+uint64_t loader_trace_begin(void);
+void loader_trace_end(const char *phase, const char *detail, uint64_t start);
+
 bool compare_vk_extension_properties(const VkExtensionProperties *op1, const VkExtensionProperties *op2);
 
 VkResult loader_validate_layers(const struct loader_instance *inst, const uint32_t layer_count,
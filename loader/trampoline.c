@@ -226,6 +226,8 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance(const VkInstanceCr
     VkResult res = VK_ERROR_INITIALIZATION_FAILED;
 
     loader_platform_thread_once(&once_init, loader_initialize);
+    uint64_t create_start = loader_trace_begin();
+    uint64_t trace_start;
 
     // Fail if the requested Vulkan apiVersion is > 1.0 since the loader only supports 1.0.
     // Having pCreateInfo == NULL, pCreateInfo->pApplication == NULL, or
@@ -295,7 +297,9 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance(const VkInstanceCr
     // enabledLayerCount == 0 and VK_INSTANCE_LAYERS is unset. For now always
     // get layer list via loader_layer_scan().
     memset(&ptr_instance->instance_layer_list, 0, sizeof(ptr_instance->instance_layer_list));
+    trace_start = loader_trace_begin();
     loader_layer_scan(ptr_instance, &ptr_instance->instance_layer_list);
+    loader_trace_end("layer scan", NULL, trace_start);
 
     // Validate the app requested layers to be enabled
     if (pCreateInfo->enabledLayerCount > 0) {
@@ -308,7 +312,9 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance(const VkInstanceCr
 
     // Scan/discover all ICD libraries
     memset(&ptr_instance->icd_tramp_list, 0, sizeof(ptr_instance->icd_tramp_list));
+    trace_start = loader_trace_begin();
     res = loader_icd_scan(ptr_instance, &ptr_instance->icd_tramp_list);
+    loader_trace_end("ICD scan", NULL, trace_start);
     if (res != VK_SUCCESS) {
         goto out;
     }
@@ -343,7 +349,9 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance(const VkInstanceCr
     }
 
     created_instance = (VkInstance)ptr_instance;
+    trace_start = loader_trace_begin();
     res = loader_create_instance_chain(&ici, pAllocator, ptr_instance, &created_instance);
+    loader_trace_end("instance chain build", NULL, trace_start);
 
     if (res == VK_SUCCESS) {
         memset(ptr_instance->enabled_known_extensions.padding, 0, sizeof(uint64_t) * 4);
@@ -400,6 +408,7 @@ out:
         }
     }
 
+    loader_trace_end("vkCreateInstance", NULL, create_start);
     return res;
 }
 
@@ -654,7 +663,9 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateDevice(VkPhysicalDevice phy
         dev->expanded_activated_layer_list.list = NULL;
     }
 
+    uint64_t trace_start = loader_trace_begin();
     res = loader_create_device_chain(phys_dev, pCreateInfo, pAllocator, inst, dev);
+    loader_trace_end("device chain build", NULL, trace_start);
     if (res != VK_SUCCESS) {
         loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0, "vkCreateDevice:  Failed to create device chain.");
         goto out;
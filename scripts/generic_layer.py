@@ -60,6 +60,8 @@ from generator import *
 #     parameter on a separate line
 #   alignFuncParam - if nonzero and parameters are being put on a
 #     separate line, align parameter names at the specified column
+#   helper_file_type - which file to generate, for generators that
+#     produce more than one
 class GenericGeneratorOptions(GeneratorOptions):
     def __init__(self,
                  filename = None,
@@ -100,6 +102,7 @@ class GenericGeneratorOptions(GeneratorOptions):
         self.indentFuncProto = indentFuncProto
         self.indentFuncPointer = indentFuncPointer
         self.alignFuncParam  = alignFuncParam
+        self.helper_file_type = helper_file_type
 
 # GenericOutputGenerator - subclass of OutputGenerator.
 # Generates a generic layer that intercepts all API entrypoints
@@ -199,8 +202,8 @@ class GenericOutputGenerator(OutputGenerator):
             write('    // TODO : Extend struct w/ further custom data', file=self.outFile)
             write('};', file=self.outFile)
     
-            write('static unordered_map<void *, device_layer_data *> device_layer_data_map;', file=self.outFile)
-            write('static unordered_map<void *, instance_layer_data *> instance_layer_data_map;', file=self.outFile)
+            write('static LayerDataMap<device_layer_data> device_layer_data_map;', file=self.outFile)
+            write('static LayerDataMap<instance_layer_data> instance_layer_data_map;', file=self.outFile)
 
     def endFile(self):
         # C-specific
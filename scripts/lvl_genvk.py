@@ -26,6 +26,7 @@ from dispatch_table_helper_generator import DispatchTableHelperOutputGenerator,
 from helper_file_generator import HelperFileOutputGenerator, HelperFileOutputGeneratorOptions
 from loader_extension_generator import LoaderExtensionOutputGenerator, LoaderExtensionGeneratorOptions
 from generic_layer import GenericGeneratorOptions, GenericOutputGenerator
+from timing_generator import TimingOutputGenerator
 
 # Simple timer functions
 startTime = None
@@ -446,6 +447,50 @@ def makeGenOpts(extensions = [], removeExtensions = [], protect = True, director
             helper_file_type  = 'generic_layer_source')
         ]
 
+    # Options for timing layer function table
+    genOpts['timing_layer.h'] = [
+          TimingOutputGenerator,
+          GenericGeneratorOptions(
+            filename          = 'timing_layer.h',
+            directory         = directory,
+            apiname           = 'vulkan',
+            profile           = None,
+            versions          = allVersions,
+            emitversions      = allVersions,
+            defaultExtensions = 'vulkan',
+            addExtensions     = addExtensions,
+            removeExtensions  = removeExtensions,
+            prefixText        = prefixStrings + vkPrefixStrings,
+            protectFeature    = False,
+            apicall           = 'VKAPI_ATTR ',
+            apientry          = 'VKAPI_CALL ',
+            apientryp         = 'VKAPI_PTR *',
+            alignFuncParam    = 48,
+            helper_file_type  = 'timing_layer_header')
+        ]
+
+    # Options for timing layer intercepts
+    genOpts['timing_wrappers.h'] = [
+          TimingOutputGenerator,
+          GenericGeneratorOptions(
+            filename          = 'timing_wrappers.h',
+            directory         = directory,
+            apiname           = 'vulkan',
+            profile           = None,
+            versions          = allVersions,
+            emitversions      = allVersions,
+            defaultExtensions = 'vulkan',
+            addExtensions     = addExtensions,
+            removeExtensions  = removeExtensions,
+            prefixText        = prefixStrings + vkPrefixStrings,
+            protectFeature    = False,
+            apicall           = 'VKAPI_ATTR ',
+            apientry          = 'VKAPI_CALL ',
+            apientryp         = 'VKAPI_PTR *',
+            alignFuncParam    = 48,
+            helper_file_type  = 'timing_wrappers_header')
+        ]
+
 
 # Generate a target based on the options in the matching genOpts{} object.
 # This is encapsulated in a function so it can be profiled and/or timed.
@@ -162,6 +162,10 @@ class ParamCheckerOutputGenerator(OutputGenerator):
         self.extension_type = ''                          # Type of active feature (extension), device or instance
         self.extension_names = dict()                     # Dictionary of extension names to extension name defines
         self.valid_vuids = set()                          # Set of all valid VUIDs
+        self.maxParameterNameIndices = 4                  # Must match ParameterName::kMaxIndices in parameter_name.h
+        self.stypeValues = dict()                         # Map of VkStructureType name to numeric value, kept across features
+        self.registryStructTypes = dict()                 # Map of every registry struct typename to its VkStructureType
+        self.maxAllowedPNextStructs = 64                  # Must match the width of the seen-type mask in validate_struct_pnext
         # Named tuples to store struct and command data
         self.StructType = namedtuple('StructType', ['name', 'value'])
         self.CommandParam = namedtuple('CommandParam', ['type', 'name', 'ispointer', 'isstaticarray', 'isbool', 'israngedenum',
@@ -219,6 +223,12 @@ class ParamCheckerOutputGenerator(OutputGenerator):
                 if len(vuid_num) == 8 and all(c in string.hexdigits for c in vuid_num):
                     self.valid_vuids.add(vuid_num)
         #
+        # Record the sType of every struct in the registry, so that pNext checks can name structs from other features
+        for struct in self.registry.tree.findall('types/type'):
+            for member in struct.findall('member'):
+                if member.findtext('name') == 'sType' and member.get('values'):
+                    self.registryStructTypes[struct.get('name')] = member.get('values')
+        #
         # User-supplied prefix text, if any (list of strings)
         if (genOpts.prefixText):
             for s in genOpts.prefixText:
@@ -438,6 +448,7 @@ class ParamCheckerOutputGenerator(OutputGenerator):
         if groupName == 'VkStructureType':
             for elem in groupElem.findall('enum'):
                 self.stypes.append(elem.get('name'))
+                self.stypeValues[elem.get('name')] = self.enumToValue(elem, True)[0]
         elif 'FlagBits' in groupName:
             bits = []
             for elem in groupElem.findall('enum'):
@@ -579,12 +590,14 @@ class ParamCheckerOutputGenerator(OutputGenerator):
         # Add STRUCTURE_TYPE_
         return re.sub('VK_', 'VK_STRUCTURE_TYPE_', value)
     #
-    # Get the cached VkStructureType value for the specified struct typename, or generate a VkStructureType
-    # value assuming the struct is defined by a different feature
+    # Get the cached VkStructureType value for the specified struct typename, falling back to the registry for structs
+    # defined by a different feature, or generate a VkStructureType value if the registry does not name one
     def getStructType(self, typename):
         value = None
         if typename in self.structTypes:
             value = self.structTypes[typename].value
+        elif typename in self.registryStructTypes:
+            value = self.registryStructTypes[typename]
         else:
             value = self.genVkStructureType(typename)
             self.logMsg('diag', 'ParameterValidation: Generating {} for {} structure type that was not defined by the current feature'.format(value, typename))
@@ -794,7 +807,15 @@ class ParamCheckerOutputGenerator(OutputGenerator):
         vuid = self.GetVuid("VUID-%s-pNext-pNext" % struct_type_name)
         if value.extstructs:
             structs = value.extstructs.split(',')
-            checkExpr.append('const VkStructureType allowedStructs[] = {' + ', '.join([self.getStructType(s) for s in structs]) + '};\n')
+            if len(structs) > self.maxAllowedPNextStructs:
+                raise Exception('Unsupported parameter validation case: {} allows more than {} pNext structures'.format(struct_type_name, self.maxAllowedPNextStructs))
+            # validate_struct_pnext binary searches this table, so emit it sorted by enumerant value
+            stypes = [self.getStructType(s) for s in structs]
+            for stype in stypes:
+                if stype not in self.stypeValues:
+                    raise Exception('Unknown VkStructureType {} in the pNext structures for {}'.format(stype, struct_type_name))
+            stypes.sort(key=lambda stype: self.stypeValues[stype])
+            checkExpr.append('static const VkStructureType allowedStructs[] = {' + ', '.join(stypes) + '};\n')
             extStructCount = 'ARRAY_SIZE(allowedStructs)'
             extStructVar = 'allowedStructs'
             extStructNames = '"' + ', '.join(structs) + '"'
@@ -887,7 +908,12 @@ class ParamCheckerOutputGenerator(OutputGenerator):
             if 'IndexVector' in line:
                 line = line.replace('IndexVector{ ', 'IndexVector{{ ')
                 line = line.replace(' }),', ' }}),')
-            return line.format(**kwargs)
+            line = line.format(**kwargs)
+            # ParameterName keeps its index values in a fixed-size array of ParameterName::kMaxIndices entries
+            for name in re.findall(r'ParameterName\("([^"]*)"', line):
+                if name.count('%i') > self.maxParameterNameIndices:
+                    raise Exception('ParameterName "{}" nests arrays deeper than ParameterName::kMaxIndices'.format(name))
+            return line
         return line
     #
     # Process struct validation code for inclusion in function or parent struct validation code
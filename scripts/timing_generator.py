@@ -0,0 +1,170 @@
+#!/usr/bin/python3 -i
+#
+# Copyright (c) 2015-2017 The Khronos Group Inc.
+# Copyright (c) 2015-2017 Valve Corporation
+# Copyright (c) 2015-2017 LunarG, Inc.
+# Copyright (c) 2015-2017 Google Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# Author: Tobin Ehlis <tobine@google.com>
+#
+# This script generates the entry point wrappers for the timing layer. It
+#  extends the generic layer generator: every instance and device command
+#  is intercepted, timed around the call down the chain, and recorded against
+#  a per-command index. Two files are produced, selected by helper_file_type:
+#    timing_layer.h    - TimedFunction enum and the matching name table
+#    timing_wrappers.h - the intercepts and the name_to_funcptr_map
+
+import os,re,sys
+from generator import *
+from generic_layer import GenericOutputGenerator
+
+# TimingOutputGenerator - subclass of GenericOutputGenerator.
+# Generates the timing layer intercepts. Options are GenericGeneratorOptions,
+# with helper_file_type set to 'timing_layer_header' or 'timing_wrappers_header'.
+#
+# ---- methods ----
+# TimingOutputGenerator(errFile, warnFile, diagFile) - args as for
+#   OutputGenerator. Defines additional internal state.
+# ---- methods overriding base class ----
+# beginFile(genOpts)
+# endFile()
+# endFeature()
+# genStruct(typeinfo,name)
+# genCmd(cmdinfo)
+class TimingOutputGenerator(GenericOutputGenerator):
+    """Generate timing layer intercepts for all API entrypoints"""
+    # Commands implemented by hand in timing.cpp. They still get a TimedFunction
+    # index so the manual bodies can time their call down the chain.
+    manual_functions = [
+        'vkGetDeviceProcAddr',
+        'vkGetInstanceProcAddr',
+        'vkCreateDevice',
+        'vkDestroyDevice',
+        'vkCreateInstance',
+        'vkDestroyInstance',
+        'vkEnumerateInstanceLayerProperties',
+        'vkEnumerateInstanceExtensionProperties',
+        'vkEnumerateDeviceLayerProperties',
+        'vkEnumerateDeviceExtensionProperties',
+    ]
+    def __init__(self,
+                 errFile = sys.stderr,
+                 warnFile = sys.stderr,
+                 diagFile = sys.stdout):
+        GenericOutputGenerator.__init__(self, errFile, warnFile, diagFile)
+        self.timed_functions = []
+
+    def beginFile(self, genOpts):
+        OutputGenerator.beginFile(self, genOpts)
+        self.header = (genOpts.helper_file_type == 'timing_layer_header')
+        # Multiple inclusion protection & C++ namespace.
+        if (genOpts.protectFile and self.genOpts.filename):
+            headerSym = '__' + re.sub('\.h', '_h_', os.path.basename(self.genOpts.filename))
+            write('#ifndef', headerSym, file=self.outFile)
+            write('#define', headerSym, '1', file=self.outFile)
+            self.newline()
+        #
+        # User-supplied prefix text, if any (list of strings)
+        if (genOpts.prefixText):
+            for s in genOpts.prefixText:
+                write(s, file=self.outFile)
+        write('namespace timing {', file=self.outFile)
+        self.newline()
+
+    def endFile(self):
+        if self.header:
+            # One index per command, independent of platform defines, so that the
+            # layout of the per-thread statistics blocks is the same everywhere.
+            write('// Index of every command the timing layer can record', file=self.outFile)
+            write('enum TimedFunction {', file=self.outFile)
+            for name in self.timed_functions:
+                write('    TIMED_%s,' % name, file=self.outFile)
+            write('    TIMED_FUNCTION_COUNT', file=self.outFile)
+            write('};\n', file=self.outFile)
+            write('// Command names, indexed by TimedFunction', file=self.outFile)
+            write('static const char *const timed_function_names[TIMED_FUNCTION_COUNT] = {', file=self.outFile)
+            for name in self.timed_functions:
+                write('    "%s",' % name, file=self.outFile)
+            write('};', file=self.outFile)
+        else:
+            self.newline()
+            # record intercepted procedures
+            write('// Map of all APIs to be intercepted by this layer', file=self.outFile)
+            write('static const std::unordered_map<std::string, void*> name_to_funcptr_map = {', file=self.outFile)
+            write('\n'.join(self.intercepts), file=self.outFile)
+            write('};\n', file=self.outFile)
+        self.newline()
+        write('} // namespace timing', file=self.outFile)
+        if (self.genOpts.protectFile and self.genOpts.filename):
+            self.newline()
+            write('#endif', file=self.outFile)
+        # Finish processing in superclass
+        OutputGenerator.endFile(self)
+    def endFeature(self):
+        # Features without intercepts (and every feature of the enum header)
+        # are skipped rather than written as empty #ifdef blocks
+        if self.sections['command']:
+            GenericOutputGenerator.endFeature(self)
+        else:
+            OutputGenerator.endFeature(self)
+    #
+    # The generic layer writes out struct definitions; this one doesn't need them
+    def genStruct(self, typeinfo, typeName):
+        OutputGenerator.genStruct(self, typeinfo, typeName)
+    #
+    # Command generation
+    def genCmd(self, cmdinfo, name):
+        OutputGenerator.genCmd(self, cmdinfo, name)
+        if self.header:
+            self.timed_functions.append(name)
+            return
+
+        # record that the function will be intercepted
+        if (self.featureExtraProtect != None):
+            self.intercepts += [ '#ifdef %s' % self.featureExtraProtect ]
+        self.intercepts += [ '    {"%s", (void*)%s},' % (name,name[2:]) ]
+        if (self.featureExtraProtect != None):
+            self.intercepts += [ '#endif' ]
+
+        decls = self.makeCDecls(cmdinfo.elem)
+        if name in self.manual_functions:
+            self.appendSection('command', '')
+            self.appendSection('command', '// declare only')
+            self.appendSection('command', decls[0])
+            return
+
+        self.appendSection('command', '')
+        self.appendSection('command', decls[0][:-1])
+        self.appendSection('command', '{')
+        # first parameter is always dispatchable
+        dispatchable_type = cmdinfo.elem.find('param/type').text
+        dispatchable_name = cmdinfo.elem.find('param/name').text
+        self.appendSection('command', '    layer_data *my_data = GetLayerDataPtr(get_dispatch_key(%s), layer_data_map);' % dispatchable_name)
+        if dispatchable_type in ["VkPhysicalDevice", "VkInstance"]:
+            self.appendSection('command', '    VkLayerInstanceDispatchTable *pTable = my_data->instance_dispatch_table;')
+        else:
+            self.appendSection('command', '    VkLayerDispatchTable *pTable = my_data->device_dispatch_table;')
+        self.appendSection('command', '    TimedCall timed_call(TIMED_%s);' % name)
+        resulttype = cmdinfo.elem.find('proto/type')
+        if (resulttype != None and resulttype.text == 'void'):
+          resulttype = None
+        params = cmdinfo.elem.findall('param/name')
+        paramstext = ','.join([str(param.text) for param in params])
+        API = name.replace('vk','pTable->',1)
+        if (resulttype != None):
+            self.appendSection('command', '    return ' + API + '(' + paramstext + ');')
+        else:
+            self.appendSection('command', '    ' + API + '(' + paramstext + ');')
+        self.appendSection('command', '}')
@@ -9,6 +9,20 @@ set -e
 #Verify that the loader is working
 ./run_loader_tests.sh
 
+# Verify the format trait tables used by the validation layers
+./vk_format_utils_tests
+
+# Verify the open-addressing map behind the validation layers' state tables
+./vk_layer_flat_map_tests
+
+# Verify how vkGetLayerStateStatsLUNARG fills in the stats of a chain of layers
+./vk_layer_state_stats_tests
+
+# Verify core_validation's page-protected guard for mapped non-coherent memory, which is only built on Linux
+if [ "$(uname)" = "Linux" ]; then
+    ./vk_memory_guard_tests
+fi
+
 # Verify that validation checks in source match documentation
 ./vkvalidatelayerdoc.sh terse_mode
 
@@ -0,0 +1,1204 @@
+/*
+ * Copyright (c) 2015-2017 The Khronos Group Inc.
+ * Copyright (c) 2015-2017 Valve Corporation
+ * Copyright (c) 2015-2017 LunarG, Inc.
+ * Copyright (C) 2015-2017 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Measures how much CPU time the validation layers spend on the calls that applications make most often.
+//
+//   vk_layer_benchmarks [--layer <name>]... [--no-layers] [--scale <n>] [--verbose] [<benchmark>...]
+//
+// Runs the named benchmarks, or all of them, on the first physical device of whatever ICD the loader finds. The layers
+// under test default to VK_LAYER_LUNARG_core_validation; --no-layers times the driver alone, so that its share can be
+// subtracted. --scale multiplies the number of iterations. No GPU work is waited on, so results mostly reflect the CPU
+// side of the layers and the driver.
+//
+// Each benchmark also reports how many errors and warnings the layers issued while it ran. These should be zero: a
+// benchmark that trips validation isn't timing the path it was written for.
+//
+// A few benchmarks also time helpers from the layers directly, such as FlatHashMap against the std::unordered_map it
+// replaced; those parts don't go through the loader and ignore --layer.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+#include "vk_layer_flat_map.h"
+#include "parameter_name.h"
+
+namespace {
+// Counts calls to the global operator new. Where the layers share the program's C++ runtime (Linux), their allocations
+// are counted as well.
+std::atomic<uint64_t> allocation_count(0);
+}  // namespace
+
+// Kept out of line: once GCC inlines them it pairs the malloc and free inside with the new and delete expressions in the
+// standard library, and warns that they don't match.
+#if defined(__GNUC__)
+#define BENCHMARK_NOINLINE __attribute__((noinline))
+#else
+#define BENCHMARK_NOINLINE
+#endif
+
+BENCHMARK_NOINLINE void *operator new(size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    void *pointer = malloc(size ? size : 1);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+BENCHMARK_NOINLINE void operator delete(void *pointer) throw() { free(pointer); }
+
+namespace {
+
+bool verbose = false;
+uint32_t error_count = 0;
+uint32_t warning_count = 0;
+// Results of the container benchmarks land here, so that the work can't be optimized away
+volatile uint64_t benchmark_sink = 0;
+
+VKAPI_ATTR VkBool32 VKAPI_CALL CountMessages(VkDebugReportFlagsEXT flags, VkDebugReportObjectTypeEXT, uint64_t, size_t, int32_t,
+                                             const char *layer_prefix, const char *message, void *) {
+    if (flags & VK_DEBUG_REPORT_ERROR_BIT_EXT) error_count++;
+    if (flags & (VK_DEBUG_REPORT_WARNING_BIT_EXT | VK_DEBUG_REPORT_PERFORMANCE_WARNING_BIT_EXT)) warning_count++;
+    if (verbose) fprintf(stderr, "%s: %s\n", layer_prefix, message);
+    return VK_FALSE;
+}
+
+// An instance with the layers under test enabled, and the first physical device it finds
+class BenchmarkInstance {
+   public:
+    BenchmarkInstance() : instance(VK_NULL_HANDLE), gpu(VK_NULL_HANDLE), callback_(VK_NULL_HANDLE) {}
+    ~BenchmarkInstance() {
+        if (callback_) {
+            auto destroy_callback = reinterpret_cast<PFN_vkDestroyDebugReportCallbackEXT>(
+                vkGetInstanceProcAddr(instance, "vkDestroyDebugReportCallbackEXT"));
+            destroy_callback(instance, callback_, nullptr);
+        }
+        if (instance) vkDestroyInstance(instance, nullptr);
+    }
+
+    bool Init(const std::vector<const char *> &layers) {
+        const char *extensions[] = {VK_EXT_DEBUG_REPORT_EXTENSION_NAME};
+        VkApplicationInfo app_info = {VK_STRUCTURE_TYPE_APPLICATION_INFO};
+        app_info.pApplicationName = "vk_layer_benchmarks";
+        app_info.apiVersion = VK_API_VERSION_1_0;
+        VkInstanceCreateInfo instance_info = {VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+        instance_info.pApplicationInfo = &app_info;
+        instance_info.enabledLayerCount = static_cast<uint32_t>(layers.size());
+        instance_info.ppEnabledLayerNames = layers.data();
+        instance_info.enabledExtensionCount = 1;
+        instance_info.ppEnabledExtensionNames = extensions;
+        VkResult result = vkCreateInstance(&instance_info, nullptr, &instance);
+        if (result != VK_SUCCESS) {
+            fprintf(stderr, "vkCreateInstance failed: %d\n", result);
+            return false;
+        }
+
+        auto create_callback = reinterpret_cast<PFN_vkCreateDebugReportCallbackEXT>(
+            vkGetInstanceProcAddr(instance, "vkCreateDebugReportCallbackEXT"));
+        VkDebugReportCallbackCreateInfoEXT callback_info = {VK_STRUCTURE_TYPE_DEBUG_REPORT_CALLBACK_CREATE_INFO_EXT};
+        callback_info.flags =
+            VK_DEBUG_REPORT_ERROR_BIT_EXT | VK_DEBUG_REPORT_WARNING_BIT_EXT | VK_DEBUG_REPORT_PERFORMANCE_WARNING_BIT_EXT;
+        callback_info.pfnCallback = CountMessages;
+        if (create_callback) create_callback(instance, &callback_info, nullptr, &callback_);
+
+        uint32_t gpu_count = 1;
+        result = vkEnumeratePhysicalDevices(instance, &gpu_count, &gpu);
+        if ((result != VK_SUCCESS && result != VK_INCOMPLETE) || gpu_count == 0) {
+            fprintf(stderr, "No physical devices found\n");
+            return false;
+        }
+        return true;
+    }
+
+    VkInstance instance;
+    VkPhysicalDevice gpu;
+
+   private:
+    VkDebugReportCallbackEXT callback_;
+};
+
+// A device with one queue from the first graphics queue family and a command pool for it. Objects created through it
+// are destroyed with it.
+class BenchmarkDevice {
+   public:
+    BenchmarkDevice() : device(VK_NULL_HANDLE), queue(VK_NULL_HANDLE), queue_family(0), command_pool(VK_NULL_HANDLE) {}
+    ~BenchmarkDevice() {
+        if (!device) return;
+        vkDeviceWaitIdle(device);
+        for (auto it = cleanup_.rbegin(); it != cleanup_.rend(); ++it) (*it)();
+        vkDestroyDevice(device, nullptr);
+    }
+
+    bool Init(const BenchmarkInstance &instance, const std::vector<const char *> &extensions = std::vector<const char *>()) {
+        uint32_t family_count = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(instance.gpu, &family_count, nullptr);
+        std::vector<VkQueueFamilyProperties> families(family_count);
+        vkGetPhysicalDeviceQueueFamilyProperties(instance.gpu, &family_count, families.data());
+        while (queue_family < family_count && !(families[queue_family].queueFlags & VK_QUEUE_GRAPHICS_BIT)) queue_family++;
+        if (queue_family == family_count) {
+            fprintf(stderr, "No graphics queue family\n");
+            return false;
+        }
+
+        float priority = 1.0f;
+        VkDeviceQueueCreateInfo queue_info = {VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO};
+        queue_info.queueFamilyIndex = queue_family;
+        queue_info.queueCount = 1;
+        queue_info.pQueuePriorities = &priority;
+        VkDeviceCreateInfo device_info = {VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+        device_info.queueCreateInfoCount = 1;
+        device_info.pQueueCreateInfos = &queue_info;
+        device_info.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+        device_info.ppEnabledExtensionNames = extensions.data();
+        VkResult result = vkCreateDevice(instance.gpu, &device_info, nullptr, &device);
+        if (result != VK_SUCCESS) {
+            fprintf(stderr, "vkCreateDevice failed: %d\n", result);
+            device = VK_NULL_HANDLE;
+            return false;
+        }
+        vkGetDeviceQueue(device, queue_family, 0, &queue);
+        vkGetPhysicalDeviceMemoryProperties(instance.gpu, &memory_properties_);
+
+        VkCommandPoolCreateInfo pool_info = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+        pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        pool_info.queueFamilyIndex = queue_family;
+        vkCreateCommandPool(device, &pool_info, nullptr, &command_pool);
+        VkDevice device_handle = device;
+        VkCommandPool pool_handle = command_pool;
+        OnDestroy([=]() { vkDestroyCommandPool(device_handle, pool_handle, nullptr); });
+        return true;
+    }
+
+    // Runs cleanup when the device is destroyed, in the reverse order of the calls
+    void OnDestroy(std::function<void()> cleanup) { cleanup_.push_back(std::move(cleanup)); }
+
+    VkCommandBuffer AllocateCommandBuffer(VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY) {
+        VkCommandBufferAllocateInfo allocate_info = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+        allocate_info.commandPool = command_pool;
+        allocate_info.level = level;
+        allocate_info.commandBufferCount = 1;
+        VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+        vkAllocateCommandBuffers(device, &allocate_info, &command_buffer);
+        return command_buffer;
+    }
+
+    // A 2D image in optimal tiling, with memory of its own bound to it
+    VkImage CreateImage(VkFormat format, uint32_t width, uint32_t height, uint32_t mip_levels, uint32_t array_layers,
+                        VkImageUsageFlags usage) {
+        VkImageCreateInfo image_info = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+        image_info.imageType = VK_IMAGE_TYPE_2D;
+        image_info.format = format;
+        image_info.extent = {width, height, 1};
+        image_info.mipLevels = mip_levels;
+        image_info.arrayLayers = array_layers;
+        image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+        image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+        image_info.usage = usage;
+        image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkImage image = VK_NULL_HANDLE;
+        vkCreateImage(device, &image_info, nullptr, &image);
+        VkDevice device_handle = device;
+        OnDestroy([=]() { vkDestroyImage(device_handle, image, nullptr); });
+        VkMemoryRequirements requirements;
+        vkGetImageMemoryRequirements(device, image, &requirements);
+        vkBindImageMemory(device, image, AllocateMemory(requirements), 0);
+        return image;
+    }
+
+    // A 2D view of the first mip level and array layer of image
+    VkImageView CreateImageView(VkImage image, VkFormat format, VkImageAspectFlags aspect_mask) {
+        VkImageViewCreateInfo view_info = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+        view_info.image = image;
+        view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        view_info.format = format;
+        view_info.subresourceRange = {aspect_mask, 0, 1, 0, 1};
+        VkImageView view = VK_NULL_HANDLE;
+        vkCreateImageView(device, &view_info, nullptr, &view);
+        VkDevice device_handle = device;
+        OnDestroy([=]() { vkDestroyImageView(device_handle, view, nullptr); });
+        return view;
+    }
+
+    // A buffer with memory of its own bound to it
+    VkBuffer CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage) {
+        VkBufferCreateInfo buffer_info = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+        buffer_info.size = size;
+        buffer_info.usage = usage;
+        buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        vkCreateBuffer(device, &buffer_info, nullptr, &buffer);
+        VkDevice device_handle = device;
+        OnDestroy([=]() { vkDestroyBuffer(device_handle, buffer, nullptr); });
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(device, buffer, &requirements);
+        vkBindBufferMemory(device, buffer, AllocateMemory(requirements), 0);
+        return buffer;
+    }
+
+    VkSampler CreateSampler() {
+        VkSamplerCreateInfo sampler_info = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+        sampler_info.magFilter = VK_FILTER_NEAREST;
+        sampler_info.minFilter = VK_FILTER_NEAREST;
+        sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler_info.maxAnisotropy = 1.0f;
+        sampler_info.borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+        VkSampler sampler = VK_NULL_HANDLE;
+        vkCreateSampler(device, &sampler_info, nullptr, &sampler);
+        VkDevice device_handle = device;
+        OnDestroy([=]() { vkDestroySampler(device_handle, sampler, nullptr); });
+        return sampler;
+    }
+
+    VkDevice device;
+    VkQueue queue;
+    uint32_t queue_family;
+    VkCommandPool command_pool;
+
+   private:
+    // Memory of the first type that requirements allow, freed after what is bound to it is destroyed
+    VkDeviceMemory AllocateMemory(const VkMemoryRequirements &requirements) {
+        VkMemoryAllocateInfo allocate_info = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+        allocate_info.allocationSize = requirements.size;
+        while (allocate_info.memoryTypeIndex < memory_properties_.memoryTypeCount &&
+               !(requirements.memoryTypeBits & (1u << allocate_info.memoryTypeIndex))) {
+            allocate_info.memoryTypeIndex++;
+        }
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        vkAllocateMemory(device, &allocate_info, nullptr, &memory);
+        VkDevice device_handle = device;
+        cleanup_.insert(cleanup_.end() - 1, [=]() { vkFreeMemory(device_handle, memory, nullptr); });
+        return memory;
+    }
+
+    VkPhysicalDeviceMemoryProperties memory_properties_;
+    std::vector<std::function<void()>> cleanup_;
+};
+
+void BeginCommandBuffer(VkCommandBuffer command_buffer, VkCommandBufferUsageFlags flags = 0) {
+    VkCommandBufferBeginInfo begin_info = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    begin_info.flags = flags;
+    vkBeginCommandBuffer(command_buffer, &begin_info);
+}
+
+// The render pass of a deferred renderer: the first subpass writes two color attachments and depth, the second reads
+// those two as input attachments and writes a third, and the last reads the third and writes the final color.
+const uint32_t deferred_attachment_count = 5;
+const uint32_t deferred_subpass_count = 3;
+const VkFormat deferred_color_format = VK_FORMAT_R8G8B8A8_UNORM;
+const VkFormat deferred_depth_format = VK_FORMAT_D16_UNORM;
+
+VkRenderPass CreateDeferredRenderPass(BenchmarkDevice &device) {
+    VkAttachmentDescription attachments[deferred_attachment_count] = {};
+    for (uint32_t i = 0; i < deferred_attachment_count; i++) {
+        attachments[i].format = i == 4 ? deferred_depth_format : deferred_color_format;
+        attachments[i].samples = VK_SAMPLE_COUNT_1_BIT;
+        attachments[i].loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachments[i].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        attachments[i].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachments[i].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachments[i].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        attachments[i].finalLayout = i < 3 ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+                                           : i == 3 ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+                                                    : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    }
+    VkAttachmentReference gbuffer_outputs[2] = {{0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL},
+                                                {1, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL}};
+    VkAttachmentReference depth = {4, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+    VkAttachmentReference gbuffer_inputs[2] = {{0, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+                                               {1, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL}};
+    VkAttachmentReference lighting_output = {2, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+    VkAttachmentReference lighting_input = {2, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    VkAttachmentReference final_output = {3, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+    VkSubpassDescription subpasses[deferred_subpass_count] = {};
+    for (auto &subpass : subpasses) subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpasses[0].colorAttachmentCount = 2;
+    subpasses[0].pColorAttachments = gbuffer_outputs;
+    subpasses[0].pDepthStencilAttachment = &depth;
+    subpasses[1].inputAttachmentCount = 2;
+    subpasses[1].pInputAttachments = gbuffer_inputs;
+    subpasses[1].colorAttachmentCount = 1;
+    subpasses[1].pColorAttachments = &lighting_output;
+    subpasses[2].inputAttachmentCount = 1;
+    subpasses[2].pInputAttachments = &lighting_input;
+    subpasses[2].colorAttachmentCount = 1;
+    subpasses[2].pColorAttachments = &final_output;
+    VkSubpassDependency dependencies[deferred_subpass_count - 1];
+    for (uint32_t i = 0; i < deferred_subpass_count - 1; i++) {
+        dependencies[i] = {i,
+                           i + 1,
+                           VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                           VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                           VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                           VK_ACCESS_INPUT_ATTACHMENT_READ_BIT,
+                           VK_DEPENDENCY_BY_REGION_BIT};
+    }
+
+    VkRenderPassCreateInfo render_pass_info = {VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO};
+    render_pass_info.attachmentCount = deferred_attachment_count;
+    render_pass_info.pAttachments = attachments;
+    render_pass_info.subpassCount = deferred_subpass_count;
+    render_pass_info.pSubpasses = subpasses;
+    render_pass_info.dependencyCount = deferred_subpass_count - 1;
+    render_pass_info.pDependencies = dependencies;
+    VkRenderPass render_pass = VK_NULL_HANDLE;
+    vkCreateRenderPass(device.device, &render_pass_info, nullptr, &render_pass);
+    VkDevice vk_device = device.device;
+    device.OnDestroy([=]() { vkDestroyRenderPass(vk_device, render_pass, nullptr); });
+    return render_pass;
+}
+
+// A framebuffer for a deferred render pass, with images of its own
+VkFramebuffer CreateDeferredFramebuffer(BenchmarkDevice &device, VkRenderPass render_pass, uint32_t size) {
+    VkImageView views[deferred_attachment_count];
+    for (uint32_t i = 0; i < deferred_attachment_count; i++) {
+        VkFormat format = i == 4 ? deferred_depth_format : deferred_color_format;
+        VkImageUsageFlags usage = i == 4 ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        if (i < 3) usage |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+        VkImage image = device.CreateImage(format, size, size, 1, 1, usage);
+        views[i] = device.CreateImageView(image, format, i == 4 ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT);
+    }
+    VkFramebufferCreateInfo framebuffer_info = {VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO};
+    framebuffer_info.renderPass = render_pass;
+    framebuffer_info.attachmentCount = deferred_attachment_count;
+    framebuffer_info.pAttachments = views;
+    framebuffer_info.width = size;
+    framebuffer_info.height = size;
+    framebuffer_info.layers = 1;
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+    vkCreateFramebuffer(device.device, &framebuffer_info, nullptr, &framebuffer);
+    VkDevice vk_device = device.device;
+    device.OnDestroy([=]() { vkDestroyFramebuffer(vk_device, framebuffer, nullptr); });
+    return framebuffer;
+}
+
+void BeginDeferredRenderPass(VkCommandBuffer command_buffer, VkRenderPass render_pass, VkFramebuffer framebuffer, uint32_t size,
+                             VkSubpassContents contents) {
+    VkRenderPassBeginInfo begin_info = {VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
+    begin_info.renderPass = render_pass;
+    begin_info.framebuffer = framebuffer;
+    begin_info.renderArea = {{0, 0}, {size, size}};
+    vkCmdBeginRenderPass(command_buffer, &begin_info, contents);
+}
+
+// Accumulates the time spent in the timed parts of a benchmark
+class Stopwatch {
+   public:
+    Stopwatch() : total_(0) {}
+    void Start() { start_ = std::chrono::steady_clock::now(); }
+    void Stop() { total_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count(); }
+    double Seconds() const { return total_; }
+
+   private:
+    std::chrono::steady_clock::time_point start_;
+    double total_;
+};
+
+// Prints the time per operation, and the messages issued since the previous report
+void Report(const char *what, const Stopwatch &stopwatch, uint64_t operations, const char *operation) {
+    double per_operation = stopwatch.Seconds() / operations;
+    const char *unit = "ns";
+    double scaled = per_operation * 1e9;
+    if (scaled >= 10000) {
+        unit = "us";
+        scaled /= 1000;
+    }
+    printf("%-52s %9.1f %s per %s  (%u errors, %u warnings)\n", what, scaled, unit, operation, error_count, warning_count);
+    fflush(stdout);
+    error_count = 0;
+    warning_count = 0;
+}
+
+// Cheap vkCmd* calls, where finding the layer's per-device data is a large part of the cost. With two devices the lookup
+// can't be served by remembering the last device.
+void BenchmarkDispatch(const BenchmarkInstance &instance, uint32_t scale) {
+    BenchmarkDevice devices[2];
+    VkCommandBuffer command_buffers[2];
+    for (uint32_t i = 0; i < 2; i++) {
+        if (!devices[i].Init(instance)) return;
+        command_buffers[i] = devices[i].AllocateCommandBuffer();
+    }
+
+    const uint32_t calls_per_recording = 1000;
+    const uint32_t recordings = 1000 * scale;
+    for (uint32_t device_count = 1; device_count <= 2; device_count++) {
+        Stopwatch stopwatch;
+        for (uint32_t recording = 0; recording < recordings; recording++) {
+            for (uint32_t i = 0; i < device_count; i++) BeginCommandBuffer(command_buffers[i]);
+            stopwatch.Start();
+            for (uint32_t call = 0; call < calls_per_recording; call++) {
+                vkCmdSetLineWidth(command_buffers[call % device_count], 1.0f);
+            }
+            stopwatch.Stop();
+            for (uint32_t i = 0; i < device_count; i++) vkEndCommandBuffer(command_buffers[i]);
+        }
+        Report(device_count == 1 ? "vkCmdSetLineWidth, one device" : "vkCmdSetLineWidth, alternating between two devices",
+               stopwatch, uint64_t(recordings) * calls_per_recording, "call");
+    }
+}
+
+// Descriptor streaming: every set is rewritten each frame, with one uniform buffer and eight combined image samplers
+// drawn from a few dozen resources. Writes come one descriptor at a time, as engines that patch sets in place issue them,
+// and then as one template update per set.
+void BenchmarkDescriptorUpdates(const BenchmarkInstance &instance, uint32_t scale) {
+    const uint32_t set_count = 512;
+    const uint32_t images_per_set = 8;
+    const uint32_t view_count = 24;
+    const uint32_t sampler_count = 4;
+    const uint32_t buffer_count = 8;
+    const VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+
+    BenchmarkDevice device;
+    std::vector<const char *> extensions;
+    uint32_t extension_count = 0;
+    vkEnumerateDeviceExtensionProperties(instance.gpu, nullptr, &extension_count, nullptr);
+    std::vector<VkExtensionProperties> available(extension_count);
+    vkEnumerateDeviceExtensionProperties(instance.gpu, nullptr, &extension_count, available.data());
+    for (const auto &extension : available) {
+        if (!strcmp(extension.extensionName, VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME)) {
+            extensions.push_back(VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME);
+        }
+    }
+    if (!device.Init(instance, extensions)) return;
+    VkDevice vk_device = device.device;
+
+    std::vector<VkImageView> views(view_count);
+    for (auto &view : views) {
+        VkImage image = device.CreateImage(format, 64, 64, 1, 1, VK_IMAGE_USAGE_SAMPLED_BIT);
+        view = device.CreateImageView(image, format, VK_IMAGE_ASPECT_COLOR_BIT);
+    }
+    std::vector<VkSampler> samplers(sampler_count);
+    for (auto &sampler : samplers) sampler = device.CreateSampler();
+    std::vector<VkBuffer> buffers(buffer_count);
+    for (auto &buffer : buffers) buffer = device.CreateBuffer(4096, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+
+    VkDescriptorSetLayoutBinding bindings[2] = {
+        {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_ALL_GRAPHICS, nullptr},
+        {1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, images_per_set, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr}};
+    VkDescriptorSetLayoutCreateInfo layout_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+    layout_info.bindingCount = 2;
+    layout_info.pBindings = bindings;
+    VkDescriptorSetLayout set_layout;
+    vkCreateDescriptorSetLayout(vk_device, &layout_info, nullptr, &set_layout);
+    device.OnDestroy([=]() { vkDestroyDescriptorSetLayout(vk_device, set_layout, nullptr); });
+
+    VkDescriptorPoolSize pool_sizes[2] = {{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, set_count},
+                                          {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, set_count * images_per_set}};
+    VkDescriptorPoolCreateInfo pool_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+    pool_info.maxSets = set_count;
+    pool_info.poolSizeCount = 2;
+    pool_info.pPoolSizes = pool_sizes;
+    VkDescriptorPool pool;
+    vkCreateDescriptorPool(vk_device, &pool_info, nullptr, &pool);
+    device.OnDestroy([=]() { vkDestroyDescriptorPool(vk_device, pool, nullptr); });
+    std::vector<VkDescriptorSetLayout> set_layouts(set_count, set_layout);
+    VkDescriptorSetAllocateInfo allocate_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+    allocate_info.descriptorPool = pool;
+    allocate_info.descriptorSetCount = set_count;
+    allocate_info.pSetLayouts = set_layouts.data();
+    std::vector<VkDescriptorSet> sets(set_count);
+    vkAllocateDescriptorSets(vk_device, &allocate_info, sets.data());
+
+    // What each set points at; the choice of resources shifts from frame to frame
+    struct SetContents {
+        VkDescriptorBufferInfo buffer;
+        VkDescriptorImageInfo images[images_per_set];
+    };
+    std::vector<SetContents> contents(set_count);
+    auto fill_contents = [&](uint32_t frame) {
+        for (uint32_t i = 0; i < set_count; i++) {
+            contents[i].buffer = {buffers[(i + frame) % buffer_count], 0, 256};
+            for (uint32_t j = 0; j < images_per_set; j++) {
+                contents[i].images[j] = {samplers[(i + j) % sampler_count], views[(i * 3 + j + frame) % view_count],
+                                         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+            }
+        }
+    };
+
+    const uint32_t frames = 200 * scale;
+    std::vector<VkWriteDescriptorSet> writes;
+    writes.reserve(set_count * (1 + images_per_set));
+    Stopwatch stopwatch;
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        fill_contents(frame);
+        writes.clear();
+        for (uint32_t i = 0; i < set_count; i++) {
+            VkWriteDescriptorSet write = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+            write.dstSet = sets[i];
+            write.dstBinding = 0;
+            write.descriptorCount = 1;
+            write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            write.pBufferInfo = &contents[i].buffer;
+            writes.push_back(write);
+            for (uint32_t j = 0; j < images_per_set; j++) {
+                write.dstBinding = 1;
+                write.dstArrayElement = j;
+                write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                write.pBufferInfo = nullptr;
+                write.pImageInfo = &contents[i].images[j];
+                writes.push_back(write);
+            }
+        }
+        stopwatch.Start();
+        vkUpdateDescriptorSets(vk_device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+        stopwatch.Stop();
+    }
+    Report("vkUpdateDescriptorSets, one descriptor per write", stopwatch, uint64_t(frames) * writes.size(), "write");
+
+    if (extensions.empty()) {
+        printf("vkUpdateDescriptorSetWithTemplateKHR skipped: %s isn't supported\n",
+               VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME);
+        return;
+    }
+    auto create_template = reinterpret_cast<PFN_vkCreateDescriptorUpdateTemplateKHR>(
+        vkGetDeviceProcAddr(vk_device, "vkCreateDescriptorUpdateTemplateKHR"));
+    auto destroy_template = reinterpret_cast<PFN_vkDestroyDescriptorUpdateTemplateKHR>(
+        vkGetDeviceProcAddr(vk_device, "vkDestroyDescriptorUpdateTemplateKHR"));
+    auto update_with_template = reinterpret_cast<PFN_vkUpdateDescriptorSetWithTemplateKHR>(
+        vkGetDeviceProcAddr(vk_device, "vkUpdateDescriptorSetWithTemplateKHR"));
+    VkDescriptorUpdateTemplateEntryKHR entries[2] = {
+        {0, 0, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, offsetof(SetContents, buffer), sizeof(VkDescriptorBufferInfo)},
+        {1, 0, images_per_set, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, offsetof(SetContents, images),
+         sizeof(VkDescriptorImageInfo)}};
+    VkDescriptorUpdateTemplateCreateInfoKHR template_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO_KHR};
+    template_info.descriptorUpdateEntryCount = 2;
+    template_info.pDescriptorUpdateEntries = entries;
+    template_info.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET_KHR;
+    template_info.descriptorSetLayout = set_layout;
+    VkDescriptorUpdateTemplateKHR update_template;
+    create_template(vk_device, &template_info, nullptr, &update_template);
+    device.OnDestroy([=]() { destroy_template(vk_device, update_template, nullptr); });
+
+    Stopwatch template_stopwatch;
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        fill_contents(frame);
+        template_stopwatch.Start();
+        for (uint32_t i = 0; i < set_count; i++) update_with_template(vk_device, sets[i], update_template, &contents[i]);
+        template_stopwatch.Stop();
+    }
+    Report("vkUpdateDescriptorSetWithTemplateKHR", template_stopwatch, uint64_t(frames) * set_count, "set");
+}
+
+// Pre-recorded secondaries executed in every subpass of a deferred render pass. They were recorded against a render pass
+// that is compatible with the one they run in, but isn't the same object, as when an engine records them once for a
+// whole family of render passes.
+void BenchmarkExecuteCommands(const BenchmarkInstance &instance, uint32_t scale) {
+    const uint32_t secondaries_per_subpass = 64;
+    const uint32_t size = 256;
+
+    BenchmarkDevice device;
+    if (!device.Init(instance)) return;
+    VkRenderPass render_pass = CreateDeferredRenderPass(device);
+    VkRenderPass inherited_render_pass = CreateDeferredRenderPass(device);
+    VkFramebuffer framebuffer = CreateDeferredFramebuffer(device, render_pass, size);
+
+    std::vector<VkCommandBuffer> secondaries[deferred_subpass_count];
+    for (uint32_t subpass = 0; subpass < deferred_subpass_count; subpass++) {
+        for (uint32_t i = 0; i < secondaries_per_subpass; i++) {
+            VkCommandBuffer secondary = device.AllocateCommandBuffer(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+            VkCommandBufferInheritanceInfo inheritance_info = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
+            inheritance_info.renderPass = inherited_render_pass;
+            inheritance_info.subpass = subpass;
+            VkCommandBufferBeginInfo begin_info = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+            begin_info.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+            begin_info.pInheritanceInfo = &inheritance_info;
+            vkBeginCommandBuffer(secondary, &begin_info);
+            vkCmdSetLineWidth(secondary, 1.0f);
+            vkEndCommandBuffer(secondary);
+            secondaries[subpass].push_back(secondary);
+        }
+    }
+
+    VkCommandBuffer primary = device.AllocateCommandBuffer();
+    const uint32_t frames = 1000 * scale;
+    Stopwatch stopwatch;
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        BeginCommandBuffer(primary, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        BeginDeferredRenderPass(primary, render_pass, framebuffer, size, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        for (uint32_t subpass = 0; subpass < deferred_subpass_count; subpass++) {
+            if (subpass) vkCmdNextSubpass(primary, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+            stopwatch.Start();
+            vkCmdExecuteCommands(primary, secondaries_per_subpass, secondaries[subpass].data());
+            stopwatch.Stop();
+        }
+        vkCmdEndRenderPass(primary);
+        vkEndCommandBuffer(primary);
+    }
+    Report("vkCmdExecuteCommands, compatible render pass", stopwatch,
+           uint64_t(frames) * deferred_subpass_count * secondaries_per_subpass, "secondary");
+}
+
+// Render passes begun over and over against a few dozen framebuffers, with no commands inside, so that the checks made
+// when a render pass begins dominate. Then the same again while a texture streamer creates and destroys an image and an
+// image view between passes, none of which the framebuffers use.
+void BenchmarkBeginRenderPass(const BenchmarkInstance &instance, uint32_t scale) {
+    const uint32_t framebuffer_count = 24;
+    const uint32_t passes_per_recording = 96;
+    const uint32_t size = 256;
+
+    BenchmarkDevice device;
+    if (!device.Init(instance)) return;
+    VkRenderPass render_pass = CreateDeferredRenderPass(device);
+    std::vector<VkFramebuffer> framebuffers(framebuffer_count);
+    for (auto &framebuffer : framebuffers) framebuffer = CreateDeferredFramebuffer(device, render_pass, size);
+
+    VkImage texture = device.CreateImage(VK_FORMAT_R8G8B8A8_UNORM, size, size, 1, 1, VK_IMAGE_USAGE_SAMPLED_BIT);
+    VkImageCreateInfo streamed_image_info = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+    streamed_image_info.imageType = VK_IMAGE_TYPE_2D;
+    streamed_image_info.format = VK_FORMAT_R8G8B8A8_UNORM;
+    streamed_image_info.extent = {size, size, 1};
+    streamed_image_info.mipLevels = 1;
+    streamed_image_info.arrayLayers = 1;
+    streamed_image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    streamed_image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    streamed_image_info.usage = VK_IMAGE_USAGE_SAMPLED_BIT;
+    VkImageViewCreateInfo streamed_view_info = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+    streamed_view_info.image = texture;
+    streamed_view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    streamed_view_info.format = VK_FORMAT_R8G8B8A8_UNORM;
+    streamed_view_info.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+    VkCommandBuffer command_buffer = device.AllocateCommandBuffer();
+    const uint32_t recordings = 1000 * scale;
+    for (int streaming = 0; streaming < 2; streaming++) {
+        Stopwatch stopwatch;
+        for (uint32_t recording = 0; recording < recordings; recording++) {
+            BeginCommandBuffer(command_buffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+            for (uint32_t pass = 0; pass < passes_per_recording; pass++) {
+                if (streaming) {
+                    VkImage image;
+                    vkCreateImage(device.device, &streamed_image_info, nullptr, &image);
+                    vkDestroyImage(device.device, image, nullptr);
+                    VkImageView view;
+                    vkCreateImageView(device.device, &streamed_view_info, nullptr, &view);
+                    vkDestroyImageView(device.device, view, nullptr);
+                }
+                stopwatch.Start();
+                BeginDeferredRenderPass(command_buffer, render_pass, framebuffers[pass % framebuffer_count], size,
+                                        VK_SUBPASS_CONTENTS_INLINE);
+                stopwatch.Stop();
+                for (uint32_t subpass = 1; subpass < deferred_subpass_count; subpass++) {
+                    vkCmdNextSubpass(command_buffer, VK_SUBPASS_CONTENTS_INLINE);
+                }
+                vkCmdEndRenderPass(command_buffer);
+            }
+            vkEndCommandBuffer(command_buffer);
+        }
+        Report(streaming ? "vkCmdBeginRenderPass, streaming unrelated images"
+                         : "vkCmdBeginRenderPass, 5 attachments, 3 subpasses",
+               stopwatch, uint64_t(recordings) * passes_per_recording, "begin");
+    }
+}
+
+// A GPU profiler's timestamps: each frame resets a whole query pool, writes a timestamp into every query, submits, and
+// reads the results back.
+void BenchmarkTimestampQueries(const BenchmarkInstance &instance, uint32_t scale) {
+    const uint32_t query_count = 4096;
+
+    BenchmarkDevice device;
+    if (!device.Init(instance)) return;
+    VkDevice vk_device = device.device;
+    VkQueryPoolCreateInfo pool_info = {VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+    pool_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    pool_info.queryCount = query_count;
+    VkQueryPool pool;
+    vkCreateQueryPool(vk_device, &pool_info, nullptr, &pool);
+    device.OnDestroy([=]() { vkDestroyQueryPool(vk_device, pool, nullptr); });
+
+    VkCommandBuffer command_buffer = device.AllocateCommandBuffer();
+    std::vector<uint64_t> results(query_count);
+    const uint32_t frames = 200 * scale;
+    Stopwatch record_stopwatch;
+    Stopwatch submit_stopwatch;
+    Stopwatch results_stopwatch;
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        BeginCommandBuffer(command_buffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        record_stopwatch.Start();
+        vkCmdResetQueryPool(command_buffer, pool, 0, query_count);
+        for (uint32_t query = 0; query < query_count; query++) {
+            vkCmdWriteTimestamp(command_buffer,
+                                query % 2 ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, pool,
+                                query);
+        }
+        record_stopwatch.Stop();
+        vkEndCommandBuffer(command_buffer);
+
+        VkSubmitInfo submit_info = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = &command_buffer;
+        submit_stopwatch.Start();
+        vkQueueSubmit(device.queue, 1, &submit_info, VK_NULL_HANDLE);
+        vkQueueWaitIdle(device.queue);
+        submit_stopwatch.Stop();
+
+        results_stopwatch.Start();
+        vkGetQueryPoolResults(vk_device, pool, 0, query_count, query_count * sizeof(uint64_t), results.data(), sizeof(uint64_t),
+                              VK_QUERY_RESULT_64_BIT);
+        results_stopwatch.Stop();
+    }
+    Report("vkCmdResetQueryPool and vkCmdWriteTimestamp", record_stopwatch, uint64_t(frames) * query_count, "query");
+    Report("vkQueueSubmit and vkQueueWaitIdle, 4096 queries", submit_stopwatch, frames, "frame");
+    Report("vkGetQueryPoolResults, 4096 queries", results_stopwatch, frames, "frame");
+}
+
+// A render graph's barriers: each vkCmdPipelineBarrier call moves many subresources of the same few images between
+// attachment and shader read layouts. Barriers come one subresource at a time and then one whole image at a time.
+void BenchmarkPipelineBarriers(const BenchmarkInstance &instance, uint32_t scale) {
+    const uint32_t image_count = 16;
+    const uint32_t mip_levels = 4;
+    const uint32_t array_layers = 6;
+    const VkImageLayout layouts[2] = {VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    const VkAccessFlags access_masks[2] = {VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT};
+
+    BenchmarkDevice device;
+    if (!device.Init(instance)) return;
+    std::vector<VkImage> images(image_count);
+    for (auto &image : images) {
+        image = device.CreateImage(VK_FORMAT_R8G8B8A8_UNORM, 256, 256, mip_levels, array_layers,
+                                   VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+    }
+    VkCommandBuffer command_buffer = device.AllocateCommandBuffer();
+
+    for (int whole_images = 0; whole_images < 2; whole_images++) {
+        const uint32_t barriers_per_call = whole_images ? image_count : 256;
+        const uint32_t calls_per_recording = 200;
+        const uint32_t recordings = (whole_images ? 100 : 10) * scale;
+        // Which of the two layouts each subresource is in, or each image when barriers cover whole images
+        std::vector<uint32_t> state(image_count * mip_levels * array_layers);
+        std::vector<VkImageMemoryBarrier> barriers(barriers_per_call);
+        Stopwatch stopwatch;
+        for (uint32_t recording = 0; recording < recordings; recording++) {
+            BeginCommandBuffer(command_buffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+            for (uint32_t i = 0; i < image_count; i++) {
+                VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+                barrier.dstAccessMask = access_masks[0];
+                barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                barrier.newLayout = layouts[0];
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.image = images[i];
+                barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS};
+                vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0,
+                                     nullptr, 0, nullptr, 1, &barrier);
+            }
+            std::fill(state.begin(), state.end(), 0);
+
+            for (uint32_t call = 0; call < calls_per_recording; call++) {
+                for (uint32_t k = 0; k < barriers_per_call; k++) {
+                    uint32_t image = k % image_count;
+                    uint32_t mip = whole_images ? 0 : (k / image_count) % mip_levels;
+                    uint32_t layer = whole_images ? 0 : (k / (image_count * mip_levels) + call) % array_layers;
+                    uint32_t &from = state[(image * mip_levels + mip) * array_layers + layer];
+                    auto &barrier = barriers[k];
+                    barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+                    barrier.srcAccessMask = access_masks[from];
+                    barrier.dstAccessMask = access_masks[!from];
+                    barrier.oldLayout = layouts[from];
+                    barrier.newLayout = layouts[!from];
+                    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                    barrier.image = images[image];
+                    if (whole_images) {
+                        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, VK_REMAINING_MIP_LEVELS, 0,
+                                                    VK_REMAINING_ARRAY_LAYERS};
+                    } else {
+                        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, mip, 1, layer, 1};
+                    }
+                    from = !from;
+                }
+                stopwatch.Start();
+                vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0,
+                                     nullptr, 0, nullptr, barriers_per_call, barriers.data());
+                stopwatch.Stop();
+            }
+            vkEndCommandBuffer(command_buffer);
+        }
+        Report(whole_images ? "vkCmdPipelineBarrier, 16 whole-image barriers" : "vkCmdPipelineBarrier, 256 subresource barriers",
+               stopwatch, uint64_t(recordings) * calls_per_recording * barriers_per_call, "barrier");
+    }
+}
+
+// Times finding each of probes in a Map holding keys
+template <typename Map>
+void TimeLookups(const char *container, const char *kind, const std::vector<uint64_t> &keys, const std::vector<uint64_t> &probes,
+                 uint32_t scale) {
+    Map map;
+    for (auto key : keys) map.emplace(key, key);
+    const uint32_t rounds = std::max<uint32_t>(1, (1u << 23) / static_cast<uint32_t>(probes.size())) * scale;
+    uint64_t found = 0;
+    Stopwatch stopwatch;
+    stopwatch.Start();
+    for (uint32_t round = 0; round < rounds; round++) {
+        for (auto probe : probes) {
+            auto it = map.find(probe);
+            if (it != map.end()) found += it->second;
+        }
+    }
+    stopwatch.Stop();
+    benchmark_sink = benchmark_sink + found;
+    char what[64];
+    snprintf(what, sizeof(what), "%s, %u entries, %s", container, static_cast<unsigned>(keys.size()), kind);
+    Report(what, stopwatch, uint64_t(rounds) * probes.size(), "lookup");
+}
+
+// Handle lookups in the layers' state tables: FlatHashMap against std::unordered_map, for a small table and one with
+// tens of thousands of objects. Keys look like the heap addresses a driver hands out as handles, 64 to 256 bytes apart,
+// and are looked up in a shuffled order. Misses are addresses inside those objects.
+void BenchmarkHandleMaps(const BenchmarkInstance &, uint32_t scale) {
+    const uint32_t sizes[] = {64, 16384};
+    std::mt19937 random(1);
+    for (auto size : sizes) {
+        std::vector<uint64_t> keys(size);
+        std::vector<uint64_t> misses(size);
+        uint64_t address = 0x7f4a10000000ull;
+        for (uint32_t i = 0; i < size; i++) {
+            address += 0x40 * (1 + random() % 4);
+            keys[i] = address;
+            misses[i] = address + 0x10;
+        }
+        std::shuffle(keys.begin(), keys.end(), random);
+        std::vector<uint64_t> hits = keys;
+        std::shuffle(hits.begin(), hits.end(), random);
+        std::shuffle(misses.begin(), misses.end(), random);
+
+        TimeLookups<FlatHashMap<uint64_t, uint64_t>>("FlatHashMap", "hits", keys, hits, scale);
+        TimeLookups<std::unordered_map<uint64_t, uint64_t>>("std::unordered_map", "hits", keys, hits, scale);
+        TimeLookups<FlatHashMap<uint64_t, uint64_t>>("FlatHashMap", "misses", keys, misses, scale);
+        TimeLookups<std::unordered_map<uint64_t, uint64_t>>("std::unordered_map", "misses", keys, misses, scale);
+    }
+}
+
+// Like Report, with the number of allocations per operation added to the label
+void ReportAllocations(const char *what, const Stopwatch &stopwatch, uint64_t operations, const char *operation,
+                       uint64_t allocations) {
+    char label[64];
+    snprintf(label, sizeof(label), "%s: %.1f allocs", what, double(allocations) / operations);
+    Report(label, stopwatch, operations, operation);
+}
+
+// Stands in for the parameter validation helpers, which only format the name when the check fails. Called through a
+// volatile pointer so that the name has to be built as it would be for a call into another translation unit.
+bool CheckRequiredHandle(const ParameterName &name, uint64_t handle) { return !handle && !name.get_name().empty(); }
+bool (*volatile check_required_handle)(const ParameterName &, uint64_t) = CheckRequiredHandle;
+
+// ParameterName construction for array elements, as the generated parameter validation code does for every member of
+// every element it checks, and the rarer case where the check fails and the name is formatted. The last case records
+// buffer barriers under the layers being measured; with VK_LAYER_LUNARG_parameter_validation each barrier builds four
+// names.
+void BenchmarkParameterNames(const BenchmarkInstance &instance, uint32_t scale) {
+    const uint32_t names_per_round = 1024;
+    const uint32_t rounds = 4096 * scale;
+    for (uint32_t test = 0; test < 3; test++) {
+        const uint64_t handle = test == 2 ? 0 : 1;
+        const uint32_t test_rounds = test == 2 ? rounds / 16 : rounds;
+        uint64_t failed = 0;
+        uint64_t allocations = allocation_count.load();
+        Stopwatch stopwatch;
+        stopwatch.Start();
+        for (uint32_t round = 0; round < test_rounds; round++) {
+            for (uint32_t i = 0; i < names_per_round; i++) {
+                if (test == 1) {
+                    failed += check_required_handle(
+                        ParameterName("pCreateInfos[%i].pStages[%i].module", ParameterName::IndexVector{i / 4, i % 4}), handle);
+                } else {
+                    failed += check_required_handle(
+                        ParameterName("pBufferMemoryBarriers[%i].buffer", ParameterName::IndexVector{i}), handle);
+                }
+            }
+        }
+        stopwatch.Stop();
+        allocations = allocation_count.load() - allocations;
+        benchmark_sink = benchmark_sink + failed;
+        const char *labels[] = {"ParameterName, one index", "ParameterName, two indices", "ParameterName, formatted"};
+        ReportAllocations(labels[test], stopwatch, uint64_t(test_rounds) * names_per_round, "name", allocations);
+    }
+
+    BenchmarkDevice device;
+    if (!device.Init(instance)) return;
+    const uint32_t buffer_count = 8;
+    const uint32_t barriers_per_call = 64;
+    VkBuffer buffers[buffer_count];
+    for (auto &buffer : buffers) buffer = device.CreateBuffer(4096, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    std::vector<VkBufferMemoryBarrier> barriers(barriers_per_call);
+    for (uint32_t i = 0; i < barriers_per_call; i++) {
+        auto &barrier = barriers[i];
+        barrier = {VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = buffers[i % buffer_count];
+        barrier.size = VK_WHOLE_SIZE;
+    }
+
+    VkCommandBuffer command_buffer = device.AllocateCommandBuffer();
+    const uint32_t calls_per_recording = 16;
+    const uint32_t recordings = 1000 * scale;
+    Stopwatch stopwatch;
+    uint64_t allocations = 0;
+    for (uint32_t recording = 0; recording < recordings; recording++) {
+        BeginCommandBuffer(command_buffer);
+        uint64_t start_count = allocation_count.load();
+        stopwatch.Start();
+        for (uint32_t call = 0; call < calls_per_recording; call++) {
+            vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0,
+                                 nullptr, barriers_per_call, barriers.data(), 0, nullptr);
+        }
+        stopwatch.Stop();
+        allocations += allocation_count.load() - start_count;
+        vkEndCommandBuffer(command_buffer);
+    }
+    ReportAllocations("vkCmdPipelineBarrier, 64 buffer barriers", stopwatch,
+                      uint64_t(recordings) * calls_per_recording * barriers_per_call, "barrier", allocations);
+}
+
+// Writes through mappings of host-visible memory that isn't coherent, which core_validation shadows so that it can check
+// for writes outside the mapped range. First a large persistent mapping, of which each frame writes and flushes a few
+// scattered ranges, and then a mapping made, filled, flushed and unmapped each frame. Compare the shadow copy against
+// guard pages by setting lunarg_core_validation.noncoherent_memory_guard to shadow or to pages in vk_layer_settings.txt.
+void BenchmarkMappedMemory(const BenchmarkInstance &instance, uint32_t scale) {
+    BenchmarkDevice device;
+    if (!device.Init(instance)) return;
+    VkPhysicalDeviceMemoryProperties memory_properties;
+    vkGetPhysicalDeviceMemoryProperties(instance.gpu, &memory_properties);
+    VkMemoryAllocateInfo allocate_info = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+    while (allocate_info.memoryTypeIndex < memory_properties.memoryTypeCount &&
+           (memory_properties.memoryTypes[allocate_info.memoryTypeIndex].propertyFlags &
+            (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) != VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        allocate_info.memoryTypeIndex++;
+    }
+    if (allocate_info.memoryTypeIndex == memory_properties.memoryTypeCount) {
+        printf("mappedmemory skipped: no memory type is host visible without being host coherent\n");
+        return;
+    }
+
+    VkDevice vk_device = device.device;
+    const VkDeviceSize persistent_size = 64 << 20;
+    const VkDeviceSize transient_size = 1 << 20;
+    VkDeviceMemory memory[2] = {};
+    for (uint32_t i = 0; i < 2; i++) {
+        allocate_info.allocationSize = i == 0 ? persistent_size : transient_size;
+        vkAllocateMemory(vk_device, &allocate_info, nullptr, &memory[i]);
+        VkDeviceMemory memory_handle = memory[i];
+        device.OnDestroy([=]() { vkFreeMemory(vk_device, memory_handle, nullptr); });
+    }
+
+    // Ranges a few hundred bytes long, 4 KiB aligned and spread over the whole allocation, as a streaming allocator that
+    // suballocates constant and vertex data from one mapping would write them
+    const uint32_t ranges_per_frame = 16;
+    const VkDeviceSize range_size = 256;
+    // With a shadow copy, every range flushed copies the whole mapping to the driver, so the persistent mapping runs fewer frames
+    const uint32_t persistent_frames = 100 * scale;
+    const uint32_t transient_frames = 1000 * scale;
+    std::mt19937 random(1);
+    void *data = nullptr;
+    vkMapMemory(vk_device, memory[0], 0, VK_WHOLE_SIZE, 0, &data);
+    std::vector<VkMappedMemoryRange> ranges(ranges_per_frame, {VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE});
+    Stopwatch stopwatch;
+    for (uint32_t frame = 0; frame < persistent_frames; frame++) {
+        for (auto &range : ranges) {
+            range.memory = memory[0];
+            range.offset = (random() % (persistent_size / 4096)) * 4096;
+            range.size = range_size;
+        }
+        stopwatch.Start();
+        for (const auto &range : ranges) memset(static_cast<char *>(data) + range.offset, frame & 0xff, range_size);
+        vkFlushMappedMemoryRanges(vk_device, ranges_per_frame, ranges.data());
+        stopwatch.Stop();
+    }
+    vkUnmapMemory(vk_device, memory[0]);
+    Report("64 MiB persistent mapping, 16 ranges flushed", stopwatch, persistent_frames, "frame");
+
+    stopwatch = Stopwatch();
+    VkMappedMemoryRange whole_range = {VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE};
+    whole_range.memory = memory[1];
+    whole_range.size = VK_WHOLE_SIZE;
+    for (uint32_t frame = 0; frame < transient_frames; frame++) {
+        stopwatch.Start();
+        vkMapMemory(vk_device, memory[1], 0, VK_WHOLE_SIZE, 0, &data);
+        memset(data, frame & 0xff, static_cast<size_t>(transient_size));
+        vkFlushMappedMemoryRanges(vk_device, 1, &whole_range);
+        vkUnmapMemory(vk_device, memory[1]);
+        stopwatch.Stop();
+    }
+    Report("1 MiB mapped, written, flushed and unmapped", stopwatch, transient_frames, "frame");
+}
+
+// A compute shader whose only function adds 1 to an integer instruction_count times, which makes a module of roughly
+// 20 bytes per instruction. Words are written out by hand, as the benchmarks don't depend on a shader compiler.
+std::vector<uint32_t> MakeComputeShader(uint32_t instruction_count) {
+    // Opcodes, with the operand count in the high half-word
+    const uint32_t op_capability = 2 << 16 | 17, op_memory_model = 3 << 16 | 14, op_entry_point = 5 << 16 | 15,
+                   op_execution_mode = 6 << 16 | 16, op_type_void = 2 << 16 | 19, op_type_function = 3 << 16 | 33,
+                   op_type_int = 4 << 16 | 21, op_constant = 4 << 16 | 43, op_function = 5 << 16 | 54, op_label = 2 << 16 | 248,
+                   op_iadd = 5 << 16 | 128, op_return = 1 << 16 | 253, op_function_end = 1 << 16 | 56;
+    // Result ids: void, function type, int, constant 1, main, its label, and then one per add
+    const uint32_t first_add = 7;
+    std::vector<uint32_t> words = {0x07230203, 0x00010000, 0, first_add + instruction_count, 0,
+                                   op_capability, 1,  // Shader
+                                   op_memory_model, 0, 1,  // Logical GLSL450
+                                   op_entry_point, 5, 5, 0x6e69616d, 0,  // GLCompute %main "main"
+                                   op_execution_mode, 5, 17, 1, 1, 1,  // LocalSize 1 1 1
+                                   op_type_void, 1, op_type_function, 2, 1, op_type_int, 3, 32, 1, op_constant, 3, 4, 1,
+                                   op_function, 1, 5, 0, 2, op_label, 6};
+    for (uint32_t i = 0; i < instruction_count; i++) {
+        const uint32_t add[] = {op_iadd, 3, first_add + i, i == 0 ? 4 : first_add + i - 1, 4};
+        words.insert(words.end(), add, add + 5);
+    }
+    words.push_back(op_return);
+    words.push_back(op_function_end);
+    return words;
+}
+
+// Load time: a few thousand shader modules of 1 to 80 KB, created by four loader threads, and then a compute pipeline
+// for each. SPIR-V validation is most of the cost. Setting lunarg_core_validation.deferred_shader_validation_threads in
+// vk_layer_settings.txt moves it from vkCreateShaderModule to a worker pool, which the first pipeline using a module waits
+// for.
+void BenchmarkShaderModules(const BenchmarkInstance &instance, uint32_t scale) {
+    BenchmarkDevice device;
+    if (!device.Init(instance)) return;
+    VkDevice vk_device = device.device;
+    const uint32_t module_count = 4000 * scale;
+    const uint32_t loader_threads = 4;
+    std::vector<std::vector<uint32_t>> code(7);
+    for (uint32_t i = 0; i < code.size(); i++) code[i] = MakeComputeShader(64 << i);
+
+    std::vector<VkShaderModule> modules(module_count);
+    Stopwatch stopwatch;
+    stopwatch.Start();
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < loader_threads; t++) {
+        threads.emplace_back([&, t]() {
+            for (uint32_t i = t; i < module_count; i += loader_threads) {
+                const auto &words = code[i % code.size()];
+                VkShaderModuleCreateInfo module_info = {VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
+                module_info.codeSize = words.size() * sizeof(uint32_t);
+                module_info.pCode = words.data();
+                vkCreateShaderModule(vk_device, &module_info, nullptr, &modules[i]);
+            }
+        });
+    }
+    for (auto &thread : threads) thread.join();
+    stopwatch.Stop();
+    for (auto module : modules) device.OnDestroy([=]() { vkDestroyShaderModule(vk_device, module, nullptr); });
+    Report("vkCreateShaderModule, from 4 threads", stopwatch, module_count, "module");
+
+    VkPipelineLayoutCreateInfo layout_info = {VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    vkCreatePipelineLayout(vk_device, &layout_info, nullptr, &layout);
+    device.OnDestroy([=]() { vkDestroyPipelineLayout(vk_device, layout, nullptr); });
+    VkComputePipelineCreateInfo pipeline_info = {VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO};
+    pipeline_info.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipeline_info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipeline_info.stage.pName = "main";
+    pipeline_info.layout = layout;
+    stopwatch = Stopwatch();
+    for (auto module : modules) {
+        pipeline_info.stage.module = module;
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        stopwatch.Start();
+        vkCreateComputePipelines(vk_device, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &pipeline);
+        stopwatch.Stop();
+        device.OnDestroy([=]() { vkDestroyPipeline(vk_device, pipeline, nullptr); });
+    }
+    Report("vkCreateComputePipelines, first use of each module", stopwatch, module_count, "pipeline");
+}
+
+struct Benchmark {
+    const char *name;
+    const char *description;
+    void (*run)(const BenchmarkInstance &instance, uint32_t scale);
+};
+
+const Benchmark benchmarks[] = {
+    {"dispatch", "cheap vkCmd* calls on one and on two devices", BenchmarkDispatch},
+    {"descriptors", "descriptor set writes and template updates", BenchmarkDescriptorUpdates},
+    {"secondaries", "secondary command buffers executed in a compatible render pass", BenchmarkExecuteCommands},
+    {"renderpasses", "render passes begun repeatedly against a set of framebuffers", BenchmarkBeginRenderPass},
+    {"queries", "timestamp queries reset, written, submitted and read back", BenchmarkTimestampQueries},
+    {"barriers", "image layout transitions by subresource and by whole image", BenchmarkPipelineBarriers},
+    {"handlemaps", "handle lookups in FlatHashMap and std::unordered_map", BenchmarkHandleMaps},
+    {"parameternames", "ParameterName construction, alone and in buffer barriers", BenchmarkParameterNames},
+    {"mappedmemory", "writes and flushes through mappings of non-coherent memory", BenchmarkMappedMemory},
+    {"shadermodules", "thousands of shader modules created from four threads, then used", BenchmarkShaderModules},
+};
+
+void PrintUsage(const char *program) {
+    fprintf(stderr, "Usage: %s [--layer <name>]... [--no-layers] [--scale <n>] [--verbose] [<benchmark>...]\n\nBenchmarks:\n",
+            program);
+    for (const auto &benchmark : benchmarks) fprintf(stderr, "  %-14s %s\n", benchmark.name, benchmark.description);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::vector<const char *> layers;
+    bool no_layers = false;
+    uint32_t scale = 1;
+    std::vector<const Benchmark *> selected;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--layer") && i + 1 < argc) {
+            layers.push_back(argv[++i]);
+        } else if (!strcmp(argv[i], "--no-layers")) {
+            no_layers = true;
+        } else if (!strcmp(argv[i], "--scale") && i + 1 < argc) {
+            scale = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(argv[i], "--verbose")) {
+            verbose = true;
+        } else {
+            const Benchmark *found = nullptr;
+            for (const auto &benchmark : benchmarks) {
+                if (!strcmp(argv[i], benchmark.name)) found = &benchmark;
+            }
+            if (!found) {
+                PrintUsage(argv[0]);
+                return 1;
+            }
+            selected.push_back(found);
+        }
+    }
+    if (scale == 0) scale = 1;
+    if (no_layers) {
+        layers.clear();
+    } else if (layers.empty()) {
+        layers.push_back("VK_LAYER_LUNARG_core_validation");
+    }
+    if (selected.empty()) {
+        for (const auto &benchmark : benchmarks) selected.push_back(&benchmark);
+    }
+
+    BenchmarkInstance instance;
+    if (!instance.Init(layers)) return 1;
+    error_count = 0;
+    warning_count = 0;
+    for (auto benchmark : selected) benchmark->run(instance, scale);
+    return 0;
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2015-2017 The Khronos Group Inc.
+ * Copyright (c) 2015-2017 Valve Corporation
+ * Copyright (c) 2015-2017 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Checks FlatHashMap against std::unordered_map, and that create/destroy churn at a steady size doesn't keep rebuilding
+// the table.
+
+#include <random>
+#include <unordered_map>
+#include "vk_layer_flat_map.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+// Counts how often keys are hashed: once per lookup or insertion, plus once per live entry on each rehash
+size_t hash_calls = 0;
+struct CountingHash {
+    size_t operator()(uint64_t key) const {
+        hash_calls++;
+        return std::hash<uint64_t>()(key);
+    }
+};
+
+// Handles as the layers see them: distinct, with the low bits of pointers clear
+uint64_t Handle(uint64_t i) { return (i + 1) << 6; }
+
+}  // namespace
+
+TEST(FlatHashMap, MatchesUnorderedMap) {
+    FlatHashMap<uint64_t, uint64_t> map;
+    std::unordered_map<uint64_t, uint64_t> reference;
+    std::mt19937 rng(1);
+    for (int i = 0; i < 200000; i++) {
+        uint64_t key = Handle(rng() % 4096);
+        switch (rng() % 4) {
+            case 0:
+                map[key] = i;
+                reference[key] = i;
+                break;
+            case 1: {
+                auto result = map.emplace(key, i);
+                auto expected = reference.emplace(key, i);
+                ASSERT_EQ(expected.second, result.second);
+                ASSERT_EQ(expected.first->second, result.first->second);
+                break;
+            }
+            case 2:
+                ASSERT_EQ(reference.erase(key), map.erase(key));
+                break;
+            default: {
+                auto it = map.find(key);
+                auto expected = reference.find(key);
+                ASSERT_EQ(expected == reference.end(), it == map.end());
+                if (it != map.end()) {
+                    ASSERT_EQ(expected->second, it->second);
+                }
+                break;
+            }
+        }
+        ASSERT_EQ(reference.size(), map.size());
+    }
+
+    size_t visited = 0;
+    for (const auto &entry : map) {
+        ASSERT_EQ(1u, reference.count(entry.first));
+        EXPECT_EQ(reference[entry.first], entry.second);
+        visited++;
+    }
+    EXPECT_EQ(reference.size(), visited);
+}
+
+TEST(FlatHashMap, EraseWhileIterating) {
+    FlatHashMap<uint64_t, uint64_t> map;
+    for (uint64_t i = 0; i < 1000; i++) map[Handle(i)] = i;
+    for (auto it = map.begin(); it != map.end();) {
+        if (it->second % 3) {
+            it = map.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    EXPECT_EQ(334u, map.size());
+    for (uint64_t i = 0; i < 1000; i++) EXPECT_EQ(i % 3 ? 0u : 1u, map.count(Handle(i))) << i;
+}
+
+// The state tables see objects created and destroyed at a roughly constant live count. With the table close to 3/4
+// full, that used to rebuild it at the same size after every few operations, as each erase left a tombstone.
+TEST(FlatHashMap, ChurnAtSteadySizeIsAmortizedConstant) {
+    const uint64_t live = 12287;
+    const uint64_t operations = 200000;
+    FlatHashMap<uint64_t, uint64_t, CountingHash> map;
+    for (uint64_t i = 0; i < live; i++) map[Handle(i)] = i;
+    EXPECT_EQ(16384u, map.capacity());
+
+    hash_calls = 0;
+    for (uint64_t i = 0; i < operations; i++) {
+        // Destroy the oldest object and create a new one
+        ASSERT_EQ(1u, map.erase(Handle(i)));
+        map[Handle(live + i)] = live + i;
+    }
+    EXPECT_EQ(live, map.size());
+    EXPECT_LE(map.capacity(), 32768u);
+    // Two hashes per iteration for the erase and the insert, plus about one more on average for rehashing. Rebuilding
+    // every few operations costs thousands.
+    EXPECT_LT(hash_calls, operations * 4);
+
+    for (uint64_t i = 0; i < live; i++) EXPECT_EQ(1u, map.count(Handle(operations + i))) << i;
+}
+
+TEST(FlatHashMap, ChurnAtLowLoadStaysSmall) {
+    FlatHashMap<uint64_t, uint64_t, CountingHash> map;
+    for (uint64_t i = 0; i < 100; i++) map[Handle(i)] = i;
+    size_t capacity = map.capacity();
+
+    hash_calls = 0;
+    for (uint64_t i = 0; i < 100000; i++) {
+        map.erase(Handle(i));
+        map[Handle(100 + i)] = i;
+    }
+    // Tombstones are cleared by rebuilding in place rather than by growing
+    EXPECT_EQ(capacity, map.capacity());
+    EXPECT_LT(hash_calls, 100000u * 4);
+}
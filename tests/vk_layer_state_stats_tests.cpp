@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2015-2017 The Khronos Group Inc.
+ * Copyright (c) 2015-2017 Valve Corporation
+ * Copyright (c) 2015-2017 LunarG, Inc.
+ * Copyright (C) 2015-2017 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Checks the two-call idiom of vkGetLayerStateStatsLUNARG across a chain of two layers: the count query, arrays that
+// end inside either layer's entries, and an array that holds exactly the upper layer's entries.
+
+#include <string.h>
+#include <vector>
+#include "vk_layer_state_stats.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+// The layer below, reached through FakeGetDeviceProcAddr as the upper layer would reach it through the dispatch chain
+StateStats *lower_layer = nullptr;
+
+VKAPI_ATTR VkResult VKAPI_CALL LowerGetLayerStateStats(VkDevice device, uint32_t *pStatCount, VkLayerStateStatLUNARG *pStats) {
+    return lower_layer->Report(device, nullptr, pStatCount, pStats);
+}
+
+VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL FakeGetDeviceProcAddr(VkDevice, const char *pName) {
+    if (lower_layer && !strcmp(pName, VK_LUNARG_STATE_STATS_FUNCTION_NAME)) {
+        return reinterpret_cast<PFN_vkVoidFunction>(LowerGetLayerStateStats);
+    }
+    return nullptr;
+}
+
+class StateStatsTest : public ::testing::Test {
+   protected:
+    StateStatsTest() : device_(reinterpret_cast<VkDevice>(1)), upper_("upper"), lower_("lower") {
+        upper_.Add("buffers", 1, 100);
+        upper_.Add("images", 2, 200);
+        lower_.Add("a", 3, 300);
+        lower_.Add("b", 4, 400);
+        lower_.Add("c", 5, 500);
+        lower_layer = &lower_;
+    }
+    ~StateStatsTest() { lower_layer = nullptr; }
+
+    // Calls Report with an array of count entries, filled with a marker so that entries that weren't written show up
+    VkResult Report(uint32_t count, std::vector<VkLayerStateStatLUNARG> *stats) {
+        VkLayerStateStatLUNARG marker = {};
+        marker.objectCount = ~0ull;
+        stats->assign(count, marker);
+        uint32_t written = count;
+        VkResult result = upper_.Report(device_, FakeGetDeviceProcAddr, &written, stats->data());
+        EXPECT_LE(written, count);
+        for (uint32_t i = written; i < count; i++) EXPECT_EQ(~0ull, (*stats)[i].objectCount) << i;
+        stats->resize(written);
+        return result;
+    }
+
+    VkDevice device_;
+    StateStats upper_;
+    StateStats lower_;
+};
+
+}  // namespace
+
+TEST_F(StateStatsTest, CountQueryIncludesLayersBelow) {
+    uint32_t count = 0;
+    EXPECT_EQ(VK_SUCCESS, upper_.Report(device_, FakeGetDeviceProcAddr, &count, nullptr));
+    EXPECT_EQ(5u, count);
+
+    count = 0;
+    EXPECT_EQ(VK_SUCCESS, upper_.Report(device_, nullptr, &count, nullptr));
+    EXPECT_EQ(2u, count);
+}
+
+TEST_F(StateStatsTest, FullArrayListsThisLayerFirst) {
+    std::vector<VkLayerStateStatLUNARG> stats;
+    EXPECT_EQ(VK_SUCCESS, Report(5, &stats));
+    ASSERT_EQ(5u, stats.size());
+    const char *layers[] = {"upper", "upper", "lower", "lower", "lower"};
+    const char *categories[] = {"buffers", "images", "a", "b", "c"};
+    for (uint32_t i = 0; i < 5; i++) {
+        EXPECT_STREQ(layers[i], stats[i].layerName) << i;
+        EXPECT_STREQ(categories[i], stats[i].category) << i;
+        EXPECT_EQ(i + 1, stats[i].objectCount) << i;
+        EXPECT_EQ((i + 1) * 100, stats[i].byteCount) << i;
+    }
+
+    // Spare room is left alone, and the count is lowered to what was written
+    EXPECT_EQ(VK_SUCCESS, Report(8, &stats));
+    EXPECT_EQ(5u, stats.size());
+}
+
+TEST_F(StateStatsTest, ShortArrayIsIncomplete) {
+    std::vector<VkLayerStateStatLUNARG> stats;
+
+    // Ends inside the lower layer's entries
+    EXPECT_EQ(VK_INCOMPLETE, Report(4, &stats));
+    ASSERT_EQ(4u, stats.size());
+    EXPECT_STREQ("images", stats[1].category);
+    EXPECT_STREQ("b", stats[3].category);
+
+    // Ends inside this layer's own entries; the layer below isn't reached
+    EXPECT_EQ(VK_INCOMPLETE, Report(1, &stats));
+    ASSERT_EQ(1u, stats.size());
+    EXPECT_STREQ("buffers", stats[0].category);
+}
+
+TEST_F(StateStatsTest, ArrayHoldingExactlyThisLayersEntriesIsIncomplete) {
+    std::vector<VkLayerStateStatLUNARG> stats;
+    EXPECT_EQ(VK_INCOMPLETE, Report(2, &stats));
+    ASSERT_EQ(2u, stats.size());
+    EXPECT_STREQ("upper", stats[1].layerName);
+
+    // Unless the layers below have nothing to add
+    StateStats empty("lower");
+    lower_layer = &empty;
+    EXPECT_EQ(VK_SUCCESS, Report(2, &stats));
+    EXPECT_EQ(2u, stats.size());
+
+    // Or there are none
+    lower_layer = nullptr;
+    EXPECT_EQ(VK_SUCCESS, Report(2, &stats));
+    EXPECT_EQ(2u, stats.size());
+}
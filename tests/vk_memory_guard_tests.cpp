@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2015-2017 The Khronos Group Inc.
+ * Copyright (c) 2015-2017 Valve Corporation
+ * Copyright (c) 2015-2017 LunarG, Inc.
+ * Copyright (C) 2015-2017 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Exercises core_validation's page-protected guard for mapped non-coherent memory: copying in on first touch, flushing
+// only what was written, invalidation, out-of-range writes, unmapping while other threads fault, and passing faults that
+// aren't its own to the handler that was installed before it.
+
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "memory_guard.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+// Stands in for an application's own SIGSEGV handler. It's installed before main(), so it's the handler that the guard
+// finds when it installs its own. It records the address and makes the page writable, so the faulting access succeeds
+// when it's retried.
+void *foreign_fault_address = nullptr;
+void ForeignFaultHandler(int, siginfo_t *info, void *) {
+    foreign_fault_address = info->si_addr;
+    long page_size = sysconf(_SC_PAGESIZE);
+    void *page = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(info->si_addr) & ~static_cast<uintptr_t>(page_size - 1));
+    mprotect(page, page_size, PROT_READ | PROT_WRITE);
+}
+
+struct InstallForeignFaultHandler {
+    InstallForeignFaultHandler() {
+        struct sigaction action = {};
+        action.sa_sigaction = ForeignFaultHandler;
+        action.sa_flags = SA_SIGINFO;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGSEGV, &action, nullptr);
+    }
+} install_foreign_fault_handler;
+
+const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+// The driver's side of a mapping
+std::vector<uint8_t> DriverData(size_t size) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) data[i] = static_cast<uint8_t>(i * 7 + 1);
+    return data;
+}
+
+}  // namespace
+
+TEST(GuardedMapping, CopiesInOnFirstTouchAndFlushesWrites) {
+    auto driver = DriverData(100 * page_size);
+    auto mapping = GuardedMapping::Create(driver.data(), driver.size(), 64, 64);
+    ASSERT_NE(nullptr, mapping);
+    auto data = static_cast<uint8_t *>(mapping->data());
+
+    EXPECT_EQ(0, memcmp(data, driver.data(), driver.size()));
+    data[10] = 0xaa;
+    data[50 * page_size] = 0xbb;
+    EXPECT_NE(0xaa, driver[10]);
+
+    bool underflow, overflow;
+    mapping->Flush(&underflow, &overflow);
+    EXPECT_FALSE(underflow);
+    EXPECT_FALSE(overflow);
+    EXPECT_EQ(0xaa, driver[10]);
+    EXPECT_EQ(0xbb, driver[50 * page_size]);
+
+    // Flushed blocks are write-protected again; writing one takes another fault and is flushed again
+    data[11] = 0xcc;
+    mapping->Flush(&underflow, &overflow);
+    EXPECT_EQ(0xcc, driver[11]);
+}
+
+TEST(GuardedMapping, FlushesOnlyBlocksWrittenSinceTheLastFlush) {
+    auto driver = DriverData(100 * page_size);
+    auto mapping = GuardedMapping::Create(driver.data(), driver.size(), 0, 64);
+    ASSERT_NE(nullptr, mapping);
+    auto data = static_cast<uint8_t *>(mapping->data());
+
+    // Read the whole range, so every block holds a copy, then write to the first one only
+    EXPECT_EQ(0, memcmp(data, driver.data(), driver.size()));
+    bool underflow, overflow;
+    mapping->Flush(&underflow, &overflow);
+    data[0] = 0x11;
+    // Changes the driver makes elsewhere must not be overwritten with the stale copy
+    driver[80 * page_size] = 0x22;
+
+    mapping->Flush(&underflow, &overflow);
+    EXPECT_EQ(0x11, driver[0]);
+    EXPECT_EQ(0x22, driver[80 * page_size]);
+}
+
+TEST(GuardedMapping, InvalidateRereadsFromTheDriver) {
+    auto driver = DriverData(4 * page_size);
+    auto mapping = GuardedMapping::Create(driver.data(), driver.size(), 0, 64);
+    ASSERT_NE(nullptr, mapping);
+    auto data = static_cast<uint8_t *>(mapping->data());
+
+    EXPECT_EQ(driver[100], data[100]);
+    driver[100] = 0x33;
+    EXPECT_NE(0x33, data[100]);
+    mapping->Invalidate();
+    EXPECT_EQ(0x33, data[100]);
+}
+
+TEST(GuardedMapping, ReportsWritesBeforeTheRange) {
+    auto driver = DriverData(3 * page_size);
+    bool underflow, overflow;
+
+    // Into the guard page
+    auto mapping = GuardedMapping::Create(driver.data(), driver.size(), 0, 64);
+    ASSERT_NE(nullptr, mapping);
+    static_cast<uint8_t *>(mapping->data())[-1] = 0;
+    mapping->Flush(&underflow, &overflow);
+    EXPECT_TRUE(underflow);
+    EXPECT_FALSE(overflow);
+    // Each write is reported once
+    mapping->Flush(&underflow, &overflow);
+    EXPECT_FALSE(underflow);
+
+    // Into the part of the first page that precedes the range
+    mapping = GuardedMapping::Create(driver.data(), driver.size(), 256, 64);
+    ASSERT_NE(nullptr, mapping);
+    static_cast<uint8_t *>(mapping->data())[-1] = 0;
+    mapping->Flush(&underflow, &overflow);
+    EXPECT_TRUE(underflow);
+    EXPECT_FALSE(overflow);
+    mapping->Flush(&underflow, &overflow);
+    EXPECT_FALSE(underflow);
+}
+
+TEST(GuardedMapping, ReportsWritesAfterTheRange) {
+    auto driver = DriverData(3 * page_size);
+    bool underflow, overflow;
+
+    // Into the guard page
+    auto mapping = GuardedMapping::Create(driver.data(), driver.size(), 0, 64);
+    ASSERT_NE(nullptr, mapping);
+    static_cast<uint8_t *>(mapping->data())[driver.size()] = 0;
+    mapping->Flush(&underflow, &overflow);
+    EXPECT_FALSE(underflow);
+    EXPECT_TRUE(overflow);
+    mapping->Flush(&underflow, &overflow);
+    EXPECT_FALSE(overflow);
+
+    // Into the part of the last page that follows the range
+    mapping = GuardedMapping::Create(driver.data(), driver.size() - 100, 0, 64);
+    ASSERT_NE(nullptr, mapping);
+    static_cast<uint8_t *>(mapping->data())[driver.size() - 100] = 0;
+    mapping->Flush(&underflow, &overflow);
+    EXPECT_FALSE(underflow);
+    EXPECT_TRUE(overflow);
+    EXPECT_NE(0, driver[driver.size() - 100]);
+}
+
+TEST(GuardedMapping, PassesOtherFaultsToThePreviousHandler) {
+    auto driver = DriverData(page_size);
+    auto mapping = GuardedMapping::Create(driver.data(), driver.size(), 0, 64);
+    ASSERT_NE(nullptr, mapping);
+
+    void *page = mmap(nullptr, page_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(MAP_FAILED, page);
+    foreign_fault_address = nullptr;
+    *static_cast<volatile uint8_t *>(page) = 1;
+    EXPECT_EQ(page, foreign_fault_address);
+    munmap(page, page_size);
+
+    // The guard's own faults are still taken afterwards
+    static_cast<uint8_t *>(mapping->data())[0] = 0x44;
+    bool underflow, overflow;
+    mapping->Flush(&underflow, &overflow);
+    EXPECT_EQ(0x44, driver[0]);
+}
+
+// With SIGSEGV ignored when the guard is installed, a SIGSEGV sent by kill() is ignored as before, and doesn't take the
+// guard's handler away from its mappings. Exits with 0 if a guarded write after the signal still reaches the driver.
+static void IgnoreSignalThenWrite() {
+    signal(SIGSEGV, SIG_IGN);
+    auto driver = DriverData(page_size);
+    auto mapping = GuardedMapping::Create(driver.data(), driver.size(), 0, 64);
+    if (!mapping) exit(2);
+    kill(getpid(), SIGSEGV);
+    static_cast<uint8_t *>(mapping->data())[0] = 0x55;
+    bool underflow, overflow;
+    mapping->Flush(&underflow, &overflow);
+    exit(driver[0] == 0x55 ? 0 : 3);
+}
+
+TEST(GuardedMapping, IgnoredSignalLeavesTheHandlerInstalled) {
+    // Runs in a fresh process, so that the guard's handler is installed after SIGSEGV is set to be ignored
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+    EXPECT_EXIT(IgnoreSignalThenWrite(), ::testing::ExitedWithCode(0), "");
+}
+
+TEST(GuardedMapping, UnmapsWhileOtherThreadsFault) {
+    // Each thread maps, writes, flushes and unmaps its own memory over and over, so that the fault handler keeps scanning
+    // the table while other threads take their mappings out of it and free them
+    const size_t page_count = 64;
+    std::atomic<int> mismatches(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&]() {
+            auto driver = DriverData(page_count * page_size);
+            for (int i = 0; i < 200; i++) {
+                auto mapping = GuardedMapping::Create(driver.data(), driver.size(), 0, 64);
+                if (!mapping) continue;
+                auto data = static_cast<uint8_t *>(mapping->data());
+                for (size_t page = 0; page < page_count; page += 4) data[page * page_size] = static_cast<uint8_t>(i);
+                bool underflow, overflow;
+                mapping->Flush(&underflow, &overflow);
+                if (driver[(page_count - 4) * page_size] != static_cast<uint8_t>(i)) mismatches++;
+            }
+        });
+    }
+    for (auto &thread : threads) thread.join();
+    EXPECT_EQ(0, mismatches.load());
+}